@@ -52,7 +52,8 @@ DecorativeMesh from it.
     file.close();
     DecorativeMesh decoration(mesh);
 @endcode 
-You can also read a polygon mesh from a VTK PolyData (.vtp) file.
+You can also read a polygon mesh from a VTK PolyData (.vtp) file, or from a
+binary mesh file written by writeBinaryFile(), which loads much faster.
 
 You can also build meshes programmatically, and some static methods are provided
 here for generating some common shapes.
@@ -225,6 +226,37 @@ public:
     @param[in]  pathname    The name of a .vtp file. **/
     void loadVtpFile(const String& pathname);
 
+    /** Write this mesh to a binary mesh file, which loadBinaryFile() can 
+    read far faster than a text format can be parsed. The file holds the 
+    vertex positions and faces in the native binary format of this platform 
+    and precision of Real, so it is best used as a fast-loading copy of a 
+    mesh whose original is kept in a portable format such as OBJ or VTP.
+    The file is written under a temporary name and then renamed, so any mesh
+    that currently has an earlier version of it mapped (see loadBinaryFile())
+    keeps the contents it loaded.
+    @param[in]  pathname    The name of the file to write; an existing file
+                            is replaced. **/
+    void writeBinaryFile(const String& pathname) const;
+
+    /** Load a binary mesh file written by writeBinaryFile(), adding the 
+    vertices and faces it contains to this mesh. If this mesh is empty, the 
+    file is memory mapped and the mesh refers directly to its contents, so 
+    nothing is copied and the operating system reads the file in only as it
+    is used. The file then stays mapped until the mesh is cleared or 
+    destroyed, or until it is changed, which first makes a private copy. If
+    this mesh isn't empty the file's contents are copied in. An exception is
+    thrown if the file isn't a valid binary mesh file written on a platform 
+    like this one.
+
+    @warning While a mesh has a file mapped, that file must not be truncated
+    or rewritten in place, by this program or any other. Pages that are no
+    longer backed by the file can't be read, and on Linux and macOS touching
+    them kills the program with SIGBUS. Replacing the file by renaming a new
+    one over it, as writeBinaryFile() does, is safe. Call clear() or change
+    the mesh first if the file must be modified in place.
+    @param[in]  pathname    The name of the file to read. **/
+    void loadBinaryFile(const String& pathname);
+
 private:
     explicit PolygonalMesh(PolygonalMeshImpl* impl) : HandleBase(impl) {}
     void initializeHandleIfEmpty();
@@ -25,7 +25,11 @@
 #include "SimTKcommon/internal/Xml.h"
 
 #include <cassert>
-#include <sstream>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <string>
 #include <set>
 #include <map>
@@ -76,12 +80,14 @@ int PolygonalMesh::getFaceVertex(int face, int vertex) const {
 
 int PolygonalMesh::addVertex(const Vec3& position) {
     initializeHandleIfEmpty();
+    updImpl().makeWritable();
     updImpl().vertices.push_back(position);
     return getImpl().vertices.size()-1;
 }
 
 int PolygonalMesh::addFace(const Array_<int>& vertices) {
     initializeHandleIfEmpty();
+    updImpl().makeWritable();
     for (int i = 0; i < (int) vertices.size(); i++)
         updImpl().faceVertexIndex.push_back(vertices[i]);
 
@@ -96,6 +102,7 @@ int PolygonalMesh::addFace(const Array_<int>& vertices) {
 
 PolygonalMesh& PolygonalMesh::scaleMesh(Real scale) {
     if (!isEmptyHandle()) {
+        updImpl().makeWritable();
         Array_<Vec3>& vertices = updImpl().vertices;
         for (int i = 0; i < (int) vertices.size(); i++)
             vertices[i] *= scale;
@@ -105,6 +112,7 @@ PolygonalMesh& PolygonalMesh::scaleMesh(Real scale) {
 
 PolygonalMesh& PolygonalMesh::transformMesh(const Transform& X_AM) {
     if (!isEmptyHandle()) {
+        updImpl().makeWritable();
         Array_<Vec3>& vertices = updImpl().vertices;
         for (int i = 0; i < (int) vertices.size(); i++)
             vertices[i] = X_AM*vertices[i];
@@ -112,6 +120,9 @@ PolygonalMesh& PolygonalMesh::transformMesh(const Transform& X_AM) {
     return *this;
 }
 
+// Each line is parsed in place rather than through a stringstream, since for
+// large meshes the per-line stream and token strings cost far more than the
+// reading itself. The line buffer is reused from line to line.
 void PolygonalMesh::loadObjFile(std::istream& file) {
     const char* methodName = "PolygonalMesh::loadObjFile()";
     SimTK_ERRCHK_ALWAYS(file.good(), methodName,
@@ -132,27 +143,40 @@ void PolygonalMesh::loadObjFile(std::istream& file) {
             std::getline(file, continuation);
             line += continuation;
         }
-        std::stringstream s(line);
-        std::string command;
-        s >> command;
-        if (command == "v") {
+
+        // Find the command, which is the first word on the line.
+        const char* p = line.c_str();
+        while (std::isspace((unsigned char)*p)) ++p;
+        const char* command = p;
+        while (*p && !std::isspace((unsigned char)*p)) ++p;
+        if (p-command != 1)
+            continue;
+
+        if (*command == 'v') {
             // A vertex
             
-            Real x, y, z;
-            s >> x;
-            s >> y;
-            s >> z;
-            SimTK_ERRCHK1_ALWAYS(!s.fail(), methodName,
-                "Found invalid vertex description: %s", line.c_str());
-            addVertex(Vec3(x, y, z));
+            Vec3 position;
+            for (int i = 0; i < 3; i++) {
+                char* end;
+                position[i] = (Real)std::strtod(p, &end);
+                SimTK_ERRCHK1_ALWAYS(end != p, methodName,
+                    "Found invalid vertex description: %s", line.c_str());
+                p = end;
+            }
+            addVertex(position);
         }
-        else if (command == "f") {
-            // A face
+        else if (*command == 'f') {
+            // A face; each entry is the vertex index, possibly followed by
+            // texture and normal indices which are skipped.
             
             indices.clear();
-            int index;
-            while (s >> index) {
-                s.ignore(line.size(), ' ');
+            for (;;) {
+                char* end;
+                int index = (int)std::strtol(p, &end, 10);
+                if (end == p)
+                    break;
+                const char* space = std::strchr(end, ' ');
+                p = space ? space+1 : line.c_str()+line.size();
                 if (index < 0)
                     index += getNumVertices()-initialVertices;
                 else
@@ -164,6 +188,152 @@ void PolygonalMesh::loadObjFile(std::istream& file) {
     }
 }
 
+//------------------------------------------------------------------------------
+//                            BINARY MESH FILES
+//------------------------------------------------------------------------------
+// A binary mesh file is a header followed by the vertex positions (3 Reals
+// each), then faceVertexStart (numFaces+1 ints) and faceVertexIndex, all in
+// native format. The header is a multiple of 8 bytes long so that the arrays
+// can be used in place in a memory mapped file.
+namespace {
+
+const char BinaryMeshMagic[8] = {'S','i','m','T','K','p','m','f'};
+const int  BinaryMeshVersion = 1;
+const int  BinaryMeshByteOrder = 0x01020304;
+
+struct BinaryMeshHeader {
+    char    magic[8];
+    int     version;
+    int     realSize;       // sizeof(Real)
+    int     byteOrder;      // BinaryMeshByteOrder, as written
+    int     numVertices;
+    int     numFaces;
+    int     numFaceVertices;
+};
+
+}
+
+void PolygonalMesh::writeBinaryFile(const String& pathname) const {
+    const char* methodName = "PolygonalMesh::writeBinaryFile()";
+    BinaryMeshHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BinaryMeshMagic, sizeof(header.magic));
+    header.version = BinaryMeshVersion;
+    header.realSize = sizeof(Real);
+    header.byteOrder = BinaryMeshByteOrder;
+    header.numVertices = getNumVertices();
+    header.numFaces = getNumFaces();
+    header.numFaceVertices = 
+        isEmptyHandle() ? 0 : getImpl().faceVertexIndex.size();
+
+    // Write a temporary file and then rename it over the target, rather than
+    // rewriting the target in place. A mesh that has this file mapped (which
+    // may be this one) keeps reading the old contents instead of faulting on
+    // pages that have been truncated away.
+    const String tempname = pathname + ".tmp";
+    std::ofstream file(tempname.c_str(), std::ios::out | std::ios::binary);
+    SimTK_ERRCHK1_ALWAYS(file.good(), methodName,
+        "Can't create file '%s'.", tempname.c_str());
+    file.write((const char*)&header, sizeof(header));
+    if (isEmptyHandle()) {
+        const int start = 0;
+        file.write((const char*)&start, sizeof(int));
+    } else {
+        const PolygonalMeshImpl& impl = getImpl();
+        for (int i = 0; i < header.numVertices; i++)
+            file.write((const char*)&impl.vertices[i][0], 3*sizeof(Real));
+        file.write((const char*)impl.faceVertexStart.cbegin(), 
+                   impl.faceVertexStart.size()*sizeof(int));
+        file.write((const char*)impl.faceVertexIndex.cbegin(), 
+                   impl.faceVertexIndex.size()*sizeof(int));
+    }
+    file.close();
+    if (file.fail()) {
+        std::remove(tempname.c_str());
+        SimTK_ERRCHK1_ALWAYS(false, methodName,
+            "An error occurred while writing file '%s'.", tempname.c_str());
+    }
+#ifdef _WIN32
+    // rename() won't replace an existing file here. Removing it fails while
+    // it is mapped, which is then reported below.
+    std::remove(pathname.c_str());
+#endif
+    if (std::rename(tempname.c_str(), pathname.c_str()) != 0) {
+        std::remove(tempname.c_str());
+        SimTK_ERRCHK1_ALWAYS(false, methodName,
+            "Can't replace file '%s'; it may be in use.", pathname.c_str());
+    }
+}
+
+void PolygonalMesh::loadBinaryFile(const String& pathname) {
+    const char* methodName = "PolygonalMesh::loadBinaryFile()";
+    MappedFile* file = new MappedFile(pathname);
+    try {
+        const char* data = file->getData();
+        BinaryMeshHeader header;
+        SimTK_ERRCHK1_ALWAYS(file->getSize() >= sizeof(header), methodName,
+            "File '%s' is too short to be a binary mesh file.", 
+            pathname.c_str());
+        std::memcpy(&header, data, sizeof(header));
+        SimTK_ERRCHK1_ALWAYS(std::memcmp(header.magic, BinaryMeshMagic, 
+                                         sizeof(header.magic)) == 0, 
+            methodName, "File '%s' is not a binary mesh file.", 
+            pathname.c_str());
+        SimTK_ERRCHK2_ALWAYS(header.version == BinaryMeshVersion, methodName,
+            "File '%s' has binary mesh format version %d, which isn't"
+            " supported.", pathname.c_str(), header.version);
+        SimTK_ERRCHK1_ALWAYS(   header.realSize == (int)sizeof(Real) 
+                             && header.byteOrder == BinaryMeshByteOrder, 
+            methodName, "File '%s' was written by a platform or precision"
+            " that differs from this one.", pathname.c_str());
+
+        const int nv = header.numVertices, nf = header.numFaces,
+                  nfv = header.numFaceVertices;
+        SimTK_ERRCHK1_ALWAYS(   nv >= 0 && nf >= 0 && nfv >= 0
+                             && file->getSize() == sizeof(header) 
+                                + 3*(std::size_t)nv*sizeof(Real) 
+                                + ((std::size_t)nf+1+nfv)*sizeof(int),
+            methodName, "File '%s' has the wrong size for the mesh it"
+            " describes.", pathname.c_str());
+
+        Vec3* vertexData = (Vec3*)(data + sizeof(header));
+        int* faceVertexStart = (int*)((Real*)vertexData + 3*nv);
+        int* faceVertexIndex = faceVertexStart + nf+1;
+
+        // Check the faces so that a damaged file can't cause a crash later.
+        bool valid = faceVertexStart[0] == 0 && faceVertexStart[nf] == nfv;
+        for (int i = 0; i < nf; i++)
+            valid &= faceVertexStart[i] <= faceVertexStart[i+1];
+        for (int i = 0; i < nfv; i++)
+            valid &= faceVertexIndex[i] >= 0 && faceVertexIndex[i] < nv;
+        SimTK_ERRCHK1_ALWAYS(valid, methodName,
+            "File '%s' contains an invalid face.", pathname.c_str());
+
+        initializeHandleIfEmpty();
+        if (getNumVertices() == 0 && getNumFaces() == 0) {
+            // Use the file contents in place; the mesh takes over the file.
+            updImpl().adoptMappedFile(file, vertexData, nv, faceVertexStart,
+                                      nf, faceVertexIndex, nfv);
+            return;
+        }
+
+        // Otherwise append copies.
+        PolygonalMeshImpl& impl = updImpl();
+        impl.makeWritable();
+        const int firstVertex = impl.vertices.size();
+        const int firstIndex = impl.faceVertexIndex.size();
+        impl.vertices.insert(impl.vertices.end(), vertexData, vertexData+nv);
+        for (int i = 0; i < nfv; i++)
+            impl.faceVertexIndex.push_back(faceVertexIndex[i] + firstVertex);
+        for (int i = 1; i <= nf; i++)
+            impl.faceVertexStart.push_back(faceVertexStart[i] + firstIndex);
+    } catch (...) {
+        delete file;
+        throw;
+    }
+    delete file;
+}
+
 /* Use our XML reader to parse VTK's PolyData file format and add the polygons
 found there to whatever is currently in this PolygonalMesh object. OpenSim uses
 this format for its geometric objects. 
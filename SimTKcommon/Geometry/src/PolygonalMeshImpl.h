@@ -26,25 +26,69 @@
 
 #include "SimTKcommon/internal/PolygonalMesh.h"
 #include "SimTKcommon/internal/Array.h"
+#include "SimTKcommon/internal/MappedFile.h"
 
 namespace SimTK {
 
 /**
  * This is the internal implementation of PolygonalMesh.
+ *
+ * When a mesh is loaded from a binary mesh file, its arrays don't own their
+ * data but refer directly to the contents of the memory mapped file. Call
+ * makeWritable() before changing anything; that replaces the arrays with
+ * ordinary copies and releases the file.
  */
 class SimTK_SimTKCOMMON_EXPORT PolygonalMeshImpl 
 :   public PIMPLImplementation<PolygonalMesh, PolygonalMeshImpl> {
 public:
-    PolygonalMeshImpl() {faceVertexStart.push_back(0);}
-    ~PolygonalMeshImpl() {}
+    PolygonalMeshImpl() : mappedFile(0) {faceVertexStart.push_back(0);}
+    // The copy owns its data even if the source is mapped.
+    PolygonalMeshImpl(const PolygonalMeshImpl& src) 
+    :   PIMPLImplementation<PolygonalMesh, PolygonalMeshImpl>(src),
+        vertices(src.vertices), faceVertexIndex(src.faceVertexIndex),
+        faceVertexStart(src.faceVertexStart), mappedFile(0) {}
+    ~PolygonalMeshImpl() {releaseMappedFile();}
     PolygonalMeshImpl* clone() const{return new PolygonalMeshImpl(*this);}
     void clear() {
+        releaseMappedFile();
         vertices.clear(); faceVertexIndex.clear(); faceVertexStart.clear();
         faceVertexStart.push_back(0);
     }
+
+    bool isMapped() const {return mappedFile != 0;}
+    // Make the arrays refer to the contents of this file, which this object
+    // takes over. The arrays must not be changed until makeWritable() has
+    // been called.
+    void adoptMappedFile(MappedFile* file, Vec3* vertexData, int numVertices,
+                         int* faceVertexStartData, int numFaces,
+                         int* faceVertexIndexData, int numFaceVertices) {
+        clear();
+        vertices.shareData(vertexData, numVertices);
+        faceVertexStart.shareData(faceVertexStartData, numFaces+1);
+        faceVertexIndex.shareData(faceVertexIndexData, numFaceVertices);
+        mappedFile = file;
+    }
+    void makeWritable() {
+        if (!mappedFile) return;
+        Array_<Vec3> v(vertices); vertices.swap(v);
+        Array_<int>  i(faceVertexIndex); faceVertexIndex.swap(i);
+        Array_<int>  s(faceVertexStart); faceVertexStart.swap(s);
+        delete mappedFile; mappedFile = 0;
+    }
+
     Array_<Vec3>    vertices;
     Array_<int>     faceVertexIndex;
     Array_<int>     faceVertexStart;
+private:
+    PolygonalMeshImpl& operator=(const PolygonalMeshImpl&); // suppress
+    void releaseMappedFile() {
+        if (!mappedFile) return;
+        vertices.deallocate(); faceVertexIndex.deallocate(); 
+        faceVertexStart.deallocate();
+        delete mappedFile; mappedFile = 0;
+    }
+
+    MappedFile*     mappedFile; // owned; null unless the arrays share it
 };
 
 } // namespace SimTK
@@ -1113,8 +1113,9 @@ SpatialInertia_ shift(const Vec3P& S) const
 /// @see shift() if you want to leave this object unmolested.
 SpatialInertia_& shiftInPlace(const Vec3P& S) {
     G.shiftToCentroidInPlace(p);    // change to central inertia
-    G.shiftFromCentroidInPlace(S);  // now inertia is about S
-    p -= S; // was p=com-OF, now want p'=com-(OF+S)=p-S
+    const Vec3P pNew(p-S);          // was p=com-OF, now p'=com-(OF+S)=p-S
+    G.shiftFromCentroidInPlace(pNew); // now inertia is about OF+S (sign of
+    p = pNew;                         //   pNew doesn't matter here)
     return *this;
 }
 
@@ -261,6 +261,12 @@ public:
     // The generated geometry will be *appended* to the supplied output vector.
     void calcDecorativeGeometryAndAppend
        (const State&, Stage, Array_<DecorativeGeometry>&) const;
+
+    // Return false if this subsystem contains elements that modify shared
+    // data while being realized, so that different States must not be
+    // realized at the same time on different threads. This requires that
+    // topology has been realized.
+    bool isThreadSafe() const;
     
     void createScheduledEvent(const State& state, EventId& eventId) const;
     void createTriggeredEvent(const State& state, EventId& eventId, 
@@ -318,6 +324,8 @@ protected:
     virtual int calcDecorativeGeometryAndAppendImpl
        (const State&, Stage, Array_<DecorativeGeometry>&) const {return 0;}
 
+    virtual bool isThreadSafeImpl() const {return true;}
+
     virtual void calcEventTriggerInfoImpl
        (const State&, Array_<EventTriggerInfo>&) const {}
     virtual void calcTimeOfNextScheduledEventImpl
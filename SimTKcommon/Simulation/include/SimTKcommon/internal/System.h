@@ -1003,6 +1003,17 @@ public:
         return *this;
     }
 
+    /** Limit the number of Newton iterations a project() method may take,
+    for callers that must bound the work done. If the required accuracy
+    hasn't been reached by then, project() fails with status 
+    FailedToAchieveAccuracy but leaves the improved result in place. A
+    project() method never exceeds its own limit, and a nonpositive value
+    (the default) means no further limit is imposed. **/
+    ProjectOptions& setMaxIterations(int maxIterations) {
+        this->maxIterations = maxIterations > 0 ? maxIterations : 0;
+        return *this;
+    }
+
     /** Remove a given option from the set. Nothing happens if the option wasn't
     already set. **/
     ProjectOptions& clearOption(Option opt) 
@@ -1018,6 +1029,9 @@ public:
     Real getOvershootFactor() const {return desiredOvershoot;}
     /** Return the maximum norm we're allowed to attempt to correct. **/
     Real getProjectionLimit() const {return projectionLimit;}
+    /** Return the iteration limit, or zero if there is none beyond the
+    project() method's own. **/
+    int getMaxIterations() const {return maxIterations;}
 
     bool isOptionSet(Option opt) const {return (optionSet&(unsigned)opt) != 0;}
 
@@ -1039,12 +1053,14 @@ private:
     Real     requiredAccuracy;
     Real     desiredOvershoot; // try for accuracy*overshoot
     Real     projectionLimit;  // abort if initial norm is worse than this
+    int      maxIterations;    // 0 means no limit
     unsigned optionSet;
 
     void setAccuracyDefaults() {
         requiredAccuracy = getDefaultRequiredAccuracy();
         desiredOvershoot = getDefaultOvershootFactor(); 
         projectionLimit  = Infinity; // we'll try from however far away
+        maxIterations    = 0;
     }
 };
 
@@ -770,6 +770,73 @@ private:
         // Subsystem stage should now match what we copied.
         currentStage = targetStage;
     }
+
+public:
+    // Return true if this subsystem and the source have both been realized
+    // through Instance stage from the same definitions, so that they have
+    // identical allocations and views into identically partitioned globals.
+    bool hasSameAllocationsAs(const PerSubsystemInfo& src) const {
+        if (currentStage < Stage::Instance || src.currentStage < Stage::Instance)
+            return false;
+        for (int i=Stage::Topology; i <= Stage::Instance; ++i)
+            if (stageVersions[i] != src.stageVersions[i])
+                return false;
+
+        if (   qInfo.size() != src.qInfo.size()
+            || uInfo.size() != src.uInfo.size()
+            || zInfo.size() != src.zInfo.size()
+            || discreteInfo.size() != src.discreteInfo.size()
+            || qerrInfo.size() != src.qerrInfo.size()
+            || uerrInfo.size() != src.uerrInfo.size()
+            || udoterrInfo.size() != src.udoterrInfo.size()
+            || cacheInfo.size() != src.cacheInfo.size())
+            return false;
+        for (int j=0; j<Stage::NValid; ++j)
+            if (   triggerInfo[j].size() != src.triggerInfo[j].size()
+                || triggerstart[j] != src.triggerstart[j]
+                || triggers[j].size() != src.triggers[j].size())
+                return false;
+
+        if (   qstart != src.qstart || q.size() != src.q.size()
+            || ustart != src.ustart || u.size() != src.u.size()
+            || zstart != src.zstart || z.size() != src.z.size()
+            || qerrstart != src.qerrstart || qerr.size() != src.qerr.size()
+            || uerrstart != src.uerrstart || uerr.size() != src.uerr.size()
+            || udoterrstart != src.udoterrstart
+            || udoterr.size() != src.udoterr.size())
+            return false;
+
+        for (unsigned i=0; i < discreteInfo.size(); ++i)
+            if (!discreteInfo[i].getValue()
+                    .isCompatible(src.discreteInfo[i].getValue()))
+                return false;
+        for (unsigned i=0; i < cacheInfo.size(); ++i)
+            if (!cacheInfo[i].getValue()
+                    .isCompatible(src.cacheInfo[i].getValue()))
+                return false;
+        return true;
+    }
+
+    // Given hasSameAllocationsAs(src), make this a copy of the source as
+    // copyFrom(src, Stage::Instance) would, but keeping our views of the
+    // global resources (which the State copies separately) and assigning
+    // into the existing discrete variable and cache entry values rather than
+    // cloning them.
+    void copyValuesFrom(const PerSubsystemInfo& src) {
+        assert(hasSameAllocationsAs(src));
+        restoreToStage(Stage::Instance);
+
+        name     = src.name;
+        version  = src.version;
+        copyAllStacksThroughStage(src, Stage::Instance);
+
+        // The Topology through Instance versions already match. Later cache
+        // entries were copied with versions no later than the source's, so
+        // make sure none of them can look current here.
+        for (int i=Stage::Instance+1; i < Stage::NValid; ++i)
+            stageVersions[i] =
+                std::max(stageVersions[i], src.stageVersions[i]+1);
+    }
 };
 
 
@@ -827,6 +894,28 @@ public:
 
     StateImpl& operator=(const StateImpl& src) {
         if (&src == this) return *this;
+
+        // An integrator repeatedly assigns a State to another one that was
+        // copied from it earlier. Then all the allocations are already in
+        // place, and we can copy just the values without touching the heap.
+        if (hasSameAllocationsAs(src)) {
+            invalidateJustSystemStage(Stage::Time);
+            for (int i=Stage::Time; i < Stage::NValid; ++i)
+                systemStageVersions[i] =
+                    std::max(systemStageVersions[i],
+                             src.systemStageVersions[i]+1);
+            for (SubsystemIndex i(0); i<(int)subsystems.size(); ++i)
+                subsystems[i].copyValuesFrom(src.subsystems[i]);
+
+            t = src.t;
+            y = src.y;
+            uWeights = src.uWeights;
+            zWeights = src.zWeights;
+            qerrWeights = src.qerrWeights;
+            uerrWeights = src.uerrWeights;
+            return *this;
+        }
+
         invalidateJustSystemStage(Stage::Topology);
         for (SubsystemIndex i(0); i<(int)subsystems.size(); ++i)
             subsystems[i].invalidateStageJustThisSubsystem(Stage::Topology);
@@ -2414,6 +2503,27 @@ private:
     // and version are the System name and version.
     Array_<PerSubsystemInfo> subsystems;
 
+    // Return true if this State and the source have both been realized through
+    // Instance stage from the same definitions, so that assignment needn't
+    // reallocate anything.
+    bool hasSameAllocationsAs(const StateImpl& src) const {
+        if (   currentSystemStage < Stage::Instance
+            || src.currentSystemStage < Stage::Instance)
+            return false;
+        for (int i=Stage::Topology; i <= Stage::Instance; ++i)
+            if (systemStageVersions[i] != src.systemStageVersions[i])
+                return false;
+        if (   subsystems.size() != src.subsystems.size()
+            || y.size() != src.y.size() || yerr.size() != src.yerr.size()
+            || udoterr.size() != src.udoterr.size()
+            || allTriggers.size() != src.allTriggers.size())
+            return false;
+        for (SubsystemIndex i(0); i<(int)subsystems.size(); ++i)
+            if (!subsystems[i].hasSameAllocationsAs(src.subsystems[i]))
+                return false;
+        return true;
+    }
+
     // Return true only if all subsystems have been realized to at least Stage g.
     bool allSubsystemsAtLeastAtStage(Stage g) const {
         for (SubsystemIndex i(0); i < (int)subsystems.size(); ++i)
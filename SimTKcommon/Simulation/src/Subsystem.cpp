@@ -651,6 +651,15 @@ void Subsystem::Guts::calcDecorativeGeometryAndAppend
     calcDecorativeGeometryAndAppendImpl(s,stage,geom);
 }
 
+//------------------------------------------------------------------------------
+//                              IS THREAD SAFE
+//------------------------------------------------------------------------------
+bool Subsystem::Guts::isThreadSafe() const {
+    SimTK_STAGECHECK_TOPOLOGY_REALIZED_ALWAYS(subsystemTopologyHasBeenRealized(),
+        "Subsystem", getName(), "Subsystem::Guts::isThreadSafe()");
+    return isThreadSafeImpl();
+}
+
 //------------------------------------------------------------------------------
 //                              HANDLE EVENTS
 //------------------------------------------------------------------------------
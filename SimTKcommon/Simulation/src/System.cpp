@@ -36,12 +36,13 @@
 #include "SimTKcommon/internal/SystemGuts.h"
 #include "SimTKcommon/internal/EventHandler.h"
 #include "SimTKcommon/internal/EventReporter.h"
+#include "SimTKcommon/internal/ThreadLocal.h"
 
 #include "SystemGutsRep.h"
 
+#include <algorithm>
 #include <cassert>
 #include <map>
-#include <set>
 
 namespace SimTK {
 
@@ -662,6 +663,18 @@ void System::Guts::projectU(State& s, Vector& uErrEst,
 //------------------------------------------------------------------------------
 //                             HANDLE EVENTS
 //------------------------------------------------------------------------------
+namespace {
+// Work arrays for handleEvents() and handleEventsImpl(). A System may be 
+// handling events for several States at once, so each thread has its own set,
+// which keeps its heap space from one call to the next.
+struct HandleEventsScratch {
+    Array_<StageVersion>    stageVersions;
+    Array_<EventId>         eventsForSubsystem;
+};
+
+ThreadLocal<HandleEventsScratch> handleEventsScratch;
+}
+
 void System::Guts::handleEvents
    (State& s, Event::Cause cause, const Array_<EventId>& eventIds,
     const HandleEventsOptions& options, HandleEventsResults& results) const
@@ -672,7 +685,8 @@ void System::Guts::handleEvents
     const Real savedTime = s.getTime();
 
     // Save the stage version numbers so we can look for changes.
-    Array_<StageVersion> stageVersions;
+    Array_<StageVersion>& stageVersions = 
+        handleEventsScratch.upd().stageVersions;
     s.getSystemStageVersions(stageVersions);
 
     handleEventsImpl(s, cause, eventIds, options, results);
@@ -835,7 +849,9 @@ void System::Guts::handleEventsImpl
     // more of the eventIds. If there are no eventIds then this is a generic
     // event like Initialization and all the Subsystems get a call.
     
-    Array_<EventId> eventsForSubsystem;
+    Array_<EventId>& eventsForSubsystem = 
+        handleEventsScratch.upd().eventsForSubsystem;
+    eventsForSubsystem.clear();
     for (SubsystemIndex sx(0); sx < getNumSubsystems(); ++sx) {
         const Subsystem::Guts& sub = getRep().subsystems[sx].getSubsystemGuts();
 
@@ -1280,16 +1296,11 @@ public:
         const Real accuracy = options.getAccuracy();
         bool shouldTerminate = false;
         
-        // Build a set of the ids for quick lookup.      
-        std::set<EventId> idSet;
-        for (int i = 0; i < (int)eventIds.size(); ++i)
-            idSet.insert(eventIds[i]);
-        
         // Process triggered events.
         
         if (cause == Event::Cause::Triggered) {
             for (int i = 0; i < (int)triggeredEventHandlers.size(); ++i) {
-                if (idSet.find(info.triggeredEventIds[i]) != idSet.end()) {
+                if (isListed(eventIds, info.triggeredEventIds[i])) {
                     bool eventShouldTerminate = false;
                     triggeredEventHandlers[i]->handleEvent
                                             (s, accuracy, eventShouldTerminate);
@@ -1298,7 +1309,7 @@ public:
                 }
             }
             for (int i = 0; i < (int)triggeredEventReporters.size(); ++i) {
-                if (idSet.find(info.triggeredReportIds[i]) != idSet.end())
+                if (isListed(eventIds, info.triggeredReportIds[i]))
                     triggeredEventReporters[i]->handleEvent(s);
             }
         }
@@ -1307,7 +1318,7 @@ public:
         
         if (cause == Event::Cause::Scheduled) {
             for (int i = 0; i < (int)scheduledEventHandlers.size(); ++i) {
-                if (idSet.find(info.scheduledEventIds[i]) != idSet.end()) {
+                if (isListed(eventIds, info.scheduledEventIds[i])) {
                     bool eventShouldTerminate = false;
                     scheduledEventHandlers[i]->handleEvent
                                             (s, accuracy, eventShouldTerminate);
@@ -1316,7 +1327,7 @@ public:
                 }
             }
             for (int i = 0; i < (int)scheduledEventReporters.size(); ++i) {
-                if (idSet.find(info.scheduledReportIds[i]) != idSet.end())
+                if (isListed(eventIds, info.scheduledReportIds[i]))
                     scheduledEventReporters[i]->handleEvent(s);
             }
         }
@@ -1333,17 +1344,11 @@ public:
                       const Array_<EventId>& eventIds) const OVERRIDE_11 {
         const CachedEventInfo& info = getCachedEventInfo(s);
         
-        // Build a set of the ids for quick lookup.
-        
-        std::set<EventId> idSet;
-        for (int i = 0; i < (int)eventIds.size(); ++i)
-            idSet.insert(eventIds[i]);
-        
         // Process triggered events.
         
         if (cause == Event::Cause::Triggered) {
             for (int i = 0; i < (int)triggeredEventReporters.size(); ++i) {
-                if (idSet.find(info.triggeredReportIds[i]) != idSet.end())
+                if (isListed(eventIds, info.triggeredReportIds[i]))
                     triggeredEventReporters[i]->handleEvent(s);
             }
         }
@@ -1352,13 +1357,20 @@ public:
         
         if (cause == Event::Cause::Scheduled) {
             for (int i = 0; i < (int)scheduledEventReporters.size(); ++i) {
-                if (idSet.find(info.scheduledReportIds[i]) != idSet.end())
+                if (isListed(eventIds, info.scheduledReportIds[i]))
                     scheduledEventReporters[i]->handleEvent(s);
             }
         }
     }
 
 private:
+    // There are only ever a few events handled at once, so a linear search
+    // is fast and, unlike building a set, doesn't allocate heap space.
+    static bool isListed(const Array_<EventId>& eventIds, EventId id) {
+        return std::find(eventIds.begin(), eventIds.end(), id) 
+               != eventIds.end();
+    }
+
     mutable CacheEntryIndex                 cachedEventInfoIndex;
     mutable Array_<ScheduledEventHandler*>  scheduledEventHandlers;
     mutable Array_<TriggeredEventHandler*>  triggeredEventHandlers;
@@ -37,6 +37,7 @@
 
 #include "SimTKcommon/internal/System.h"
 #include "SimTKcommon/internal/SystemGuts.h"
+#include "SimTKcommon/internal/AtomicInteger.h"
 
 #include "SubsystemGutsRep.h"
 
@@ -202,19 +203,21 @@ private:
     mutable State           defaultState;
 
         // STATISTICS //
-    mutable int nRealizationsOfStage[Stage::NValid];
-    mutable int nRealizeCalls; // counts realizeTopology(), realizeModel(), realize()
+    // These are bumped from const methods, possibly by several threads at
+    // once when different States are being realized concurrently.
+    mutable AtomicInteger nRealizationsOfStage[Stage::NValid];
+    mutable AtomicInteger nRealizeCalls; // counts realizeTopology(), realizeModel(), realize()
 
-    mutable int nPrescribeQCalls, nPrescribeUCalls;
+    mutable AtomicInteger nPrescribeQCalls, nPrescribeUCalls;
 
-    mutable int nProjectQCalls, nProjectUCalls;
-    mutable int nFailedProjectQCalls, nFailedProjectUCalls;
-    mutable int nQProjections, nUProjections; // the ones that did something
-    mutable int nQErrEstProjections, nUErrEstProjections;
+    mutable AtomicInteger nProjectQCalls, nProjectUCalls;
+    mutable AtomicInteger nFailedProjectQCalls, nFailedProjectUCalls;
+    mutable AtomicInteger nQProjections, nUProjections; // the ones that did something
+    mutable AtomicInteger nQErrEstProjections, nUErrEstProjections;
 
-    mutable int nHandlerCallsThatChangedStage[Stage::NValid];
-    mutable int nHandleEventsCalls;
-    mutable int nReportEventsCalls;
+    mutable AtomicInteger nHandlerCallsThatChangedStage[Stage::NValid];
+    mutable AtomicInteger nHandleEventsCalls;
+    mutable AtomicInteger nReportEventsCalls;
 
     void resetAllCounters() {
         for (int i=0; i<Stage::NValid; ++i)
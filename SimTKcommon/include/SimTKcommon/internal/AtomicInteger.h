@@ -45,7 +45,12 @@ class SimTK_SimTKCOMMON_EXPORT AtomicInteger {
 public:
     AtomicInteger();
     AtomicInteger(int value);
+    /**
+     * Copying an AtomicInteger copies its current value; the copy is an independent counter.
+     */
+    AtomicInteger(const AtomicInteger& src);
     ~AtomicInteger();
+    AtomicInteger& operator=(const AtomicInteger& src);
     AtomicInteger& operator=(int value);
     operator int() const;
     int operator++();
@@ -70,6 +75,39 @@ private:
 
 std::ostream& operator<<(std::ostream& stream, const AtomicInteger& value);
 
+/**
+ * This is a 64 bit counterpart of AtomicInteger, for counts that could overflow an int.  Only the
+ * operators needed for counting are provided: ++, --, += and -= are atomic.  Since there are no
+ * lock-free 64 bit atomic operations available on every platform, each update is done while
+ * holding a spinlock, which is still much cheaper than a mutex for so short an operation.
+ */
+
+class SimTK_SimTKCOMMON_EXPORT AtomicLongLong {
+public:
+    AtomicLongLong();
+    AtomicLongLong(long long value);
+    /**
+     * Copying an AtomicLongLong copies its current value; the copy is an independent counter.
+     */
+    AtomicLongLong(const AtomicLongLong& src);
+    ~AtomicLongLong();
+    AtomicLongLong& operator=(const AtomicLongLong& src);
+    AtomicLongLong& operator=(long long value);
+    operator long long() const;
+    long long operator++();
+    long long operator++(int);
+    long long operator--();
+    long long operator--(int);
+    AtomicLongLong& operator+=(long long value);
+    AtomicLongLong& operator-=(long long value);
+    bool operator==(long long value) const;
+    bool operator!=(long long value) const;
+private:
+    void* atomic;
+};
+
+std::ostream& operator<<(std::ostream& stream, const AtomicLongLong& value);
+
 } // namespace SimTK
 
 #endif // SimTK_SimTKCOMMON_ATOMIC_INTEGER_H_
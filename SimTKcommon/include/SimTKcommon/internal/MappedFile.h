@@ -0,0 +1,93 @@
+#ifndef SimTK_SimTKCOMMON_MAPPED_FILE_H_
+#define SimTK_SimTKCOMMON_MAPPED_FILE_H_
+
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+Declaration of the SimTK::MappedFile class providing platform-independent,
+read-only memory mapping of files. **/
+
+#include "SimTKcommon/internal/common.h"
+#include <string>
+#include <cstddef>
+
+namespace SimTK {
+
+/** This class maps the contents of a file into memory for reading, so that
+large binary files can be used in place without first being copied into
+memory by stream I/O. The operating system pages the contents in as they are
+touched, and pages of a file that is mapped repeatedly are shared through its
+cache.
+
+The mapping is removed when the MappedFile is closed or destroyed, after
+which pointers obtained from getData() are no longer valid. The file must not
+be truncated or rewritten in place while it is mapped: reading a page past
+the new end of the file raises SIGBUS on POSIX systems, and rewritten pages
+change underneath the reader. Replace such a file by renaming a new one over
+it instead. A MappedFile
+can't be copied. Example:
+<pre>
+    MappedFile file("mesh.bin");
+    const char* bytes = file.getData();
+    // ... use bytes[0] through bytes[file.getSize()-1] ...
+</pre> **/
+class SimTK_SimTKCOMMON_EXPORT MappedFile {
+public:
+    /** Create a MappedFile that isn't yet associated with any file. **/
+    MappedFile() : m_data(0), m_size(0) {}
+    /** Map the named file; an exception is thrown if that fails. **/
+    explicit MappedFile(const std::string& pathname);
+    /** Unmap the file if one is mapped. **/
+    ~MappedFile() {close();}
+
+    /** Map the named file, first closing any file that is already mapped.
+    If the file can't be opened or mapped an exception is thrown and this
+    MappedFile is left closed. An empty file can be mapped; it has size zero
+    and a null data pointer. **/
+    void open(const std::string& pathname);
+    /** Remove the mapping, if any. This is harmless if nothing is mapped. **/
+    void close();
+
+    /** Return true if a file is currently mapped. **/
+    bool isOpen() const {return !m_pathname.empty();}
+    /** Get the pathname of the mapped file, or an empty string. **/
+    const std::string& getPathname() const {return m_pathname;}
+    /** Get the first byte of the file's contents, or null if the file is
+    empty or none is mapped. The memory is read only. **/
+    const char* getData() const {return m_data;}
+    /** Get the number of bytes in the file. **/
+    std::size_t getSize() const {return m_size;}
+
+private:
+    MappedFile(const MappedFile&);              // suppress
+    MappedFile& operator=(const MappedFile&);   // suppress
+
+    std::string m_pathname;
+    const char* m_data;
+    std::size_t m_size;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SimTKCOMMON_MAPPED_FILE_H_
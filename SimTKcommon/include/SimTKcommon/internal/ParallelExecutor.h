@@ -60,6 +60,14 @@ class ParallelExecutorImpl;
  * processor utilitization.  Alternatively, if the Task will only be executed four times, you might
  * specify min(4, ParallelExecutor::getNumProcessors()) to avoid creating extra threads that will never
  * have any work to do.
+ *
+ * ParallelExecutor is implemented on top of TaskScheduler, which you can use directly if you need
+ * chunked loops or heterogeneous tasks.  Indices are handed out to the threads dynamically, so a thread
+ * that finishes early takes on more of them.  It is safe to call execute() from inside a Task that is
+ * itself being executed in parallel; the calling thread helps execute the inner Task while it waits.
+ * If execute() throws an exception on any thread, no further indices are started, finish() is still
+ * called on every thread that called initialize(), and the first exception is rethrown from
+ * ParallelExecutor::execute() on the calling thread.
  */
 
 class SimTK_SimTKCOMMON_EXPORT ParallelExecutor : public PIMPLHandle<ParallelExecutor, ParallelExecutorImpl> {
@@ -61,6 +61,9 @@ class ParallelWorkQueueImpl;
  * processor utilitization.  Alternatively, if only four Tasks will be executed, you might specify
  * min(4, ParallelExecutor::getNumProcessors()) to avoid creating extra threads that will never
  * have any work to do.
+ *
+ * ParallelWorkQueue is implemented on top of TaskScheduler.  If a Task throws an exception, it is
+ * rethrown from the next call to flush().
  */
 
 class SimTK_SimTKCOMMON_EXPORT ParallelWorkQueue : public PIMPLHandle<ParallelWorkQueue, ParallelWorkQueueImpl> {
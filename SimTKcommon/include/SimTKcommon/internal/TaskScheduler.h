@@ -0,0 +1,220 @@
+#ifndef SimTK_SimTKCOMMON_TASK_SCHEDULER_H_
+#define SimTK_SimTKCOMMON_TASK_SCHEDULER_H_
+
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ParallelExecutor.h"
+#include "PrivateImplementation.h"
+#include "Array.h"
+
+namespace SimTK {
+
+class TaskScheduler;
+class TaskSchedulerImpl;
+class TaskGroupImpl;
+
+// We only want the template instantiation to occur once. This symbol is defined in the SimTK core
+// compilation unit that defines the TaskScheduler class but should not be defined any other time.
+#ifndef SimTK_SIMTKCOMMON_DEFINING_TASK_SCHEDULER
+    extern template class PIMPLHandle<TaskScheduler, TaskSchedulerImpl>;
+#endif
+
+/**
+ * This class is a pool of worker threads that execute Tasks using work stealing.  It is the common
+ * foundation for multithreaded computations in SimTK; ParallelExecutor, Parallel2DExecutor and
+ * ParallelWorkQueue are all implemented on top of it.
+ *
+ * Each worker thread has its own double ended queue of Tasks.  A worker pushes the Tasks it spawns onto
+ * the back of its own queue and takes its next Task from there too, so related work tends to stay on
+ * one thread.  When a worker's queue is empty it steals the oldest Task from the front of some other
+ * worker's queue.  Tasks spawned from a thread that isn't one of this scheduler's workers go into a
+ * shared queue that all workers steal from.
+ *
+ * There are two ways to give it work.  For a loop over a range of indices, define a subclass of
+ * TaskScheduler::RangeTask and call parallelFor():
+ *
+ * <pre>
+ * TaskScheduler scheduler;
+ * scheduler.parallelFor(myRangeTask, 0, n);
+ * </pre>
+ *
+ * The range is cut into chunks of at least grainSize indices, and RangeTask::execute() is called once
+ * per chunk.  For heterogeneous work, define subclasses of TaskScheduler::Task and spawn them into a
+ * TaskGroup, then wait for the group:
+ *
+ * <pre>
+ * TaskScheduler::TaskGroup group(scheduler);
+ * group.spawn(taskA);
+ * group.spawn(taskB);
+ * group.wait();
+ * </pre>
+ *
+ * A Task may itself spawn Tasks, call parallelFor(), or wait on a TaskGroup.  A worker thread that waits
+ * keeps executing other Tasks until the ones it is waiting for are done, so nested parallelism does not
+ * deadlock and does not tie up threads.  A thread that isn't a worker simply blocks while it waits.
+ *
+ * An exception thrown by a Task is caught on the worker thread and the same exception is rethrown
+ * from TaskGroup::wait() (or parallelFor()) on the waiting thread.  If several Tasks fail, only the
+ * first exception is rethrown and the others are discarded.
+ *
+ * For per-thread scratch storage, allocate getNumThreads()+1 slots and index them with
+ * getCurrentThreadIndex(); TaskScheduler::Scratch does exactly that.
+ */
+
+class SimTK_SimTKCOMMON_EXPORT TaskScheduler : public PIMPLHandle<TaskScheduler, TaskSchedulerImpl> {
+public:
+    class Task;
+    class RangeTask;
+    class TaskGroup;
+    template <class T> class Scratch;
+    /**
+     * Construct a TaskScheduler.
+     *
+     * @param numThreads the number of worker threads to create.  By default, this is set equal to the
+     * number of processors.
+     */
+    explicit TaskScheduler(int numThreads = ParallelExecutor::getNumProcessors());
+    /**
+     * Get the number of worker threads.
+     */
+    int getNumThreads() const;
+    /**
+     * Execute a RangeTask in parallel over the indices begin <= i < end, and return once all of them
+     * are done.  The range is divided into contiguous chunks with at least grainSize indices each
+     * (except perhaps the last); if grainSize is zero or negative a chunk size is chosen that gives
+     * each thread several chunks to balance the load.  If the whole range fits in a single chunk, or
+     * there is only one worker thread, the task is executed directly on the calling thread.
+     */
+    void parallelFor(RangeTask& task, int begin, int end, int grainSize = 0);
+    /**
+     * Get the index of the calling thread in this scheduler.  Worker threads have indices 0 to
+     * getNumThreads()-1; any other thread gets getNumThreads().
+     */
+    int getCurrentThreadIndex() const;
+    /**
+     * Determine whether the thread invoking this method is a worker thread of any TaskScheduler.
+     */
+    static bool isWorkerThread();
+};
+
+/**
+ * Concrete subclasses of this abstract class represent Tasks that can be spawned into a
+ * TaskScheduler::TaskGroup.  The scheduler does not take ownership of a Task, and the same Task
+ * object may be spawned several times.
+ */
+
+class TaskScheduler::Task {
+public:
+    virtual ~Task() {
+    }
+    /**
+     * This method defines the task to be performed.  It is called once on some worker thread
+     * each time the Task is spawned.
+     */
+    virtual void execute() = 0;
+};
+
+/**
+ * Concrete subclasses of this abstract class represent loops that can be executed by
+ * TaskScheduler::parallelFor().
+ */
+
+class TaskScheduler::RangeTask {
+public:
+    virtual ~RangeTask() {
+    }
+    /**
+     * This method is called in parallel, once for each chunk begin <= i < end of the full range.
+     * Chunks do not overlap and together they cover the full range exactly once.
+     */
+    virtual void execute(int begin, int end) = 0;
+};
+
+/**
+ * A TaskGroup collects Tasks spawned into a TaskScheduler so that they can be waited on together.
+ * Destroying a TaskGroup waits for any Tasks still outstanding, but discards their errors; call
+ * wait() explicitly if you care about exceptions.
+ */
+
+class SimTK_SimTKCOMMON_EXPORT TaskScheduler::TaskGroup {
+public:
+    /**
+     * Create an empty TaskGroup whose Tasks will be executed by the given scheduler.
+     */
+    explicit TaskGroup(TaskScheduler& scheduler);
+    ~TaskGroup();
+    /**
+     * Queue a Task for execution.  This returns immediately; the Task must remain valid until
+     * wait() returns.
+     */
+    void spawn(Task& task);
+    /**
+     * Block until every Task spawned into this group so far has finished.  If any of them threw an
+     * exception, the first one is rethrown here after they have all finished.  The group may be reused
+     * afterwards.
+     */
+    void wait();
+private:
+    TaskGroup(const TaskGroup&);            // suppress
+    TaskGroup& operator=(const TaskGroup&); // suppress
+    TaskGroupImpl* impl;
+};
+
+/**
+ * This is a set of objects of type T with one slot for each worker thread of a TaskScheduler plus one
+ * for any other thread, for use as per-thread scratch space or as private accumulators that are
+ * combined once a parallel operation is done.  upd() returns the calling thread's slot; there is no
+ * locking since no two threads ever share a slot.  Only a non-worker thread can use the extra slot, so
+ * don't use a Scratch from more than one such thread at a time.
+ */
+
+template <class T>
+class TaskScheduler::Scratch {
+public:
+    explicit Scratch(const TaskScheduler& scheduler, const T& initialValue = T())
+    :   scheduler(scheduler), slots(scheduler.getNumThreads()+1, initialValue) {
+    }
+    /** Get the calling thread's slot. **/
+    T& upd() {
+        return slots[scheduler.getCurrentThreadIndex()];
+    }
+    /** Get the number of slots, which is one more than the number of worker threads. **/
+    int size() const {
+        return (int)slots.size();
+    }
+    /** Access a slot by index, for example to combine them all at the end. **/
+    const T& operator[](int i) const {
+        return slots[i];
+    }
+    T& operator[](int i) {
+        return slots[i];
+    }
+private:
+    const TaskScheduler& scheduler;
+    Array_<T>            slots;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SimTKCOMMON_TASK_SCHEDULER_H_
@@ -36,10 +36,20 @@ AtomicInteger::AtomicInteger(int value) {
     gmx_atomic_set(reinterpret_cast<gmx_atomic_t*>(atomic), value);
 }
 
+AtomicInteger::AtomicInteger(const AtomicInteger& src) {
+    atomic = new gmx_atomic_t();
+    gmx_atomic_set(reinterpret_cast<gmx_atomic_t*>(atomic), (int)src);
+}
+
 AtomicInteger::~AtomicInteger() {
     delete reinterpret_cast<gmx_atomic_t*>(atomic);
 }
 
+AtomicInteger& AtomicInteger::operator=(const AtomicInteger& src) {
+    gmx_atomic_set(reinterpret_cast<gmx_atomic_t*>(atomic), (int)src);
+    return *this;
+}
+
 AtomicInteger& AtomicInteger::operator=(int value) {
     gmx_atomic_set(reinterpret_cast<gmx_atomic_t*>(atomic), value);
     return *this;
@@ -167,3 +177,98 @@ std::ostream& SimTK::operator<<(std::ostream& stream, const AtomicInteger& value
     int i = value;
     return stream << i;
 }
+
+// gmx_atomic_t holds only an int, so the 64 bit value is guarded by a spinlock
+// instead. The lock is initialized by copying a static initializer since not
+// every platform provides gmx_spinlock_init().
+namespace {
+struct AtomicLongLongRep {
+    gmx_spinlock_t  lock;
+    long long       value;
+};
+
+AtomicLongLongRep* newAtomicLongLongRep(long long value) {
+    const AtomicLongLongRep init = {GMX_SPINLOCK_INITIALIZER, value};
+    return new AtomicLongLongRep(init);
+}
+
+// Add to the value and return the new value, all while holding the lock.
+long long addReturn(void* atomic, long long value) {
+    AtomicLongLongRep* rep = reinterpret_cast<AtomicLongLongRep*>(atomic);
+    gmx_spinlock_lock(&rep->lock);
+    const long long result = (rep->value += value);
+    gmx_spinlock_unlock(&rep->lock);
+    return result;
+}
+}
+
+AtomicLongLong::AtomicLongLong() {
+    atomic = newAtomicLongLongRep(0);
+}
+
+AtomicLongLong::AtomicLongLong(long long value) {
+    atomic = newAtomicLongLongRep(value);
+}
+
+AtomicLongLong::AtomicLongLong(const AtomicLongLong& src) {
+    atomic = newAtomicLongLongRep((long long)src);
+}
+
+AtomicLongLong::~AtomicLongLong() {
+    delete reinterpret_cast<AtomicLongLongRep*>(atomic);
+}
+
+AtomicLongLong& AtomicLongLong::operator=(const AtomicLongLong& src) {
+    return *this = (long long)src;
+}
+
+AtomicLongLong& AtomicLongLong::operator=(long long value) {
+    AtomicLongLongRep* rep = reinterpret_cast<AtomicLongLongRep*>(atomic);
+    gmx_spinlock_lock(&rep->lock);
+    rep->value = value;
+    gmx_spinlock_unlock(&rep->lock);
+    return *this;
+}
+
+AtomicLongLong::operator long long() const {
+    return addReturn(atomic, 0);
+}
+
+long long AtomicLongLong::operator++() {
+    return addReturn(atomic, 1);
+}
+
+long long AtomicLongLong::operator++(int) {
+    return addReturn(atomic, 1) - 1;
+}
+
+long long AtomicLongLong::operator--() {
+    return addReturn(atomic, -1);
+}
+
+long long AtomicLongLong::operator--(int) {
+    return addReturn(atomic, -1) + 1;
+}
+
+AtomicLongLong& AtomicLongLong::operator+=(long long value) {
+    addReturn(atomic, value);
+    return *this;
+}
+
+AtomicLongLong& AtomicLongLong::operator-=(long long value) {
+    addReturn(atomic, -value);
+    return *this;
+}
+
+bool AtomicLongLong::operator==(long long value) const {
+    return (long long)*this == value;
+}
+
+bool AtomicLongLong::operator!=(long long value) const {
+    return (long long)*this != value;
+}
+
+std::ostream& SimTK::operator<<(std::ostream& stream, const AtomicLongLong& value) {
+    long long i = value;
+    return stream << i;
+}
@@ -0,0 +1,119 @@
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon/internal/common.h"
+#include "SimTKcommon/internal/ExceptionMacros.h"
+#include "SimTKcommon/internal/MappedFile.h"
+
+#include <string>
+using std::string;
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+
+using namespace SimTK;
+
+MappedFile::MappedFile(const string& pathname) : m_data(0), m_size(0) {
+    open(pathname);
+}
+
+void MappedFile::open(const string& pathname) {
+    const char* methodName = "MappedFile::open()";
+    close();
+    SimTK_ERRCHK_ALWAYS(!pathname.empty(), methodName,
+        "No pathname was supplied.");
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(pathname.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    SimTK_ERRCHK1_ALWAYS(file != INVALID_HANDLE_VALUE, methodName,
+        "Can't open file '%s'.", pathname.c_str());
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        SimTK_ERRCHK1_ALWAYS(false, methodName,
+            "Can't get the size of file '%s'.", pathname.c_str());
+    }
+    const char* data = 0;
+    if (size.QuadPart > 0) {
+        // The view keeps the file open after the handles are closed.
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY,
+                                            0, 0, NULL);
+        if (mapping != NULL) {
+            data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    SimTK_ERRCHK1_ALWAYS(size.QuadPart == 0 || data != 0, methodName,
+        "Can't map file '%s' into memory.", pathname.c_str());
+    m_size = (std::size_t)size.QuadPart;
+#else
+    const int fd = ::open(pathname.c_str(), O_RDONLY);
+    SimTK_ERRCHK1_ALWAYS(fd >= 0, methodName,
+        "Can't open file '%s'.", pathname.c_str());
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        SimTK_ERRCHK1_ALWAYS(false, methodName,
+            "Can't get the size of file '%s'.", pathname.c_str());
+    }
+    const char* data = 0;
+    if (info.st_size > 0) {
+        // The mapping keeps the file open after the descriptor is closed.
+        void* addr = mmap(0, (size_t)info.st_size, PROT_READ, MAP_SHARED,
+                          fd, 0);
+        if (addr != MAP_FAILED)
+            data = (const char*)addr;
+    }
+    ::close(fd);
+    SimTK_ERRCHK1_ALWAYS(info.st_size == 0 || data != 0, methodName,
+        "Can't map file '%s' into memory.", pathname.c_str());
+    m_size = (std::size_t)info.st_size;
+#endif
+
+    m_data = data;
+    m_pathname = pathname;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+    #ifdef _WIN32
+        UnmapViewOfFile(m_data);
+    #else
+        munmap((void*)m_data, m_size);
+    #endif
+    }
+    m_pathname.clear();
+    m_data = 0;
+    m_size = 0;
+}
@@ -23,53 +23,60 @@
 
 #include "ParallelExecutorImpl.h"
 #include "SimTKcommon/internal/ParallelExecutor.h"
+#include "SimTKcommon/internal/AtomicInteger.h"
 #include <pthread.h>
 
 namespace SimTK {
 
-static void* threadBody(void* args);
-
-ParallelExecutorImpl::ParallelExecutorImpl(int numThreads) : finished(false) {
+/**
+ * This is the TaskScheduler task that does the work of ParallelExecutor::execute().  One copy is
+ * spawned per thread.  Each copy initializes the ParallelExecutor::Task, keeps claiming the next
+ * unclaimed index until there are none left, then finishes the Task, all on a single thread.
+ */
 
-    // Construct all the threading related objects we will need.
-    
-    SimTK_APIARGCHECK_ALWAYS(numThreads > 0, "ParallelExecutorImpl", "ParallelExecutorImpl", "Number of threads must be positive.");
-    threads.resize(numThreads);
-    pthread_mutex_init(&runLock, NULL);
-    pthread_cond_init(&runCondition, NULL);
-    pthread_cond_init(&waitCondition, NULL);
-    for (int i = 0; i < numThreads; ++i) {
-        threadInfo.push_back(new ThreadInfo(i, this));
-        pthread_create(&threads[i], NULL, threadBody, threadInfo[i]);
+class ExecutorSlice : public TaskScheduler::Task {
+public:
+    ExecutorSlice(ParallelExecutor::Task& task, int times, pthread_mutex_t& finishLock)
+    :   task(task), times(times), nextIndex(0), finishLock(finishLock) {
+    }
+    void execute() {
+        task.initialize();
+        try {
+            for (int index = nextIndex++; index < times; index = nextIndex++)
+                task.execute(index);
+        }
+        catch (...) {
+            // Stop the other slices from starting more indices, but still finish this thread's
+            // share before the scheduler passes the exception on to the caller of execute().
+            nextIndex = times;
+            finish();
+            throw;
+        }
+        finish();
     }
+private:
+    void finish() {
+        pthread_mutex_lock(&finishLock);
+        task.finish();
+        pthread_mutex_unlock(&finishLock);
+    }
+    ParallelExecutor::Task& task;
+    const int times;
+    AtomicInteger nextIndex;
+    pthread_mutex_t& finishLock;
+};
+
+ParallelExecutorImpl::ParallelExecutorImpl(int numThreads) : scheduler(numThreads) {
+    pthread_mutex_init(&finishLock, NULL);
 }
 ParallelExecutorImpl::~ParallelExecutorImpl() {
-    
-    // Notify the threads that they should exit.
-    
-    pthread_mutex_lock(&runLock);
-    finished = true;
-    for (int i = 0; i < (int) threads.size(); ++i)
-        threadInfo[i]->running = true;
-    pthread_cond_broadcast(&runCondition);
-    pthread_mutex_unlock(&runLock);
-    
-    // Wait until all the threads have finished.
-    
-    for (int i = 0; i < (int) threads.size(); ++i)
-        pthread_join(threads[i], NULL);
-    
-    // Clean up threading related objects.
-    
-    pthread_mutex_destroy(&runLock);
-    pthread_cond_destroy(&runCondition);
-    pthread_cond_destroy(&waitCondition);
+    pthread_mutex_destroy(&finishLock);
 }
 ParallelExecutorImpl* ParallelExecutorImpl::clone() const {
-    return new ParallelExecutorImpl(threads.size());
+    return new ParallelExecutorImpl(scheduler.getNumThreads());
 }
 void ParallelExecutorImpl::execute(ParallelExecutor::Task& task, int times) {
-    if (times == 1 || threads.size() == 1) {
+    if (times == 1 || getThreadCount() == 1) {
         // Nothing is actually going to get done in parallel, so we might as well
         // just execute the task directly and save the threading overhead.
         
@@ -80,80 +87,15 @@ void ParallelExecutorImpl::execute(ParallelExecutor::Task& task, int times) {
         return;
     }
     
-    // Initialize fields to execute the new task.
-    
-    pthread_mutex_lock(&runLock);
-    currentTask = &task;
-    currentTaskCount = times;
-    waitingThreadCount = 0;
-    for (int i = 0; i < (int) threadInfo.size(); ++i)
-        threadInfo[i]->running = true;
-
-    // Wake up the worker threads and wait until they finish.
+    // Give every worker thread a slice and wait until they finish. If this is
+    // called from inside another parallel task, the calling worker helps out
+    // while it waits.
     
-    pthread_cond_broadcast(&runCondition);
-    do {
-        pthread_cond_wait(&waitCondition, &runLock);
-    } while (waitingThreadCount < (int) threads.size());
-    pthread_mutex_unlock(&runLock);
-}
-void ParallelExecutorImpl::incrementWaitingThreads() {
-    pthread_mutex_lock(&runLock);
-    getCurrentTask().finish();
-    waitingThreadCount++;
-    if (waitingThreadCount == threads.size()) {
-        pthread_cond_signal(&waitCondition);
-    }
-    pthread_mutex_unlock(&runLock);
-}
-
-ThreadLocal<bool> ParallelExecutorImpl::isWorker(false);
-
-/**
- * This function contains the code executed by the worker threads.
- */
-
-void* threadBody(void* args) {
-    ParallelExecutorImpl::isWorker.upd() = true;
-    ThreadInfo& info = *reinterpret_cast<ThreadInfo*>(args);
-    ParallelExecutorImpl& executor = *info.executor;
-    int threadCount = executor.getThreadCount();
-    while (!executor.isFinished()) {
-        
-        // Wait for a Task to come in.
-        
-        pthread_mutex_lock(executor.getLock());
-        while (!info.running) {
-            pthread_cond_wait(executor.getCondition(), executor.getLock());
-        }
-        pthread_mutex_unlock(executor.getLock());
-        if (!executor.isFinished()) {
-            
-            // Execute the task for all the indices belonging to this thread.
-            
-            int count = executor.getCurrentTaskCount();
-            ParallelExecutor::Task& task = executor.getCurrentTask();
-            task.initialize();
-            int index = info.index;
-            try {
-                while (index < count) {
-                    task.execute(index);
-                    index += threadCount;
-                }
-            }
-            catch (std::exception ex) {
-                std::cerr <<"The parallel task threw an unhandled exception:"<< std::endl;
-                std::cerr <<ex.what()<< std::endl;
-            }
-            catch (...) {
-                std::cerr <<"The parallel task threw an error."<< std::endl;
-            }
-            info.running = false;
-            executor.incrementWaitingThreads();
-        }
-    }
-    delete &info;
-    return 0;
+    ExecutorSlice slice(task, times, finishLock);
+    TaskScheduler::TaskGroup group(scheduler);
+    for (int i = 0; i < getThreadCount(); ++i)
+        group.spawn(slice);
+    group.wait();
 }
 
 ParallelExecutor::ParallelExecutor(int numThreads) : HandleBase(new ParallelExecutorImpl(numThreads)) {
@@ -214,7 +156,7 @@ int ParallelExecutor::getNumProcessors() {
 }
 
 bool ParallelExecutor::isWorkerThread() {
-    return ParallelExecutorImpl::isWorker.get();
+    return TaskScheduler::isWorkerThread();
 }
 
 } // namespace SimTK
@@ -25,29 +25,14 @@
  * -------------------------------------------------------------------------- */
 
 #include "SimTKcommon/internal/ParallelExecutor.h"
-#include "SimTKcommon/internal/ThreadLocal.h"
-#include "SimTKcommon/internal/Array.h"
+#include "SimTKcommon/internal/TaskScheduler.h"
 #include <pthread.h>
 
 namespace SimTK {
 
-class ParallelExecutorImpl;
-
 /**
- * This class stores per-thread information used while executing a task.
- */
-
-class ThreadInfo {
-public:
-    ThreadInfo(int index, ParallelExecutorImpl* executor) : index(index), executor(executor), running(false) {
-    }
-    const int index;
-    ParallelExecutorImpl* const executor;
-    bool running;
-};
-
-/**
- * This is the internal implementation class for ParallelExecutor.
+ * This is the internal implementation class for ParallelExecutor.  It is a thin layer over a
+ * TaskScheduler, which owns the worker threads.
  */
 
 class ParallelExecutorImpl : public PIMPLImplementation<ParallelExecutor, ParallelExecutorImpl> {
@@ -57,34 +42,11 @@ public:
     ParallelExecutorImpl* clone() const;
     void execute(ParallelExecutor::Task& task, int times);
     int getThreadCount() {
-        return threads.size();
-    }
-    ParallelExecutor::Task& getCurrentTask() {
-        return *currentTask;
-    }
-    int getCurrentTaskCount() {
-        return currentTaskCount;
-    }
-    bool isFinished() {
-        return finished;
-    }
-    pthread_mutex_t* getLock() {
-        return &runLock;
-    }
-    pthread_cond_t* getCondition() {
-        return &runCondition;
+        return scheduler.getNumThreads();
     }
-    void incrementWaitingThreads();
-    static ThreadLocal<bool> isWorker;
 private:
-    bool finished;
-    pthread_mutex_t runLock;
-    pthread_cond_t runCondition, waitCondition;
-    Array_<pthread_t> threads;
-    Array_<ThreadInfo*> threadInfo;
-    ParallelExecutor::Task* currentTask;
-    int currentTaskCount;
-    int waitingThreadCount;
+    TaskScheduler scheduler;
+    pthread_mutex_t finishLock;
 };
 
 } // namespace SimTK
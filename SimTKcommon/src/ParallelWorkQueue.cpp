@@ -24,118 +24,80 @@
 #include "ParallelWorkQueueImpl.h"
 #include "SimTKcommon/internal/ParallelExecutor.h"
 #include <pthread.h>
-#include <utility>
-
-using std::queue;
 
 namespace SimTK {
 
-static void* threadBody(void* args) {
-    ParallelWorkQueueImpl& owner = *reinterpret_cast<ParallelWorkQueueImpl*>(args);
-    queue<ParallelWorkQueue::Task*>& taskQueue = owner.updTaskQueue();
-    pthread_mutex_t& queueLock = owner.getQueueLock();
-    pthread_cond_t& waitForTaskCondition = owner.getWaitCondition();
-    pthread_cond_t& queueFullCondition = owner.getQueueFullCondition();
-    bool decrementTaskCount = false;
-    while (!owner.isFinished() || !taskQueue.empty()) {
-        pthread_mutex_lock(&queueLock);
-        if (decrementTaskCount) {
-            owner.markTaskCompleted();
-            decrementTaskCount = false;
-        }
-        while (taskQueue.empty() && !owner.isFinished())
-            pthread_cond_wait(&waitForTaskCondition, &queueLock);
-        ParallelWorkQueue::Task* task = NULL;
-        if (!taskQueue.empty()) {
-            task = taskQueue.front();
-            taskQueue.pop();
-        }
-        pthread_cond_signal(&queueFullCondition);
-        pthread_mutex_unlock(&queueLock);
-        if (task != NULL) {
+/**
+ * This wraps a ParallelWorkQueue::Task for the TaskScheduler, and deletes both once the Task has
+ * been executed.
+ */
+
+class ParallelWorkQueueImpl::QueuedTask : public TaskScheduler::Task {
+public:
+    QueuedTask(ParallelWorkQueueImpl& owner, ParallelWorkQueue::Task* task) : owner(owner), task(task) {
+    }
+    ~QueuedTask() {
+        delete task;
+    }
+    void execute() {
+        owner.markTaskStarted();
+        try {
             task->execute();
-            delete task;
-            decrementTaskCount = true;
         }
+        catch (...) {
+            delete this;
+            throw;
+        }
+        delete this;
     }
-    if (decrementTaskCount) {
-        pthread_mutex_lock(&queueLock);
-        owner.markTaskCompleted();
-        pthread_mutex_unlock(&queueLock);
-    }
-    return 0;
-}
+private:
+    ParallelWorkQueueImpl& owner;
+    ParallelWorkQueue::Task* task;
+};
 
-ParallelWorkQueueImpl::ParallelWorkQueueImpl(int queueSize, int numThreads) : queueSize(queueSize), pendingTasks(0), finished(false) {
+ParallelWorkQueueImpl::ParallelWorkQueueImpl(int queueSize, int numThreads)
+:   queueSize(queueSize), waitingTasks(0), scheduler(numThreads), group(scheduler) {
     pthread_mutex_init(&queueLock, NULL);
-    pthread_cond_init(&waitForTaskCondition, NULL);
     pthread_cond_init(&queueFullCondition, NULL);
-    threads.resize(numThreads);
-    for (int i = 0; i < numThreads; ++i)
-        pthread_create(&threads[i], NULL, threadBody, this);
 }
 
 ParallelWorkQueueImpl::~ParallelWorkQueueImpl() {
-    // Wait for the theads to finish.
+    // Wait for the tasks to finish. Errors were already lost if nobody called flush().
 
-    pthread_mutex_lock(&queueLock);
-    finished = true;
-    pthread_cond_broadcast(&waitForTaskCondition);
-    pthread_mutex_unlock(&queueLock);
-    for (int i = 0; i < (int) threads.size(); ++i)
-        pthread_join(threads[i], NULL);
+    try {
+        group.wait();
+    }
+    catch (...) {
+    }
 
     // Clean up memory.
     
     pthread_mutex_destroy(&queueLock);
-    pthread_cond_destroy(&waitForTaskCondition);
     pthread_cond_destroy(&queueFullCondition);
 }
 
 ParallelWorkQueueImpl* ParallelWorkQueueImpl::clone() const {
-    return new ParallelWorkQueueImpl(queueSize, threads.size());
+    return new ParallelWorkQueueImpl(queueSize, scheduler.getNumThreads());
 }
 
 void ParallelWorkQueueImpl::addTask(ParallelWorkQueue::Task* task) {
     pthread_mutex_lock(&queueLock);
-    while ((int)taskQueue.size() >= queueSize)
+    while (waitingTasks >= queueSize)
         pthread_cond_wait(&queueFullCondition, &queueLock);
-    taskQueue.push(task);
-    ++pendingTasks;
-    pthread_cond_signal(&waitForTaskCondition);
+    ++waitingTasks;
     pthread_mutex_unlock(&queueLock);
+    group.spawn(*new QueuedTask(*this, task));
 }
 
 void ParallelWorkQueueImpl::flush() {
-    pthread_mutex_lock(&queueLock);
-    while (pendingTasks > 0)
-       pthread_cond_wait(&queueFullCondition, &queueLock);
-    pthread_mutex_unlock(&queueLock);
-}
-
-queue<ParallelWorkQueue::Task*>& ParallelWorkQueueImpl::updTaskQueue() {
-    return taskQueue;
-}
-
-bool ParallelWorkQueueImpl::isFinished() const {
-    return finished;
-}
-
-pthread_mutex_t& ParallelWorkQueueImpl::getQueueLock() {
-    return queueLock;
+    group.wait();
 }
 
-pthread_cond_t& ParallelWorkQueueImpl::getWaitCondition() {
-    return waitForTaskCondition;
-}
-
-pthread_cond_t& ParallelWorkQueueImpl::getQueueFullCondition() {
-    return queueFullCondition;
-}
-
-void ParallelWorkQueueImpl::markTaskCompleted() {
-    --pendingTasks;
+void ParallelWorkQueueImpl::markTaskStarted() {
+    pthread_mutex_lock(&queueLock);
+    --waitingTasks;
     pthread_cond_signal(&queueFullCondition);
+    pthread_mutex_unlock(&queueLock);
 }
 
 ParallelWorkQueue::ParallelWorkQueue(int queueSize, int numThreads) : HandleBase(new ParallelWorkQueueImpl(queueSize, numThreads)) {
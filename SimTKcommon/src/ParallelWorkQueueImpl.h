@@ -25,40 +25,33 @@
  * -------------------------------------------------------------------------- */
 
 #include "SimTKcommon/internal/ParallelWorkQueue.h"
-#include "SimTKcommon/internal/Array.h"
+#include "SimTKcommon/internal/TaskScheduler.h"
 #include <pthread.h>
-#include <queue>
 
 namespace SimTK {
 
-class ParallelExecutor;
-
 /**
- * This is the internal implementation class for ParallelWorkQueue.
+ * This is the internal implementation class for ParallelWorkQueue.  Tasks are spawned into a
+ * TaskGroup on a TaskScheduler, which owns the worker threads; this class only adds the limit on how
+ * many Tasks may be waiting to start.
  */
 
 class ParallelWorkQueueImpl : public PIMPLImplementation<ParallelWorkQueue, ParallelWorkQueueImpl> {
 public:
-    class ExecutorTask;
+    class QueuedTask;
     ParallelWorkQueueImpl(int queueSize, int numThreads);
     ~ParallelWorkQueueImpl();
     ParallelWorkQueueImpl* clone() const;
     void addTask(ParallelWorkQueue::Task* task);
     void flush();
-    std::queue<ParallelWorkQueue::Task*>& updTaskQueue();
-    bool isFinished() const;
-    pthread_mutex_t& getQueueLock();
-    pthread_cond_t& getWaitCondition();
-    pthread_cond_t& getQueueFullCondition();
-    void markTaskCompleted();
+    void markTaskStarted();
 private:
     const int queueSize;
-    int pendingTasks;
-    bool finished;
-    std::queue<ParallelWorkQueue::Task*> taskQueue;
+    int waitingTasks;
     pthread_mutex_t queueLock;
-    pthread_cond_t waitForTaskCondition, queueFullCondition;
-    Array_<pthread_t> threads;
+    pthread_cond_t queueFullCondition;
+    TaskScheduler scheduler;
+    TaskScheduler::TaskGroup group; // must be destroyed before the scheduler
 };
 
 } // namespace SimTK
@@ -25,10 +25,12 @@
 #define SimTK_SIMTKCOMMON_DEFINING_PARALLEL_EXECUTOR
 #define SimTK_SIMTKCOMMON_DEFINING_PARALLEL_2D_EXECUTOR
 #define SimTK_SIMTKCOMMON_DEFINING_PARALLEL_WORK_QUEUE
+#define SimTK_SIMTKCOMMON_DEFINING_TASK_SCHEDULER
 #include "../Geometry/src/PolygonalMeshImpl.h"
 #include "ParallelExecutorImpl.h"
 #include "Parallel2DExecutorImpl.h"
 #include "ParallelWorkQueueImpl.h"
+#include "TaskSchedulerImpl.h"
 #include "SimTKcommon/internal/PrivateImplementation_Defs.h"
 
 namespace SimTK {
@@ -45,4 +47,7 @@ template class PIMPLImplementation<Parallel2DExecutor, Parallel2DExecutorImpl>;
 template class PIMPLHandle<ParallelWorkQueue, ParallelWorkQueueImpl>;
 template class PIMPLImplementation<ParallelWorkQueue, ParallelWorkQueueImpl>;
 
+template class PIMPLHandle<TaskScheduler, TaskSchedulerImpl>;
+template class PIMPLImplementation<TaskScheduler, TaskSchedulerImpl>;
+
 } // namespace SimTK
@@ -0,0 +1,324 @@
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "TaskSchedulerImpl.h"
+#include "SimTKcommon/internal/TaskScheduler.h"
+#include "SimTKcommon/internal/ExceptionMacros.h"
+#include <pthread.h>
+#include <algorithm>
+#include <exception>
+
+namespace SimTK {
+
+ThreadLocal<WorkerId> TaskSchedulerImpl::currentWorker;
+
+/**
+ * This is what a new worker thread needs to know to get started.
+ */
+
+class WorkerStart {
+public:
+    WorkerStart(TaskSchedulerImpl* scheduler, int index) : scheduler(scheduler), index(index) {
+    }
+    TaskSchedulerImpl* scheduler;
+    int index;
+};
+
+/**
+ * This function contains the code executed by the worker threads.
+ */
+
+static void* threadBody(void* args) {
+    WorkerStart* start = reinterpret_cast<WorkerStart*>(args);
+    TaskSchedulerImpl& scheduler = *start->scheduler;
+    const int index = start->index;
+    delete start;
+    TaskSchedulerImpl::currentWorker.upd() = WorkerId(&scheduler, index);
+    scheduler.workerLoop(index);
+    return 0;
+}
+
+TaskSchedulerImpl::TaskSchedulerImpl(int numThreads) : finished(false), queuedCount(0), sleepingCount(0) {
+    SimTK_APIARGCHECK_ALWAYS(numThreads > 0, "TaskSchedulerImpl", "TaskSchedulerImpl", "Number of threads must be positive.");
+    pthread_mutex_init(&sleepLock, NULL);
+    pthread_cond_init(&workCondition, NULL);
+    for (int i = 0; i <= numThreads; ++i)
+        queues.push_back(new WorkerQueue());
+    threads.resize(numThreads);
+    for (int i = 0; i < numThreads; ++i)
+        pthread_create(&threads[i], NULL, threadBody, new WorkerStart(this, i));
+}
+
+TaskSchedulerImpl::~TaskSchedulerImpl() {
+
+    // Tell the workers to exit once the queues are empty, and wait for them.
+
+    pthread_mutex_lock(&sleepLock);
+    finished = true;
+    pthread_cond_broadcast(&workCondition);
+    pthread_mutex_unlock(&sleepLock);
+    for (int i = 0; i < (int) threads.size(); ++i)
+        pthread_join(threads[i], NULL);
+
+    // Clean up.
+
+    for (int i = 0; i < (int) queues.size(); ++i)
+        delete queues[i];
+    pthread_mutex_destroy(&sleepLock);
+    pthread_cond_destroy(&workCondition);
+}
+
+TaskSchedulerImpl* TaskSchedulerImpl::clone() const {
+    return new TaskSchedulerImpl(getNumThreads());
+}
+
+int TaskSchedulerImpl::getCurrentThreadIndex() const {
+    const WorkerId& id = currentWorker.get();
+    return id.scheduler == this ? id.index : getNumThreads();
+}
+
+void TaskSchedulerImpl::enqueue(const TaskRecord& record) {
+
+    // A worker keeps its own Tasks; anyone else uses the shared queue.
+
+    queues[getCurrentThreadIndex()]->pushBack(record);
+    ++queuedCount;
+    pthread_mutex_lock(&sleepLock);
+    if (sleepingCount > 0)
+        pthread_cond_signal(&workCondition);
+    pthread_mutex_unlock(&sleepLock);
+}
+
+bool TaskSchedulerImpl::findTask(int workerIndex, TaskRecord& record) {
+
+    // Newest Task from our own queue first, then the oldest one from anyone else's.
+
+    if (queues[workerIndex]->popBack(record))
+        return true;
+    const int numQueues = queues.size();
+    for (int i = 1; i < numQueues; ++i)
+        if (queues[(workerIndex+i)%numQueues]->popFront(record))
+            return true;
+    return false;
+}
+
+bool TaskSchedulerImpl::runOneTask(int workerIndex) {
+    TaskRecord record;
+    if (!findTask(workerIndex, record))
+        return false;
+    --queuedCount;
+    std::exception_ptr error;
+    try {
+        record.task->execute();
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    record.group->markTaskCompleted(error);
+    return true;
+}
+
+bool TaskSchedulerImpl::waitForWork() {
+
+    // queuedCount is incremented after a Task is pushed and decremented after it is popped, so it
+    // can briefly be negative; that still means there's nothing to do.
+
+    pthread_mutex_lock(&sleepLock);
+    while (queuedCount <= 0 && !finished) {
+        ++sleepingCount;
+        pthread_cond_wait(&workCondition, &sleepLock);
+        --sleepingCount;
+    }
+    const bool keepGoing = !finished || queuedCount > 0;
+    pthread_mutex_unlock(&sleepLock);
+    return keepGoing;
+}
+
+void TaskSchedulerImpl::waitForWorkOrCompletion(const AtomicInteger& pending) {
+
+    // This is for a worker waiting on a TaskGroup when there is nothing left to run.  It sleeps with
+    // the idle workers, and is woken either by new work or by notifyGroupCompleted().
+
+    pthread_mutex_lock(&sleepLock);
+    while (queuedCount <= 0 && pending > 0) {
+        ++sleepingCount;
+        pthread_cond_wait(&workCondition, &sleepLock);
+        --sleepingCount;
+    }
+    pthread_mutex_unlock(&sleepLock);
+}
+
+void TaskSchedulerImpl::notifyGroupCompleted() {
+    pthread_mutex_lock(&sleepLock);
+    if (sleepingCount > 0)
+        pthread_cond_broadcast(&workCondition);
+    pthread_mutex_unlock(&sleepLock);
+}
+
+void TaskSchedulerImpl::workerLoop(int workerIndex) {
+    do {
+        while (runOneTask(workerIndex))
+            ;
+    } while (waitForWork());
+}
+
+/**
+ * This executes chunks of a parallelFor() range.  The same object is spawned several times, and each
+ * copy keeps taking the next unclaimed chunk until there are none left, so that a thread that gets
+ * through its chunks quickly takes on more of them.
+ */
+
+class RangeRunner : public TaskScheduler::Task {
+public:
+    RangeRunner(TaskScheduler::RangeTask& task, int begin, int end, int grainSize)
+    :   task(task), begin(begin), end(end), grainSize(grainSize), nextChunk(0) {
+    }
+    void execute() {
+        const int numChunks = (end-begin+grainSize-1)/grainSize;
+        for (int chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++) {
+            const int lo = begin + chunk*grainSize;
+            task.execute(lo, std::min(end, lo+grainSize));
+        }
+    }
+private:
+    TaskScheduler::RangeTask& task;
+    const int begin, end, grainSize;
+    AtomicInteger nextChunk;
+};
+
+void TaskSchedulerImpl::parallelFor(TaskScheduler::RangeTask& task, int begin, int end, int grainSize) {
+    const int n = end-begin;
+    if (n <= 0)
+        return;
+    const int numThreads = getNumThreads();
+    if (grainSize <= 0)
+        grainSize = std::max(1, n/(4*numThreads));
+    const int numChunks = (n+grainSize-1)/grainSize;
+    if (numChunks == 1 || numThreads == 1) {
+        task.execute(begin, end);
+        return;
+    }
+    RangeRunner runner(task, begin, end, grainSize);
+    TaskGroupImpl group(*this);
+    for (int i = 0; i < std::min(numChunks, numThreads); ++i)
+        group.spawn(runner);
+    group.wait(true);
+}
+
+TaskGroupImpl::TaskGroupImpl(TaskSchedulerImpl& scheduler) : scheduler(scheduler), pending(0) {
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&doneCondition, NULL);
+}
+
+TaskGroupImpl::~TaskGroupImpl() {
+    pthread_mutex_destroy(&lock);
+    pthread_cond_destroy(&doneCondition);
+}
+
+void TaskGroupImpl::spawn(TaskScheduler::Task& task) {
+    pthread_mutex_lock(&lock);
+    ++pending;
+    pthread_mutex_unlock(&lock);
+    scheduler.enqueue(TaskRecord(&task, this));
+}
+
+void TaskGroupImpl::markTaskCompleted(const std::exception_ptr& error) {
+
+    // A worker waiting on this group may be asleep with the idle workers, so the scheduler has to
+    // be told when the group is done.  The group may be destroyed as soon as the lock is released,
+    // so get everything needed for that first.
+
+    TaskSchedulerImpl& owner = scheduler;
+    pthread_mutex_lock(&lock);
+    if (error && !firstError)
+        firstError = error;
+    const bool done = (--pending == 0);
+    if (done)
+        pthread_cond_broadcast(&doneCondition);
+    pthread_mutex_unlock(&lock);
+    if (done)
+        owner.notifyGroupCompleted();
+}
+
+void TaskGroupImpl::wait(bool rethrow) {
+
+    // A worker of our scheduler helps out rather than blocking, which is what makes nested
+    // parallelism safe.  When there is nothing to run, the remaining Tasks are executing on other
+    // threads, so it sleeps until one of them spawns more work or the group is done.
+
+    const WorkerId& id = TaskSchedulerImpl::currentWorker.get();
+    if (id.scheduler == &scheduler) {
+        while (pending > 0)
+            if (!scheduler.runOneTask(id.index))
+                scheduler.waitForWorkOrCompletion(pending);
+    }
+
+    // Whether we helped or not, we have to get the lock to be sure that the last Task is done
+    // with this group before we return.
+
+    pthread_mutex_lock(&lock);
+    while (pending > 0)
+        pthread_cond_wait(&doneCondition, &lock);
+    const std::exception_ptr error = firstError;
+    firstError = std::exception_ptr();
+    pthread_mutex_unlock(&lock);
+    if (rethrow && error)
+        std::rethrow_exception(error);
+}
+
+TaskScheduler::TaskScheduler(int numThreads) : HandleBase(new TaskSchedulerImpl(numThreads)) {
+}
+
+int TaskScheduler::getNumThreads() const {
+    return getImpl().getNumThreads();
+}
+
+void TaskScheduler::parallelFor(RangeTask& task, int begin, int end, int grainSize) {
+    updImpl().parallelFor(task, begin, end, grainSize);
+}
+
+int TaskScheduler::getCurrentThreadIndex() const {
+    return getImpl().getCurrentThreadIndex();
+}
+
+bool TaskScheduler::isWorkerThread() {
+    return TaskSchedulerImpl::currentWorker.get().scheduler != 0;
+}
+
+TaskScheduler::TaskGroup::TaskGroup(TaskScheduler& scheduler) : impl(new TaskGroupImpl(scheduler.updImpl())) {
+}
+
+TaskScheduler::TaskGroup::~TaskGroup() {
+    impl->wait(false);
+    delete impl;
+}
+
+void TaskScheduler::TaskGroup::spawn(Task& task) {
+    impl->spawn(task);
+}
+
+void TaskScheduler::TaskGroup::wait() {
+    impl->wait(true);
+}
+
+} // namespace SimTK
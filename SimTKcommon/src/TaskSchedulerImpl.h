@@ -0,0 +1,167 @@
+#ifndef SimTK_SimTKCOMMON_TASK_SCHEDULER_IMPL_H_
+#define SimTK_SimTKCOMMON_TASK_SCHEDULER_IMPL_H_
+
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon/internal/TaskScheduler.h"
+#include "SimTKcommon/internal/ThreadLocal.h"
+#include "SimTKcommon/internal/AtomicInteger.h"
+#include "SimTKcommon/internal/Array.h"
+#include <pthread.h>
+#include <deque>
+#include <exception>
+
+namespace SimTK {
+
+class TaskSchedulerImpl;
+
+/**
+ * This records which scheduler, if any, the current thread is a worker for, and its index there.
+ */
+
+class WorkerId {
+public:
+    WorkerId() : scheduler(0), index(-1) {
+    }
+    WorkerId(TaskSchedulerImpl* scheduler, int index) : scheduler(scheduler), index(index) {
+    }
+    TaskSchedulerImpl* scheduler;
+    int index;
+};
+
+/**
+ * This keeps track of the outstanding Tasks spawned into one TaskGroup.  The count is modified only
+ * while holding the lock so that a thread blocked in wait() can't return, and destroy the group,
+ * while the last Task is still signaling it.
+ */
+
+class TaskGroupImpl {
+public:
+    explicit TaskGroupImpl(TaskSchedulerImpl& scheduler);
+    ~TaskGroupImpl();
+    void spawn(TaskScheduler::Task& task);
+    void wait(bool rethrow);
+    void markTaskCompleted(const std::exception_ptr& error);
+    TaskSchedulerImpl& getScheduler() {
+        return scheduler;
+    }
+private:
+    TaskSchedulerImpl& scheduler;
+    AtomicInteger pending;
+    std::exception_ptr firstError;
+    pthread_mutex_t lock;
+    pthread_cond_t doneCondition;
+};
+
+/**
+ * This is one entry in a worker's queue.
+ */
+
+class TaskRecord {
+public:
+    TaskRecord() : task(0), group(0) {
+    }
+    TaskRecord(TaskScheduler::Task* task, TaskGroupImpl* group) : task(task), group(group) {
+    }
+    TaskScheduler::Task* task;
+    TaskGroupImpl* group;
+};
+
+/**
+ * A double ended queue of Tasks.  Its owner pushes and pops at the back; thieves pop at the front.
+ */
+
+class WorkerQueue {
+public:
+    WorkerQueue() {
+        pthread_mutex_init(&lock, NULL);
+    }
+    ~WorkerQueue() {
+        pthread_mutex_destroy(&lock);
+    }
+    void pushBack(const TaskRecord& record) {
+        pthread_mutex_lock(&lock);
+        tasks.push_back(record);
+        pthread_mutex_unlock(&lock);
+    }
+    bool popBack(TaskRecord& record) {
+        pthread_mutex_lock(&lock);
+        const bool found = !tasks.empty();
+        if (found) {
+            record = tasks.back();
+            tasks.pop_back();
+        }
+        pthread_mutex_unlock(&lock);
+        return found;
+    }
+    bool popFront(TaskRecord& record) {
+        pthread_mutex_lock(&lock);
+        const bool found = !tasks.empty();
+        if (found) {
+            record = tasks.front();
+            tasks.pop_front();
+        }
+        pthread_mutex_unlock(&lock);
+        return found;
+    }
+private:
+    pthread_mutex_t lock;
+    std::deque<TaskRecord> tasks;
+};
+
+/**
+ * This is the internal implementation class for TaskScheduler.
+ */
+
+class TaskSchedulerImpl : public PIMPLImplementation<TaskScheduler, TaskSchedulerImpl> {
+public:
+    TaskSchedulerImpl(int numThreads);
+    ~TaskSchedulerImpl();
+    TaskSchedulerImpl* clone() const;
+    int getNumThreads() const {
+        return threads.size();
+    }
+    void parallelFor(TaskScheduler::RangeTask& task, int begin, int end, int grainSize);
+    int getCurrentThreadIndex() const;
+    void enqueue(const TaskRecord& record);
+    bool runOneTask(int workerIndex);
+    void waitForWorkOrCompletion(const AtomicInteger& pending);
+    void notifyGroupCompleted();
+    void workerLoop(int workerIndex);
+    static ThreadLocal<WorkerId> currentWorker;
+private:
+    bool findTask(int workerIndex, TaskRecord& record);
+    bool waitForWork();
+    bool finished;
+    Array_<pthread_t> threads;
+    Array_<WorkerQueue*> queues; // one per worker, plus a shared one for other threads
+    AtomicInteger queuedCount;
+    int sleepingCount;
+    pthread_mutex_t sleepLock;
+    pthread_cond_t workCondition;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SimTKCOMMON_TASK_SCHEDULER_IMPL_H_
@@ -69,6 +69,14 @@ void testOperators() {
     ASSERT(a == 8);
     a >>= 1;
     ASSERT(a == 4);
+    AtomicInteger b(a);
+    ASSERT(b == 4);
+    ++b;
+    ASSERT(a == 4 && b == 5);
+    a = b;
+    ASSERT(a == 5);
+    ++a;
+    ASSERT(a == 6 && b == 5);
 }
 
 void testParallelExecution() {
@@ -139,10 +147,54 @@ void testParallelExecution() {
     }
 }
 
+void testLongLong() {
+    const long long big = 3000000000LL; // too big for an int
+    AtomicLongLong a = big;
+    ASSERT(a == big);
+    ASSERT(a != big+1);
+    ASSERT(++a == big+1);
+    ASSERT(a++ == big+1);
+    ASSERT(a == big+2);
+    ASSERT(--a == big+1);
+    ASSERT(a-- == big+1);
+    ASSERT(a == big);
+    a += big;
+    ASSERT(a == 2*big);
+    a -= big+5;
+    ASSERT(a == big-5);
+    AtomicLongLong b(a);
+    ++b;
+    ASSERT(a == big-5 && b == big-4);
+    a = b;
+    ++a;
+    ASSERT(a == big-3 && b == big-4);
+
+    // See if the ++ operator is properly atomic.
+
+    class IncrementTask : public ParallelExecutor::Task {
+    public:
+        IncrementTask(AtomicLongLong& count) : count(count) {
+        }
+        void execute(int i) {
+            ++count;
+        }
+    private:
+        AtomicLongLong& count;
+    };
+    ParallelExecutor executor;
+    for (int i = 0; i < 100; ++i) {
+        IncrementTask task(a);
+        a = big;
+        executor.execute(task, 5000);
+        ASSERT(a == big+5000);
+    }
+}
+
 int main() {
     try {
         testOperators();
         testParallelExecution();
+        testLongLong();
     } catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
         return 1;
@@ -326,6 +326,31 @@ void testArticulatedInertia() {
     SimTK_TEST_EQ(abi.shiftInPlace(-shiftVec).toSpatialMat(), mabi);
 }
 
+// Shifting a rigid body spatial inertia must agree with rigid-shifting the
+// equivalent articulated body inertia. Note that an ABI shift by s moves the
+// origin by -s.
+void testSpatialInertiaShift() {
+    const Real mass = 1.5;
+    const Vec3 com = Test::randVec3();
+    const UnitInertia central(1, 2, 2.5, .1, -.2, .05);
+    const SpatialInertia si(mass, com, central.shiftFromCentroid(-com));
+
+    const Vec3 S = Test::randVec3();
+    const SpatialInertia shifted = si.shift(S);
+    SimTK_TEST_EQ(shifted.getMassCenter(), com-S);
+    SimTK_TEST_EQ(ArticulatedInertia(shifted).toSpatialMat(),
+                  ArticulatedInertia(si).shift(-S).toSpatialMat());
+
+    SpatialInertia inPlace(si);
+    inPlace.shiftInPlace(S).shiftInPlace(-S);
+    SimTK_TEST_EQ(inPlace.toSpatialMat(), si.toSpatialMat());
+
+    // Shifting to the mass center must produce the central inertia.
+    const SpatialInertia atCOM = si.shift(com);
+    SimTK_TEST_EQ(atCOM.getMassCenter(), Vec3(0));
+    SimTK_TEST_EQ(atCOM.getUnitInertia().asSymMat33(), central.asSymMat33());
+}
+
 void testManualABIShift(const ArticulatedInertia& abi, const Array_<Vec3>& shifts, Real& out) {
     SpatialMat mabi = abi.toSpatialMat();
 
@@ -368,6 +393,7 @@ int main() {
         SimTK_SUBTEST(testInertia);
         SimTK_SUBTEST(testHalfCross);
         SimTK_SUBTEST(testArticulatedInertia);
+        SimTK_SUBTEST(testSpatialInertiaShift);
 
         // Speed tests.
         shifts.resize(NSHIFTS);
@@ -24,6 +24,8 @@
 #include "SimTKcommon.h"
 
 #include <iostream>
+#include <stdexcept>
+#include <string>
 
 #define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
 
@@ -91,10 +93,44 @@ void testSingleThreadedExecution() {
         ASSERT(flags[j] == (j < numFlags-10 ? 1 : 0));
 }
 
+class ThrowingTask : public ParallelExecutor::Task {
+public:
+    ThrowingTask() : started(0), finished(0) {
+    }
+    void execute(int index) {
+        if (index == 5)
+            throw std::runtime_error("expected failure");
+    }
+    void initialize() {
+        ++started;
+    }
+    void finish() {
+        ++finished;
+    }
+    AtomicInteger started, finished;
+};
+
+// The exception should reach the caller of execute(), and every thread that started should
+// still have been finished.
+void testExceptions() {
+    ParallelExecutor executor(3);
+    ThrowingTask task;
+    bool caught = false;
+    try {
+        executor.execute(task, 100);
+    }
+    catch (const std::runtime_error& e) {
+        caught = (std::string(e.what()) == "expected failure");
+    }
+    ASSERT(caught);
+    ASSERT(task.started == task.finished);
+}
+
 int main() {
     try {
         testParallelExecution();
         testSingleThreadedExecution();
+        testExceptions();
     } catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
         return 1;
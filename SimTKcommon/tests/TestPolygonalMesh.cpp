@@ -24,6 +24,8 @@
 #include "SimTKcommon.h"
 
 #include <iostream>
+#include <fstream>
+#include <cstdio>
 
 #define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
 
@@ -109,10 +111,94 @@ void testLoadObjFile() {
     ASSERT(mesh.getFaceVertex(3, 3) == 1);
 }
 
+bool sameMesh(const PolygonalMesh& mesh1, const PolygonalMesh& mesh2) {
+    if (mesh1.getNumVertices() != mesh2.getNumVertices()
+        || mesh1.getNumFaces() != mesh2.getNumFaces())
+        return false;
+    for (int i = 0; i < mesh1.getNumVertices(); i++)
+        if (mesh1.getVertexPosition(i) != mesh2.getVertexPosition(i))
+            return false;
+    for (int i = 0; i < mesh1.getNumFaces(); i++) {
+        if (mesh1.getNumVerticesForFace(i) != mesh2.getNumVerticesForFace(i))
+            return false;
+        for (int j = 0; j < mesh1.getNumVerticesForFace(i); j++)
+            if (mesh1.getFaceVertex(i, j) != mesh2.getFaceVertex(i, j))
+                return false;
+    }
+    return true;
+}
+
+void testBinaryFile() {
+    const String pathname = "TestPolygonalMesh_brick.bin";
+    const PolygonalMesh brick = PolygonalMesh::createBrickMesh(Vec3(1, 2, 3), 2);
+    brick.writeBinaryFile(pathname);
+
+    // Loading into an empty mesh uses the file in place.
+    PolygonalMesh mesh;
+    mesh.loadBinaryFile(pathname);
+    ASSERT(sameMesh(mesh, brick));
+    PolygonalMesh copy;
+    copy.copyAssign(mesh);
+    ASSERT(sameMesh(copy, brick));
+
+    // Changing the mesh doesn't change the file.
+    mesh.scaleMesh(2);
+    ASSERT(mesh.getVertexPosition(0) == 2*brick.getVertexPosition(0));
+    PolygonalMesh original;
+    original.loadBinaryFile(pathname);
+    ASSERT(sameMesh(original, brick));
+    original.clear();
+    ASSERT(original.getNumVertices() == 0 && original.getNumFaces() == 0);
+
+    // Loading into a mesh that has something in it appends.
+    PolygonalMesh twice = PolygonalMesh::createBrickMesh(Vec3(1, 2, 3), 2);
+    twice.loadBinaryFile(pathname);
+    ASSERT(twice.getNumVertices() == 2*brick.getNumVertices());
+    ASSERT(twice.getNumFaces() == 2*brick.getNumFaces());
+    const int nv = brick.getNumVertices(), nf = brick.getNumFaces();
+    for (int i = 0; i < nf; i++)
+        for (int j = 0; j < brick.getNumVerticesForFace(i); j++)
+            ASSERT(twice.getFaceVertex(nf+i, j) == brick.getFaceVertex(i, j)+nv);
+
+    // Rewriting a file that is mapped leaves the mapped mesh intact, even
+    // when the mesh writes itself back to its own file.
+    PolygonalMesh mapped;
+    mapped.loadBinaryFile(pathname);
+    mapped.writeBinaryFile(pathname);
+    PolygonalMesh::createSphereMesh(1, 1).writeBinaryFile(pathname);
+    ASSERT(sameMesh(mapped, brick));
+    PolygonalMesh sphere;
+    sphere.loadBinaryFile(pathname);
+    ASSERT(sphere.getNumVertices() != brick.getNumVertices());
+    mapped.clear();
+
+    // An empty mesh can be written and read back.
+    PolygonalMesh empty;
+    empty.writeBinaryFile(pathname);
+    empty.loadBinaryFile(pathname);
+    ASSERT(empty.getNumVertices() == 0 && empty.getNumFaces() == 0);
+
+    // Anything else is rejected.
+    {
+        ofstream out(pathname.c_str(), ios::out | ios::binary);
+        out << "v 1 2 3\n";
+    }
+    bool threw = false;
+    try {PolygonalMesh bad; bad.loadBinaryFile(pathname);}
+    catch (const std::exception&) {threw = true;}
+    ASSERT(threw);
+    std::remove(pathname.c_str());
+    threw = false;
+    try {PolygonalMesh bad; bad.loadBinaryFile(pathname);}
+    catch (const std::exception&) {threw = true;}
+    ASSERT(threw);
+}
+
 int main() {
     try {
         testCreateMesh();
         testLoadObjFile();
+        testBinaryFile();
     } catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
         return 1;
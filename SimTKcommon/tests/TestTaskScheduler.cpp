@@ -0,0 +1,164 @@
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+
+#include <iostream>
+#include <stdexcept>
+
+#define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
+
+using std::cout;
+using std::endl;
+using namespace SimTK;
+using namespace std;
+
+// Increment a flag for every index, and count them in per-thread scratch.
+class CountRange : public TaskScheduler::RangeTask {
+public:
+    CountRange(Array_<int>& flags, TaskScheduler::Scratch<int>& counts) : flags(flags), counts(counts) {
+    }
+    void execute(int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            flags[i]++;
+            counts.upd()++;
+        }
+    }
+private:
+    Array_<int>& flags;
+    TaskScheduler::Scratch<int>& counts;
+};
+
+void testParallelFor(int numThreads) {
+    const int numFlags = 1000;
+    TaskScheduler scheduler(numThreads);
+    ASSERT(scheduler.getNumThreads() == numThreads);
+    ASSERT(scheduler.getCurrentThreadIndex() == numThreads);
+    ASSERT(!TaskScheduler::isWorkerThread());
+    for (int grain = 0; grain < 40; grain += 7) {
+        Array_<int> flags(numFlags, 0);
+        TaskScheduler::Scratch<int> counts(scheduler, 0);
+        ASSERT(counts.size() == numThreads+1);
+        CountRange task(flags, counts);
+        scheduler.parallelFor(task, 10, numFlags-10, grain);
+        int total = 0;
+        for (int i = 0; i < counts.size(); ++i)
+            total += counts[i];
+        ASSERT(total == numFlags-20);
+        for (int i = 0; i < numFlags; ++i)
+            ASSERT(flags[i] == (i >= 10 && i < numFlags-10 ? 1 : 0));
+    }
+}
+
+// Each of these runs an inner parallelFor from inside a worker thread.
+class NestedTask : public TaskScheduler::Task {
+public:
+    NestedTask(TaskScheduler& scheduler, Array_<int>& flags, int begin, int end)
+    :   scheduler(scheduler), flags(flags), begin(begin), end(end) {
+    }
+    void execute() {
+        ASSERT(TaskScheduler::isWorkerThread());
+        TaskScheduler::Scratch<int> counts(scheduler, 0);
+        CountRange inner(flags, counts);
+        scheduler.parallelFor(inner, begin, end, 3);
+    }
+private:
+    TaskScheduler& scheduler;
+    Array_<int>& flags;
+    const int begin, end;
+};
+
+void testNestedTaskGroups() {
+    const int numTasks = 20, perTask = 50;
+    TaskScheduler scheduler(4);
+    Array_<int> flags(numTasks*perTask, 0);
+    Array_<NestedTask*> tasks;
+    TaskScheduler::TaskGroup group(scheduler);
+    for (int i = 0; i < numTasks; ++i) {
+        tasks.push_back(new NestedTask(scheduler, flags, i*perTask, (i+1)*perTask));
+        group.spawn(*tasks.back());
+    }
+    group.wait();
+    for (int i = 0; i < (int) flags.size(); ++i)
+        ASSERT(flags[i] == 1);
+    for (int i = 0; i < numTasks; ++i)
+        delete tasks[i];
+}
+
+class ThrowingTask : public TaskScheduler::Task {
+public:
+    void execute() {
+        throw std::runtime_error("expected failure");
+    }
+};
+
+class SetFlagTask : public TaskScheduler::Task {
+public:
+    SetFlagTask(int& flag) : flag(flag) {
+    }
+    void execute() {
+        flag = 1;
+    }
+private:
+    int& flag;
+};
+
+// An exception should come out of wait() only after the other tasks are done,
+// and the group should be usable again afterwards.
+void testExceptions() {
+    TaskScheduler scheduler(3);
+    TaskScheduler::TaskGroup group(scheduler);
+    ThrowingTask thrower;
+    int flag = 0;
+    SetFlagTask setter(flag);
+    group.spawn(thrower);
+    group.spawn(setter);
+    bool caught = false;
+    try {
+        group.wait();
+    }
+    catch (const std::runtime_error& e) {
+        // The original exception, not a translation of it.
+        caught = (std::string(e.what()) == "expected failure");
+    }
+    ASSERT(caught);
+    ASSERT(flag == 1);
+    flag = 0;
+    group.spawn(setter);
+    group.wait();
+    ASSERT(flag == 1);
+}
+
+int main() {
+    try {
+        testParallelFor(1);
+        testParallelFor(4);
+        testNestedTaskGroups();
+        testExceptions();
+    } catch(const std::exception& e) {
+        cout << "exception: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
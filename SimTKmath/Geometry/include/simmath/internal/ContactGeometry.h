@@ -146,6 +146,25 @@ may return any of them.
 specified point. **/
 Vec3 findNearestPoint(const Vec3& position, bool& inside, UnitVec3& normal) const;
 
+/** Find the nearest point on the surface of this object to each of a set of
+points at once. The results are those findNearestPoint() would give for each 
+point, except that where several surface points are equally close a different
+one may be chosen. Some kinds of geometry answer a batch of queries much 
+faster than they would answer each one separately, particularly when 
+successive points are close to one another; a TriangleMesh, for example, 
+starts each search from the face nearest to the previous point.
+@param[in]  positions   The points in question.
+@param[out] nearest     On exit, the point on the surface nearest to each one.
+@param[out] inside      On exit, whether each point is inside this object.
+@param[out] normals     On exit, the surface normal at each returned point.
+The output arrays are resized to match \a positions. **/
+void findNearestPoints(const Array_<Vec3>& positions, Array_<Vec3>& nearest, 
+                       Array_<bool>& inside, Array_<UnitVec3>& normals) const;
+/** This is the same as the other findNearestPoints() signature except that
+the surface normals aren't wanted, which saves evaluating them. **/
+void findNearestPoints(const Array_<Vec3>& positions, Array_<Vec3>& nearest, 
+                       Array_<bool>& inside) const;
+
 /** Given a query point Q, find the nearest point P on the surface of this 
 object, looking only down the local gradient. Thus we cannot guarantee that P
 is the globally nearest point; if you need that use the findNearestPoint()
@@ -531,7 +550,10 @@ static void combineParaboloids(const Rotation& R_SP1, const Vec2& k1,
                                Vec2& k);
 
 
-/** @name                  Geodesic Evaluators **/
+/** @name                  Geodesic Evaluators
+These methods keep the geodesics they shoot, and their statistics, inside this
+ContactGeometry object, so geodesics on a given ContactGeometry must not be 
+calculated by more than one thread at a time. **/
 /**@{**/
 
 /** Given two points, find a geodesic curve connecting them.
@@ -1041,7 +1063,11 @@ a unique height z, so caves and overhangs cannot be represented.
 The surface is parameterized as z=f(x,y) where x,y,z are measured in 
 the surface's local coordinate frame. This can also be described as the 
 implicit function F(x,y,z)=f(x,y)-z=0, as though this were an infinitely thick
-slab in the -z direction below the surface. **/
+slab in the -z direction below the surface. 
+
+Evaluation remembers the most recently used patch inside this object to speed
+up nearby queries, so a SmoothHeightMap must not be evaluated by more than one
+thread at a time. **/
 class SimTK_SIMMATH_EXPORT 
 ContactGeometry::SmoothHeightMap : public ContactGeometry {
 public:
@@ -1254,6 +1280,21 @@ OBBTreeNode getOBBTreeNode() const;
 because you can create a DecorativeMesh from this and then look at it. **/
 PolygonalMesh createPolygonalMesh() const;
 
+/** Write this mesh to a binary file from which createFromBinaryFile() can
+recreate it. Loading that file is much faster than constructing the mesh from
+its vertices and faces, because the edge and face adjacency and the Oriented
+Bounding Box Tree are saved rather than recomputed. The file is meant as a
+cache rather than for exchanging meshes: its contents are in the native
+binary format of this platform and this precision of Real.
+@param pathname  The file to write; an existing file is overwritten. **/
+void writeBinaryFile(const String& pathname) const;
+/** Create a TriangleMesh from a file written by writeBinaryFile(). The file
+is memory mapped and read in place. An exception is thrown if the file can't
+be read, or if it was written on a platform or with a precision different
+from this one.
+@param pathname  The file to read. **/
+static TriangleMesh createFromBinaryFile(const String& pathname);
+
 /** Return true if the supplied ContactGeometry object is a triangle mesh. **/
 static bool isInstance(const ContactGeometry& geo)
 {   return geo.getTypeId()==classTypeId(); }
@@ -1268,6 +1309,7 @@ static TriangleMesh& updAs(ContactGeometry& geo)
 static ContactGeometryTypeId classTypeId();
 
 class Impl; /**< Internal use only. **/
+explicit TriangleMesh(Impl* impl); /**< Internal use only. **/
 const Impl& getImpl() const; /**< Internal use only. **/
 Impl& updImpl(); /**< Internal use only. **/
 };
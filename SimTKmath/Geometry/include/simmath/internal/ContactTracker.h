@@ -84,6 +84,15 @@ getContactGeometryTypeIds() const {return m_surfaceTypes;}
 
 virtual ~ContactTracker() {}
 
+/** Return true if trackContact() may be called concurrently from several
+threads, each for a different pair of surfaces. A surface may appear in more
+than one of those pairs, so it must not modify the surfaces or anything else
+they share. ContactTrackerSubsystem checks this before tracking contacts in 
+parallel; trackers that return false are always called on the thread doing
+the realization. The default implementation returns false; the built-in
+trackers return true except for GeneralImplicitPair. **/
+virtual bool isThreadSafe() const {return false;}
+
 /** The ContactTrackerSubsystem will invoke this method for any pair of
 contact surfaces that is already being tracked, or for which the static broad 
 phase analysis indicated that they might be in contact now. Only position 
@@ -215,6 +224,8 @@ HalfSpaceSphere()
 
 virtual ~HalfSpaceSphere() {}
 
+virtual bool isThreadSafe() const {return true;}
+
 virtual bool trackContact
    (const Contact&         priorStatus,
     const Transform& X_GS1, 
@@ -260,6 +271,8 @@ HalfSpaceEllipsoid()
 
 virtual ~HalfSpaceEllipsoid() {}
 
+virtual bool isThreadSafe() const {return true;}
+
 virtual bool trackContact
    (const Contact&         priorStatus,
     const Transform& X_GS1, 
@@ -305,6 +318,8 @@ SphereSphere()
 
 virtual ~SphereSphere() {}
 
+virtual bool isThreadSafe() const {return true;}
+
 virtual bool trackContact
    (const Contact&         priorStatus,
     const Transform& X_GS1, 
@@ -350,6 +365,8 @@ HalfSpaceTriangleMesh()
 
 virtual ~HalfSpaceTriangleMesh() {}
 
+virtual bool isThreadSafe() const {return true;}
+
 virtual bool trackContact
    (const Contact&         priorStatus,
     const Transform& X_GS1, 
@@ -403,6 +420,8 @@ SphereTriangleMesh()
 
 virtual ~SphereTriangleMesh() {}
 
+virtual bool isThreadSafe() const {return true;}
+
 virtual bool trackContact
    (const Contact&         priorStatus,
     const Transform& X_GS1, 
@@ -445,7 +464,11 @@ void processBox
 //             TRIANGLE MESH - TRIANGLE MESH CONTACT TRACKER
 //==============================================================================
 /** This ContactTracker handles contacts between two 
-ContactGeometry::TriangleMesh surfaces. **/
+ContactGeometry::TriangleMesh surfaces. The intersecting faces are found by
+walking a four-way version of both meshes' OBB trees together, testing
+several boxes at a time. A TriangleMeshContact returned from here remembers 
+where that walk stopped, and when it is passed back in as the prior status
+the next walk starts from there rather than from the roots. **/
 class SimTK_SIMMATH_EXPORT ContactTracker::TriangleMeshTriangleMesh
 :   public ContactTracker {
 public:
@@ -455,6 +478,8 @@ TriangleMeshTriangleMesh()
 
 virtual ~TriangleMeshTriangleMesh() {}
 
+virtual bool isThreadSafe() const {return true;}
+
 virtual bool trackContact
    (const Contact&         priorStatus,
     const Transform& X_GS1, 
@@ -484,23 +509,14 @@ virtual bool initializeContact
     Contact&               contactStatus) const;
 
 private:
-void findIntersectingFaces
-   (const ContactGeometry::TriangleMesh&                mesh1, 
-    const ContactGeometry::TriangleMesh&                mesh2,
-    const ContactGeometry::TriangleMesh::OBBTreeNode&   node1, 
-    const ContactGeometry::TriangleMesh::OBBTreeNode&   node2, 
-    const OrientedBoundingBox&                          node2Bounds_M1,
-    const Transform&                                    X_M1M2, 
-    std::set<int>&                                      insideFaces1, 
-    std::set<int>&                                      insideFaces2) const; 
 void findBuriedFaces
    (const ContactGeometry::TriangleMesh&    mesh,
     const ContactGeometry::TriangleMesh&    otherMesh,
     const Transform&                        X_OM, 
-    std::set<int>&                          insideFaces) const;
+    const Array_<int>&                      boundaryFaces,
+    Array_<int>&                            faceType) const;
 void tagFaces(const ContactGeometry::TriangleMesh&   mesh, 
               Array_<int>&                           faceType,
-              std::set<int>&                         triangles, 
               int                                    index,
               int                                    depth) const;
 };
@@ -520,6 +536,8 @@ ConvexImplicitPair(ContactGeometryTypeId type1, ContactGeometryTypeId type2)
 
 virtual ~ConvexImplicitPair() {}
 
+virtual bool isThreadSafe() const {return true;}
+
 virtual bool trackContact
    (const Contact&         priorStatus,
     const Transform& X_GS1, 
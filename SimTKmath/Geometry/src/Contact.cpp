@@ -224,7 +224,8 @@ TriangleMeshContactImpl::TriangleMeshContactImpl
    (ContactSurfaceIndex surf1, ContactSurfaceIndex surf2,
     const Transform& X_S1S2,
     const set<int>& faces1, const set<int>& faces2) 
-:   ContactImpl(surf1, surf2, X_S1S2), faces1(faces1), faces2(faces2) {}
+:   ContactImpl(surf1, surf2, X_S1S2), frontMesh1(0), frontMesh2(0),
+    faces1(faces1), faces2(faces2) {}
 
 
 
@@ -114,6 +114,23 @@ Vec3 ContactGeometry::findNearestPoint(const Vec3& position, bool& inside, UnitV
     return getImpl().findNearestPoint(position, inside, normal);
 }
 
+void ContactGeometry::findNearestPoints
+   (const Array_<Vec3>& positions, Array_<Vec3>& nearest, Array_<bool>& inside,
+    Array_<UnitVec3>& normals) const {
+    nearest.resize(positions.size());
+    inside.resize(positions.size());
+    normals.resize(positions.size());
+    getImpl().findNearestPoints(positions, nearest, inside, &normals);
+}
+
+void ContactGeometry::findNearestPoints
+   (const Array_<Vec3>& positions, Array_<Vec3>& nearest, Array_<bool>& inside)
+    const {
+    nearest.resize(positions.size());
+    inside.resize(positions.size());
+    getImpl().findNearestPoints(positions, nearest, inside, 0);
+}
+
 Vec3 ContactGeometry::projectDownhillToNearestPoint(const Vec3& Q) const {
     return getImpl().projectDownhillToNearestPoint(Q);
 }
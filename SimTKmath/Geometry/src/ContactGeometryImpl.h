@@ -78,6 +78,22 @@ public:
     virtual Vec3 findNearestPoint(const Vec3& position, bool& inside, 
                                   UnitVec3& normal) const = 0;
 
+    // The output arrays have already been sized to match the positions; 
+    // normals is null if the caller doesn't want them. Geometry that can take
+    // advantage of successive queries being near each other should override
+    // this.
+    virtual void findNearestPoints(const Array_<Vec3>& positions, 
+                                   Array_<Vec3>& nearest, Array_<bool>& inside,
+                                   Array_<UnitVec3>* normals) const {
+        UnitVec3 normal;
+        for (unsigned i=0; i < positions.size(); ++i) {
+            bool isInside;
+            nearest[i] = findNearestPoint(positions[i], isInside, normal);
+            inside[i] = isInside;
+            if (normals) (*normals)[i] = normal;
+        }
+    }
+
     virtual bool intersectsRay(const Vec3& origin, const UnitVec3& direction, 
                                Real& distance, UnitVec3& normal) const = 0;
 
@@ -934,6 +950,52 @@ public:
 
 
 
+//==============================================================================
+//                           OBB TREE 4 NODE
+//==============================================================================
+// A node of a four-way version of a TriangleMesh's OBB tree, made by skipping
+// every other level of the binary tree; the mesh-mesh contact tracker walks
+// this one. The nodes are kept in a single array and refer to each other by
+// index. Besides its own box, each node keeps copies of its children's boxes
+// packed component by component (childCenter[i][k] is component i of child
+// k's center) so that all the children can be tested against another box in
+// one pass over contiguous data. Unused child slots repeat the first child.
+// Boxes are given by center, axes (the columns of a rotation matrix) and
+// half-lengths along those axes, all in the mesh frame.
+class OBBTree4Node {
+public:
+    bool isLeaf() const {return numChildren == 0;}
+
+    // Set overlaps[k] to true if child k's box might intersect the given
+    // one, and false if they are certainly disjoint.
+    void findChildOverlaps(const Vec3& center, const Mat33& axes, 
+                           const Vec3& halfSize, bool overlaps[4]) const;
+
+    // Return false if this node's box and the given one are certainly
+    // disjoint.
+    bool overlapsBox(const Vec3& center, const Mat33& axes, 
+                     const Vec3& halfSize) const;
+
+    // Set distance2[k] to the square of the distance from the given point to
+    // child k's box, which is zero if the point is inside it.
+    void findChildDistances2(const Vec3& point, Real distance2[4]) const;
+
+    Vec3    center;
+    Mat33   axes;
+    Vec3    halfSize;
+    Real    volume;
+    int     numChildren;        // 0 for a leaf, otherwise 2 to 4
+    int     children[4];        // node indices
+    int     firstTriangle;      // leaves only: a range of the mesh's
+    int     numTriangles;       //   OBB tree 4 triangle list
+
+    Real    childCenter[3][4];
+    Real    childAxes[9][4];    // row i, column j is [3*i+j]
+    Real    childHalfSize[3][4];
+};
+
+
+
 //==============================================================================
 //                            TRIANGLE MESH IMPL
 //==============================================================================
@@ -960,6 +1022,9 @@ public:
                           UnitVec3& normal) const;
     Vec3 findNearestPoint(const Vec3& position, bool& inside, int& face, 
                           Vec2& uv) const;
+    void findNearestPoints(const Array_<Vec3>& positions, Array_<Vec3>& nearest,
+                           Array_<bool>& inside, 
+                           Array_<UnitVec3>* normals) const;
     Vec3 findNearestPointToFace(const Vec3& position, int face, Vec2& uv) const;
     bool intersectsRay(const Vec3& origin, const UnitVec3& direction, 
                        Real& distance, UnitVec3& normal) const;
@@ -973,21 +1038,38 @@ public:
 
     void createPolygonalMesh(PolygonalMesh& mesh) const;
 
+    // Save everything, including the adjacency and the OBB tree, in the
+    // binary format read by readBinaryFile().
+    void writeBinaryFile(const String& pathname) const;
+
+    // The four-way OBB tree; node 0 is the root. The leaves' triangles are
+    // ranges of the triangle list.
+    const Array_<OBBTree4Node>& getOBBTree4() const {return obb4;}
+    const Array_<int>& getOBBTree4Triangles() const {return obb4Triangles;}
+
     static ContactGeometryTypeId classTypeId() {
         static const ContactGeometryTypeId id = 
             createNewContactGeometryTypeId();
         return id;
     }
 private:
+    class ObbTreeBuilder;
+
+    // An empty mesh, to be filled in by readBinaryFile().
+    Impl() : ContactGeometryImpl(), boundingSphereRadius(0), smooth(false) {}
+    void readBinaryFile(const String& pathname);
+
     void init(const Array_<Vec3>& vertexPositions, const Array_<int>& faceIndices);
-    void createObbTree(OBBTreeNodeImpl& node, const Array_<int>& faceIndices);
-    void splitObbAxis(const Array_<int>& parentIndices, 
-                      Array_<int>& child1Indices, 
-                      Array_<int>& child2Indices, int axis);
+    int createObbTree4(const OBBTreeNodeImpl& node);
+    // Search the four-way tree below a node for a face nearer to the 
+    // position than the one given, replacing it and its distance if found.
+    void findNearerFace(int node, const Vec3& position, Real& distance2, 
+                        int& face, Vec2& uv, Vec3& nearestPoint) const;
     void findBoundingSphere(Vec3* point[], int p, int b, 
                             Vec3& center, Real& radius);
     friend class ContactGeometry::TriangleMesh;
     friend class OBBTreeNodeImpl;
+    friend class ObbTreeBuilder;
 
     Array_<Edge>    edges;
     Array_<Face>    faces;
@@ -995,6 +1077,8 @@ private:
     Vec3            boundingSphereCenter;
     Real            boundingSphereRadius;
     OBBTreeNodeImpl obb;
+    Array_<OBBTree4Node> obb4;
+    Array_<int>     obb4Triangles;
     bool            smooth;
 };
 
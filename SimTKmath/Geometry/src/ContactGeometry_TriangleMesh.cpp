@@ -31,14 +31,14 @@
 #include "ContactGeometryImpl.h"
 
 #include <iostream>
+#include <fstream>
 #include <cmath>
+#include <cstring>
 #include <map>
-#include <set>
 
 using namespace SimTK;
 using std::map;
 using std::pair;
-using std::set;
 using std::string;
 using std::cout; using std::endl;
 
@@ -55,6 +55,25 @@ ContactGeometry::TriangleMesh::TriangleMesh
    (const PolygonalMesh& mesh, bool smooth) 
 :   ContactGeometry(new TriangleMesh::Impl(mesh, smooth)) {}
 
+ContactGeometry::TriangleMesh::TriangleMesh(TriangleMesh::Impl* impl)
+:   ContactGeometry(impl) {}
+
+/*static*/ ContactGeometry::TriangleMesh ContactGeometry::TriangleMesh::
+createFromBinaryFile(const String& pathname) {
+    TriangleMesh::Impl* impl = new TriangleMesh::Impl();
+    try {
+        impl->readBinaryFile(pathname);
+    } catch (...) {
+        delete impl;
+        throw;
+    }
+    return TriangleMesh(impl);
+}
+
+void ContactGeometry::TriangleMesh::
+writeBinaryFile(const String& pathname) const 
+{   getImpl().writeBinaryFile(pathname); }
+
 /*static*/ ContactGeometryTypeId ContactGeometry::TriangleMesh::classTypeId() 
 {   return ContactGeometry::TriangleMesh::Impl::classTypeId(); }
 
@@ -263,6 +282,80 @@ findNearestPoint(const Vec3& position, bool& inside, int& face, Vec2& uv) const
     return nearestPoint;
 }
 
+// Each search starts from the face that was nearest to the previous point,
+// so when successive points are close together only the few parts of the 
+// tree that could hold something at least as near are visited. The four-way
+// tree is used, since it finds the distances to all of a node's children at
+// once.
+void ContactGeometry::TriangleMesh::Impl::
+findNearestPoints(const Array_<Vec3>& positions, Array_<Vec3>& nearest,
+                  Array_<bool>& inside, Array_<UnitVec3>* normals) const 
+{
+    int face = -1;
+    for (unsigned i=0; i < positions.size(); ++i) {
+        const Vec3& position = positions[i];
+        Real distance2 = MostPositiveReal;
+        Vec2 uv;
+        Vec3 nearestPoint;
+        if (face >= 0) {
+            nearestPoint = findNearestPointToFace(position, face, uv);
+            distance2 = (nearestPoint-position).normSqr();
+        }
+        findNearerFace(0, position, distance2, face, uv, nearestPoint);
+        inside[i] = (~(position-nearestPoint)*faces[face].normal < 0);
+        if (normals)
+            (*normals)[i] = findNormalAtPoint(face, uv);
+        nearest[i] = nearestPoint;
+    }
+}
+
+// This follows OBBTreeNodeImpl::findNearestPoint(): children are searched 
+// nearest first, and of two faces at the same distance (within a tolerance)
+// the one that the point is most nearly straight out from is preferred.
+void ContactGeometry::TriangleMesh::Impl::
+findNearerFace(int index, const Vec3& position, Real& distance2, int& face, 
+               Vec2& uv, Vec3& nearestPoint) const 
+{
+    const Real tol = 100*Eps;
+    const OBBTree4Node& node = obb4[index];
+    if (node.isLeaf()) {
+        for (int i=0; i < node.numTriangles; ++i) {
+            const int triangle = obb4Triangles[node.firstTriangle+i];
+            Vec2 triangleUV;
+            const Vec3 p = findNearestPointToFace(position, triangle, triangleUV);
+            const Vec3 offset = p-position;
+            const Real d2 = offset.normSqr();
+            if (d2 < distance2 
+                || (d2 < distance2*(1+tol) && triangle != face
+                    && std::abs(~offset*faces[triangle].normal) 
+                       > std::abs(~offset*faces[face].normal))) {
+                nearestPoint = p;
+                distance2 = d2;
+                face = triangle;
+                uv = triangleUV;
+            }
+        }
+        return;
+    }
+
+    Real childDistance2[4];
+    node.findChildDistances2(position, childDistance2);
+    int order[4];
+    for (int k=0; k < node.numChildren; ++k) {
+        int j = k;
+        for (; j > 0 && childDistance2[order[j-1]] > childDistance2[k]; --j)
+            order[j] = order[j-1];
+        order[j] = k;
+    }
+    for (int k=0; k < node.numChildren; ++k) {
+        // The rest are no nearer than this one.
+        if (childDistance2[order[k]] >= distance2*(1+tol))
+            break;
+        findNearerFace(node.children[order[k]], position, distance2, face, uv,
+                       nearestPoint);
+    }
+}
+
 bool ContactGeometry::TriangleMesh::Impl::
 intersectsRay(const Vec3& origin, const UnitVec3& direction, Real& distance, 
               UnitVec3& normal) const {
@@ -300,6 +393,288 @@ createPolygonalMesh(PolygonalMesh& mesh) const {
     }
 }
 
+//------------------------------------------------------------------------------
+//                             BINARY MESH FILES
+//------------------------------------------------------------------------------
+// A binary mesh file is a header followed by arrays of Reals and then arrays
+// of ints, each in native format:
+//   Reals: vertex positions and normals (6 per vertex), face normals and 
+//          areas (4 per face), OBB tree node rotations (row by row), origins
+//          and sizes (15 per node)
+//   ints:  first edge of each vertex, vertices and edges of each face (6 per
+//          face), vertices and faces of each edge (4 per edge), OBB tree
+//          node first child, second child, number of triangles, and start of
+//          its triangles (4 per node), then the leaf triangle list
+// The tree nodes are in depth first order, so a node's first child 
+// immediately follows it. The header is a multiple of sizeof(Real) bytes,
+// so the arrays can be used in place in a memory mapped file.
+namespace {
+
+const char BinaryMeshMagic[8] = {'S','i','m','T','K','m','s','h'};
+const int  BinaryMeshVersion = 1;
+const int  BinaryMeshByteOrder = 0x01020304;
+
+struct BinaryMeshHeader {
+    char    magic[8];
+    int     version;
+    int     realSize;           // sizeof(Real)
+    int     byteOrder;          // BinaryMeshByteOrder, as written
+    int     smooth;
+    int     numVertices;
+    int     numFaces;
+    int     numEdges;
+    int     numObbNodes;
+    int     numObbTriangles;
+    int     reserved;
+    Real    boundingSphere[4];  // center, radius
+};
+
+// Append the subtree rooted at this node in depth first order, returning the
+// node's index.
+int appendObbNode(const OBBTreeNodeImpl& node, Array_<Real>& reals, 
+                  Array_<int>& ints, Array_<int>& triangles) 
+{   const int index = ints.size()/4;
+    const Transform& X = node.bounds.getTransform();
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            reals.push_back(X.R().asMat33()(i,j));
+    for (int i = 0; i < 3; i++) reals.push_back(X.p()[i]);
+    for (int i = 0; i < 3; i++) reals.push_back(node.bounds.getSize()[i]);
+    ints.push_back(-1); ints.push_back(-1);
+    ints.push_back(node.numTriangles); ints.push_back(triangles.size());
+    if (node.child1 == NULL)
+        triangles.insert(triangles.end(), node.triangles.begin(), 
+                         node.triangles.end());
+    else {
+        ints[4*index] = appendObbNode(*node.child1, reals, ints, triangles);
+        ints[4*index+1] = appendObbNode(*node.child2, reals, ints, triangles);
+    }
+    return index;
+}
+
+// Trees read from a file may be no deeper than this. The tree builder
+// doesn't come anywhere near it for real meshes, but a file could describe a
+// much deeper tree, and the rest of the code walks trees recursively.
+const int MaxObbTreeDepth = 1000;
+
+// Rebuild the tree rooted at the given node from the arrays written by 
+// appendObbNode(), returning the number of nodes read, or -1 if the arrays
+// don't describe a valid tree. The nodes are in depth first order, so they
+// are read in index order; a stack holds the second children still to come.
+int readObbTree(OBBTreeNodeImpl& root, int numNodes, 
+                const Real* reals, const int* ints, 
+                const int* triangles, int numTriangles, int numFaces) 
+{   struct Pending {
+        Pending(OBBTreeNodeImpl* node, int index, int depth) 
+        :   node(node), index(index), depth(depth) {}
+        OBBTreeNodeImpl* node; int index, depth;
+    };
+    Array_<Pending> stack;
+    stack.push_back(Pending(&root, 0, 1));
+    int next = 0; // index of the next node in depth first order
+    while (!stack.empty()) {
+        const Pending pending = stack.back();
+        stack.pop_back();
+        // A second child must follow the end of its sibling's subtree.
+        if (pending.index != next || pending.depth > MaxObbTreeDepth)
+            return -1;
+        OBBTreeNodeImpl& node = *pending.node;
+        const int index = pending.index;
+        const Real* r = reals + 15*index;
+        const int*  n = ints + 4*index;
+        const Rotation R(Mat33(r[0],r[1],r[2], r[3],r[4],r[5], 
+                               r[6],r[7],r[8]), true);
+        node.bounds = OrientedBoundingBox
+           (Transform(R, Vec3(r[9],r[10],r[11])), Vec3(r[12],r[13],r[14]));
+        node.numTriangles = n[2];
+        next = index+1;
+        if (n[0] < 0) {
+            if (   n[1] >= 0 || n[2] <= 0 || n[3] < 0 
+                || n[3] > numTriangles-n[2])
+                return -1;
+            for (int i = 0; i < n[2]; i++) {
+                const int face = triangles[n[3]+i];
+                if (face < 0 || face >= numFaces)
+                    return -1;
+                node.triangles.push_back(face);
+            }
+            continue;
+        }
+        if (n[0] != index+1 || n[1] <= n[0] || n[1] >= numNodes)
+            return -1;
+        node.child1 = new OBBTreeNodeImpl();
+        node.child2 = new OBBTreeNodeImpl();
+        stack.push_back(Pending(node.child2, n[1], pending.depth+1));
+        stack.push_back(Pending(node.child1, n[0], pending.depth+1));
+    }
+    return next;
+}
+
+}
+
+void ContactGeometry::TriangleMesh::Impl::
+writeBinaryFile(const String& pathname) const {
+    const char* methodName = "ContactGeometry::TriangleMesh::writeBinaryFile()";
+    Array_<Real> nodeReals;
+    Array_<int>  nodeInts, obbTriangles;
+    appendObbNode(obb, nodeReals, nodeInts, obbTriangles);
+
+    BinaryMeshHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BinaryMeshMagic, sizeof(header.magic));
+    header.version = BinaryMeshVersion;
+    header.realSize = sizeof(Real);
+    header.byteOrder = BinaryMeshByteOrder;
+    header.smooth = smooth;
+    header.numVertices = vertices.size();
+    header.numFaces = faces.size();
+    header.numEdges = edges.size();
+    header.numObbNodes = nodeInts.size()/4;
+    header.numObbTriangles = obbTriangles.size();
+    for (int i = 0; i < 3; i++) 
+        header.boundingSphere[i] = boundingSphereCenter[i];
+    header.boundingSphere[3] = boundingSphereRadius;
+
+    Array_<Real> reals;
+    reals.reserve(6*vertices.size() + 4*faces.size() + nodeReals.size());
+    for (int i = 0; i < (int) vertices.size(); i++) {
+        const Vertex& v = vertices[i];
+        for (int j = 0; j < 3; j++) reals.push_back(v.pos[j]);
+        for (int j = 0; j < 3; j++) reals.push_back(v.normal[j]);
+    }
+    for (int i = 0; i < (int) faces.size(); i++) {
+        const Face& f = faces[i];
+        for (int j = 0; j < 3; j++) reals.push_back(f.normal[j]);
+        reals.push_back(f.area);
+    }
+    reals.insert(reals.end(), nodeReals.begin(), nodeReals.end());
+
+    Array_<int> ints;
+    ints.reserve(vertices.size() + 6*faces.size() + 4*edges.size() 
+                 + nodeInts.size() + obbTriangles.size());
+    for (int i = 0; i < (int) vertices.size(); i++)
+        ints.push_back(vertices[i].firstEdge);
+    for (int i = 0; i < (int) faces.size(); i++) {
+        const Face& f = faces[i];
+        ints.insert(ints.end(), f.vertices, f.vertices+3);
+        ints.insert(ints.end(), f.edges, f.edges+3);
+    }
+    for (int i = 0; i < (int) edges.size(); i++) {
+        const Edge& e = edges[i];
+        ints.insert(ints.end(), e.vertices, e.vertices+2);
+        ints.insert(ints.end(), e.faces, e.faces+2);
+    }
+    ints.insert(ints.end(), nodeInts.begin(), nodeInts.end());
+    ints.insert(ints.end(), obbTriangles.begin(), obbTriangles.end());
+
+    std::ofstream file(pathname.c_str(), std::ios::out | std::ios::binary);
+    SimTK_ERRCHK1_ALWAYS(file.good(), methodName,
+        "Can't create file '%s'.", pathname.c_str());
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)reals.cbegin(), reals.size()*sizeof(Real));
+    file.write((const char*)ints.cbegin(), ints.size()*sizeof(int));
+    file.close();
+    SimTK_ERRCHK1_ALWAYS(!file.fail(), methodName,
+        "An error occurred while writing file '%s'.", pathname.c_str());
+}
+
+void ContactGeometry::TriangleMesh::Impl::
+readBinaryFile(const String& pathname) {
+    const char* methodName = 
+        "ContactGeometry::TriangleMesh::createFromBinaryFile()";
+    const MappedFile file(pathname);
+    const char* data = file.getData();
+
+    BinaryMeshHeader header;
+    SimTK_ERRCHK1_ALWAYS(file.getSize() >= sizeof(header), methodName,
+        "File '%s' is too short to be a binary mesh file.", pathname.c_str());
+    std::memcpy(&header, data, sizeof(header));
+    SimTK_ERRCHK1_ALWAYS(std::memcmp(header.magic, BinaryMeshMagic, 
+                                     sizeof(header.magic)) == 0, methodName,
+        "File '%s' is not a binary mesh file.", pathname.c_str());
+    SimTK_ERRCHK2_ALWAYS(header.version == BinaryMeshVersion, methodName,
+        "File '%s' has binary mesh format version %d, which isn't supported.",
+        pathname.c_str(), header.version);
+    SimTK_ERRCHK1_ALWAYS(   header.realSize == (int)sizeof(Real) 
+                         && header.byteOrder == BinaryMeshByteOrder, 
+        methodName, "File '%s' was written by a platform or precision that"
+        " differs from this one.", pathname.c_str());
+
+    const int nv = header.numVertices, nf = header.numFaces, 
+              ne = header.numEdges, nn = header.numObbNodes,
+              nt = header.numObbTriangles;
+    SimTK_ERRCHK1_ALWAYS(nv > 0 && nf > 0 && ne > 0 && nn > 0 && nt > 0,
+        methodName, "File '%s' contains an empty mesh.", pathname.c_str());
+    const std::size_t numReals = 6*(std::size_t)nv + 4*(std::size_t)nf 
+                                 + 15*(std::size_t)nn;
+    const std::size_t numInts = (std::size_t)nv + 6*(std::size_t)nf 
+                                + 4*(std::size_t)ne + 4*(std::size_t)nn 
+                                + (std::size_t)nt;
+    SimTK_ERRCHK1_ALWAYS(file.getSize() == sizeof(header) 
+                         + numReals*sizeof(Real) + numInts*sizeof(int),
+        methodName, "File '%s' has the wrong size for the mesh it describes.",
+        pathname.c_str());
+
+    const Real* vertexReals = (const Real*)(data + sizeof(header));
+    const Real* faceReals   = vertexReals + 6*nv;
+    const Real* nodeReals   = faceReals + 4*nf;
+    const int*  vertexInts  = (const int*)(nodeReals + 15*nn);
+    const int*  faceInts    = vertexInts + nv;
+    const int*  edgeInts    = faceInts + 6*nf;
+    const int*  nodeInts    = edgeInts + 4*ne;
+    const int*  triangles   = nodeInts + 4*nn;
+
+    // Check every index so that a damaged file can't cause a crash later.
+    bool valid = true;
+    for (int i = 0; i < nv; i++)
+        valid &= vertexInts[i] >= 0 && vertexInts[i] < ne;
+    for (int i = 0; i < nf; i++)
+        for (int j = 0; j < 3; j++) 
+            valid &=    faceInts[6*i+j] >= 0 && faceInts[6*i+j] < nv
+                     && faceInts[6*i+3+j] >= 0 && faceInts[6*i+3+j] < ne;
+    for (int i = 0; i < ne; i++)
+        for (int j = 0; j < 2; j++)
+            valid &=    edgeInts[4*i+j] >= 0 && edgeInts[4*i+j] < nv
+                     && edgeInts[4*i+2+j] >= 0 && edgeInts[4*i+2+j] < nf;
+    SimTK_ERRCHK1_ALWAYS(valid, methodName,
+        "File '%s' contains an invalid vertex, edge, or face index.", 
+        pathname.c_str());
+
+    vertices.reserve(nv);
+    for (int i = 0; i < nv; i++) {
+        const Real* r = vertexReals + 6*i;
+        vertices.push_back(Vertex(Vec3(r[0], r[1], r[2])));
+        vertices.back().normal = UnitVec3(Vec3(r[3], r[4], r[5]), true);
+        vertices.back().firstEdge = vertexInts[i];
+    }
+    faces.reserve(nf);
+    for (int i = 0; i < nf; i++) {
+        const Real* r = faceReals + 4*i;
+        const int*  n = faceInts + 6*i;
+        faces.push_back(Face(n[0], n[1], n[2], 
+                             UnitVec3(Vec3(r[0], r[1], r[2]), true), r[3]));
+        for (int j = 0; j < 3; j++) 
+            faces.back().edges[j] = n[3+j];
+    }
+    edges.reserve(ne);
+    for (int i = 0; i < ne; i++) {
+        const int* n = edgeInts + 4*i;
+        edges.push_back(Edge(n[0], n[1], n[2], n[3]));
+    }
+
+    SimTK_ERRCHK1_ALWAYS(readObbTree(obb, nn, nodeReals, nodeInts, 
+                                     triangles, nt, nf) == nn, methodName,
+        "File '%s' contains an invalid OBB tree.", pathname.c_str());
+    obb4.clear(); obb4Triangles.clear();
+    createObbTree4(obb);
+
+    boundingSphereCenter = Vec3(header.boundingSphere[0], 
+                                header.boundingSphere[1],
+                                header.boundingSphere[2]);
+    boundingSphereRadius = header.boundingSphere[3];
+    smooth = header.smooth != 0;
+}
+
 ContactGeometry::TriangleMesh::Impl::Impl
    (const ArrayViewConst_<Vec3>& vertexPositions, 
     const ArrayViewConst_<int>& faceIndices, bool smooth) 
@@ -395,6 +770,243 @@ ContactGeometry::TriangleMesh::Impl::Impl
     }
 }
 
+//------------------------------------------------------------------------------
+//                            OBB TREE BUILDER
+//------------------------------------------------------------------------------
+// This builds a mesh's binary OBB tree from the top down. Each node's box is
+// fit to the vertices of its faces. The faces are then divided between two
+// children using a binned surface area heuristic along the box's own axes:
+// faces are sorted into bins by the centers of their extents along an axis,
+// and the boundary between bins that minimizes the children's summed
+// (surface area * number of faces) is chosen. That makes the cost of a node
+// linear in its number of faces, so the whole build is O(n log n). When a
+// TaskScheduler is supplied, the children of large nodes are built in
+// parallel.
+class ContactGeometry::TriangleMesh::Impl::ObbTreeBuilder {
+public:
+    ObbTreeBuilder(const Impl& mesh, TaskScheduler* scheduler)
+    :   mesh(mesh), scheduler(scheduler), 
+        scratch(scheduler ? scheduler->getNumThreads()+1 : 1) {}
+
+    void build(OBBTreeNodeImpl& node, const Array_<int>& faceIndices);
+
+private:
+    // Number of bins along each axis, and the number of faces below which 
+    // children are always built on the current thread.
+    enum {NumBins = 16, ParallelGrain = 4096};
+
+    // A face's extent in the frame of the box being split.
+    struct FaceBounds {
+        Vec3 low, high, center;
+    };
+
+    // Space reused from node to node by one thread. A vertex has been 
+    // collected for the current node if its mark equals currentMark.
+    struct BuildScratch {
+        BuildScratch() : currentMark(0) {}
+        Array_<int>         vertexMark;
+        int                 currentMark;
+        Vector_<Vec3>       points;
+        Array_<FaceBounds>  bounds;
+    };
+
+    class BuildTask : public TaskScheduler::Task {
+    public:
+        BuildTask(ObbTreeBuilder& builder, OBBTreeNodeImpl& node,
+                  const Array_<int>& faceIndices)
+        :   builder(builder), node(node), faceIndices(faceIndices) {}
+        void execute() {builder.build(node, faceIndices);}
+    private:
+        ObbTreeBuilder&     builder;
+        OBBTreeNodeImpl&    node;
+        const Array_<int>&  faceIndices;
+    };
+
+    BuildScratch& updScratch() 
+    {   return scratch[scheduler ? scheduler->getCurrentThreadIndex() : 0]; }
+
+    void fitBox(OBBTreeNodeImpl& node, const Array_<int>& faceIndices);
+    bool split(const OBBTreeNodeImpl& node, const Array_<int>& faceIndices,
+               Array_<int>& child1Indices, Array_<int>& child2Indices);
+
+    const Impl&             mesh;
+    TaskScheduler*          scheduler;
+    Array_<BuildScratch>    scratch;
+};
+
+void ContactGeometry::TriangleMesh::Impl::ObbTreeBuilder::build
+   (OBBTreeNodeImpl& node, const Array_<int>& faceIndices) 
+{   node.numTriangles = faceIndices.size();
+    fitBox(node, faceIndices);
+
+    Array_<int> child1Indices, child2Indices;
+    if (faceIndices.size() <= 3 
+        || !split(node, faceIndices, child1Indices, child2Indices)) {
+        // This is a leaf node.
+        node.triangles.insert(node.triangles.begin(), faceIndices.begin(), 
+                              faceIndices.end());
+        return;
+    }
+
+    node.child1 = new OBBTreeNodeImpl();
+    node.child2 = new OBBTreeNodeImpl();
+    if (scheduler && (int)faceIndices.size() >= ParallelGrain) {
+        BuildTask task(*this, *node.child1, child1Indices);
+        TaskScheduler::TaskGroup group(*scheduler);
+        group.spawn(task);
+        build(*node.child2, child2Indices);
+        group.wait();
+    } else {
+        build(*node.child1, child1Indices);
+        build(*node.child2, child2Indices);
+    }
+}
+
+// Find the vertices of the node's faces, each one once, and fit the node's
+// box to them.
+void ContactGeometry::TriangleMesh::Impl::ObbTreeBuilder::fitBox
+   (OBBTreeNodeImpl& node, const Array_<int>& faceIndices) 
+{   BuildScratch& s = updScratch();
+    if (s.vertexMark.empty())
+        s.vertexMark.resize(mesh.vertices.size(), -1);
+    const int mark = s.currentMark++;
+
+    int numPoints = 0;
+    for (int i = 0; i < (int) faceIndices.size(); i++) 
+        for (int j = 0; j < 3; j++) {
+            const int v = mesh.faces[faceIndices[i]].vertices[j];
+            if (s.vertexMark[v] != mark) {
+                s.vertexMark[v] = mark;
+                ++numPoints;
+            }
+        }
+    s.points.resize(numPoints);
+    ++s.currentMark; // so each vertex is copied just once below
+    int index = 0;
+    for (int i = 0; i < (int) faceIndices.size(); i++) 
+        for (int j = 0; j < 3; j++) {
+            const int v = mesh.faces[faceIndices[i]].vertices[j];
+            if (s.vertexMark[v] != mark+1) {
+                s.vertexMark[v] = mark+1;
+                s.points[index++] = mesh.vertices[v].pos;
+            }
+        }
+    node.bounds = OrientedBoundingBox(s.points);
+}
+
+// Divide the faces between two children, returning false if they can't be
+// divided because their extents all have the same center.
+bool ContactGeometry::TriangleMesh::Impl::ObbTreeBuilder::split
+   (const OBBTreeNodeImpl& node, const Array_<int>& faceIndices,
+    Array_<int>& child1Indices, Array_<int>& child2Indices) 
+{   const Rotation& R = node.bounds.getTransform().R();
+    const int n = faceIndices.size();
+
+    // Find each face's extent in the box frame, and the range of their
+    // centers.
+    BuildScratch& s = updScratch();
+    s.bounds.resize(n);
+    Vec3 centerLow(Infinity), centerHigh(-Infinity);
+    for (int i = 0; i < n; i++) {
+        const int* v = mesh.faces[faceIndices[i]].vertices;
+        FaceBounds& b = s.bounds[i];
+        b.low = b.high = ~R*mesh.vertices[v[0]].pos;
+        for (int j = 1; j < 3; j++) {
+            const Vec3 p = ~R*mesh.vertices[v[j]].pos;
+            for (int k = 0; k < 3; k++) {
+                b.low[k] = std::min(b.low[k], p[k]);
+                b.high[k] = std::max(b.high[k], p[k]);
+            }
+        }
+        b.center = (b.low+b.high)/2;
+        for (int k = 0; k < 3; k++) {
+            centerLow[k] = std::min(centerLow[k], b.center[k]);
+            centerHigh[k] = std::max(centerHigh[k], b.center[k]);
+        }
+    }
+
+    // Find the cheapest boundary between bins along each axis. The cost of
+    // a child is half its surface area times its number of faces.
+    Real bestCost = Infinity;
+    int bestAxis = -1, bestBin = -1;
+    for (int axis = 0; axis < 3; axis++) {
+        const Real range = centerHigh[axis]-centerLow[axis];
+        if (!(range > 0))
+            continue;
+        const Real scale = NumBins*(1-SignificantReal)/range;
+        int  count[NumBins] = {0};
+        Vec3 low[NumBins], high[NumBins];
+        for (int k = 0; k < NumBins; k++) {
+            low[k] = Vec3(Infinity);
+            high[k] = Vec3(-Infinity);
+        }
+        for (int i = 0; i < n; i++) {
+            const FaceBounds& b = s.bounds[i];
+            const int k = std::min((int)((b.center[axis]-centerLow[axis])*scale),
+                                   (int)NumBins-1);
+            ++count[k];
+            for (int j = 0; j < 3; j++) {
+                low[k][j] = std::min(low[k][j], b.low[j]);
+                high[k][j] = std::max(high[k][j], b.high[j]);
+            }
+        }
+
+        // Sweep from the top down to get the cost of each upper child,
+        // then from the bottom up adding in the lower child.
+        Real upperCost[NumBins];
+        Vec3 boxLow(Infinity), boxHigh(-Infinity);
+        int  numUpper = 0;
+        for (int k = NumBins-1; k > 0; k--) {
+            numUpper += count[k];
+            for (int j = 0; j < 3; j++) {
+                boxLow[j] = std::min(boxLow[j], low[k][j]);
+                boxHigh[j] = std::max(boxHigh[j], high[k][j]);
+            }
+            const Vec3 size = boxHigh-boxLow;
+            upperCost[k] = numUpper == 0 ? Real(0) : numUpper*
+                (size[0]*size[1]+size[1]*size[2]+size[2]*size[0]);
+        }
+        boxLow = Vec3(Infinity); boxHigh = Vec3(-Infinity);
+        int numLower = 0;
+        for (int k = 0; k < NumBins-1; k++) {
+            numLower += count[k];
+            for (int j = 0; j < 3; j++) {
+                boxLow[j] = std::min(boxLow[j], low[k][j]);
+                boxHigh[j] = std::max(boxHigh[j], high[k][j]);
+            }
+            if (numLower == 0 || numLower == n)
+                continue;
+            const Vec3 size = boxHigh-boxLow;
+            const Real cost = upperCost[k+1] + numLower*
+                (size[0]*size[1]+size[1]*size[2]+size[2]*size[0]);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = k;
+            }
+        }
+    }
+    if (bestAxis < 0)
+        return false;
+
+    const Real scale = NumBins*(1-SignificantReal)
+                       / (centerHigh[bestAxis]-centerLow[bestAxis]);
+    for (int i = 0; i < n; i++) {
+        const int k = std::min((int)((s.bounds[i].center[bestAxis]
+                                      -centerLow[bestAxis])*scale),
+                               (int)NumBins-1);
+        if (k <= bestBin)
+            child1Indices.push_back(faceIndices[i]);
+        else
+            child2Indices.push_back(faceIndices[i]);
+    }
+    return true;
+}
+
+// Meshes with at least this many faces have their OBB trees built by 
+// several threads.
+static const int ParallelObbTreeBuildSize = 20000;
+
 void ContactGeometry::TriangleMesh::Impl::init
    (const Array_<Vec3>& vertexPositions, const Array_<int>& faceIndices) 
 {   SimTK_APIARGCHECK_ALWAYS(faceIndices.size()%3 == 0, 
@@ -530,7 +1142,14 @@ void ContactGeometry::TriangleMesh::Impl::init
     Array_<int> allFaces(faces.size());
     for (int i = 0; i < (int) allFaces.size(); i++)
         allFaces[i] = i;
-    createObbTree(obb, allFaces);
+    if (   (int)faces.size() >= ParallelObbTreeBuildSize 
+        && ParallelExecutor::getNumProcessors() > 1) {
+        TaskScheduler scheduler;
+        ObbTreeBuilder(*this, &scheduler).build(obb, allFaces);
+    } else
+        ObbTreeBuilder(*this, 0).build(obb, allFaces);
+    obb4.clear(); obb4Triangles.clear();
+    createObbTree4(obb);
     
     // Find the bounding sphere.
     Array_<const Vec3*> points(vertices.size());
@@ -541,118 +1160,61 @@ void ContactGeometry::TriangleMesh::Impl::init
     boundingSphereRadius = bnd.getRadius();
 }
 
-void ContactGeometry::TriangleMesh::Impl::createObbTree
-   (OBBTreeNodeImpl& node, const Array_<int>& faceIndices) 
-{   // Find all vertices in the node and build the OrientedBoundingBox.
-    node.numTriangles = faceIndices.size();
-    set<int> vertexIndices;
-    for (int i = 0; i < (int) faceIndices.size(); i++) 
-        for (int j = 0; j < 3; j++)
-            vertexIndices.insert(faces[faceIndices[i]].vertices[j]);
-    Vector_<Vec3> points((int)vertexIndices.size());
-    int index = 0;
-    for (set<int>::iterator iter = vertexIndices.begin(); 
-                            iter != vertexIndices.end(); ++iter)
-        points[index++] = vertices[*iter].pos;
-    node.bounds = OrientedBoundingBox(points);
-    if (faceIndices.size() > 3) {
-
-        // Order the axes by size.
-
-        int axisOrder[3];
-        const Vec3& size = node.bounds.getSize();
-        if (size[0] > size[1]) {
-            if (size[0] > size[2]) {
-                axisOrder[0] = 0;
-                if (size[1] > size[2]) {
-                    axisOrder[1] = 1;
-                    axisOrder[2] = 2;
-                }
-                else {
-                    axisOrder[1] = 2;
-                    axisOrder[2] = 1;
-                }
-            }
-            else {
-                axisOrder[0] = 2;
-                axisOrder[1] = 0;
-                axisOrder[2] = 1;
-            }
-        }
-        else if (size[0] > size[2]) {
-            axisOrder[0] = 1;
-            axisOrder[1] = 0;
-            axisOrder[2] = 2;
-        }
-        else {
-            if (size[1] > size[2]) {
-                axisOrder[0] = 1;
-                axisOrder[1] = 2;
-            }
-            else {
-                axisOrder[0] = 2;
-                axisOrder[1] = 1;
-            }
-            axisOrder[2] = 0;
-        }
-
-        // Try splitting along each axis.
-
-        for (int i = 0; i < 3; i++) {
-            Array_<int> child1Indices, child2Indices;
-            splitObbAxis(faceIndices, child1Indices, child2Indices, 
-                         axisOrder[i]);
-            if (child1Indices.size() > 0 && child2Indices.size() > 0) {
-                // It was successfully split, so create the child nodes.
+// Add a four-way node for this binary node, whose children are its 
+// grandchildren (or its children, where those are leaves), and return its
+// index.
+int ContactGeometry::TriangleMesh::Impl::createObbTree4
+   (const OBBTreeNodeImpl& node) 
+{   const int index = obb4.size();
+    obb4.push_back(OBBTree4Node());
+    {   OBBTree4Node& node4 = obb4[index];
+        const Transform& X = node.bounds.getTransform();
+        node4.halfSize = node.bounds.getSize()/2;
+        node4.center = X*node4.halfSize;
+        node4.axes = X.R().asMat33();
+        node4.volume = 8*node4.halfSize[0]*node4.halfSize[1]*node4.halfSize[2];
+        node4.numChildren = 0;
+        node4.firstTriangle = obb4Triangles.size();
+        node4.numTriangles = 0;
+    }
+    if (node.child1 == NULL) {
+        obb4Triangles.insert(obb4Triangles.end(), node.triangles.begin(),
+                             node.triangles.end());
+        obb4[index].numTriangles = node.triangles.size();
+        return index;
+    }
 
-                node.child1 = new OBBTreeNodeImpl();
-                node.child2 = new OBBTreeNodeImpl();
-                createObbTree(*node.child1, child1Indices);
-                createObbTree(*node.child2, child2Indices);
-                return;
-            }
+    const OBBTreeNodeImpl* binaryChildren[2] = {node.child1, node.child2};
+    const OBBTreeNodeImpl* children[4];
+    int numChildren = 0;
+    for (int c=0; c < 2; ++c) {
+        const OBBTreeNodeImpl& child = *binaryChildren[c];
+        if (child.child1 == NULL)
+            children[numChildren++] = &child;
+        else {
+            children[numChildren++] = child.child1;
+            children[numChildren++] = child.child2;
         }
     }
-    
-    // This is a leaf node.
-    
-    node.triangles.insert(node.triangles.begin(), faceIndices.begin(), 
-                          faceIndices.end());
-}
 
-void ContactGeometry::TriangleMesh::Impl::splitObbAxis
-   (const Array_<int>& parentIndices, Array_<int>& child1Indices, 
-    Array_<int>& child2Indices, int axis) 
-{   // For each face, find its minimum and maximum extent along the axis.
-    Vector minExtent(parentIndices.size());
-    Vector maxExtent(parentIndices.size());
-    for (int i = 0; i < (int) parentIndices.size(); i++) {
-        int* vertexIndices = faces[parentIndices[i]].vertices;
-        Real minVal = vertices[vertexIndices[0]].pos[axis];
-        Real maxVal = vertices[vertexIndices[0]].pos[axis];
-        minVal = std::min(minVal, vertices[vertexIndices[1]].pos[axis]);
-        maxVal = std::max(maxVal, vertices[vertexIndices[1]].pos[axis]);
-        minExtent[i] = std::min(minVal, vertices[vertexIndices[2]].pos[axis]);
-        maxExtent[i] = std::max(maxVal, vertices[vertexIndices[2]].pos[axis]);
-    }
-    
-    // Select a split point that tries to put as many faces as possible 
-    // entirely on one side or the other.
-    
-    Real split = (median(minExtent)+median(maxExtent)) / 2;
-    
-    // Choose a side for each face.
-    
-    for (int i = 0; i < (int) parentIndices.size(); i++) {
-        if (maxExtent[i] <= split)
-            child1Indices.push_back(parentIndices[i]);
-        else if (minExtent[i] >= split)
-            child2Indices.push_back(parentIndices[i]);
-        else if (0.5*(minExtent[i]+maxExtent[i]) <= split)
-            child1Indices.push_back(parentIndices[i]);
-        else
-            child2Indices.push_back(parentIndices[i]);
+    // Note that obb4 grows as the children are added.
+    int childIndex[4];
+    for (int k=0; k < numChildren; ++k)
+        childIndex[k] = createObbTree4(*children[k]);
+
+    OBBTree4Node& node4 = obb4[index];
+    node4.numChildren = numChildren;
+    for (int k=0; k < 4; ++k) {
+        const OBBTree4Node& child = obb4[childIndex[k < numChildren ? k : 0]];
+        node4.children[k] = childIndex[k < numChildren ? k : 0];
+        for (int i=0; i < 3; ++i) {
+            node4.childCenter[i][k] = child.center[i];
+            node4.childHalfSize[i][k] = child.halfSize[i];
+            for (int j=0; j < 3; ++j)
+                node4.childAxes[3*i+j][k] = child.axes(i,j);
+        }
     }
+    return index;
 }
 
 Vec3 ContactGeometry::TriangleMesh::Impl::findNearestPointToFace
@@ -805,21 +1367,30 @@ Vec3 OBBTreeNodeImpl::findNearestPoint
             (child1->bounds.findNearestPoint(position)-position).normSqr();
         Real child2BoundsDist2 = 
             (child2->bounds.findNearestPoint(position)-position).normSqr();
+        // Once one child has been searched, nothing in the other one can win
+        // unless it is within the tie tolerance of what was found, so that
+        // becomes the cutoff for searching the other child.
         if (child1BoundsDist2 < child2BoundsDist2) {
             if (child1BoundsDist2 < cutoff2) {
                 child1point = child1->findNearestPoint(mesh, position, cutoff2, child1distance2, child1face, child1uv);
-                if (child2BoundsDist2 < child1distance2 && child2BoundsDist2 < cutoff2)
-                    child2point = child2->findNearestPoint(mesh, position, cutoff2, child2distance2, child2face, child2uv);
+                const Real cutoff = std::min(cutoff2, child1distance2*(1+tol));
+                if (child2BoundsDist2 < child1distance2 && child2BoundsDist2 < cutoff)
+                    child2point = child2->findNearestPoint(mesh, position, cutoff, child2distance2, child2face, child2uv);
             }
         }
         else {
             if (child2BoundsDist2 < cutoff2) {
                 child2point = child2->findNearestPoint(mesh, position, cutoff2, child2distance2, child2face, child2uv);
-                if (child1BoundsDist2 < child2distance2 && child1BoundsDist2 < cutoff2)
-                    child1point = child1->findNearestPoint(mesh, position, cutoff2, child1distance2, child1face, child1uv);
+                const Real cutoff = std::min(cutoff2, child2distance2*(1+tol));
+                if (child1BoundsDist2 < child2distance2 && child1BoundsDist2 < cutoff)
+                    child1point = child1->findNearestPoint(mesh, position, cutoff, child1distance2, child1face, child1uv);
             }
         }
-        if (   child1distance2 <= child2distance2*(1+tol) 
+        // A child that was skipped, or had nothing within the cutoff, has
+        // no face to compare.
+        if (   child1distance2 != MostPositiveReal 
+            && child2distance2 != MostPositiveReal
+            && child1distance2 <= child2distance2*(1+tol) 
             && child2distance2 <= child1distance2*(1+tol)) {
             // Decide based on angle which one to use.
             
@@ -985,6 +1556,117 @@ intersectsRay(const ContactGeometry::TriangleMesh::Impl& mesh,
 
 
 
+//==============================================================================
+//                            OBB TREE 4 NODE
+//==============================================================================
+
+// Test box A against four boxes B[k] using the separating axis test of
+// Gottschalk, Lin and Manocha (see OrientedBoundingBox::intersectsBox()).
+// The boxes B are packed component by component and every test is done for
+// all four at once; the loops over k have no branches so the compiler can
+// turn them into SIMD instructions. A small tolerance is added to the 
+// rotation terms to deal with nearly parallel edges, so a pair of boxes that
+// just touch is never reported as disjoint.
+static void findBoxOverlaps4
+   (const Vec3& cA, const Mat33& A, const Vec3& a,
+    const Real cB[3][4], const Real B[9][4], const Real b[3][4],
+    bool overlaps[4])
+{
+    const Real eps = SignificantReal;
+
+    // R[i][j][k] = A_i . B_j for box k; t[i][k] is the center offset along A_i.
+    Real R[3][3][4], absR[3][3][4], t[3][4];
+    for (int i=0; i < 3; ++i) {
+        for (int j=0; j < 3; ++j)
+            for (int k=0; k < 4; ++k) {
+                R[i][j][k] = A(0,i)*B[j][k] + A(1,i)*B[3+j][k] 
+                             + A(2,i)*B[6+j][k];
+                absR[i][j][k] = std::abs(R[i][j][k]) + eps;
+            }
+        for (int k=0; k < 4; ++k)
+            t[i][k] = A(0,i)*(cB[0][k]-cA[0]) + A(1,i)*(cB[1][k]-cA[1]) 
+                      + A(2,i)*(cB[2][k]-cA[2]);
+    }
+
+    int separated[4] = {0,0,0,0};
+
+    // The axes of A.
+    for (int i=0; i < 3; ++i)
+        for (int k=0; k < 4; ++k) {
+            const Real rb = b[0][k]*absR[i][0][k] + b[1][k]*absR[i][1][k]
+                            + b[2][k]*absR[i][2][k];
+            separated[k] |= std::abs(t[i][k]) > a[i] + rb;
+        }
+
+    // The axes of B.
+    for (int j=0; j < 3; ++j)
+        for (int k=0; k < 4; ++k) {
+            const Real ra = a[0]*absR[0][j][k] + a[1]*absR[1][j][k]
+                            + a[2]*absR[2][j][k];
+            const Real d = t[0][k]*R[0][j][k] + t[1][k]*R[1][j][k] 
+                           + t[2][k]*R[2][j][k];
+            separated[k] |= std::abs(d) > ra + b[j][k];
+        }
+
+    // The nine cross products A_i x B_j.
+    for (int i=0; i < 3; ++i) {
+        const int i1 = (i+1)%3, i2 = (i+2)%3;
+        for (int j=0; j < 3; ++j) {
+            const int j1 = (j+1)%3, j2 = (j+2)%3;
+            for (int k=0; k < 4; ++k) {
+                const Real ra = a[i1]*absR[i2][j][k] + a[i2]*absR[i1][j][k];
+                const Real rb = b[j1][k]*absR[i][j2][k] 
+                                + b[j2][k]*absR[i][j1][k];
+                const Real d = t[i2][k]*R[i1][j][k] - t[i1][k]*R[i2][j][k];
+                separated[k] |= std::abs(d) > ra + rb;
+            }
+        }
+    }
+
+    for (int k=0; k < 4; ++k)
+        overlaps[k] = !separated[k];
+}
+
+void OBBTree4Node::findChildOverlaps
+   (const Vec3& center, const Mat33& axes, const Vec3& halfSize, 
+    bool overlaps[4]) const 
+{   findBoxOverlaps4(center, axes, halfSize, 
+                     childCenter, childAxes, childHalfSize, overlaps); }
+
+// Like findBoxOverlaps4(), this works on all four children at once.
+void OBBTree4Node::findChildDistances2
+   (const Vec3& point, Real distance2[4]) const 
+{   for (int k=0; k < 4; ++k)
+        distance2[k] = 0;
+    for (int i=0; i < 3; ++i)
+        for (int k=0; k < 4; ++k) {
+            // Axis i of child k is column i of its rotation.
+            const Real d = childAxes[i][k]*(point[0]-childCenter[0][k])
+                         + childAxes[3+i][k]*(point[1]-childCenter[1][k])
+                         + childAxes[6+i][k]*(point[2]-childCenter[2][k]);
+            const Real excess = std::max(std::abs(d)-childHalfSize[i][k], 
+                                         Real(0));
+            distance2[k] += excess*excess;
+        }
+}
+
+bool OBBTree4Node::overlapsBox
+   (const Vec3& center, const Mat33& axes, const Vec3& halfSize) const 
+{   Real c[3][4], r[9][4], h[3][4];
+    for (int k=0; k < 4; ++k)
+        for (int i=0; i < 3; ++i) {
+            c[i][k] = this->center[i];
+            h[i][k] = this->halfSize[i];
+            for (int j=0; j < 3; ++j)
+                r[3*i+j][k] = this->axes(i,j);
+        }
+    bool overlaps[4];
+    findBoxOverlaps4(center, axes, halfSize, c, r, h, overlaps);
+    return overlaps[0];
+}
+
+
+
 //==============================================================================
 //            CONTACT GEOMETRY :: TRIANGLE MESH :: OBB TREE NODE
 //==============================================================================
@@ -26,6 +26,7 @@
 
 #include "simmath/internal/common.h"
 #include "simmath/internal/Contact.h"
+#include "simmath/internal/ContactGeometry.h"
 
 namespace SimTK {
 
@@ -219,6 +220,14 @@ public:
         return tid;
     }
 
+    // Where the mesh-mesh tracker stopped descending the two meshes' OBB
+    // trees, as pairs of (mesh 1, mesh 2) node indices; the next step starts
+    // from here. The meshes are recorded so that a front is never used with
+    // different ones.
+    Array_<std::pair<int,int> >                 front;
+    const ContactGeometry::TriangleMesh::Impl*  frontMesh1;
+    const ContactGeometry::TriangleMesh::Impl*  frontMesh2;
+
 private:
 friend class TriangleMeshContact;
 
@@ -23,6 +23,9 @@
 
 #include "SimTKmath.h"
 
+#include "ContactGeometryImpl.h"
+#include "ContactImpl.h"
+
 #include <algorithm>
 using std::pair; using std::make_pair;
 #include <iostream>
@@ -1069,6 +1072,311 @@ bool ContactTracker::SphereTriangleMesh::initializeContact
 //==============================================================================
 //               TRIANGLE MESH - TRIANGLE MESH CONTACT TRACKER
 //==============================================================================
+namespace {
+
+typedef std::pair<int,int> NodePair; // (mesh 1 node, mesh 2 node)
+
+// A node pair above the previous front whose children are being visited;
+// see MeshMeshTraversal::visit().
+struct VisitFrame {
+    NodePair    pair;
+    int         side, numChildren, next; // next child to visit
+    bool        tested, allDisjoint;
+    bool        ov[4];  // children's overlaps, once tested
+};
+
+// The front where a walk stopped for a pair of meshes that were found not to
+// be touching. The meshes are only compared, never dereferenced.
+struct SavedFront {
+    SavedFront() : mesh1(0), mesh2(0) {}
+    const void*         mesh1;
+    const void*         mesh2;
+    Array_<NodePair>    front;
+};
+
+// Work arrays for TriangleMeshTriangleMesh::trackContact(). A tracker may be
+// used by several threads at once so each thread has its own set, which keeps
+// its heap space from one call to the next.
+struct MeshMeshScratch {
+    enum {NumSavedFronts = 8};
+    MeshMeshScratch() : nextSaved(0) {}
+    Array_<NodePair>        front, leafPairs;
+    Array_<std::pair<NodePair,bool> > descendStack;
+    Array_<VisitFrame>      visitStack;
+    Array_<int>             boundaryFaces1, boundaryFaces2;
+    Array_<int>             faceType1, faceType2;
+    // Second leaf's triangles in M1, and their bounding boxes.
+    Array_<Geo::Triangle>   tri2;
+    Array_<Vec3>            lower2, upper2;
+    // Fronts of recently separated mesh pairs, reused round robin.
+    SavedFront              saved[NumSavedFronts];
+    int                     nextSaved;
+};
+
+ThreadLocal<MeshMeshScratch> meshMeshScratch;
+
+// This walks two meshes' four-way OBB trees together looking for pairs of
+// leaves whose boxes overlap, then checks their triangles. The node pairs
+// form a tree of their own: a pair's children come from descending the node
+// with the bigger box (or the one that isn't a leaf), which depends only on
+// the trees, not on where the meshes are. The pairs where the descent 
+// stopped, because their boxes were disjoint or both nodes were leaves, make
+// up a "front" across that tree, kept in depth first order.
+//
+// Starting from the previous front instead of the roots saves testing the 
+// pairs above it, which overlapped last time and most likely still do.
+// Previous front pairs are tested directly and descended from if they now
+// overlap; a group of siblings that are all disjoint is merged back into
+// their parent pair if that is disjoint too. Whatever the previous front
+// was, the pairs found are the same as from the roots; the previous front is
+// only compared against, so even one from some other pair of meshes is safe.
+//
+// The new front and the leaf pairs are left in the scratch arrays, and both
+// walks use explicit stacks there rather than recursion.
+class MeshMeshTraversal {
+public:
+    MeshMeshTraversal(const ContactGeometry::TriangleMesh::Impl& mesh1,
+                      const ContactGeometry::TriangleMesh::Impl& mesh2,
+                      const Transform&                           X_M1M2,
+                      MeshMeshScratch&                           scratch)
+    :   tree1(mesh1.getOBBTree4()), tree2(mesh2.getOBBTree4()), 
+        X_M1M2(X_M1M2), X_M2M1(~X_M1M2), prevFront(0), pos(0), 
+        front(scratch.front), leafPairs(scratch.leafPairs), 
+        stack(scratch.descendStack), frames(scratch.visitStack)
+    {   front.clear(); leafPairs.clear(); }
+
+    void findFromRoots() {
+        const NodePair root(0,0);
+        settle(root, overlaps(root));
+    }
+
+    void findFromFront(const Array_<NodePair>& previous) {
+        prevFront = &previous; pos = 0;
+        visit(NodePair(0,0));
+        prevFront = 0;
+    }
+
+private:
+    // 1 to descend mesh 1's node, 2 for mesh 2's, 0 if both are leaves.
+    int getDescentSide(const NodePair& p) const {
+        const OBBTree4Node& n1 = tree1[p.first];
+        const OBBTree4Node& n2 = tree2[p.second];
+        if (!n1.isLeaf() && (n2.isLeaf() || n1.volume >= n2.volume))
+            return 1;
+        return n2.isLeaf() ? 0 : 2;
+    }
+    int getNumChildren(const NodePair& p, int side) const {
+        return side == 1 ? tree1[p.first].numChildren 
+                         : tree2[p.second].numChildren;
+    }
+    NodePair getChild(const NodePair& p, int side, int k) const {
+        return side == 1 ? NodePair(tree1[p.first].children[k], p.second)
+                         : NodePair(p.first, tree2[p.second].children[k]);
+    }
+
+    // Test all the children on one side against the node on the other side,
+    // with the latter's box moved into the former's mesh frame.
+    void findChildOverlaps(const NodePair& p, int side, bool ov[4]) const {
+        if (side == 1) {
+            const OBBTree4Node& other = tree2[p.second];
+            tree1[p.first].findChildOverlaps(X_M1M2*other.center, 
+                X_M1M2.R().asMat33()*other.axes, other.halfSize, ov);
+        } else {
+            const OBBTree4Node& other = tree1[p.first];
+            tree2[p.second].findChildOverlaps(X_M2M1*other.center, 
+                X_M2M1.R().asMat33()*other.axes, other.halfSize, ov);
+        }
+    }
+    bool overlaps(const NodePair& p) const {
+        const OBBTree4Node& other = tree2[p.second];
+        return tree1[p.first].overlapsBox(X_M1M2*other.center,
+            X_M1M2.R().asMat33()*other.axes, other.halfSize);
+    }
+
+    // Put a pair whose overlap is known on the front, descending from it if
+    // it overlaps. Return true if it was disjoint.
+    bool settle(const NodePair& p, bool overlapping) {
+        if (!overlapping) {front.push_back(p); return true;}
+        descend(p);
+        return false;
+    }
+
+    // Descend from an overlapping pair, depth first, using an explicit stack
+    // of pairs whose overlap has already been determined.
+    void descend(const NodePair& p) {
+        stack.clear();
+        stack.push_back(std::make_pair(p, true));
+        while (!stack.empty()) {
+            const NodePair q = stack.back().first;
+            const bool overlapping = stack.back().second;
+            stack.pop_back();
+            if (!overlapping) {front.push_back(q); continue;}
+            const int side = getDescentSide(q);
+            if (side == 0) {
+                front.push_back(q); 
+                leafPairs.push_back(q); 
+                continue;
+            }
+            bool ov[4];
+            findChildOverlaps(q, side, ov);
+            for (int k = getNumChildren(q, side)-1; k >= 0; --k)
+                stack.push_back(std::make_pair(getChild(q, side, k), ov[k]));
+        }
+    }
+
+    bool isOnPrevFront(const NodePair& p) const {
+        return pos == (int)prevFront->size() || (*prevFront)[pos] == p
+               || getDescentSide(p) == 0;
+    }
+
+    // Step past p on the previous front if it is the next entry there.
+    void passPrevFront(const NodePair& p) {
+        if (pos < (int)prevFront->size() && (*prevFront)[pos] == p) ++pos;
+    }
+
+    void pushFrame(const NodePair& p) {
+        VisitFrame frame;
+        frame.pair = p;
+        frame.side = getDescentSide(p);
+        frame.numChildren = getNumChildren(p, frame.side);
+        frame.next = 0;
+        frame.tested = false;
+        frame.allDisjoint = true;
+        frames.push_back(frame);
+    }
+
+    // Handle the pairs from the previous front's tree, starting with the
+    // root pair p. Pairs above the previous front are kept on a stack while
+    // their children are visited in order. Those children that are on the
+    // previous front are tested together. Once all of a pair's children are
+    // done, they are merged back into it if they and it are disjoint.
+    void visit(const NodePair& p) {
+        if (isOnPrevFront(p)) {
+            passPrevFront(p);
+            settle(p, overlaps(p));
+            return;
+        }
+        frames.clear();
+        pushFrame(p);
+        while (!frames.empty()) {
+            VisitFrame& frame = frames.back();
+            if (frame.next < frame.numChildren) {
+                const NodePair child = 
+                    getChild(frame.pair, frame.side, frame.next);
+                if (!isOnPrevFront(child)) {
+                    pushFrame(child); // frame is invalid now
+                    continue;
+                }
+                passPrevFront(child);
+                if (!frame.tested) {
+                    findChildOverlaps(frame.pair, frame.side, frame.ov); 
+                    frame.tested = true;
+                }
+                const bool disjoint = settle(child, frame.ov[frame.next]);
+                frame.allDisjoint = frame.allDisjoint && disjoint;
+                ++frame.next;
+                continue;
+            }
+
+            // All the children are done.
+            bool disjoint = false;
+            if (frame.allDisjoint && !overlaps(frame.pair)) {
+                front.resize(front.size()-frame.numChildren);
+                front.push_back(frame.pair);
+                disjoint = true;
+            }
+            frames.pop_back();
+            if (!frames.empty()) {
+                VisitFrame& parent = frames.back();
+                parent.allDisjoint = parent.allDisjoint && disjoint;
+                ++parent.next;
+            }
+        }
+    }
+
+    const Array_<OBBTree4Node>&         tree1;
+    const Array_<OBBTree4Node>&         tree2;
+    const Transform                     X_M1M2, X_M2M1;
+    const Array_<NodePair>*             prevFront;
+    int                                 pos; // next unvisited entry
+    Array_<NodePair>&                   front;
+    Array_<NodePair>&                   leafPairs;
+    Array_<std::pair<NodePair,bool> >&  stack;
+    Array_<VisitFrame>&                 frames;
+};
+
+// Find the faces of each mesh that intersect a face of the other, given the
+// pairs of leaves whose boxes overlap. A cheap comparison of the triangles'
+// axis aligned boxes in M1 rules out most pairs before the exact test.
+// The face lists may contain duplicates; they are replaced, not appended to.
+void findIntersectingFaces
+   (const ContactGeometry::TriangleMesh&        mesh1,
+    const ContactGeometry::TriangleMesh&        mesh2,
+    const Transform&                            X_M1M2,
+    const Array_<NodePair>&                     leafPairs,
+    MeshMeshScratch&                            scratch,
+    Array_<int>&                                faces1,
+    Array_<int>&                                faces2)
+{
+    const ContactGeometry::TriangleMesh::Impl& impl1 = mesh1.getImpl();
+    const ContactGeometry::TriangleMesh::Impl& impl2 = mesh2.getImpl();
+    const Array_<OBBTree4Node>& tree1 = impl1.getOBBTree4();
+    const Array_<OBBTree4Node>& tree2 = impl2.getOBBTree4();
+    const Array_<int>& triangles1 = impl1.getOBBTree4Triangles();
+    const Array_<int>& triangles2 = impl2.getOBBTree4Triangles();
+
+    Array_<Geo::Triangle>& tri2 = scratch.tri2;
+    Array_<Vec3>& lower2 = scratch.lower2;
+    Array_<Vec3>& upper2 = scratch.upper2;
+    faces1.clear(); faces2.clear();
+    for (int p=0; p < (int)leafPairs.size(); ++p) {
+        const OBBTree4Node& leaf1 = tree1[leafPairs[p].first];
+        const OBBTree4Node& leaf2 = tree2[leafPairs[p].second];
+
+        // Move the second leaf's triangles into M1.
+        tri2.resize(leaf2.numTriangles);
+        lower2.resize(leaf2.numTriangles); upper2.resize(leaf2.numTriangles);
+        for (int t=0; t < leaf2.numTriangles; ++t) {
+            const int face2 = triangles2[leaf2.firstTriangle+t];
+            for (int v=0; v < 3; ++v)
+                tri2[t][v] = X_M1M2*mesh2.getVertexPosition
+                                        (mesh2.getFaceVertex(face2, v));
+            lower2[t] = upper2[t] = tri2[t][0];
+            for (int v=1; v < 3; ++v)
+                for (int i=0; i < 3; ++i) {
+                    lower2[t][i] = std::min(lower2[t][i], tri2[t][v][i]);
+                    upper2[t][i] = std::max(upper2[t][i], tri2[t][v][i]);
+                }
+        }
+
+        for (int s=0; s < leaf1.numTriangles; ++s) {
+            const int face1 = triangles1[leaf1.firstTriangle+s];
+            const Geo::Triangle tri1
+               (mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 0)),
+                mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 1)),
+                mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 2)));
+            Vec3 lower1 = tri1[0], upper1 = tri1[0];
+            for (int v=1; v < 3; ++v)
+                for (int i=0; i < 3; ++i) {
+                    lower1[i] = std::min(lower1[i], tri1[v][i]);
+                    upper1[i] = std::max(upper1[i], tri1[v][i]);
+                }
+            for (int t=0; t < leaf2.numTriangles; ++t) {
+                if (   lower1[0] > upper2[t][0] || lower2[t][0] > upper1[0]
+                    || lower1[1] > upper2[t][1] || lower2[t][1] > upper1[1]
+                    || lower1[2] > upper2[t][2] || lower2[t][2] > upper1[2])
+                    continue;
+                if (tri2[t].overlapsTriangle(tri1)) {
+                    faces1.push_back(face1);
+                    faces2.push_back(triangles2[leaf2.firstTriangle+t]);
+                }
+            }
+        }
+    }
+}
+
+}
+
 // Cost is TODO
 bool ContactTracker::TriangleMeshTriangleMesh::trackContact
    (const Contact&         priorStatus,
@@ -1096,108 +1404,83 @@ bool ContactTracker::TriangleMeshTriangleMesh::trackContact
 
     // Transform giving mesh2 (M2) frame in the mesh1 (M1) frame.
     const Transform X_M1M2 = ~X_GM1*X_GM2; 
-    std::set<int> insideFaces1, insideFaces2;
-
-    // Get M2's bounding box in M1's frame.
-    const OrientedBoundingBox 
-        mesh2Bounds_M1 = X_M1M2*mesh2.getOBBTreeNode().getBounds();
+    MeshMeshScratch& scratch = meshMeshScratch.upd();
+    // These are flat lists that may contain duplicates.
+    Array_<int>& boundaryFaces1 = scratch.boundaryFaces1;
+    Array_<int>& boundaryFaces2 = scratch.boundaryFaces2;
+
+    // Find the pairs of OBB tree leaves whose boxes overlap, starting from
+    // where we left off last time if the prior status came from here, or
+    // else from where this thread last saw these meshes separate.
+    const ContactGeometry::TriangleMesh::Impl& impl1 = mesh1.getImpl();
+    const ContactGeometry::TriangleMesh::Impl& impl2 = mesh2.getImpl();
+    MeshMeshTraversal traversal(impl1, impl2, X_M1M2, scratch);
+    const TriangleMeshContactImpl* prior = 
+        TriangleMeshContact::isInstance(priorStatus)
+        ? &static_cast<const TriangleMeshContactImpl&>(priorStatus.getImpl())
+        : 0;
+    SavedFront* saved = 0;
+    for (int i=0; i < MeshMeshScratch::NumSavedFronts; ++i)
+        if (   scratch.saved[i].mesh1 == &impl1 
+            && scratch.saved[i].mesh2 == &impl2)
+            saved = &scratch.saved[i];
+    if (prior && prior->frontMesh1 == &impl1 && prior->frontMesh2 == &impl2)
+        traversal.findFromFront(prior->front);
+    else if (saved)
+        traversal.findFromFront(saved->front);
+    else
+        traversal.findFromRoots();
 
     // Find the faces that are actually intersecting faces on the other
     // surface (this doesn't yet include faces that may be completely buried).
-    findIntersectingFaces(mesh1, mesh2, 
-                          mesh1.getOBBTreeNode(), mesh2.getOBBTreeNode(), 
-                          mesh2Bounds_M1, X_M1M2, insideFaces1, insideFaces2);
+    findIntersectingFaces(mesh1, mesh2, X_M1M2, scratch.leafPairs, scratch,
+                          boundaryFaces1, boundaryFaces2);
     
     // It should never be the case that one set of faces is empty and the
     // other isn't, however it is conceivable that roundoff error could cause
     // this to happen so we'll check both lists.
-    if (insideFaces1.empty() && insideFaces2.empty()) {
-        currentStatus.clear(); // not touching
+    if (boundaryFaces1.empty() && boundaryFaces2.empty()) {
+        // Not touching. There's no Contact to keep the front on, so save it
+        // here for the next time these meshes are checked.
+        if (!saved) {
+            saved = &scratch.saved[scratch.nextSaved];
+            scratch.nextSaved = 
+                (scratch.nextSaved+1) % MeshMeshScratch::NumSavedFronts;
+            saved->mesh1 = &impl1;
+            saved->mesh2 = &impl2;
+        }
+        saved->front.swap(scratch.front);
+        currentStatus.clear();
         return true; // successful return
     }
     
     // There was an intersection. We now need to identify every triangle and 
     // vertex of each mesh that is inside the other mesh. We found the border
-    // intersections above; now we have to fill in the buried faces.
-    findBuriedFaces(mesh1, mesh2, ~X_M1M2, insideFaces1);
-    findBuriedFaces(mesh2, mesh1,  X_M1M2, insideFaces2);
+    // intersections above; now we have to fill in the buried faces. Each
+    // face is classified in a flat array, and the face sets needed by
+    // TriangleMeshContact are then built in order, one face at a time.
+    Array_<int>& faceType1 = scratch.faceType1;
+    Array_<int>& faceType2 = scratch.faceType2;
+    findBuriedFaces(mesh1, mesh2, ~X_M1M2, boundaryFaces1, faceType1);
+    findBuriedFaces(mesh2, mesh1,  X_M1M2, boundaryFaces2, faceType2);
+    std::set<int> insideFaces1, insideFaces2;
+    for (int i = 0; i < (int)faceType1.size(); ++i)
+        if (faceType1[i] > 0) insideFaces1.insert(insideFaces1.end(), i);
+    for (int i = 0; i < (int)faceType2.size(); ++i)
+        if (faceType2[i] > 0) insideFaces2.insert(insideFaces2.end(), i);
 
     currentStatus = TriangleMeshContact(priorStatus.getSurface1(), 
                                         priorStatus.getSurface2(), 
                                         X_M1M2, 
                                         insideFaces1, insideFaces2);
+    TriangleMeshContactImpl& current = 
+        static_cast<TriangleMeshContactImpl&>(currentStatus.updImpl());
+    current.front = scratch.front;
+    current.frontMesh1 = &impl1;
+    current.frontMesh2 = &impl2;
     return true; // success
 }
 
-void ContactTracker::TriangleMeshTriangleMesh::
-findIntersectingFaces
-   (const ContactGeometry::TriangleMesh&                mesh1, 
-    const ContactGeometry::TriangleMesh&                mesh2,
-    const ContactGeometry::TriangleMesh::OBBTreeNode&   node1, 
-    const ContactGeometry::TriangleMesh::OBBTreeNode&   node2, 
-    const OrientedBoundingBox&                          node2Bounds_M1,
-    const Transform&                                    X_M1M2, 
-    std::set<int>&                                      triangles1, 
-    std::set<int>&                                      triangles2) const 
-{   // See if the bounding boxes intersect.
-    
-    if (!node1.getBounds().intersectsBox(node2Bounds_M1))
-        return;
-    
-    // If either node is not a leaf node, process the children recursively.
-    
-    if (!node1.isLeafNode()) {
-        if (!node2.isLeafNode()) {
-            const OrientedBoundingBox firstChildBounds = 
-                X_M1M2*node2.getFirstChildNode().getBounds();
-            const OrientedBoundingBox secondChildBounds = 
-                X_M1M2*node2.getSecondChildNode().getBounds();
-            findIntersectingFaces(mesh1, mesh2, node1.getFirstChildNode(), node2.getFirstChildNode(), firstChildBounds, X_M1M2, triangles1, triangles2);
-            findIntersectingFaces(mesh1, mesh2, node1.getFirstChildNode(), node2.getSecondChildNode(), secondChildBounds, X_M1M2, triangles1, triangles2);
-            findIntersectingFaces(mesh1, mesh2, node1.getSecondChildNode(), node2.getFirstChildNode(), firstChildBounds, X_M1M2, triangles1, triangles2);
-            findIntersectingFaces(mesh1, mesh2, node1.getSecondChildNode(), node2.getSecondChildNode(), secondChildBounds, X_M1M2, triangles1, triangles2);
-        }
-        else {
-            findIntersectingFaces(mesh1, mesh2, node1.getFirstChildNode(), node2, node2Bounds_M1, X_M1M2, triangles1, triangles2);
-            findIntersectingFaces(mesh1, mesh2, node1.getSecondChildNode(), node2, node2Bounds_M1, X_M1M2, triangles1, triangles2);
-        }
-        return;
-    }
-    else if (!node2.isLeafNode()) {
-        const OrientedBoundingBox firstChildBounds = 
-            X_M1M2*node2.getFirstChildNode().getBounds();
-        const OrientedBoundingBox secondChildBounds = 
-            X_M1M2*node2.getSecondChildNode().getBounds();
-        findIntersectingFaces(mesh1, mesh2, node1, node2.getFirstChildNode(), firstChildBounds, X_M1M2, triangles1, triangles2);
-        findIntersectingFaces(mesh1, mesh2, node1, node2.getSecondChildNode(), secondChildBounds, X_M1M2, triangles1, triangles2);
-        return;
-    }
-    
-    // These are both leaf nodes, so check triangles for intersections.
-    
-    const Array_<int>& node1triangles = node1.getTriangles();
-    const Array_<int>& node2triangles = node2.getTriangles();
-    for (unsigned i = 0; i < node2triangles.size(); i++) {
-        const int face2 = node2triangles[i];
-        Vec3 a1 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 0));
-        Vec3 a2 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 1));
-        Vec3 a3 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 2));
-        const Geo::Triangle A(a1,a2,a3);
-        for (unsigned j = 0; j < node1triangles.size(); j++) {
-            const int face1 = node1triangles[j];
-            const Vec3& b1 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 0));
-            const Vec3& b2 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 1));
-            const Vec3& b3 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 2));
-            const Geo::Triangle B(b1,b2,b3);
-            if (A.overlapsTriangle(B)) 
-            {   // The triangles intersect.
-                triangles1.insert(face1);
-                triangles2.insert(face2);
-            }
-        }
-    }
-}
-
 static const int Outside  = -1;
 static const int Unknown  =  0;
 static const int Boundary =  1;
@@ -1207,15 +1490,17 @@ void ContactTracker::TriangleMeshTriangleMesh::
 findBuriedFaces(const ContactGeometry::TriangleMesh&    mesh,       // M 
                 const ContactGeometry::TriangleMesh&    otherMesh,  // O
                 const Transform&                        X_OM, 
-                std::set<int>&                          insideFaces) const 
+                const Array_<int>&                      boundaryFaces,
+                Array_<int>&                            faceType) const 
 {  
-    // Find which faces are inside.
+    // Find which faces are inside; on return faceType is positive for
+    // those (Boundary or Inside) and negative for the rest.
     // We're passed in the list of Boundary faces, that is, those faces of
     // "mesh" that intersect faces of "otherMesh".
-    Array_<int> faceType(mesh.getNumFaces(), Unknown);
-    for (std::set<int>::iterator iter = insideFaces.begin(); 
-                                 iter != insideFaces.end(); ++iter)
-        faceType[*iter] = Boundary;
+    faceType.resize(mesh.getNumFaces()); // keeps any extra capacity
+    faceType.fill(Unknown);
+    for (int i = 0; i < (int)boundaryFaces.size(); i++)
+        faceType[boundaryFaces[i]] = Boundary;
 
     for (int i = 0; i < (int) faceType.size(); i++) {
         if (faceType[i] == Unknown) {
@@ -1228,14 +1513,12 @@ findBuriedFaces(const ContactGeometry::TriangleMesh&    mesh,       // M
             if (   otherMesh.intersectsRay(origin_O, direction_O, distance, 
                                            face, uv) 
                 && ~direction_O*otherMesh.getFaceNormal(face) > 0) 
-            {
                 faceType[i] = Inside;
-                insideFaces.insert(i);
-            } else
+            else
                 faceType[i] = Outside;
             
             // Recursively mark adjacent inside or outside Faces.           
-            tagFaces(mesh, faceType, insideFaces, i, 0);
+            tagFaces(mesh, faceType, i, 0);
         }
     }
 }
@@ -1250,7 +1533,6 @@ static const int MaxRecursionDepth = 500;
 void ContactTracker::TriangleMeshTriangleMesh::
 tagFaces(const ContactGeometry::TriangleMesh&   mesh, 
          Array_<int>&                           faceType,
-         std::set<int>&                         triangles, 
          int                                    index,
          int                                    depth) const 
 {
@@ -1261,10 +1543,8 @@ tagFaces(const ContactGeometry::TriangleMesh&   mesh,
                             : mesh.getEdgeFace(edge, 0));
         if (faceType[face] == Unknown) {
             faceType[face] = faceType[index];
-            if (faceType[index] > 0)
-                triangles.insert(face);
             if (depth < MaxRecursionDepth)
-                tagFaces(mesh, faceType, triangles, face, depth+1);
+                tagFaces(mesh, faceType, face, depth+1);
         }
     }
 }
@@ -75,21 +75,21 @@ OrientedBoundingBox::OrientedBoundingBox(const Vector_<Vec3>& points) {
     Rotation rot(UnitVec3(axes[0]), XAxis, axes[1], YAxis);
     Real volume = calculateVolume(points, rot);
     for (Real step = Real(0.1); step > Real(0.01); step /= 2) {
+        Rotation stepRotation[6];
+        stepRotation[0].setRotationFromAngleAboutX(step);
+        stepRotation[1].setRotationFromAngleAboutX(-step);
+        stepRotation[2].setRotationFromAngleAboutY(step);
+        stepRotation[3].setRotationFromAngleAboutY(-step);
+        stepRotation[4].setRotationFromAngleAboutZ(step);
+        stepRotation[5].setRotationFromAngleAboutZ(-step);
         bool improved = true;
         while (improved) {
-            Rotation trialRotation[6];
-            trialRotation[0].setRotationFromAngleAboutX(step);
-            trialRotation[1].setRotationFromAngleAboutX(-step);
-            trialRotation[2].setRotationFromAngleAboutY(step);
-            trialRotation[3].setRotationFromAngleAboutY(-step);
-            trialRotation[4].setRotationFromAngleAboutZ(step);
-            trialRotation[5].setRotationFromAngleAboutZ(-step);
             improved = false;
             for (int i = 0; i < 6; i++) {
-                trialRotation[i] = trialRotation[i]*rot;
-                Real trialVolume = calculateVolume(points, trialRotation[i]);
+                const Rotation trialRotation = stepRotation[i]*rot;
+                Real trialVolume = calculateVolume(points, trialRotation);
                 if (trialVolume < volume) {
-                    rot = trialRotation[i];
+                    rot = trialRotation;
                     volume = trialVolume;
                     improved = true;
                 }
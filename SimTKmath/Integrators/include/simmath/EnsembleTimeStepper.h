@@ -0,0 +1,247 @@
+#ifndef SimTK_SIMMATH_ENSEMBLE_TIMESTEPPER_H_
+#define SimTK_SIMMATH_ENSEMBLE_TIMESTEPPER_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/Integrator.h"
+
+#include <string>
+
+namespace SimTK {
+
+/**
+ * This class advances many independent trajectories of the same System at
+ * once, spreading them over a pool of threads. Each trajectory (an ensemble
+ * "member") starts from its own initial State and runs to its own final time,
+ * so this is suited to parameter sweeps and uncertainty quantification where
+ * the members differ only in their state variables, including discrete
+ * variables such as parameters. The System itself is shared and is never
+ * modified; all the per-trajectory computation lives in the members' States.
+ * For example:
+ *
+ * <pre>
+ * EnsembleTimeStepper::IntegratorFactory_<RungeKuttaMersonIntegrator>
+ *     factory(1e-4);                               // accuracy
+ * EnsembleTimeStepper ensemble(system, factory);
+ * ensemble.setReportInterval(0.01);
+ * ensemble.run(initialStates, finalTimes, myReporter);
+ * </pre>
+ *
+ * Each thread has its own Integrator and TimeStepper, created once by the
+ * IntegratorFactory and reused for every member that thread runs, so no
+ * integrator workspace is allocated per member. Members are handed out to the
+ * threads one at a time as threads become free, so trajectories of very
+ * different lengths still keep all the threads busy. Results are not
+ * collected here; instead the Reporter is given each member's State at its
+ * start, at each report time and at its end as soon as they are reached.
+ *
+ * A member that fails (for example if its Integrator throws an exception
+ * because it can't meet the accuracy requirement) is recorded as failed with
+ * the error message; the other members carry on.
+ *
+ * <h3>Thread safety</h3>
+ * Members are realized concurrently, so everything that is evaluated during
+ * realization must be safe to evaluate from several threads at once, provided
+ * each thread uses its own State. The matter subsystem, the built-in forces
+ * other than those listed below, the built-in constraints and the measures
+ * meet that requirement: they keep their results in the State and their
+ * statistics in counters that can be bumped concurrently. Any parallel tree
+ * sweeps that have been turned on for the matter subsystem run serially
+ * inside ensemble members.
+ *
+ * Some elements keep scratch data in the element itself and must not be used
+ * in an ensemble System:
+ *  - a CablePath that wraps over a surface obstacle, and anything else that
+ *    computes geodesics on a ContactGeometry surface, since a ContactGeometry
+ *    remembers the geodesics it shot most recently;
+ *  - ContactGeometry::SmoothHeightMap, which remembers the BicubicSurface
+ *    patch it used most recently;
+ *  - user-written elements such as Force::Custom implementations, event
+ *    handlers and reporters, if they modify member data when called.
+ *
+ * The constructor throws an exception if the System contains a cable path or
+ * contact surface of the first two kinds; it can't detect the others. A
+ * BicubicSurface evaluated with a separate PatchHint for each thread gives
+ * correct results, but its access statistics are not guarded and will be
+ * inaccurate. The Reporter must itself be thread safe, since it is called for
+ * different members from different threads.
+ */
+class SimTK_SIMMATH_EXPORT EnsembleTimeStepper {
+public:
+    class IntegratorFactory;
+    template <class IntegratorType> class IntegratorFactory_;
+    class Reporter;
+
+    /**
+     * Create an EnsembleTimeStepper for a System, using a factory to create
+     * one Integrator for each thread. The System's topology must already have
+     * been realized, and the System and factory must outlive this object.
+     *
+     * @param numThreads the number of worker threads to create.  By default,
+     * this is set equal to the number of processors.
+     */
+    EnsembleTimeStepper(const System& system, const IntegratorFactory& factory,
+                        int numThreads = ParallelExecutor::getNumProcessors());
+    ~EnsembleTimeStepper();
+
+    /**
+     * Get the System whose trajectories are being computed.
+     */
+    const System& getSystem() const;
+    /**
+     * Get the number of worker threads.
+     */
+    int getNumThreads() const;
+
+    /**
+     * Set the interval between the times at which each member's State is
+     * passed to the Reporter, measured from the member's start time. The
+     * default is Infinity, meaning that only the initial and final States of
+     * each member are reported.
+     */
+    void setReportInterval(Real interval);
+    /**
+     * Get the interval between reports.
+     */
+    Real getReportInterval() const;
+
+    /**
+     * Run one member of the ensemble for each of the given initial States,
+     * member i running from initialStates[i] until finalTimes[i] or until an
+     * event handler terminates it. This returns when every member has
+     * finished. It must not be called by several threads at once.
+     */
+    void run(const Array_<State>& initialStates,
+             const Array_<Real>& finalTimes, Reporter& reporter);
+    /**
+     * Run one member of the ensemble for each of the given initial States,
+     * all with the same final time.
+     */
+    void run(const Array_<State>& initialStates, Real finalTime,
+             Reporter& reporter);
+
+    /**
+     * Get the number of members in the most recent run.
+     */
+    int getNumMembers() const;
+    /**
+     * Get the number of members of the most recent run that failed.
+     */
+    int getNumFailedMembers() const;
+    /**
+     * Determine whether a member of the most recent run failed with an
+     * exception.
+     */
+    bool hasMemberFailed(int member) const;
+    /**
+     * Get the message of the exception that made a member fail, or an empty
+     * string if it didn't.
+     */
+    const std::string& getMemberErrorMessage(int member) const;
+    /**
+     * Get the reason a member's trajectory ended. This is
+     * Integrator::AnUnrecoverableErrorOccurred if the member failed.
+     */
+    Integrator::TerminationReason getMemberTerminationReason(int member) const;
+    /**
+     * Get the time of the last State of a member that was reported, or NaN
+     * if the member failed before its initial State could be reported.
+     */
+    Real getMemberTime(int member) const;
+    /**
+     * Get the number of integrator steps taken by a member.
+     */
+    int getMemberNumStepsTaken(int member) const;
+
+private:
+    EnsembleTimeStepper(const EnsembleTimeStepper&);            // suppress
+    EnsembleTimeStepper& operator=(const EnsembleTimeStepper&); // suppress
+
+    class EnsembleTimeStepperRep* rep;
+    friend class EnsembleTimeStepperRep;
+};
+
+/**
+ * Concrete subclasses of this abstract class create the Integrators used by
+ * an EnsembleTimeStepper, one per thread, configured however the ensemble
+ * needs. IntegratorFactory_ does this for any Integrator type whose only
+ * required setting is its accuracy.
+ */
+class EnsembleTimeStepper::IntegratorFactory {
+public:
+    virtual ~IntegratorFactory() {}
+    /**
+     * Create a new Integrator for the given System on the heap; the caller
+     * takes ownership.
+     */
+    virtual Integrator* createIntegrator(const System& system) const = 0;
+};
+
+/**
+ * This IntegratorFactory creates Integrators of a given type, optionally
+ * setting their accuracy.
+ */
+template <class IntegratorType>
+class EnsembleTimeStepper::IntegratorFactory_
+:   public EnsembleTimeStepper::IntegratorFactory {
+public:
+    /**
+     * Create a factory whose Integrators use the given accuracy, or their
+     * default accuracy if this is NaN.
+     */
+    explicit IntegratorFactory_(Real accuracy = NaN) : accuracy(accuracy) {}
+    Integrator* createIntegrator(const System& system) const {
+        Integrator* integ = new IntegratorType(system);
+        if (!isNaN(accuracy))
+            integ->setAccuracy(accuracy);
+        return integ;
+    }
+private:
+    Real accuracy;
+};
+
+/**
+ * Concrete subclasses of this abstract class receive the States of the
+ * ensemble members as they are computed. Calls for different members may be
+ * made at the same time from different threads, so implementations must be
+ * thread safe; the calls for any one member are made in time order from one
+ * thread at a time.
+ */
+class EnsembleTimeStepper::Reporter {
+public:
+    virtual ~Reporter() {}
+    /**
+     * This is called with a member's State at its start time, at each report
+     * time, and at the end of its trajectory. The State has been realized
+     * through at least the Velocity stage and is only valid during the call;
+     * realize it further or copy it here if necessary.
+     */
+    virtual void handleState(int member, const State& state) = 0;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_ENSEMBLE_TIMESTEPPER_H_
@@ -126,6 +126,8 @@ public:
     class TriedToAdvancePastFinalTime;
     class CantAskForEventInfoWhenNoEventTriggered;
 
+    class DenseOutput;
+
     /// Get the name of this integration method
     const char* getMethodName() const;
     /// Get the minimum order this Integrator may use
@@ -175,6 +177,30 @@ public:
     /// Get a non-const reference to the advanced state.
     State& updAdvancedState();
 
+    /// Get the number of internal steps whose continuous extensions have 
+    /// been recorded since the integrator was initialized or 
+    /// clearDenseOutput() was last called. Nothing is recorded unless 
+    /// setRecordDenseOutput() has been turned on. A record is appended for
+    /// every internal step, however many of them a call to stepTo() or 
+    /// stepBy() takes, and records are kept through event handling and 
+    /// reinitialize(), so a TimeStepper user sees every step too.
+    int getNumDenseOutputRecords() const;
+    /// Get the continuous extension of the i'th recorded internal step, in
+    /// the order the steps were taken. This can be evaluated for the 
+    /// continuous state variables y at any time in the step without creating
+    /// or realizing a State, which is much cheaper than asking for 
+    /// interpolated states when output is wanted much more often than the 
+    /// integrator steps. Note that the values come straight from the 
+    /// integration method's interpolant; prescribed motion has not been 
+    /// applied and constraints have not been projected.
+    /// @see DenseOutput, getNumDenseOutputRecords()
+    const DenseOutput& getDenseOutput(int i) const;
+    /// Discard the recorded continuous extensions once you have used them.
+    /// Records accumulate until this is called, so call it after reading 
+    /// them, typically after each call to stepTo(). Their storage is kept for
+    /// reuse by later steps.
+    void clearDenseOutput();
+
     /// Get the accuracy which is being used for error control.  Usually this is the same value that was
     /// specified to setAccuracy().
     Real getAccuracyInUse() const;
@@ -331,6 +357,25 @@ public:
     /// the number of convergent and divergent iterations which are available separately.
     int getNumIterations() const;
 
+    /// Get the number of steps whose wall clock time exceeded the deadline set
+    /// with setStepDeadline(), since the last call to resetAllStatistics().
+    /// Steps are timed only in real-time mode; see setUseRealTimeMode().
+    int getNumDeadlineMisses() const;
+    /// Get the longest wall clock time, in seconds, taken by any step since 
+    /// the last call to resetAllStatistics(), or zero if no step has been
+    /// timed. Steps are timed only in real-time mode.
+    Real getWorstStepWallTime() const;
+    /// Get the wall clock time, in seconds, taken by the most recent step, or
+    /// zero if no step has been timed. Steps are timed only in real-time mode.
+    Real getPreviousStepWallTime() const;
+    /// Get a histogram of the wall clock times taken by the steps since the 
+    /// last call to resetAllStatistics(). Entry 0 counts steps that took less
+    /// than a microsecond, and entry i>0 counts those that took at least 
+    /// 2^(i-1) but less than 2^i microseconds, except that the last entry 
+    /// also counts all slower steps. The entries add up to the number of steps
+    /// timed. Steps are timed only in real-time mode.
+    const Array_<int>& getStepWallTimeHistogram() const;
+
     /// Set the time at which the simulation should end.  The default is infinity.  Some integrators may
     /// not support this option.
     void setFinalTime(Real tFinal);
@@ -396,10 +441,72 @@ public:
     /// constraint manifold after interpolation is performed. The default is
     /// "true".
     void setProjectInterpolatedStates(bool shouldProject);
+    /// Are interpolated states being projected onto the constraint manifold?
+    bool isInterpolatedStateProjectionInUse() const;
     /// (Advanced) Constraint projection may use an out-of-date iteration
     /// matrix for efficiency. You can force strict use of a current iteration
     /// matrix recomputed at each iteration if you want.
     void setForceFullNewton(bool forceFullNewton);
+    /// (Advanced) Localize event triggers cheaply. While the Integrator 
+    /// narrows down the time at which an event triggered, it normally 
+    /// evaluates the candidate event triggers on interpolated states that 
+    /// have had prescribed motion applied and (see 
+    /// setProjectInterpolatedStates()) been projected onto the constraint 
+    /// manifold. With this option it instead evaluates them on states taken
+    /// directly from the integration method's interpolant, realized only as 
+    /// far as the candidates' stages require; for example, triggers that
+    /// depend only on time need nothing past Stage::Time. That can make 
+    /// localization much cheaper for systems with many event triggers, at the
+    /// cost of triggers being evaluated on states that may not quite satisfy
+    /// the constraints. The state at which the event is reported is prepared
+    /// as usual. The default is false. Some integrators may not support this
+    /// option.
+    void setUseFastEventLocalization(bool useFastLocalization);
+    /// (Advanced) Is cheap event localization in use?
+    bool isFastEventLocalizationInUse() const;
+
+    /// Record the integration method's continuous extension of each internal
+    /// step, for retrieval with getDenseOutput(). This costs a few vector
+    /// operations per step, and the caller must drain the records with 
+    /// clearDenseOutput(). The default is false.
+    void setRecordDenseOutput(bool shouldRecord);
+    /// Is the continuous extension of each step being recorded?
+    bool isDenseOutputRecorded() const;
+
+    /// Take steps whose cost is bounded, for use where each step must finish
+    /// by a wall clock deadline, such as a fixed-rate hardware-in-the-loop
+    /// controller. This requires a fixed step size; see setFixedStepSize().
+    /// In this mode:
+    ///   - A step is never rejected and retried, and steps end exactly at
+    ///     report times instead of being interpolated back to them.
+    ///   - Constraint projection is attempted after every step, limited to 
+    ///     a few iterations (see setMaximumProjectionIterations()). If that
+    ///     isn't enough the projection is counted as a failure but the 
+    ///     partially projected state is kept.
+    ///   - Event triggers are checked only at the ends of steps and are not
+    ///     localized, so the event window is the whole step.
+    ///   - Once a step has been taken, the vector workspaces kept by the
+    ///     Integrator and its integration method may no longer be resized;
+    ///     an attempt to do so throws an exception. This does not cover 
+    ///     temporaries created within a step or storage in the State, such
+    ///     as the System's cache entries.
+    ///   - The wall clock time of each step is recorded; see 
+    ///     getStepWallTimeHistogram() and setStepDeadline().
+    ///
+    /// Handling events and making reports is not bounded in this way. The
+    /// default is false. Some integrators may not support this option.
+    void setUseRealTimeMode(bool useRealTimeMode);
+    /// Is real-time mode in use?
+    bool isRealTimeModeInUse() const;
+    /// Limit the number of Newton iterations taken by each constraint 
+    /// projection during a step. If maxIterations <= 0 the default is 
+    /// restored, which is 3 in real-time mode and otherwise the projection
+    /// method's own limit.
+    void setMaximumProjectionIterations(int maxIterations);
+    /// Set the wall clock time, in seconds, within which each step should 
+    /// finish in real-time mode. Slower steps are counted by 
+    /// getNumDeadlineMisses(). The default is Infinity.
+    void setStepDeadline(Real seconds);
 
     /// OBSOLETE: use getSuccessfulStepStatusString().
     static String successfulStepStatusString(SuccessfulStepStatus stat)
@@ -414,6 +521,68 @@ protected:
     friend class IntegratorRep;
 };
 
+
+/** This is a polynomial representation of the continuous state variables y
+over one integrator step, as recorded by the Integrator when 
+Integrator::setRecordDenseOutput() is on. It can be evaluated at any time in
+its interval for the cost of a few vector operations. In terms of the scaled time s=(t-tRef)/h,
+<pre>
+    y(t) = c_0 + c_1 s + c_2 s^2 + ... + c_d s^d
+</pre>
+where the coefficient vectors c_k are the columns of a matrix and d is the 
+degree of the polynomial. Example:
+@code
+    integ.setRecordDenseOutput(true);
+    // ... after each call to stepTo():
+    Vector y;
+    for (int i = 0; i < integ.getNumDenseOutputRecords(); ++i) {
+        const Integrator::DenseOutput& dense = integ.getDenseOutput(i);
+        for (Real t = dense.getStartTime(); t <= dense.getEndTime(); t += 1e-3)
+        {   dense.evaluate(t, y); 
+            // ... log y ...
+        }
+    }
+    integ.clearDenseOutput();
+@endcode **/
+class SimTK_SIMMATH_EXPORT Integrator::DenseOutput {
+public:
+    /** Create an empty record, which can't be evaluated. **/
+    DenseOutput() : tStart(NaN), tEnd(NaN), tRef(NaN), h(NaN) {}
+
+    /** Return true if this record doesn't hold a polynomial. **/
+    bool isEmpty() const {return coefficients.ncol() == 0;}
+    /** Get the time at the start of the interval this record covers. **/
+    Real getStartTime() const {return tStart;}
+    /** Get the time at the end of the interval this record covers. **/
+    Real getEndTime() const {return tEnd;}
+    /** Get the number of continuous state variables. **/
+    int getNumY() const {return coefficients.nrow();}
+    /** Get the degree d of the polynomial. **/
+    int getDegree() const {return coefficients.ncol()-1;}
+
+    /** Evaluate the continuous state variables at time t, which must be in
+    [getStartTime(), getEndTime()] give or take some roundoff. The output 
+    vector is resized if necessary; no heap allocation is done if it already
+    has the right size. **/
+    void evaluate(Real t, Vector& y) const;
+
+    /** Remove the polynomial, leaving this record empty. **/
+    void clear();
+
+    /** (Advanced) This is for use by Integrator implementations. Resize the
+    coefficient matrix for a polynomial of degree d in ny variables, set the
+    interval [tStart,tEnd] it covers and the reference time and scale used to
+    define s, and return the coefficient matrix for the caller to fill in 
+    with c_k in column k. **/
+    Matrix& setPolynomial(int ny, int d, Real tStart, Real tEnd, 
+                          Real tRef, Real h);
+    /** Get the coefficient matrix, with c_k in column k. **/
+    const Matrix& getCoefficients() const {return coefficients;}
+private:
+    Real    tStart, tEnd, tRef, h;
+    Matrix  coefficients;
+};
+
 } // namespace SimTK
 
 #endif // SimTK_SIMMATH_INTEGRATOR_H_
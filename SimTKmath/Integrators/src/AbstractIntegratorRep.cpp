@@ -30,7 +30,8 @@ AbstractIntegratorRep::AbstractIntegratorRep
    (Integrator* handle, const System& sys, int minOrder, int maxOrder, 
     const std::string& methodName, bool hasErrorControl) 
 :   IntegratorRep(handle, sys), minOrder(minOrder), maxOrder(maxOrder), 
-    methodName(methodName), hasErrorControl(hasErrorControl) {}
+    methodName(methodName), hasErrorControl(hasErrorControl),
+    workspacesLocked(false) {}
 
 
 
@@ -38,6 +39,11 @@ AbstractIntegratorRep::AbstractIntegratorRep
 //                             METHOD INITIALIZE
 //==============================================================================
 void AbstractIntegratorRep::methodInitialize(const State& state) {
+    SimTK_ERRCHK_ALWAYS(!isRealTimeModeInUse() 
+        || (userMinStepSize != -1 && userMinStepSize == userMaxStepSize),
+        "Integrator::initialize()",
+        "Real-time mode requires a fixed step size; see "
+        "Integrator::setFixedStepSize().");
     initialized = true;
     if (userInitStepSize != -1)
         currentStepSize = userInitStepSize;
@@ -50,8 +56,27 @@ void AbstractIntegratorRep::methodInitialize(const State& state) {
     lastStepSize = currentStepSize;
     actualInitialStepSizeTaken = (hasErrorControl ? NaN : currentStepSize);
     resetMethodStatistics();
+
+    // The state's sizes may have changed; the workspaces will be resized and,
+    // in real-time mode, locked again after the next step. The event lists
+    // can't have more entries than there are triggers so we reserve that
+    // much now.
+    lockWorkspaceShapes(false);
+    const int nTriggers = state.getNEventTriggers();
+    eventCandidates.reserve(nTriggers);
+    eventCandidateTransitions.reserve(nTriggers);
+    eventTimeEstimates.reserve(nTriggers);
+    eventIds.reserve(nTriggers);
  }
 
+void AbstractIntegratorRep::lockWorkspaceShapes(bool lock) {
+    IntegratorRep::lockWorkspaceShapes(lock);
+    Vector* work[] = {&yErrEst, &yInterp};
+    for (int i=0; i < 2; ++i)
+        lockShapeIfSized(*work[i], lock);
+    workspacesLocked = lock;
+}
+
 
 
 //==============================================================================
@@ -62,17 +87,8 @@ void AbstractIntegratorRep::methodInitialize(const State& state) {
 // to initialize its discrete part from the advanced state.
 void AbstractIntegratorRep::createInterpolatedState(Real t) {
     const System& system   = getSystem();
-    const State&  advanced = getAdvancedState();
-    State&        interp   = updInterpolatedState();
-    interp = advanced; // pick up discrete stuff.
-
-    // Hermite interpolation requires state derivatives so we must realize
-    // end-of-step derivatives if they haven't already been realized.
-    realizeStateDerivatives(advanced);
-
-    interpolateOrder3(getPreviousTime(),  getPreviousY(),  getPreviousYDot(),
-                      advanced.getTime(), advanced.getY(), advanced.getYDot(),
-                      t, interp.updY());
+    State&        interp   = updInterpolatedStateFromAdvanced();
+    interpolateY(t, interp.updY());
     interp.updTime() = t;
 
     if (userProjectInterpolatedStates == 0) {
@@ -90,6 +106,72 @@ void AbstractIntegratorRep::createInterpolatedState(Real t) {
 }
 
 
+//==============================================================================
+//                              INTERPOLATE Y
+//==============================================================================
+// Evaluate the continuous state variables at time t, which is between tPrev 
+// and tCurrent, by Hermite interpolation.
+void AbstractIntegratorRep::interpolateY(Real t, Vector& y) {
+    const State& advanced = getAdvancedState();
+
+    // Hermite interpolation requires state derivatives so we must realize
+    // end-of-step derivatives if they haven't already been realized.
+    realizeStateDerivatives(advanced);
+
+    interpolateOrder3(getPreviousTime(),  getPreviousY(),  getPreviousYDot(),
+                      advanced.getTime(), advanced.getY(), advanced.getYDot(),
+                      t, y);
+}
+
+
+//==============================================================================
+//                            CALC DENSE OUTPUT
+//==============================================================================
+// Write the Hermite interpolant used by interpolateY() as a polynomial in 
+// s=(t-tPrev)/h, h=tCurrent-tPrev.
+void AbstractIntegratorRep::calcDenseOutput
+   (Integrator::DenseOutput& dense) const {
+    const State& advanced = getAdvancedState();
+    const Real t0 = getPreviousTime(), t1 = advanced.getTime();
+    const Vector& y1 = advanced.getY();
+    if (!(t0 < t1)) {
+        dense.setPolynomial(y1.size(), 0, t1, t1, t1, 1)(0) = y1;
+        return;
+    }
+
+    realizeStateDerivatives(advanced);
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
+    const Vector& f1 = advanced.getYDot();
+    const Real h = t1-t0;
+    Matrix& c = dense.setPolynomial(y1.size(), 3, t0, t1, t0, h);
+    for (int i=0; i < y1.size(); ++i) {
+        const Real dy = y1[i]-y0[i], hf0 = h*f0[i], hf1 = h*f1[i];
+        c(i,0) = y0[i];
+        c(i,1) = hf0;
+        c(i,2) = 3*dy - 2*hf0 - hf1;
+        c(i,3) = hf0 + hf1 - 2*dy;
+    }
+}
+
+
+// Write the straight line from the previous to the advanced state as a 
+// polynomial in s=(t-tPrev)/h, h=tCurrent-tPrev.
+void AbstractIntegratorRep::calcLinearDenseOutput
+   (Integrator::DenseOutput& dense) const {
+    const Real t0 = getPreviousTime(), t1 = getAdvancedTime();
+    const Vector& y1 = getAdvancedState().getY();
+    if (!(t0 < t1)) {
+        dense.setPolynomial(y1.size(), 0, t1, t1, t1, 1)(0) = y1;
+        return;
+    }
+
+    Matrix& c = dense.setPolynomial(y1.size(), 1, t0, t1, t0, t1-t0);
+    c(0) = getPreviousY();
+    c(1) = y1; c(1) -= getPreviousY();
+}
+
+
 //==============================================================================
 //                  BACK UP ADVANCED STATE BY INTERPOLATION
 //==============================================================================
@@ -100,7 +182,6 @@ void AbstractIntegratorRep::createInterpolatedState(Real t) {
 void AbstractIntegratorRep::backUpAdvancedStateByInterpolation(Real t) {
     const System& system   = getSystem();
     State& advanced = updAdvancedState();
-    Vector yinterp, dummy;
 
     assert(getPreviousTime() <= t && t <= advanced.getTime());
 
@@ -109,8 +190,8 @@ void AbstractIntegratorRep::backUpAdvancedStateByInterpolation(Real t) {
     realizeStateDerivatives(advanced);
     interpolateOrder3(getPreviousTime(),  getPreviousY(),  getPreviousYDot(),
                       advanced.getTime(), advanced.getY(), advanced.getYDot(),
-                      t, yinterp);
-    advanced.updY() = yinterp;
+                      t, yInterp);
+    advanced.updY() = yInterp;
     advanced.updTime() = t;
 
     // Ignore any user request not to project interpolated states here -- this
@@ -149,6 +230,11 @@ bool AbstractIntegratorRep::attemptDAEStep
     if (!ODEconverged)
         return false;
 
+    // In real-time mode the step will be accepted whatever happens here, so
+    // we always project, accepting whatever improvement we can get within
+    // the projection iteration limit.
+    const bool realTime = isRealTimeModeInUse();
+
     // The ODE step did not throw an exception and says it converged,
     // meaning its error estimate is worth a look.
     int worstOne;
@@ -162,7 +248,7 @@ bool AbstractIntegratorRep::attemptDAEStep
     // norm is eStep then a half step would have given us an error of
     // eHalf = eStep/(2^p). We want to try the projection as long as 
     // eHalf <= accuracy, i.e., eStep <= 2^p * accuracy.
-    if (errNorm > std::pow(Real(2),errOrder)*getAccuracyInUse())
+    if (!realTime && errNorm > std::pow(Real(2),errOrder)*getAccuracyInUse())
         return true; // this step converged, but isn't worth projecting
 
     // The ODE error estimate is good enough or at least worth trying
@@ -180,13 +266,13 @@ bool AbstractIntegratorRep::attemptDAEStep
     //        0.1               0.316
     //        0.5               1
     //        1                 2
-    const Real projectionLimit = 
-        std::max(2*getConstraintToleranceInUse(), 
+    const Real projectionLimit = realTime ? Infinity
+        : std::max(2*getConstraintToleranceInUse(), 
                     std::sqrt(getConstraintToleranceInUse()));
 
     bool anyChanges;
     if (!localProjectQAndQErrEstNoThrow(advanced, yErrEst, anyChanges,
-                                        projectionLimit))
+                                        projectionLimit) && !realTime)
         return false; // convergence failure for this step
 
     // q's satisfy the position constraint manifold. Now work on u's.
@@ -199,7 +285,7 @@ bool AbstractIntegratorRep::attemptDAEStep
     // ForceProjection option.
 
     if (!localProjectUAndUErrEstNoThrow(advanced, yErrEst, anyChanges,
-                                        projectionLimit))
+                                        projectionLimit) && !realTime)
         return false; // convergence failure for this step
 
     // ODE step and projection (if any) were successful, although 
@@ -235,7 +321,7 @@ AbstractIntegratorRep::stepTo(Real reportTime, Real scheduledEventTime) {
       // Events may cause an earlier return.
       const Real tReturn = std::min(reportTime, tMax);
 
-      if (userAllowInterpolation == 0)
+      if (userAllowInterpolation == 0 || isRealTimeModeInUse())
           tMax = tReturn;
 
       // Count the number of internal steps taken during this call to stepTo().
@@ -386,6 +472,11 @@ AbstractIntegratorRep::stepTo(Real reportTime, Real scheduledEventTime) {
           // make irreversible progress. Otherwise we'll use the saved ones to 
           // put things back the way we found them after any failures.
 
+          // In real-time mode we time everything from here to the end of 
+          // the step.
+          const long long stepStartNs = 
+              isRealTimeModeInUse() ? realTimeInNs() : 0;
+
           // Record the current time and state as the previous values.
           saveTimeAndStateAsPrevious(getAdvancedState());
           // Ensure that all derivatives and other derived quantities are known,
@@ -413,6 +504,15 @@ AbstractIntegratorRep::stepTo(Real reportTime, Real scheduledEventTime) {
           bool eventOccurred = takeOneStep(tMax, reportTime);
           //---------------------------------------------------
 
+          if (userRecordDenseOutput == 1)
+              calcDenseOutput(appendDenseOutput());
+
+          if (isRealTimeModeInUse()) {
+              recordStepWallTime(realTimeInNs() - stepStartNs);
+              if (!workspacesLocked)
+                  lockWorkspaceShapes(true);
+          }
+
           ++internalStepsTaken;
           ++statsStepsTaken;
           setStepCommunicationStatus(eventOccurred 
@@ -528,7 +628,7 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
               nz = advanced.getNZ(), 
               ny = nq+nu+nz;
     
-    Vector yErrEst(ny);
+    yErrEst.resize(ny);
     bool stepSucceeded = false;
     do {
         // If we lose more than a small fraction of the step size we wanted
@@ -617,10 +717,6 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
 
     const Real MinWindow = 
         SignificantReal * std::max(Real(1), getAdvancedTime());
-    Array_<SystemEventTriggerIndex> eventCandidates, newEventCandidates;
-    Array_<Event::Trigger> 
-        eventCandidateTransitions, newEventCandidateTransitions;
-    Array_<Real> eventTimeEstimates, newEventTimeEstimates;
 
     Real earliestTimeEst, narrowestWindow;
 
@@ -637,12 +733,14 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
     Real tLow = t0;
     Real tHigh = t1;
 
-    if (    (tHigh-tLow) <= narrowestWindow 
-        && !(tLow < tReport && tReport < tHigh)) 
+    // In real-time mode we don't localize; the event window is the whole 
+    // step, which can't straddle a report time.
+    if (   isRealTimeModeInUse()
+        || (    (tHigh-tLow) <= narrowestWindow 
+            && !(tLow < tReport && tReport < tHigh)))
     {
-        Array_<EventId> ids;
-        findEventIds(eventCandidates, ids);
-        setTriggeredEvents(tLow, tHigh, ids, eventTimeEstimates, 
+        findEventIds(eventCandidates, eventIds);
+        setTriggeredEvents(tLow, tHigh, eventIds, eventTimeEstimates, 
                            eventCandidateTransitions);
         // localized already; advanced state is right (tHigh==tAdvanced)
         return true; 
@@ -654,7 +752,10 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
     // From above we have earliestTimeEst which is the time at which we
     // think the first event is triggering.
 
-    Vector eLow = e0, eHigh = e1;
+    // Only the candidates' entries of eMid are evaluated below; the rest keep
+    // these values, which are never looked at since there are never new
+    // candidates.
+    eLow = e0; eHigh = e1; eMid = e1;
     Real bias = 1; // neutral
 
     // There is an event in (tLow,tHigh], with the eariest occurrence
@@ -677,14 +778,20 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
         const Real tMid = (tLow < tReport && tReport < tHigh) 
                           ? tReport : earliestTimeEst;
 
-        createInterpolatedState(tMid);
+        // If asked to localize cheaply, evaluate the triggers on the raw
+        // interpolant; otherwise prescribe and project as for any
+        // interpolated state.
+        if (userUseFastEventLocalization == 1) {
+            State& interp = updInterpolatedStateFromAdvanced();
+            interpolateY(tMid, interp.updY());
+            interp.updTime() = tMid;
+        } else
+            createInterpolatedState(tMid);
 
         // Failure to evaluate at the interpolated state is a disaster of some
         // kind, not something we expect to be able to recover from, so this 
         // will throw an exception if it fails.
-        realizeStateDerivatives(getInterpolatedState());
-
-        const Vector& eMid = getInterpolatedState().getEventTriggers();
+        realizeEventCandidates(getInterpolatedState(), eventCandidates, eMid);
 
         // TODO: should search in the wider interval first
 
@@ -703,11 +810,12 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
             // We guessed right -- tMid is our new tHigh, earliestTimeEst is
             // our new tMid, narrowestWindow is our localization requirement.
             tHigh = tMid; eHigh = eMid;
-            eventCandidates = newEventCandidates;
-            eventTimeEstimates = newEventTimeEstimates;
+            // (Swapping rather than copying keeps both lists' storage.)
+            eventCandidates.swap(newEventCandidates);
+            eventTimeEstimates.swap(newEventTimeEstimates);
             // these will still be the original transitions, but only the ones
             // which are still candidates are retained
-            eventCandidateTransitions = newEventCandidateTransitions;
+            eventCandidateTransitions.swap(newEventCandidateTransitions);
             continue;
         }
 
@@ -726,17 +834,16 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
         sidePrevIter = 1;
 
         tLow = tMid; eLow = eMid;
-        eventCandidates = newEventCandidates;
-        eventTimeEstimates = newEventTimeEstimates;
+        eventCandidates.swap(newEventCandidates);
+        eventTimeEstimates.swap(newEventTimeEstimates);
         // These will still be the original transitions, but only the ones
         // which are still candidates are retained.
-        eventCandidateTransitions = newEventCandidateTransitions;
+        eventCandidateTransitions.swap(newEventCandidateTransitions);
 
     } while ((tHigh-tLow) > narrowestWindow);
 
-    Array_<EventId> ids;
-    findEventIds(eventCandidates, ids);
-    setTriggeredEvents(tLow, tHigh, ids, eventTimeEstimates, 
+    findEventIds(eventCandidates, eventIds);
+    setTriggeredEvents(tLow, tHigh, eventIds, eventTimeEstimates, 
                        eventCandidateTransitions);
 
     // We have to throw away all of the advancedState that occurred after
@@ -757,6 +864,52 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
 
 
 
+//==============================================================================
+//                         REALIZE EVENT CANDIDATES
+//==============================================================================
+// Evaluate the event triggers in the candidate list, realizing the given state
+// only as far as the latest-stage candidate requires. Acceleration is the
+// highest stage the integrator ever realizes, so if any candidate needs that
+// we just evaluate all the triggers. Only the candidates' entries in "e" are
+// written otherwise.
+void AbstractIntegratorRep::realizeEventCandidates
+   (const State& s, const Array_<SystemEventTriggerIndex>& candidates, 
+    Vector& e) const
+{
+    // The system's event triggers are ordered by stage, so the last candidate
+    // in index order is the one needing the highest stage.
+    int last = 0;
+    for (unsigned i=0; i < candidates.size(); ++i)
+        last = std::max(last, (int)candidates[i]);
+    Stage maxStage = Stage::Time;
+    while (maxStage < Stage::Acceleration 
+           && last >= s.getEventTriggerStartByStage(maxStage)
+                      + s.getNEventTriggersByStage(maxStage))
+        maxStage = maxStage.next();
+
+    if (maxStage >= Stage::Acceleration) {
+        realizeStateDerivatives(s);
+        e = s.getEventTriggers();
+        return;
+    }
+
+    // Triggers may also belong to stages below Time. Those were realized 
+    // before the step began and don't change within it, but their stage has
+    // to be found the same way.
+    getSystem().realize(s, maxStage);
+    for (unsigned i=0; i < candidates.size(); ++i) {
+        const int c = candidates[i];
+        Stage g = Stage::LowestValid;
+        while (c >= s.getEventTriggerStartByStage(g) 
+                    + s.getNEventTriggersByStage(g))
+            g = g.next();
+        assert(g <= maxStage && c >= s.getEventTriggerStartByStage(g));
+        e[c] = s.getEventTriggersByStage(g)
+                                        [c - s.getEventTriggerStartByStage(g)];
+    }
+}
+
+
 //==============================================================================
 //                              STATUS & MISC
 //==============================================================================
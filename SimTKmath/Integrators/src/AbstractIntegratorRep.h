@@ -145,6 +145,14 @@ protected:
      * Hermite spline interpolation.
      */
     virtual void createInterpolatedState(Real t);
+    /**
+     * Evaluate the continuous state variables at time t, which is between
+     * the previous and advanced times, without touching the interpolated
+     * state. createInterpolatedState() uses this; so does event localization
+     * when it is asked to evaluate event triggers cheaply. The default 
+     * implementation uses third order Hermite spline interpolation.
+     */
+    virtual void interpolateY(Real t, Vector& y);
     /**
      * Interpolate the advanced state back to an earlier part of the interval,
      * forgetting about the rest of the interval. This is necessary, for 
@@ -153,6 +161,32 @@ protected:
      * third order Hermite spline interpolation.
      */
     virtual void backUpAdvancedStateByInterpolation(Real t);
+    /**
+     * Fill in the continuous extension of the step just taken, from the 
+     * previous to the advanced time, as a polynomial. The default 
+     * implementation uses the same third order Hermite spline as 
+     * interpolateY().
+     */
+    virtual void calcDenseOutput(Integrator::DenseOutput& dense) const;
+    /**
+     * Fill in the straight line from the previous to the advanced state as
+     * the continuous extension of the step just taken. Methods that 
+     * interpolate linearly can implement calcDenseOutput() with this.
+     */
+    void calcLinearDenseOutput(Integrator::DenseOutput& dense) const;
+    /**
+     * Evaluate the listed event triggers at state s into the corresponding
+     * entries of e, realizing s only as far as those triggers need.
+     */
+    void realizeEventCandidates
+       (const State& s, const Array_<SystemEventTriggerIndex>& candidates, 
+        Vector& e) const;
+    /**
+     * Lock or unlock the shapes of the workspaces used by takeOneStep(), and
+     * those of IntegratorRep. Methods that keep their own workspaces must
+     * override this to lock those too, and call this method.
+     */
+    void lockWorkspaceShapes(bool lock);
     int statsStepsTaken, statsStepsAttempted, statsErrorTestFailures, statsConvergenceTestFailures;
 
     // Iterative methods should count iterations and then classify them as 
@@ -164,6 +198,18 @@ private:
     Real currentStepSize, lastStepSize, actualInitialStepSizeTaken;
     int minOrder, maxOrder;
     std::string methodName;
+
+    // Workspace for takeOneStep() and its event localization. These keep
+    // their storage from step to step so that stepping doesn't allocate.
+    Vector yErrEst, yInterp;
+    Vector eLow, eHigh, eMid;
+    Array_<SystemEventTriggerIndex> eventCandidates, newEventCandidates;
+    Array_<Event::Trigger> 
+        eventCandidateTransitions, newEventCandidateTransitions;
+    Array_<Real> eventTimeEstimates, newEventTimeEstimates;
+    Array_<EventId> eventIds;
+    // In real-time mode the workspaces are locked after the first step.
+    bool workspacesLocked;
 };
 
 } // namespace SimTK
@@ -160,12 +160,15 @@ CPodesIntegratorRep::~CPodesIntegratorRep() {
 }
 
 void CPodesIntegratorRep::methodInitialize(const State& state) {
+    SimTK_ERRCHK_ALWAYS(!isRealTimeModeInUse(), "Integrator::initialize()",
+        "CPodesIntegrator doesn't support real-time mode.");
     if (state.getSystemStage() < Stage::Model)
         reconstructForNewModel();
     initializeIntegrationParameters();
     initialized = true;
     pendingReturnCode = -1;
     previousStartTime = 0.0;
+    denseOutputRecordedTo = state.getTime();
     resetMethodStatistics();
     getSystem().realize(state, Stage::Velocity);
     const int ny = state.getY().size();
@@ -228,6 +231,7 @@ void CPodesIntegratorRep::methodReinitialize
     if (stage < Stage::Report) {
         pendingReturnCode = -1;
         State state = getAdvancedState();
+        denseOutputRecordedTo = state.getTime();
         getSystem().realize(state, Stage::Acceleration);
         //TODO: change this to do abstol only for q, reltol for u&z
         Real relTol = getAccuracyInUse();
@@ -266,8 +270,7 @@ void CPodesIntegratorRep::reconstructForNewModel() {
 void CPodesIntegratorRep::createInterpolatedState(Real t) {
     const System& system  = getSystem();
     const State& advanced = getAdvancedState();
-    State&       interp   = updInterpolatedState();
-    interp = advanced; // pick up discrete stuff.
+    State&       interp   = updInterpolatedStateFromAdvanced();
     Vector yout(advanced.getY().size());
     cpodes->getDky(t, 0, yout);
     interp.updY() = yout;
@@ -287,6 +290,34 @@ void CPodesIntegratorRep::createInterpolatedState(Real t) {
     realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
 }
 
+// Append CPodes's interpolating polynomial for its last internal step, from
+// where recording of that step left off up to t1, in terms of s=(t-tn)/hu; 
+// nothing is appended if that part is empty. CPodes keeps that polynomial as
+// its Nordsieck history array, whose k'th column is the scaled derivative 
+// y^(k)(tn) h^k/k!, so we just read the columns back. 
+void CPodesIntegratorRep::recordDenseOutput(Real t1) {
+    int q; Real tn, hu;
+    cpodes->getLastOrder(&q);
+    cpodes->getCurrentTime(&tn);
+    cpodes->getLastStep(&hu);
+    const Real t0 = std::max(denseOutputRecordedTo, tn-hu);
+    t1 = std::min(t1, tn);
+    if (!(t0 < t1))
+        return;
+    denseOutputRecordedTo = t1;
+
+    const int ny = getAdvancedState().getNY();
+    Matrix& c = appendDenseOutput().setPolynomial(ny, q, t0, t1, tn, hu);
+    dky.resize(ny);
+    Real scale = 1;
+    for (int k=0; k <= q; ++k) {
+        if (k > 0) scale *= hu/k;
+        cpodes->getDky(tn, k, dky);
+        c(k) = dky;
+        c(k) *= scale;
+    }
+}
+
 // Take a step. See AbstractIntegratorRep::stepTo() for how this is supposed
 // to behave. We have to go through some contortions to squeeze CPodes into
 // that mold.
@@ -317,13 +348,16 @@ stepTo(Real reportTime, Real scheduledEventTime) {
         return Integrator::StartOfContinuousInterval;
     }
 
+    // When recording dense output CPodes has to return after every internal
+    // step, since only the last step's polynomial can be read back. Steps 
+    // the user doesn't want to see are still skipped below.
+    const bool oneStep = userReturnEveryInternalStep == 1 
+                         || userRecordDenseOutput == 1;
     CPodes::StepMode mode;
     if (userFinalTime != -1 || userAllowInterpolation==0)
-        mode = (userReturnEveryInternalStep == 1) ? CPodes::OneStepTstop
-                                                  : CPodes::NormalTstop;
+        mode = oneStep ? CPodes::OneStepTstop : CPodes::NormalTstop;
     else
-        mode = (userReturnEveryInternalStep == 1) ? CPodes::OneStep
-                                                  : CPodes::Normal;
+        mode = oneStep ? CPodes::OneStep : CPodes::Normal;
 
     // Keep taking steps until something interesting happens at tMax or
     // earlier.
@@ -359,6 +393,8 @@ stepTo(Real reportTime, Real scheduledEventTime) {
                 updAdvancedState().updTime() = tret;
             }
             pendingReturnCode = -1;
+            if (userRecordDenseOutput == 1)
+                recordDenseOutput(std::min(tret, tMax));
         }
         else if (tMax == getState().getTime()) {
             
@@ -389,6 +425,11 @@ stepTo(Real reportTime, Real scheduledEventTime) {
             cpodes->getNumNonlinSolvIters(&oldNonlinIterations);
             cpodes->getNumNonlinSolvConvFails(&oldNonlinConvFailures);
 
+            // Any of the last step that lay beyond the time we returned is 
+            // still wanted, unless reinitialization has discarded it.
+            if (userRecordDenseOutput == 1)
+                recordDenseOutput(Infinity);
+
             //---------------------step------------------------
             res = cpodes->step(tMax, &tret, yout, ypout, mode);
             //-------------------------------------------------
@@ -418,6 +459,12 @@ stepTo(Real reportTime, Real scheduledEventTime) {
             // Project stats were already updated in project() above.
             statsIterations += newNonlinIterations-oldNonlinIterations;
             statsConvergenceTestFailures += newNonlinConvFailures-oldNonlinConvFailures;
+
+            // Record only up to tMax for now, since an event handler may 
+            // change the state there.
+            if (userRecordDenseOutput == 1 
+                && (res >= 0 || res == CPodes::TooMuchWork))
+                recordDenseOutput(std::min(tret, tMax));
  
             // This takes care of prescribed motion.
             setAdvancedStateAndRealizeKinematics(tret, yout);
@@ -513,7 +560,9 @@ stepTo(Real reportTime, Real scheduledEventTime) {
             Array_<EventId> ids;
             findEventIds(eventIndices, ids);
 
-            // Generate an interpolated state at tLo.      
+            // Generate an interpolated state at tLo. The advanced state at tHi
+            // is the one to return next time, not any older saved one.
+            savedY.resize(0);
             setUseInterpolatedState(true);
             createInterpolatedState(tret);
             realizeStateDerivatives(getInterpolatedState());
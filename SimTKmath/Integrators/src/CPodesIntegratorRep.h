@@ -56,6 +56,7 @@ public:
     int getNumIterations() const;
     void resetMethodStatistics();
     void createInterpolatedState(Real t);
+    void recordDenseOutput(Real t1);
     void initializeIntegrationParameters();
     void reconstructForNewModel();
     const char* getMethodName() const;
@@ -75,6 +76,8 @@ private:
     int pendingReturnCode;
     Real previousStartTime, previousTimeReturned;
     Vector savedY;
+    Real denseOutputRecordedTo; // end of the last dense output record
+    Vector dky;                 // temporary for recordDenseOutput()
     CPodes::LinearMultistepMethod method;
     void init(CPodes::LinearMultistepMethod method, CPodes::NonlinearSystemIterationType iterationType);
 };
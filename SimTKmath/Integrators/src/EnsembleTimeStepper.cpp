@@ -0,0 +1,282 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+ * This is the private (library side) implementation of the Simmath
+ * EnsembleTimeStepper class.
+ */
+
+#include "SimTKcommon.h"
+#include "simmath/Integrator.h"
+#include "simmath/TimeStepper.h"
+#include "simmath/EnsembleTimeStepper.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+
+namespace SimTK {
+
+    ///////////////////////////////////////////
+    // CLASS ENSEMBLE TIME STEPPER REP       //
+    ///////////////////////////////////////////
+
+class EnsembleTimeStepperRep {
+public:
+    EnsembleTimeStepperRep(const System& system,
+                           const EnsembleTimeStepper::IntegratorFactory& factory,
+                           int numThreads);
+    ~EnsembleTimeStepperRep();
+
+    void run(const Array_<State>& initialStates, const Array_<Real>& finalTimes,
+             EnsembleTimeStepper::Reporter& reporter);
+
+    // Run a single member to completion on the calling thread, using that
+    // thread's Integrator. Exceptions are caught and recorded.
+    void runMember(int member);
+
+    // What happened to one member. Each member's entry is written only by
+    // the thread running that member.
+    struct MemberResult {
+        MemberResult()
+        :   failed(false), reason(Integrator::InvalidTerminationReason),
+            time(NaN), numSteps(0) {}
+        bool                            failed;
+        std::string                     message;
+        Integrator::TerminationReason   reason;
+        Real                            time;
+        int                             numSteps;
+    };
+
+    const MemberResult& getResult(int member) const {
+        SimTK_INDEXCHECK_ALWAYS(member, (int)results.size(),
+                                "EnsembleTimeStepper::getMember...()");
+        return results[member];
+    }
+
+    const System&       system;
+    TaskScheduler       scheduler;
+    Real                reportInterval;
+
+    // One Integrator and TimeStepper per scheduler thread, plus one for the
+    // calling thread, which does the work itself when there is only one
+    // worker. These are indexed by TaskScheduler::getCurrentThreadIndex().
+    Array_<Integrator*>     integrators;
+    Array_<TimeStepper*>    timeSteppers;
+
+    // These are valid only during run().
+    const Array_<State>*            initialStates;
+    const Array_<Real>*             finalTimes;
+    EnsembleTimeStepper::Reporter*  reporter;
+
+    Array_<MemberResult>    results;
+};
+
+// This is the loop body for TaskScheduler::parallelFor(); we run one member
+// per chunk so that the members are handed out individually.
+class RunMembersTask : public TaskScheduler::RangeTask {
+public:
+    explicit RunMembersTask(EnsembleTimeStepperRep& rep) : rep(rep) {}
+    void execute(int begin, int end) {
+        for (int i = begin; i < end; ++i)
+            rep.runMember(i);
+    }
+private:
+    EnsembleTimeStepperRep& rep;
+};
+
+EnsembleTimeStepperRep::EnsembleTimeStepperRep
+   (const System& system, const EnsembleTimeStepper::IntegratorFactory& factory,
+    int numThreads)
+:   system(system), scheduler(numThreads), reportInterval(Infinity),
+    initialStates(0), finalTimes(0), reporter(0)
+{
+    SimTK_ERRCHK_ALWAYS(system.systemTopologyHasBeenRealized(),
+        "EnsembleTimeStepper::EnsembleTimeStepper()",
+        "The System's topology must be realized before its trajectories can "
+        "be computed concurrently.");
+    for (SubsystemIndex sx(0); sx < system.getNumSubsystems(); ++sx) {
+        const Subsystem& sub = system.getSubsystem(sx);
+        SimTK_ERRCHK1_ALWAYS(sub.getSubsystemGuts().isThreadSafe(),
+            "EnsembleTimeStepper::EnsembleTimeStepper()",
+            "Subsystem %s contains elements that can't be realized for "
+            "several States at once.", sub.getName().c_str());
+    }
+
+    // Create all the Integrators up front, on this thread, so that the
+    // factory doesn't have to be thread safe.
+    const int numSlots = scheduler.getNumThreads()+1;
+    for (int i=0; i < numSlots; ++i) {
+        integrators.push_back(factory.createIntegrator(system));
+        timeSteppers.push_back(new TimeStepper(system, *integrators.back()));
+    }
+}
+
+EnsembleTimeStepperRep::~EnsembleTimeStepperRep() {
+    for (int i=0; i < (int)timeSteppers.size(); ++i) {
+        delete timeSteppers[i];
+        delete integrators[i];
+    }
+}
+
+void EnsembleTimeStepperRep::run
+   (const Array_<State>& initialStates, const Array_<Real>& finalTimes,
+    EnsembleTimeStepper::Reporter& reporter)
+{
+    const int n = (int)initialStates.size();
+    SimTK_ERRCHK2_ALWAYS(finalTimes.size() == initialStates.size(),
+        "EnsembleTimeStepper::run()",
+        "Got %d final times for %d members.", (int)finalTimes.size(), n);
+
+    this->initialStates = &initialStates;
+    this->finalTimes    = &finalTimes;
+    this->reporter      = &reporter;
+    results.clear();
+    results.resize(n);
+
+    // A grain size of 1 hands out members one at a time to whichever thread
+    // is free, which balances trajectories of unequal length. runMember()
+    // doesn't throw.
+    RunMembersTask task(*this);
+    scheduler.parallelFor(task, 0, n, 1);
+
+    this->initialStates = 0; this->finalTimes = 0; this->reporter = 0;
+}
+
+void EnsembleTimeStepperRep::runMember(int member) {
+    const int slot = scheduler.getCurrentThreadIndex();
+    Integrator&  integ = *integrators[slot];
+    TimeStepper& ts    = *timeSteppers[slot];
+    MemberResult& result = results[member];
+
+    try {
+        const Real tFinal = (*finalTimes)[member];
+        integ.setFinalTime(tFinal);
+        ts.initialize((*initialStates)[member]); // resets the step counts
+        result.time = ts.getTime();
+        reporter->handleState(member, ts.getState());
+
+        // Some Integrators return the final state before declaring the
+        // simulation over, so we stop as soon as the final time is reached
+        // to avoid reporting it twice.
+        const Real tStart = ts.getTime();
+        for (int k=1; ts.getTime() < tFinal && !integ.isSimulationOver(); ++k) {
+            const Real tReport = std::min(tStart + k*reportInterval, tFinal);
+            ts.stepTo(tReport);
+            result.time = ts.getTime();
+            reporter->handleState(member, ts.getState());
+        }
+
+        result.reason = integ.isSimulationOver() ? integ.getTerminationReason()
+                                                 : Integrator::ReachedFinalTime;
+        result.numSteps = integ.getNumStepsTaken();
+        return;
+    } catch (const std::exception& e) {
+        result.message = e.what();
+    } catch (...) {
+        result.message = "Unknown exception.";
+    }
+
+    result.failed = true;
+    result.reason = Integrator::AnUnrecoverableErrorOccurred;
+}
+
+
+
+    ///////////////////////////////////////////////
+    // IMPLEMENTATION OF ENSEMBLE TIME STEPPER   //
+    ///////////////////////////////////////////////
+
+EnsembleTimeStepper::EnsembleTimeStepper
+   (const System& system, const IntegratorFactory& factory, int numThreads)
+:   rep(new EnsembleTimeStepperRep(system, factory, numThreads)) {}
+
+EnsembleTimeStepper::~EnsembleTimeStepper() {
+    delete rep;
+}
+
+const System& EnsembleTimeStepper::getSystem() const {
+    return rep->system;
+}
+
+int EnsembleTimeStepper::getNumThreads() const {
+    return rep->scheduler.getNumThreads();
+}
+
+void EnsembleTimeStepper::setReportInterval(Real interval) {
+    SimTK_APIARGCHECK1_ALWAYS(interval > 0, "EnsembleTimeStepper",
+        "setReportInterval", "The report interval %g must be positive.",
+        interval);
+    rep->reportInterval = interval;
+}
+
+Real EnsembleTimeStepper::getReportInterval() const {
+    return rep->reportInterval;
+}
+
+void EnsembleTimeStepper::run(const Array_<State>& initialStates,
+                              const Array_<Real>& finalTimes,
+                              Reporter& reporter) {
+    rep->run(initialStates, finalTimes, reporter);
+}
+
+void EnsembleTimeStepper::run(const Array_<State>& initialStates,
+                              Real finalTime, Reporter& reporter) {
+    rep->run(initialStates,
+             Array_<Real>(initialStates.size(), finalTime), reporter);
+}
+
+int EnsembleTimeStepper::getNumMembers() const {
+    return (int)rep->results.size();
+}
+
+int EnsembleTimeStepper::getNumFailedMembers() const {
+    int numFailed = 0;
+    for (int i=0; i < (int)rep->results.size(); ++i)
+        if (rep->results[i].failed)
+            ++numFailed;
+    return numFailed;
+}
+
+bool EnsembleTimeStepper::hasMemberFailed(int member) const {
+    return rep->getResult(member).failed;
+}
+
+const std::string& EnsembleTimeStepper::getMemberErrorMessage(int member) const {
+    return rep->getResult(member).message;
+}
+
+Integrator::TerminationReason EnsembleTimeStepper::
+getMemberTerminationReason(int member) const {
+    return rep->getResult(member).reason;
+}
+
+Real EnsembleTimeStepper::getMemberTime(int member) const {
+    return rep->getResult(member).time;
+}
+
+int EnsembleTimeStepper::getMemberNumStepsTaken(int member) const {
+    return rep->getResult(member).numSteps;
+}
+
+} // namespace SimTK
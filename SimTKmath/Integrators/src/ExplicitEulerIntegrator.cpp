@@ -55,34 +55,19 @@ ExplicitEulerIntegratorRep::ExplicitEulerIntegratorRep
 
 
 //==============================================================================
-//                         CREATE INTERPOLATED STATE
+//                              INTERPOLATE Y
 //==============================================================================
-// Create an interpolated state at time t, which is between tPrev and tCurrent.
-// If we haven't yet delivered an interpolated state in this interval, we have
-// to initialize its discrete part from the advanced state.
-void ExplicitEulerIntegratorRep::createInterpolatedState(Real t) {
-    const System& system   = getSystem();
-    const State&  advanced = getAdvancedState();
-    State&        interp   = updInterpolatedState();
-    interp = advanced; // pick up discrete stuff.
+// Evaluate the continuous state variables at time t, which is between tPrev 
+// and tCurrent, by linear interpolation.
+void ExplicitEulerIntegratorRep::interpolateY(Real t, Vector& y) {
     const Real weight1 = (getAdvancedTime()-t) /
                          (getAdvancedTime()-getPreviousTime());
     const Real weight2 = 1-weight1;
-    interp.updY() = weight1*getPreviousY()+weight2*getAdvancedState().getY();
-    interp.updTime() = t;
-
-    if (userProjectInterpolatedStates == 0) {
-        system.realize(interp, Stage::Time);
-        system.prescribeQ(interp);
-        system.realize(interp, Stage::Position);
-        system.prescribeU(interp);
-        system.realize(interp, Stage::Velocity);
-        return;
-    }
-
-    // We may need to project onto constraint manifold. Allow project()
-    // to throw an exception if it fails since there is no way to recover here.
-    realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
+    const Vector& y0 = getPreviousY();
+    const Vector& y1 = getAdvancedState().getY();
+    y.resize(y0.size());
+    for (int i=0; i<y0.size(); ++i)
+        y[i] = weight1*y0[i]+weight2*y1[i];
 }
 
 
@@ -98,7 +83,12 @@ void ExplicitEulerIntegratorRep::backUpAdvancedStateByInterpolation(Real t) {
     State& advanced = updAdvancedState();
 
     assert(getPreviousTime() <= t && t <= advanced.getTime());
-    advanced.updY() = getPreviousY() + (t-getPreviousTime())*getPreviousYDot();
+    const Real h = t-getPreviousTime();
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
+    Vector& y = advanced.updY();
+    for (int i=0; i<y.size(); ++i)
+        y[i] = y0[i] + h*f0[i];
     advanced.updTime() = t;
 
     // Ignore any user request not to project interpolated states here -- this
@@ -135,9 +125,13 @@ bool ExplicitEulerIntegratorRep::attemptDAEStep
     const Real h = t1 - getPreviousTime();
 
     // Take the step.
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
     advanced.updTime() = t1;
-    advanced.updY()    = getPreviousY() + h*getPreviousYDot();
-    yErrEst = advanced.getY(); // save unprojected Y for error estimate
+    Vector& y1 = advanced.updY();
+    for (int i=0; i<y1.size(); ++i)
+        y1[i] = y0[i] + h*f0[i];
+    yErrEst = y1; // save unprojected Y for error estimate
 
     system.realize(advanced, Stage::Time);
     system.prescribeQ(advanced);
@@ -147,9 +141,8 @@ bool ExplicitEulerIntegratorRep::attemptDAEStep
     // projection prior to calculating prescribed u's since the prescription
     // can depend on q's. Prevent project() from throwing an exception since
     // failure here may be recoverable.
-    Vector dummy; // no error estimate to project
-    bool anyChanges;
-    if (!localProjectQAndQErrEstNoThrow(advanced, dummy, anyChanges))
+    bool anyChanges; // noErrEst is empty; there's no error estimate to project
+    if (!localProjectQAndQErrEstNoThrow(advanced, noErrEst, anyChanges))
         return false; // convergence failure for this step
 
     // q's satisfy the position constraint manifold. Now work on u's.
@@ -161,7 +154,7 @@ bool ExplicitEulerIntegratorRep::attemptDAEStep
     // velocity constraints are already satisfied unless user has set the
     // ForceProjection option.
 
-    if (!localProjectUAndUErrEstNoThrow(advanced, dummy, anyChanges))
+    if (!localProjectUAndUErrEstNoThrow(advanced, noErrEst, anyChanges))
         return false; // convergence failure for this step
 
     // Now calculate derivatives at the end of this interval/start of next
@@ -173,7 +166,9 @@ bool ExplicitEulerIntegratorRep::attemptDAEStep
     // it to estimate error.
     //TODO: this is an odd mix of the unprojected Y and the projected YDot;
     //probably not right!
-    yErrEst -= getPreviousY() + (h/2)*(getPreviousYDot()+advanced.getYDot());
+    const Vector& f1 = advanced.getYDot();
+    for (int i=0; i<yErrEst.size(); ++i)
+        yErrEst[i] -= y0[i] + (h/2)*(f0[i]+f1[i]);
     errOrder = 2;
     numIterations = 1;
     return true;
@@ -34,8 +34,14 @@ public:
 protected:
     bool attemptDAEStep
        (Real t1, Vector& yErrEst, int& errOrder, int& numIterations);
-    void createInterpolatedState(Real t);
+    void interpolateY(Real t, Vector& y);
+    void calcDenseOutput(Integrator::DenseOutput& dense) const
+    {   calcLinearDenseOutput(dense); }
     void backUpAdvancedStateByInterpolation(Real t);
+private:
+    // This is always empty; it is passed to the projection methods when
+    // there is no error estimate to project.
+    Vector noErrEst;
 };
 
 } // namespace SimTK
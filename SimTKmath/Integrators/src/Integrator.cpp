@@ -167,6 +167,20 @@ State& Integrator::updAdvancedState() {
     return updRep().updAdvancedState();
 }
 
+int Integrator::getNumDenseOutputRecords() const {
+    return getRep().getNumDenseOutputRecords();
+}
+
+const Integrator::DenseOutput& Integrator::getDenseOutput(int i) const {
+    SimTK_INDEXCHECK_ALWAYS(i, getRep().getNumDenseOutputRecords(),
+        "Integrator::getDenseOutput()");
+    return getRep().getDenseOutput(i);
+}
+
+void Integrator::clearDenseOutput() {
+    updRep().clearDenseOutput();
+}
+
 
 Real Integrator::getAccuracyInUse() const {
     return getRep().getAccuracyInUse();
@@ -232,6 +246,18 @@ int Integrator::getNumDivergentIterations() const {
 int Integrator::getNumIterations() const {
     return getRep().getNumIterations();
 }
+int Integrator::getNumDeadlineMisses() const {
+    return getRep().getNumDeadlineMisses();
+}
+Real Integrator::getWorstStepWallTime() const {
+    return getRep().getWorstStepWallTime();
+}
+Real Integrator::getPreviousStepWallTime() const {
+    return getRep().getPreviousStepWallTime();
+}
+const Array_<int>& Integrator::getStepWallTimeHistogram() const {
+    return getRep().getStepWallTimeHistogram();
+}
 
 void Integrator::setFinalTime(Real tFinal) {
     assert(tFinal == -1. || (0. <= tFinal));
@@ -294,6 +320,34 @@ void Integrator::setAllowInterpolation(bool shouldInterpolate) {
 void Integrator::setProjectInterpolatedStates(bool shouldProject) {
     updRep().userProjectInterpolatedStates = shouldProject ? 1 : 0;
 }
+bool Integrator::isInterpolatedStateProjectionInUse() const
+{   return getRep().userProjectInterpolatedStates != 0; }
+void Integrator::setUseFastEventLocalization(bool useFastLocalization) {
+    updRep().userUseFastEventLocalization = useFastLocalization ? 1 : 0;
+}
+bool Integrator::isFastEventLocalizationInUse() const
+{   return getRep().userUseFastEventLocalization == 1; }
+
+void Integrator::setRecordDenseOutput(bool shouldRecord) {
+    updRep().userRecordDenseOutput = shouldRecord ? 1 : 0;
+}
+bool Integrator::isDenseOutputRecorded() const
+{   return getRep().userRecordDenseOutput == 1; }
+
+void Integrator::setUseRealTimeMode(bool useRealTimeMode) {
+    updRep().userUseRealTimeMode = useRealTimeMode ? 1 : 0;
+}
+bool Integrator::isRealTimeModeInUse() const
+{   return getRep().isRealTimeModeInUse(); }
+
+void Integrator::setMaximumProjectionIterations(int maxIterations) {
+    updRep().userMaxProjectionIterations = maxIterations > 0 ? maxIterations
+                                                             : -1;
+}
+void Integrator::setStepDeadline(Real seconds) {
+    assert(seconds == -1. || seconds > 0.);
+    updRep().userStepDeadline = seconds;
+}
 
 bool Integrator::methodHasErrorControl() const {
     return getRep().methodHasErrorControl();
@@ -311,6 +365,42 @@ int Integrator::getMethodMaxOrder() const {
     return getRep().getMethodMaxOrder();
 }
 
+    ///////////////////////////////////////////////
+    // IMPLEMENTATION OF INTEGRATOR::DENSE OUTPUT //
+    ///////////////////////////////////////////////
+
+void Integrator::DenseOutput::evaluate(Real t, Vector& y) const {
+    SimTK_ERRCHK_ALWAYS(!isEmpty(), "Integrator::DenseOutput::evaluate()",
+        "There is no polynomial to evaluate.");
+    const Real fuzz = SignificantReal * std::max(Real(1), std::abs(tEnd));
+    SimTK_ERRCHK3_ALWAYS(tStart-fuzz <= t && t <= tEnd+fuzz, 
+        "Integrator::DenseOutput::evaluate()",
+        "Time %g is outside the interval [%g,%g] covered by this record.",
+        t, tStart, tEnd);
+
+    // Horner's rule, in place.
+    const Real s = (t-tRef)/h;
+    const int d = getDegree();
+    y = coefficients(d);
+    for (int k=d-1; k >= 0; --k) {
+        y *= s;
+        y += coefficients(k);
+    }
+}
+
+void Integrator::DenseOutput::clear() {
+    tStart = tEnd = tRef = h = NaN;
+    coefficients.clear();
+}
+
+Matrix& Integrator::DenseOutput::setPolynomial
+   (int ny, int d, Real t0, Real t1, Real ref, Real scale) {
+    assert(ny >= 0 && d >= 0 && t0 <= t1 && scale != 0);
+    tStart = t0; tEnd = t1; tRef = ref; h = scale;
+    coefficients.resize(ny, d+1);
+    return coefficients;
+}
+
     //////////////////////////////////////
     // IMPLEMENTATION OF INTEGRATOR REP //
     //////////////////////////////////////
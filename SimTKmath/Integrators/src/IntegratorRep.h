@@ -258,6 +258,18 @@ public:
     Real getConstraintToleranceInUse() const {return consTol;}
     Real getTimeScaleInUse() const {return timeScaleInUse;}
 
+    bool isRealTimeModeInUse() const {return userUseRealTimeMode == 1;}
+    // The most Newton iterations a single projection may take, or 0 if the
+    // project() method's own limit applies. Real-time mode imposes a small 
+    // limit unless the user chose one.
+    int getMaxProjectionIterationsInUse() const {
+        if (userMaxProjectionIterations > 0)
+            return userMaxProjectionIterations;
+        return isRealTimeModeInUse() ? DefaultRealTimeProjectionIterations : 0;
+    }
+    Real getStepDeadlineInUse() const 
+    {   return userStepDeadline != -1 ? userStepDeadline : Infinity; }
+
     // What was the size of the first successful step after the last initialize() call?
     virtual Real getActualInitialStepSizeTaken() const = 0;
 
@@ -309,7 +321,10 @@ public:
         const Real cy1 = d*d*(3-2*d), cy0 = 1-cy1;
         const Real hdd1 = h*d*(d-1), cf1=hdd1*d, cf0=cf1-hdd1;
 
-        yt = cy0*y0 + cy1*y1 + cf0*f0 + cf1*f1; // + O(h^4)
+        const int ny = y0.size();
+        yt.resize(ny);
+        for (int i=0; i<ny; ++i) // + O(h^4)
+            yt[i] = cy0*y0[i] + cy1*y1[i] + cf0*f0[i] + cf1*f1[i];
     }
 
     // We have bracketed a zero crossing for some function f(t)
@@ -445,30 +460,36 @@ public:
     /// Given a list of events, specified by their indices in the list of trigger functions,
     /// convert them to the corresponding event IDs.
     void findEventIds(const Array_<SystemEventTriggerIndex>& indices, Array_<EventId>& ids) {
+        ids.clear();
         for (int i = 0; i < (int)indices.size(); ++i)
             ids.push_back(eventTriggerInfo[indices[i]].getEventId());
     }
 
     // Calculate the error norm using RMS or Inf norm, and report which y
     // was dominant.
+    // The q, u and z parts of the error estimate are copied into workspace
+    // rather than viewed because creating a view allocates.
     Real calcErrorNorm(const State& s, const Vector& yErrEst, 
                        int& worstY) const {
         const int nq=s.getNQ(), nu=s.getNU(), nz=s.getNZ();
+        copySegment(yErrEst, 0,     nq, qErrEstWork);
+        copySegment(yErrEst, nq,    nu, uErrEstWork);
+        copySegment(yErrEst, nq+nu, nz, zErrEstWork);
         int worstQ, worstU, worstZ;
         Real qNorm, uNorm, zNorm, maxNorm;
         if (userUseInfinityNorm == 1) {
-            qNorm = calcWeightedInfNormQ(s, s.getUWeights(), yErrEst(0,nq),
+            qNorm = calcWeightedInfNormQ(s, s.getUWeights(), qErrEstWork,
                                          worstQ);
-            uNorm = calcWeightedInfNorm(getPreviousUScale(), yErrEst(nq,nu),
+            uNorm = calcWeightedInfNorm(getPreviousUScale(), uErrEstWork,
                                         worstU);
-            zNorm = calcWeightedInfNorm(getPreviousZScale(), yErrEst(nq+nu,nz),
+            zNorm = calcWeightedInfNorm(getPreviousZScale(), zErrEstWork,
                                         worstZ);
         } else {
-            qNorm = calcWeightedRMSNormQ(s, s.getUWeights(), yErrEst(0,nq),
+            qNorm = calcWeightedRMSNormQ(s, s.getUWeights(), qErrEstWork,
                                          worstQ);
-            uNorm = calcWeightedRMSNorm(getPreviousUScale(), yErrEst(nq,nu),
+            uNorm = calcWeightedRMSNorm(getPreviousUScale(), uErrEstWork,
                                         worstU);
-            zNorm = calcWeightedRMSNorm(getPreviousZScale(), yErrEst(nq+nu,nz),
+            zNorm = calcWeightedRMSNorm(getPreviousZScale(), zErrEstWork,
                                         worstZ);
         }
 
@@ -507,28 +528,33 @@ public:
         assert(Wu.size() == nu);
         dqw.resize(nq);
         if (nq==0) return;
-        Vector du(nu);
-        system.multiplyByNPInv(state, dq, du);
-        du.rowScaleInPlace(Wu);
-        system.multiplyByN(state, du, dqw);
+        duWork.resize(nu);
+        system.multiplyByNPInv(state, dq, duWork);
+        for (int i=0; i<nu; ++i) // rowScaleInPlace() would make a view
+            duWork[i] *= Wu[i];
+        system.multiplyByN(state, duWork, dqw);
     }
     // Calculate |Wq*dq|_RMS=|N*Wu*pinv(N)*dq|_RMS
     Real calcWeightedRMSNormQ(const State& state, const Vector& Wu,
                               const Vector& dq, int& worstQ) const
     {
-        const int nq = state.getNQ();
-        Vector dqw(nq);
-        scaleDQ(state, Wu, dq, dqw);
-        return dqw.normRMS(&worstQ);
+        scaleDQ(state, Wu, dq, dqwWork);
+        return dqwWork.normRMS(&worstQ);
     }
     // Calculate |Wq*dq|_Inf=|N*Wu*pinv(N)*dq|_Inf
     Real calcWeightedInfNormQ(const State& state, const Vector& Wu,
                               const Vector& dq, int& worstQ) const
     {
-        const int nq = state.getNQ();
-        Vector dqw(nq);
-        scaleDQ(state, Wu, dq, dqw);
-        return dqw.normInf(&worstQ);
+        scaleDQ(state, Wu, dq, dqwWork);
+        return dqwWork.normInf(&worstQ);
+    }
+
+    // Copy n elements of v starting at v[start] into seg, which is resized
+    // only if it has the wrong size.
+    static void copySegment(const Vector& v, int start, int n, Vector& seg) {
+        seg.resize(n);
+        for (int i=0; i<n; ++i)
+            seg[i] = v[start+i];
     }
 
     // TODO: these utilities don't really belong here
@@ -557,10 +583,42 @@ protected:
     const Array_<EventTriggerInfo>&
         getDynamicSystemEventTriggerInfo()            const {return eventTriggerInfo;}
 
+    int getNumDenseOutputRecords() const {return numDenseOutputRecords;}
+    const Integrator::DenseOutput& getDenseOutput(int i) const 
+    {   return denseOutput[i]; }
+    void clearDenseOutput() {numDenseOutputRecords = 0;}
+    // Make room for one more record and return it for the caller to fill in.
+    // Records beyond the current count are kept from earlier use, so their
+    // coefficient matrices are normally already the right size.
+    Integrator::DenseOutput& appendDenseOutput() {
+        if (numDenseOutputRecords == (int)denseOutput.size())
+            denseOutput.push_back(Integrator::DenseOutput());
+        return denseOutput[numDenseOutputRecords++];
+    }
+
     const State& getInterpolatedState() const {return interpolatedState;}
     State&       updInterpolatedState()       {return interpolatedState;}
 
-    State& updAdvancedState() {return advancedState;}
+    // Return the interpolated state with everything but its time and 
+    // continuous variables copied from the advanced state; the caller must
+    // set those. Copying a State clones every discrete variable and cache
+    // entry, so that is skipped if the interpolated state was already copied
+    // from the advanced state and the advanced state hasn't been modified
+    // since, other than through setAdvancedState().
+    State& updInterpolatedStateFromAdvanced() {
+        if (!interpolatedStateHasAdvancedDiscreteState) {
+            interpolatedState = advancedState;
+            interpolatedStateHasAdvancedDiscreteState = true;
+        }
+        return interpolatedState;
+    }
+
+    // Anything besides the continuous variables might be changed through 
+    // this, so the interpolated state will need a fresh copy.
+    State& updAdvancedState() {
+        interpolatedStateHasAdvancedDiscreteState = false;
+        return advancedState;
+    }
 
     void setAdvancedState(const Real& t, const Vector& y) {
         advancedState.updY() = y;
@@ -579,10 +637,9 @@ protected:
         const int n = eventIds.size();
         assert(n > 0 && estEventTimes.size()==n && transitionsSeen.size()==n);
         triggeredEvents.resize(n); estimatedEventTimes.resize(n); eventTransitionsSeen.resize(n);
-        Array_<int> eventOrder; // will be a permutation of 0:n-1
-        calcEventOrder(eventIds, estEventTimes, eventOrder);
-        for (int i=0; i<(int)eventOrder.size(); ++i) {
-            const int ipos = eventOrder[i];
+        calcEventOrder(eventIds, estEventTimes, eventOrderWork);
+        for (int i=0; i<(int)eventOrderWork.size(); ++i) {
+            const int ipos = eventOrderWork[i];
             triggeredEvents[i] = eventIds[ipos];
 
             assert(tlo < estEventTimes[ipos] && estEventTimes[ipos] <= thi);
@@ -664,10 +721,16 @@ protected:
 
         tPrev        = s.getTime();
 
+        // Assignment reuses yPrev's storage if the size is unchanged, so the
+        // views (which allocate) need to be made again only after a resize.
+        const bool resized = (yPrev.size() != nq+nu+nz || qPrev.size() != nq
+                              || uPrev.size() != nu);
         yPrev        = s.getY();
-        qPrev.viewAssign(yPrev(0,     nq));
-        uPrev.viewAssign(yPrev(nq,    nu));
-        zPrev.viewAssign(yPrev(nq+nu, nz));
+        if (resized) {
+            qPrev.viewAssign(yPrev(0,     nq));
+            uPrev.viewAssign(yPrev(nq,    nu));
+            zPrev.viewAssign(yPrev(nq+nu, nz));
+        }
 
         calcRelativeScaling(s.getU(), s.getUWeights(), uScalePrev); 
         calcRelativeScaling(s.getZ(), s.getZWeights(), zScalePrev);
@@ -681,10 +744,14 @@ protected:
     void saveStateDerivsAsPrevious(const State& s) {
         const int nq = s.getNQ(), nu = s.getNU(), nz = s.getNZ();
 
+        const bool resized = (ydotPrev.size() != nq+nu+nz 
+                              || qdotPrev.size() != nq || udotPrev.size() != nu);
         ydotPrev     = s.getYDot();
-        qdotPrev.viewAssign(ydotPrev(0,     nq));
-        udotPrev.viewAssign(ydotPrev(nq,    nu));
-        zdotPrev.viewAssign(ydotPrev(nq+nu, nz));
+        if (resized) {
+            qdotPrev.viewAssign(ydotPrev(0,     nq));
+            udotPrev.viewAssign(ydotPrev(nq,    nu));
+            zdotPrev.viewAssign(ydotPrev(nq+nu, nz));
+        }
 
         qdotdotPrev  = s.getQDotDot();
         triggersPrev = s.getEventTriggers();
@@ -711,6 +778,12 @@ protected:
     int  userAllowInterpolation;        //      "
     int  userProjectInterpolatedStates; //      "
     int  userForceFullNewton;           //      "
+    int  userUseFastEventLocalization;  //      "
+    int  userRecordDenseOutput;         //      "
+    int  userUseRealTimeMode;           //      "
+
+    int  userMaxProjectionIterations;   // per projection; <= 0 means no limit
+    Real userStepDeadline;              // wall clock seconds per step
 
     // Mark all user-supplied options "not supplied by user".
     void initializeUserStuff() {
@@ -718,11 +791,15 @@ protected:
         userAccuracy = userConsTol = -1.;
         userFinalTime = -1.;
         userInternalStepLimit = -1;
+        userMaxProjectionIterations = -1;
+        userStepDeadline = -1.;
 
         // booleans
         userUseInfinityNorm = userReturnEveryInternalStep = 
             userProjectEveryStep = userAllowInterpolation = 
-            userProjectInterpolatedStates = userForceFullNewton = -1;
+            userProjectInterpolatedStates = userForceFullNewton = 
+            userUseFastEventLocalization = userRecordDenseOutput = 
+            userUseRealTimeMode = -1;
 
         accuracyInUse = NaN;
         consTol  = NaN;
@@ -781,14 +858,20 @@ protected:
             options.setOption(ProjectOptions::UseInfinityNorm);
         if (userForceFullNewton==1)
             options.setOption(ProjectOptions::ForceFullNewton);
+        options.setMaxIterations(getMaxProjectionIterationsInUse());
 
         anyChanges = false;
         ProjectResults results;
         // Nothing happens here if position constraints were already satisfied
         // unless we set the ForceProjection option above.
+        // The q part of yErrEst is projected in workspace and copied back
+        // since making a view of it would allocate.
+        const int nq = s.getNQ();
         if (yErrEst.size()) {
-            VectorView qErrEst = yErrEst(0, s.getNQ());
-            getSystem().projectQ(s, qErrEst, options, results);
+            copySegment(yErrEst, 0, nq, qErrEstWork);
+            getSystem().projectQ(s, qErrEstWork, options, results);
+            for (int i=0; i<nq; ++i)
+                yErrEst[i] = qErrEstWork[i];
         } else {
             getSystem().projectQ(s, yErrEst, options, results);
         }
@@ -824,14 +907,18 @@ protected:
             options.setOption(ProjectOptions::UseInfinityNorm);
         if (userForceFullNewton==1)
             options.setOption(ProjectOptions::ForceFullNewton);
+        options.setMaxIterations(getMaxProjectionIterationsInUse());
 
         anyChanges = false;
         ProjectResults results;
         // Nothing happens here if velocity constraints were already satisfied
         // unless we set the ForceProjection option above.
+        const int nq = s.getNQ(), nu = s.getNU();
         if (yErrEst.size()) {
-            VectorView uErrEst = yErrEst(s.getNQ(), s.getNU());
-            getSystem().projectU(s, uErrEst, options, results);
+            copySegment(yErrEst, nq, nu, uErrEstWork);
+            getSystem().projectU(s, uErrEstWork, options, results);
+            for (int i=0; i<nu; ++i)
+                yErrEst[nq+i] = uErrEstWork[i];
         } else {
             getSystem().projectU(s, yErrEst, options, results);
         }
@@ -877,10 +964,9 @@ protected:
         system.prescribeQ(s);
         system.realize(s, Stage::Position);
 
-        Vector dummy; // no error estimate to project
         ProjectResults results;
         ++statsQProjectionFailures; // assume failure, then fix if no throw
-        system.projectQ(s, dummy, options, results);
+        system.projectQ(s, noErrEst, options, results);
         --statsQProjectionFailures; // false alarm -- it succeeded
         if (results.getAnyChangeMade())
             ++statsQProjections;
@@ -890,7 +976,7 @@ protected:
 
         results.clear();
         ++statsUProjectionFailures; // assume failure, then fix if no throw
-        system.projectU(s, dummy, options, results);
+        system.projectU(s, noErrEst, options, results);
         --statsUProjectionFailures; // false alarm -- it succeeded
         if (results.getAnyChangeMade())
             ++statsUProjections;
@@ -939,6 +1025,11 @@ protected:
         statsQProjections = statsUProjections = 0;
         statsRealizationFailures = 0;
         statsQProjectionFailures = statsUProjectionFailures = 0;
+        statsDeadlineMisses = 0;
+        statsWorstStepWallTime = statsPreviousStepWallTime = 0;
+        statsStepWallTimeHistogram.resize(NumStepWallTimeBins);
+        for (int i=0; i < NumStepWallTimeBins; ++i)
+            statsStepWallTimeHistogram[i] = 0;
     }
 
     int getNumRealizations() const {return statsRealizations;} 
@@ -949,6 +1040,34 @@ protected:
     int getNumQProjectionFailures() const {return statsQProjectionFailures;} 
     int getNumUProjectionFailures() const {return statsUProjectionFailures;} 
 
+    int getNumDeadlineMisses() const {return statsDeadlineMisses;}
+    Real getWorstStepWallTime() const {return statsWorstStepWallTime;}
+    Real getPreviousStepWallTime() const {return statsPreviousStepWallTime;}
+    const Array_<int>& getStepWallTimeHistogram() const 
+    {   return statsStepWallTimeHistogram; }
+
+    // Number of bins in the step wall time histogram. Bin 0 counts steps 
+    // that took less than 1us, bin i>0 those that took [2^(i-1),2^i) us, and
+    // the last bin also counts everything slower.
+    static const int NumStepWallTimeBins = 24;
+    // Projection iteration limit in real-time mode if the user didn't set one.
+    static const int DefaultRealTimeProjectionIterations = 3;
+
+    // Add the wall clock time taken by one step, in nanoseconds, to the
+    // real-time statistics.
+    void recordStepWallTime(long long ns) {
+        const Real seconds = Real(nsToSec(ns));
+        statsPreviousStepWallTime = seconds;
+        statsWorstStepWallTime = std::max(statsWorstStepWallTime, seconds);
+        if (seconds > getStepDeadlineInUse())
+            ++statsDeadlineMisses;
+        long long us = ns/1000;
+        int bin = 0;
+        while (us > 0 && bin < NumStepWallTimeBins-1) 
+        {   us >>= 1; ++bin; }
+        ++statsStepWallTimeHistogram[bin];
+    }
+
 private:
     class EventSorter {
     public:
@@ -982,7 +1101,8 @@ private:
         }
 
         // otherwise sort
-        Array_<EventSorter> events(n);
+        Array_<EventSorter>& events = eventSortWork;
+        events.resize(n);
         for (unsigned i=0; i<n; ++i)
             events[i] = EventSorter(i, eventIds[i], estEventTimes[i]);
         std::sort(events.begin(), events.end());
@@ -1004,6 +1124,25 @@ protected:
     mutable int statsQProjections, statsUProjections;
     mutable int statsRealizations;
     mutable int statsRealizationFailures;
+    // step timing is recorded only in real-time mode
+    int statsDeadlineMisses;
+    Real statsWorstStepWallTime, statsPreviousStepWallTime;
+    Array_<int> statsStepWallTimeHistogram;
+
+    // Lock the shapes of the workspaces that are in use, so that any attempt
+    // to resize them throws rather than allocates; or unlock them. Each level
+    // of integrator that keeps workspaces of its own overrides this to lock
+    // them too, and calls the method it overrides.
+    virtual void lockWorkspaceShapes(bool lock) {
+        Vector* work[] = {&qErrEstWork, &uErrEstWork, &zErrEstWork, 
+                          &dqwWork, &duWork};
+        for (int i=0; i < 5; ++i)
+            lockShapeIfSized(*work[i], lock);
+    }
+    static void lockShapeIfSized(Vector& v, bool lock) {
+        if (!lock) v.unlockShape();
+        else if (v.size()) v.lockShape();
+    }
 private:
 
         // SYSTEM INFORMATION
@@ -1077,12 +1216,26 @@ private:
     // at the event trigger functions at tLow and tHigh.
     Array_<Event::Trigger> eventTransitionsSeen;
 
+    // Workspace for setTriggeredEvents(); eventOrderWork is a permutation of
+    // the triggered events putting them in time order.
+    Array_<int>         eventOrderWork;
+    Array_<EventSorter> eventSortWork;
+
     // When we have successfully localized a triggering event into
     // the time interval (tLow,tHigh] we record the bounds here.
     Real    tLow, tHigh;
 
+    // The continuous extensions of the internal steps taken since the user
+    // last cleared them, if the user asked for them to be recorded. Only the
+    // first numDenseOutputRecords entries are in use.
+    Array_<Integrator::DenseOutput> denseOutput;
+    int                             numDenseOutputRecords;
+
     State   interpolatedState;    // might be unused
     bool    useInterpolatedState;
+    // Whether interpolatedState holds a copy of advancedState's discrete 
+    // variables; see updInterpolatedStateFromAdvanced().
+    bool    interpolatedStateHasAdvancedDiscreteState;
 
     // Use these to record the continuous part of the previous
     // accepted state. We use these in combination with the 
@@ -1109,6 +1262,15 @@ private:
     Vector qPrev, uPrev, zPrev;
     Vector qdotPrev, udotPrev, zdotPrev;
 
+    // Workspace for error norms and projection of the error estimate. These
+    // are sized on first use and then reused so that taking a step doesn't
+    // allocate.
+    mutable Vector qErrEstWork, uErrEstWork, zErrEstWork;
+    mutable Vector dqwWork, duWork;
+
+    // Always empty; passed to projection when there is no error estimate.
+    Vector noErrEst;
+
     // We'll leave the various arrays above sized as they are and full
     // of garbage. They'll be resized when first assigned to something
     // meaningful.
@@ -1118,7 +1280,9 @@ private:
         idealNextStepSize       = NaN;
         tLow = tHigh            = NaN;
         useInterpolatedState    = false;
+        interpolatedStateHasAdvancedDiscreteState = false;
         tPrev                   = NaN;
+        numDenseOutputRecords   = 0;
     }
 
     // suppress
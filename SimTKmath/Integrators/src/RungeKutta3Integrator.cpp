@@ -57,6 +57,12 @@ RungeKutta3IntegratorRep::RungeKutta3IntegratorRep
 :   AbstractIntegratorRep(handle, sys, 3, 3, "RungeKutta3",  true) {
 }
 
+void RungeKutta3IntegratorRep::lockWorkspaceShapes(bool lock) {
+    AbstractIntegratorRep::lockWorkspaceShapes(lock);
+    for (int i=0; i<NTemps; ++i)
+        lockShapeIfSized(ytmp[i], lock);
+}
+
 // For a discussion of this Runge-Kutta 3(2) method, see J.C. Butcher, "The 
 // Numerical Analysis of Ordinary Differential Equations", John Wiley & Sons,
 // 1987, page 325. The embedded error estimate was derived using the method
@@ -96,13 +102,17 @@ bool RungeKutta3IntegratorRep::attemptODEStep
             ytmp[i].resize(y0.size());
     Vector& f1    = ytmp[0]; // rename temps
     Vector& f2    = ytmp[1];
+    Vector& ystg  = ytmp[2];
 
     const Real h = t1-t0;
+    const int ny = y0.size();
 
-    setAdvancedStateAndRealizeDerivatives(t0+h/2, y0 + (h/2)*f0);
+    for (int i=0; i<ny; ++i) ystg[i] = y0[i] + (h/2)*f0[i];
+    setAdvancedStateAndRealizeDerivatives(t0+h/2, ystg);
     f1 = getAdvancedState().getYDot();
 
-    setAdvancedStateAndRealizeDerivatives(t1,     y0 + h*(2*f1-f0));
+    for (int i=0; i<ny; ++i) ystg[i] = y0[i] + h*(2*f1[i]-f0[i]);
+    setAdvancedStateAndRealizeDerivatives(t1,     ystg);
     f2 = getAdvancedState().getYDot();
 
     // Final value. This is the 3rd order accurate estimate for 
@@ -110,7 +120,8 @@ bool RungeKutta3IntegratorRep::attemptODEStep
     // Evaluate through kinematics only; it is a waste of a stage to 
     // evaluate derivatives here since the caller will muck with this before
     // the end of the step.
-    setAdvancedStateAndRealizeKinematics(t1,      y0 + (h/6)*(f0 + 4*f1 + f2));
+    for (int i=0; i<ny; ++i) ystg[i] = y0[i] + (h/6)*(f0[i] + 4*f1[i] + f2[i]);
+    setAdvancedStateAndRealizeKinematics(t1,      ystg);
     // YErr is valid now
 
     // This is an embedded 2nd-order estimate y1hat=y(t1)+O(h^3), with
@@ -58,6 +58,12 @@ RungeKuttaMersonIntegratorRep::RungeKuttaMersonIntegratorRep
 :   AbstractIntegratorRep(handle, sys, 4, 4, "RungeKuttaMerson",  true) {
 }
 
+void RungeKuttaMersonIntegratorRep::lockWorkspaceShapes(bool lock) {
+    AbstractIntegratorRep::lockWorkspaceShapes(lock);
+    for (int i=0; i<NTemps; ++i)
+        lockShapeIfSized(ytmp[i], lock);
+}
+
 // For a discussion of the Runge-Kutta-Merson method, see Hairer,
 // Norsett & Wanner, Solving ODEs I, 2nd rev. ed. pp. 166-8, and table 4.1
 // on page 167. This is the Butcher diagram:
@@ -99,20 +105,26 @@ bool RungeKuttaMersonIntegratorRep::attemptODEStep
     Vector& ysave = ytmp[0]; // rename temps
     Vector& fa    = ytmp[1];
     Vector& fb    = ytmp[2];
+    Vector& ystg  = ytmp[3];
 
     const Real h = t1-t0;
+    const int ny = y0.size();
 
-    setAdvancedStateAndRealizeDerivatives(t0+h/3, y0 + (h/3)*f0);
+    for (int i=0; i<ny; ++i) ystg[i] = y0[i] + (h/3)*f0[i];
+    setAdvancedStateAndRealizeDerivatives(t0+h/3, ystg);
     fa = getAdvancedState().getYDot(); // fa=f1
 
-    setAdvancedStateAndRealizeDerivatives(t0+h/3, y0 + (h/6)*(f0+fa)); // f0+f1
+    for (int i=0; i<ny; ++i) ystg[i] = y0[i] + (h/6)*(f0[i]+fa[i]); // f0+f1
+    setAdvancedStateAndRealizeDerivatives(t0+h/3, ystg);
     fa = getAdvancedState().getYDot(); // fa=f2
 
-    setAdvancedStateAndRealizeDerivatives(t0+h/2, y0 + (h/8)*(f0 + 3*fa)); // f0+3f2
+    for (int i=0; i<ny; ++i) ystg[i] = y0[i] + (h/8)*(f0[i] + 3*fa[i]); // f0+3f2
+    setAdvancedStateAndRealizeDerivatives(t0+h/2, ystg);
     fb = getAdvancedState().getYDot(); // fb=f3
 
     // We'll need this for error estimation.
-    ysave = y0 + (h/2)*(f0 - 3*fa + 4*fb); // f0-3f2+4f3
+    for (int i=0; i<ny; ++i) // f0-3f2+4f3
+        ysave[i] = y0[i] + (h/2)*(f0[i] - 3*fa[i] + 4*fb[i]);
     setAdvancedStateAndRealizeDerivatives(t1, ysave);
     fa = getAdvancedState().getYDot(); // fa=f4
 
@@ -121,7 +133,8 @@ bool RungeKuttaMersonIntegratorRep::attemptODEStep
     // Evaluate through kinematics only; it is a waste of a stage to 
     // evaluate derivatives here since the caller will muck with this before
     // the end of the step.
-    setAdvancedStateAndRealizeKinematics(t1, y0 + (h/6)*(f0 + 4*fb + fa));
+    for (int i=0; i<ny; ++i) ystg[i] = y0[i] + (h/6)*(f0[i] + 4*fb[i] + fa[i]);
+    setAdvancedStateAndRealizeKinematics(t1, ystg);
     // YErr is valid now
 
     // This is an embedded 3rd-order estimate y1hat=y(t0+h)+O(h^4). (Apparently
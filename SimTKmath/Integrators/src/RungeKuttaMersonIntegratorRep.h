@@ -40,8 +40,11 @@ public:
 protected:
     bool attemptODEStep
        (Real t1, Vector& yErrEst, int& errOrder, int& numIterations);
+    void lockWorkspaceShapes(bool lock);
 private:    
-    static const int NTemps = 3;
+    // These are sized once and reused for every step; the last one holds
+    // the y argument for each stage so that no temporaries are created.
+    static const int NTemps = 4;
     Vector ytmp[NTemps];
 };
 
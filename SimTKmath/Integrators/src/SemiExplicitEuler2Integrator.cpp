@@ -47,12 +47,18 @@ SemiExplicitEuler2IntegratorRep::SemiExplicitEuler2IntegratorRep
 {
 }
 
+void SemiExplicitEuler2IntegratorRep::lockWorkspaceShapes(bool lock) {
+    AbstractIntegratorRep::lockWorkspaceShapes(lock);
+    Vector* work[] = {&m_qdotTmp, &m_qBig, &m_uBig, &m_zBig};
+    for (int i=0; i < 4; ++i)
+        lockShapeIfSized(*work[i], lock);
+}
+
 //==============================================================================
-//                         CREATE INTERPOLATED STATE
+//                              INTERPOLATE Y
 //==============================================================================
-// Create an interpolated state at time t, which is between tPrev and tCurrent.
-// If we haven't yet delivered an interpolated state in this interval, we have
-// to initialize its discrete part from the advanced state.
+// Evaluate the continuous state variables at time t, which is between tPrev 
+// and tCurrent, by linear interpolation.
 //
 // TODO: Note that this is a first-order interpolation across the *whole* step, 
 // even though this integrator takes two smaller first-order substeps. It would
@@ -61,29 +67,11 @@ SemiExplicitEuler2IntegratorRep::SemiExplicitEuler2IntegratorRep
 // the underlying steps. Alternately, the midpoint value could be used to
 // perform a second-order interpolation here; I'm not sure whether that would
 // be better.
-void SemiExplicitEuler2IntegratorRep::createInterpolatedState(Real t) {
-    const System& system   = getSystem();
-    const State&  advanced = getAdvancedState();
-    State&        interp   = updInterpolatedState();
-    interp = advanced; // pick up discrete stuff.
+void SemiExplicitEuler2IntegratorRep::interpolateY(Real t, Vector& y) {
     const Real weight1 = (getAdvancedTime()-t) /
                          (getAdvancedTime()-getPreviousTime());
     const Real weight2 = 1-weight1;
-    interp.updY() = weight1*getPreviousY()+weight2*getAdvancedState().getY();
-    interp.updTime() = t;
-
-    if (userProjectInterpolatedStates == 0) {
-        system.realize(interp, Stage::Time);
-        system.prescribeQ(interp);
-        system.realize(interp, Stage::Position);
-        system.prescribeU(interp);
-        system.realize(interp, Stage::Velocity);
-        return;
-    }
-
-    // We may need to project onto constraint manifold. Allow project()
-    // to throw an exception if it fails since there is no way to recover here.
-    realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
+    y = weight1*getPreviousY()+weight2*getAdvancedState().getY();
 }
 
 
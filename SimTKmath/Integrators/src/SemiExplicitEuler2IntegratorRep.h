@@ -34,8 +34,11 @@ public:
 protected:
     bool attemptDAEStep
        (Real t1, Vector& yErrEst, int& errOrder, int& numIterations);
-    void createInterpolatedState(Real t);
+    void interpolateY(Real t, Vector& y);
+    void calcDenseOutput(Integrator::DenseOutput& dense) const
+    {   calcLinearDenseOutput(dense); }
     void backUpAdvancedStateByInterpolation(Real t);
+    void lockWorkspaceShapes(bool lock);
 private:
     Vector m_qdotTmp, m_qBig, m_uBig, m_zBig;
 };
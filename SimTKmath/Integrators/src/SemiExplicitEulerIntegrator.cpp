@@ -49,34 +49,15 @@ SemiExplicitEulerIntegratorRep::SemiExplicitEulerIntegratorRep
 }
 
 //==============================================================================
-//                         CREATE INTERPOLATED STATE
+//                              INTERPOLATE Y
 //==============================================================================
-// Create an interpolated state at time t, which is between tPrev and tCurrent.
-// If we haven't yet delivered an interpolated state in this interval, we have
-// to initialize its discrete part from the advanced state.
-void SemiExplicitEulerIntegratorRep::createInterpolatedState(Real t) {
-    const System& system   = getSystem();
-    const State&  advanced = getAdvancedState();
-    State&        interp   = updInterpolatedState();
-    interp = advanced; // pick up discrete stuff.
+// Evaluate the continuous state variables at time t, which is between tPrev 
+// and tCurrent, by linear interpolation.
+void SemiExplicitEulerIntegratorRep::interpolateY(Real t, Vector& y) {
     const Real weight1 = (getAdvancedTime()-t) /
                          (getAdvancedTime()-getPreviousTime());
     const Real weight2 = 1-weight1;
-    interp.updY() = weight1*getPreviousY()+weight2*getAdvancedState().getY();
-    interp.updTime() = t;
-
-    if (userProjectInterpolatedStates == 0) {
-        system.realize(interp, Stage::Time);
-        system.prescribeQ(interp);
-        system.realize(interp, Stage::Position);
-        system.prescribeU(interp);
-        system.realize(interp, Stage::Velocity);
-        return;
-    }
-
-    // We may need to project onto constraint manifold. Allow project()
-    // to throw an exception if it fails since there is no way to recover here.
-    realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
+    y = weight1*getPreviousY()+weight2*getAdvancedState().getY();
 }
 
 
@@ -34,7 +34,9 @@ public:
 protected:
     bool attemptDAEStep
        (Real t1, Vector& yErrEst, int& errOrder, int& numIterations);
-    void createInterpolatedState(Real t);
+    void interpolateY(Real t, Vector& y);
+    void calcDenseOutput(Integrator::DenseOutput& dense) const
+    {   calcLinearDenseOutput(dense); }
     void backUpAdvancedStateByInterpolation(Real t);
 };
 
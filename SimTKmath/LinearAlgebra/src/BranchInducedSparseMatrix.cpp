@@ -0,0 +1,245 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/**@file
+ *
+ * Symmetric matrices with branch-induced sparsity, and their LTL and LTDL
+ * factorizations. The algorithms are from R. Featherstone, "Efficient
+ * factorization of the joint-space inertia matrix for branched kinematic
+ * trees", Int. J. Robotics Research 24(6):487-500, 2005.
+ */
+
+#include "SimTKcommon.h"
+
+#include "simmath/internal/common.h"
+#include "simmath/LinearAlgebra.h"
+
+#include <cmath>
+
+namespace SimTK {
+
+// Each row i stores the entries (i,i), (i,p(i)), (i,p(p(i))), ... in that
+// order, where p() is the parent array. So if row j=p^k(i) is an ancestor of
+// row i, row j's entries are stored in the same order as row i's entries
+// starting at k. All the algorithms below rely on that.
+
+BranchInducedSparseMatrix::
+BranchInducedSparseMatrix(const Array_<int>& parents)
+:   factorization(NotFactored) {
+    setStructure(parents);
+}
+
+void BranchInducedSparseMatrix::setStructure(const Array_<int>& parents) {
+    const int n = (int)parents.size();
+    Array_<int> depth(n), start(n+1);
+    start[0] = 0;
+    for (int i=0; i < n; ++i) {
+        const int p = parents[i];
+        SimTK_ERRCHK3_ALWAYS(-1 <= p && p < i,
+            "BranchInducedSparseMatrix::setStructure()",
+            "Parent of row %d was %d but must be -1 or in the range 0..%d.",
+            i, p, i-1);
+        depth[i] = (p < 0 ? 0 : depth[p]+1);
+        start[i+1] = start[i] + depth[i] + 1;
+    }
+    parent = parents;
+    rowStart.swap(start);
+    entries.resize(rowStart[n]);
+    setToZero();
+}
+
+void BranchInducedSparseMatrix::setToZero() {
+    entries.fill(Real(0));
+    factorization = NotFactored;
+}
+
+Real BranchInducedSparseMatrix::getEntry(int i, int j) const {
+    SimTK_INDEXCHECK_ALWAYS(i, size(), "BranchInducedSparseMatrix::getEntry()");
+    SimTK_INDEXCHECK_ALWAYS(j, size(), "BranchInducedSparseMatrix::getEntry()");
+    if (j > i) std::swap(i,j); // symmetric
+    const Real* row = &entries[rowStart[i]];
+    for (int a=i, k=0; a >= j; a=parent[a], ++k)
+        if (a == j) return row[k];
+    return 0; // j isn't an ancestor of i
+}
+
+Real& BranchInducedSparseMatrix::updEntry(int i, int j) {
+    SimTK_INDEXCHECK_ALWAYS(i, size(), "BranchInducedSparseMatrix::updEntry()");
+    SimTK_INDEXCHECK_ALWAYS(j, size(), "BranchInducedSparseMatrix::updEntry()");
+    if (j > i) std::swap(i,j); // symmetric
+    Real* row = &entries[rowStart[i]];
+    for (int a=i, k=0; a >= 0; a=parent[a], ++k)
+        if (a == j) {factorization = NotFactored; return row[k];}
+    SimTK_ERRCHK2_ALWAYS(false, "BranchInducedSparseMatrix::updEntry()",
+        "Entry (%d,%d) is not in the sparsity pattern; one index must be an "
+        "ancestor of the other.", i, j);
+    return row[0]; // can't get here
+}
+
+ArrayViewConst_<Real> BranchInducedSparseMatrix::getRow(int i) const {
+    SimTK_INDEXCHECK_ALWAYS(i, size(), "BranchInducedSparseMatrix::getRow()");
+    const Real* p = entries.cbegin();
+    return ArrayViewConst_<Real>(p+rowStart[i], p+rowStart[i+1]);
+}
+
+ArrayView_<Real> BranchInducedSparseMatrix::updRow(int i) {
+    SimTK_INDEXCHECK_ALWAYS(i, size(), "BranchInducedSparseMatrix::updRow()");
+    factorization = NotFactored;
+    Real* p = entries.begin();
+    return ArrayView_<Real>(p+rowStart[i], p+rowStart[i+1]);
+}
+
+void BranchInducedSparseMatrix::getAsMatrix(Matrix& M) const {
+    const int n = size();
+    M.resize(n,n); M.setToZero();
+    for (int i=0; i < n; ++i) {
+        const Real* row = &entries[rowStart[i]];
+        for (int a=i, k=0; a >= 0; a=parent[a], ++k)
+            M(i,a) = M(a,i) = row[k];
+    }
+}
+
+// y = A*x where A is symmetric, so each stored off-diagonal entry is used
+// twice. Complexity is O(nnz).
+void BranchInducedSparseMatrix::
+multiply(const Vector& x, Vector& y) const {
+    SimTK_ERRCHK_ALWAYS(factorization == NotFactored,
+        "BranchInducedSparseMatrix::multiply()",
+        "The matrix has been factored in place; its entries are now factors.");
+    const int n = size();
+    SimTK_ERRCHK3_ALWAYS(x.size() == n, "BranchInducedSparseMatrix::multiply()",
+        "Argument 'x' had length %d but the matrix is %d X %d.", x.size(), n, n);
+    y.resize(n); y.setToZero();
+    for (int i=0; i < n; ++i) {
+        const Real* row = &entries[rowStart[i]];
+        y[i] += row[0]*x[i];
+        for (int a=parent[i], k=1; a >= 0; a=parent[a], ++k) {
+            y[i] += row[k]*x[a];
+            y[a] += row[k]*x[i];
+        }
+    }
+}
+
+// Factor A = ~L*L in place, with L lower triangular having the same sparsity
+// pattern as A. This is Featherstone's Table 3, working from the last row
+// back. Complexity is O(sum of depth(i)^2), or O(n*d^2) for depth d.
+void BranchInducedSparseMatrix::factorLTL() {
+    SimTK_ERRCHK_ALWAYS(factorization == NotFactored,
+        "BranchInducedSparseMatrix::factorLTL()",
+        "The matrix has already been factored.");
+    for (int k=size()-1; k >= 0; --k) {
+        Real* rowk = &entries[rowStart[k]];
+        const int nk = rowStart[k+1]-rowStart[k];
+        SimTK_ERRCHK2_ALWAYS(rowk[0] > 0,
+            "BranchInducedSparseMatrix::factorLTL()",
+            "The matrix is not positive definite; pivot %d was %g.",
+            k, (double)rowk[0]);
+        rowk[0] = std::sqrt(rowk[0]);
+        for (int a=1; a < nk; ++a)
+            rowk[a] /= rowk[0];
+        // Row i=p^a(k) has entries corresponding to rowk[a..nk-1].
+        for (int i=parent[k], a=1; i >= 0; i=parent[i], ++a) {
+            Real* rowi = &entries[rowStart[i]];
+            for (int b=0; a+b < nk; ++b)
+                rowi[b] -= rowk[a]*rowk[a+b];
+        }
+    }
+    factorization = LTL;
+}
+
+// Factor A = ~L*D*L in place, with L unit lower triangular; D is stored on
+// the diagonal. This is Featherstone's Table 4.
+void BranchInducedSparseMatrix::factorLTDL() {
+    SimTK_ERRCHK_ALWAYS(factorization == NotFactored,
+        "BranchInducedSparseMatrix::factorLTDL()",
+        "The matrix has already been factored.");
+    for (int k=size()-1; k >= 0; --k) {
+        Real* rowk = &entries[rowStart[k]];
+        const int nk = rowStart[k+1]-rowStart[k];
+        SimTK_ERRCHK1_ALWAYS(rowk[0] != 0,
+            "BranchInducedSparseMatrix::factorLTDL()",
+            "The matrix is singular; pivot %d was zero.", k);
+        for (int i=parent[k], a=1; i >= 0; i=parent[i], ++a) {
+            const Real l = rowk[a] / rowk[0];
+            Real* rowi = &entries[rowStart[i]];
+            for (int b=0; a+b < nk; ++b)
+                rowi[b] -= l*rowk[a+b];
+            rowk[a] = l;
+        }
+    }
+    factorization = LTDL;
+}
+
+// Solve ~L*L*x=b or ~L*D*L*x=b. First y = ~L^-1 b working from the last row
+// back (each row of ~L^-1 only involves descendants), then D^-1 if needed,
+// then x = L^-1 y from the first row on. O(nnz) per right hand side.
+void BranchInducedSparseMatrix::solveInPlace(Real* x) const {
+    const int n = size();
+    const bool unit = (factorization == LTDL);
+    for (int i=n-1; i >= 0; --i) {
+        const Real* row = &entries[rowStart[i]];
+        if (!unit) x[i] /= row[0];
+        for (int a=parent[i], k=1; a >= 0; a=parent[a], ++k)
+            x[a] -= row[k]*x[i];
+    }
+    if (unit)
+        for (int i=0; i < n; ++i)
+            x[i] /= entries[rowStart[i]];
+    for (int i=0; i < n; ++i) {
+        const Real* row = &entries[rowStart[i]];
+        for (int a=parent[i], k=1; a >= 0; a=parent[a], ++k)
+            x[i] -= row[k]*x[a];
+        if (!unit) x[i] /= row[0];
+    }
+}
+
+void BranchInducedSparseMatrix::solve(const Vector& b, Vector& x) const {
+    SimTK_ERRCHK_ALWAYS(factorization != NotFactored,
+        "BranchInducedSparseMatrix::solve()",
+        "Call factorLTL() or factorLTDL() before solve().");
+    const int n = size();
+    SimTK_ERRCHK3_ALWAYS(b.size() == n, "BranchInducedSparseMatrix::solve()",
+        "Argument 'b' had length %d but the matrix is %d X %d.", b.size(), n, n);
+    Vector tmp(b); // contiguous copy; b and x may be the same
+    if (n) solveInPlace(&tmp[0]);
+    x = tmp;
+}
+
+void BranchInducedSparseMatrix::solve(const Matrix& B, Matrix& X) const {
+    SimTK_ERRCHK_ALWAYS(factorization != NotFactored,
+        "BranchInducedSparseMatrix::solve()",
+        "Call factorLTL() or factorLTDL() before solve().");
+    const int n = size();
+    SimTK_ERRCHK3_ALWAYS(B.nrow() == n, "BranchInducedSparseMatrix::solve()",
+        "Argument 'B' had %d rows but the matrix is %d X %d.", B.nrow(), n, n);
+    Matrix tmp(B);
+    Vector col(n);
+    for (int j=0; j < tmp.ncol(); ++j) {
+        col = tmp(j);
+        if (n) solveInPlace(&col[0]);
+        tmp(j) = col;
+    }
+    X = tmp;
+}
+
+} // namespace SimTK
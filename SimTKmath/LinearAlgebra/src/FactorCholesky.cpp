@@ -0,0 +1,278 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/**@file
+ *
+ * Cholesky factorization of symmetric positive (semi)definite matrices.
+ */
+
+#include "SimTKcommon.h"
+
+#include "simmath/internal/common.h"
+#include "simmath/LinearAlgebra.h"
+
+#include "LapackInterface.h"
+#include "FactorCholeskyRep.h"
+#include "WorkSpace.h"
+#include "LATraits.h"
+#include "LapackConvert.h"
+
+#include <iostream>
+#include <cmath>
+
+
+namespace SimTK {
+
+   ///////////////////////////
+   // FactorCholeskyDefault //
+   ///////////////////////////
+FactorCholeskyDefault::FactorCholeskyDefault() {
+    isFactored = false;
+}
+FactorCholeskyRepBase* FactorCholeskyDefault::clone() const {
+    return( new FactorCholeskyDefault(*this));
+}
+
+   ////////////////////
+   // FactorCholesky //
+   ////////////////////
+FactorCholesky::~FactorCholesky() {
+    delete rep;
+}
+// default constructor
+FactorCholesky::FactorCholesky() {
+    rep = new FactorCholeskyDefault();
+}
+// copy constructor
+FactorCholesky::FactorCholesky( const FactorCholesky& c ) {
+    rep = c.rep->clone();
+}
+// copy assignment operator
+FactorCholesky& FactorCholesky::operator=(const FactorCholesky& rhs) {
+    if (&rhs != this) {
+        delete rep;
+        rep = rhs.rep->clone();
+    }
+    return *this;
+}
+
+template < class ELT >
+FactorCholesky::FactorCholesky( const Matrix_<ELT>& m ) {
+    rep = new FactorCholeskyRep<typename CNT<ELT>::StdNumber>(m, -1);
+}
+template < class ELT >
+FactorCholesky::FactorCholesky( const Matrix_<ELT>& m, double rcond ) {
+    rep = new FactorCholeskyRep<typename CNT<ELT>::StdNumber>(m,
+        (typename CNT<ELT>::StdNumber)rcond);
+}
+template < class ELT >
+FactorCholesky::FactorCholesky( const Matrix_<ELT>& m, float rcond ) {
+    rep = new FactorCholeskyRep<typename CNT<ELT>::StdNumber>(m,
+        (typename CNT<ELT>::StdNumber)rcond);
+}
+template < class ELT >
+void FactorCholesky::factor( const Matrix_<ELT>& m ){
+    delete rep;
+    rep = new FactorCholeskyRep<typename CNT<ELT>::StdNumber>(m, -1);
+}
+template < class ELT >
+void FactorCholesky::factor( const Matrix_<ELT>& m, double rcond ){
+    delete rep;
+    rep = new FactorCholeskyRep<typename CNT<ELT>::StdNumber>(m,
+        (typename CNT<ELT>::StdNumber)rcond);
+}
+template < class ELT >
+void FactorCholesky::factor( const Matrix_<ELT>& m, float rcond ){
+    delete rep;
+    rep = new FactorCholeskyRep<typename CNT<ELT>::StdNumber>(m,
+        (typename CNT<ELT>::StdNumber)rcond);
+}
+
+bool FactorCholesky::isPositiveDefinite() const {
+    return( rep->positiveDefinite );
+}
+int FactorCholesky::getRank() const {
+    return( rep->rank );
+}
+template < typename ELT >
+void FactorCholesky::solve( const Vector_<ELT>& b, Vector_<ELT>& x ) const {
+    rep->solve( b, x );
+    return;
+}
+template < class ELT >
+void FactorCholesky::solve(  const Matrix_<ELT>& b, Matrix_<ELT>& x ) const {
+    rep->solve(  b, x );
+    return;
+}
+
+   ///////////////////////
+   // FactorCholeskyRep //
+   ///////////////////////
+template <typename T >
+FactorCholeskyRep<T>::FactorCholeskyRep()
+:   n(0), rcond(-1), pivots(0), chol(0)
+{
+}
+
+template <typename T >
+    template < typename ELT >
+FactorCholeskyRep<T>::FactorCholeskyRep( const Matrix_<ELT>& mat, T rc )
+:   n( mat.nrow() ),
+    rcond( rc ),
+    pivots( rc < 0 ? 0 : mat.nrow() ),
+    chol( mat.nrow()*mat.ncol() )
+{
+    FactorCholeskyRep<T>::factor( mat );
+    isFactored = true;
+}
+
+template <typename T >
+FactorCholeskyRepBase* FactorCholeskyRep<T>::clone() const {
+   return( new FactorCholeskyRep<T>(*this) );
+}
+
+template <typename T >
+FactorCholeskyRep<T>::~FactorCholeskyRep() {}
+
+template < class T >
+void FactorCholeskyRep<T>::solve( const Vector_<T>& b, Vector_<T>& x ) const {
+    SimTK_APIARGCHECK2_ALWAYS(b.size()==n,"FactorCholesky","solve",
+       "number of rows in right hand side=%d does not match number of rows in original matrix=%d \n",
+        b.size(), n );
+
+    x.copyAssign(b);
+    doSolve( 1, &x(0) );
+}
+
+template < class T >
+void FactorCholeskyRep<T>::solve( const Matrix_<T>& b, Matrix_<T>& x ) const {
+    SimTK_APIARGCHECK2_ALWAYS(b.nrow()==n,"FactorCholesky","solve",
+       "number of rows in right hand side=%d does not match number of rows in original matrix=%d \n",
+        b.nrow(), n );
+
+    x.copyAssign(b);
+    if (x.ncol() > 0)
+        doSolve( x.ncol(), &x(0,0) );
+}
+
+template < class T >
+void FactorCholeskyRep<T>::doSolve( int nrhs, T* b ) const {
+    if (rcond < 0) {
+        SimTK_APIARGCHECK1_ALWAYS(positiveDefinite,"FactorCholesky","solve",
+            "The matrix was not positive definite (leading minor %d was not); "
+            "use the pivoted factorization for semidefinite matrices.",
+            rank+1);
+        LapackInterface::potrs<T>( 'L', n, nrhs, chol.data, b );
+        return;
+    }
+
+    // Pivoted: ~P*A*P = L*~L where only the leading rank columns of L are
+    // nonzero. Permute the right hand sides, solve L11*~L11*y1=(~P*b)1, set
+    // y2=0, then permute back: x = P*y.
+    TypedWorkSpace<T> y(n);
+    for (int j=0; j < nrhs; ++j) {
+        T* bj = b + j*n;
+        for (int k=0; k < n; ++k) y.data[k] = bj[pivots.data[k]-1];
+        if (rank > 0) {
+            LapackInterface::trsm<T>('L', 'L', 'N', 'N', rank, 1, T(1),
+                                     chol.data, n, y.data, n);
+            LapackInterface::trsm<T>('L', 'L', 'T', 'N', rank, 1, T(1),
+                                     chol.data, n, y.data, n);
+        }
+        for (int k=rank; k < n; ++k) y.data[k] = 0;
+        for (int k=0; k < n; ++k) bj[pivots.data[k]-1] = y.data[k];
+    }
+}
+
+template <class T>
+    template<typename ELT>
+void FactorCholeskyRep<T>::factor(const Matrix_<ELT>&mat )  {
+    SimTK_APIARGCHECK2_ALWAYS(mat.nrow()==mat.ncol(),"FactorCholesky","factor",
+       "Can only factor a square matrix -- got %d X %d.",
+       (int)mat.nrow(), (int)mat.ncol());
+    SimTK_APIARGCHECK_ALWAYS(mat.nrow() > 0,"FactorCholesky","factor",
+       "Can't factor a matrix that has a zero dimension.");
+
+    // initialize the matrix we pass to LAPACK
+    // converts (negated,conjugated etc.) to LAPACK format
+    LapackConvert::convertMatrixToLapack( chol.data, mat );
+
+    int info;
+    if (rcond < 0) {
+        LapackInterface::potrf<T>('L', n, chol.data, n, info);
+        // info = i > 0 means the leading minor of order i is not positive
+        // definite.
+        rank = (info > 0 ? info-1 : n);
+    } else {
+        T maxDiag = 0;
+        for (int i=0; i < n; ++i)
+            maxDiag = std::max(maxDiag, chol.data[i*n+i]);
+        const T tol = rcond * maxDiag;
+        TypedWorkSpace<T> work(2*n);
+        LapackInterface::pstrf<T>('L', n, chol.data, n, pivots.data, rank,
+                                  tol, work.data, info);
+        // info > 0 just means the matrix was found to be rank deficient.
+        if (maxDiag <= 0) rank = 0;
+    }
+    positiveDefinite = (rank == n);
+}
+
+// instantiate
+template SimTK_SIMMATH_EXPORT FactorCholesky::FactorCholesky( const Matrix_<double>& m );
+template SimTK_SIMMATH_EXPORT FactorCholesky::FactorCholesky( const Matrix_<float>& m );
+template SimTK_SIMMATH_EXPORT FactorCholesky::FactorCholesky( const Matrix_<negator< double> >& m );
+template SimTK_SIMMATH_EXPORT FactorCholesky::FactorCholesky( const Matrix_<negator< float> >& m );
+
+template SimTK_SIMMATH_EXPORT FactorCholesky::FactorCholesky( const Matrix_<double>& m, double rcond );
+template SimTK_SIMMATH_EXPORT FactorCholesky::FactorCholesky( const Matrix_<float>& m, float rcond );
+template SimTK_SIMMATH_EXPORT FactorCholesky::FactorCholesky( const Matrix_<negator< double> >& m, double rcond );
+template SimTK_SIMMATH_EXPORT FactorCholesky::FactorCholesky( const Matrix_<negator< float> >& m, float rcond );
+
+template SimTK_SIMMATH_EXPORT void FactorCholesky::factor( const Matrix_<double>& m );
+template SimTK_SIMMATH_EXPORT void FactorCholesky::factor( const Matrix_<float>& m );
+template SimTK_SIMMATH_EXPORT void FactorCholesky::factor( const Matrix_<negator< double> >& m );
+template SimTK_SIMMATH_EXPORT void FactorCholesky::factor( const Matrix_<negator< float> >& m );
+
+template SimTK_SIMMATH_EXPORT void FactorCholesky::factor( const Matrix_<double>& m, double rcond );
+template SimTK_SIMMATH_EXPORT void FactorCholesky::factor( const Matrix_<float>& m, float rcond );
+template SimTK_SIMMATH_EXPORT void FactorCholesky::factor( const Matrix_<negator< double> >& m, double rcond );
+template SimTK_SIMMATH_EXPORT void FactorCholesky::factor( const Matrix_<negator< float> >& m, float rcond );
+
+template class FactorCholeskyRep<double>;
+template FactorCholeskyRep<double>::FactorCholeskyRep( const Matrix_<double>& m, double rcond);
+template FactorCholeskyRep<double>::FactorCholeskyRep( const Matrix_<negator<double> >& m, double rcond);
+template void FactorCholeskyRep<double>::factor( const Matrix_<double>& m);
+template void FactorCholeskyRep<double>::factor( const Matrix_<negator<double> >& m);
+
+template class FactorCholeskyRep<float>;
+template FactorCholeskyRep<float>::FactorCholeskyRep( const Matrix_<float>& m, float rcond );
+template FactorCholeskyRep<float>::FactorCholeskyRep( const Matrix_<negator<float> >& m, float rcond );
+template void FactorCholeskyRep<float>::factor( const Matrix_<float>& m);
+template void FactorCholeskyRep<float>::factor( const Matrix_<negator<float> >& m);
+
+template SimTK_SIMMATH_EXPORT void FactorCholesky::solve<float>(const Vector_<float>&, Vector_<float>&) const;
+template SimTK_SIMMATH_EXPORT void FactorCholesky::solve<double>(const Vector_<double>&, Vector_<double>&) const;
+template SimTK_SIMMATH_EXPORT void FactorCholesky::solve<float>(const Matrix_<float>&, Matrix_<float>&) const;
+template SimTK_SIMMATH_EXPORT void FactorCholesky::solve<double>(const Matrix_<double>&, Matrix_<double>&) const;
+
+} // namespace SimTK
@@ -0,0 +1,217 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/**@file
+ *
+ * L*D*~L factorization of symmetric indefinite matrices.
+ */
+
+#include "SimTKcommon.h"
+
+#include "simmath/internal/common.h"
+#include "simmath/LinearAlgebra.h"
+
+#include "LapackInterface.h"
+#include "FactorLDLTRep.h"
+#include "WorkSpace.h"
+#include "LATraits.h"
+#include "LapackConvert.h"
+
+#include <iostream>
+#include <cmath>
+
+
+namespace SimTK {
+
+   ///////////////////////
+   // FactorLDLTDefault //
+   ///////////////////////
+FactorLDLTDefault::FactorLDLTDefault() {
+    isFactored = false;
+}
+FactorLDLTRepBase* FactorLDLTDefault::clone() const {
+    return( new FactorLDLTDefault(*this));
+}
+
+   ////////////////
+   // FactorLDLT //
+   ////////////////
+FactorLDLT::~FactorLDLT() {
+    delete rep;
+}
+// default constructor
+FactorLDLT::FactorLDLT() {
+    rep = new FactorLDLTDefault();
+}
+// copy constructor
+FactorLDLT::FactorLDLT( const FactorLDLT& c ) {
+    rep = c.rep->clone();
+}
+// copy assignment operator
+FactorLDLT& FactorLDLT::operator=(const FactorLDLT& rhs) {
+    if (&rhs != this) {
+        delete rep;
+        rep = rhs.rep->clone();
+    }
+    return *this;
+}
+
+template < class ELT >
+FactorLDLT::FactorLDLT( const Matrix_<ELT>& m ) {
+    rep = new FactorLDLTRep<typename CNT<ELT>::StdNumber>(m);
+}
+template < class ELT >
+void FactorLDLT::factor( const Matrix_<ELT>& m ){
+    delete rep;
+    rep = new FactorLDLTRep<typename CNT<ELT>::StdNumber>(m);
+}
+
+bool FactorLDLT::isSingular() const {
+    return( rep->singularIndex > 0 );
+}
+int FactorLDLT::getSingularIndex() const {
+    return( rep->singularIndex );
+}
+template < typename ELT >
+void FactorLDLT::solve( const Vector_<ELT>& b, Vector_<ELT>& x ) const {
+    rep->solve( b, x );
+    return;
+}
+template < class ELT >
+void FactorLDLT::solve(  const Matrix_<ELT>& b, Matrix_<ELT>& x ) const {
+    rep->solve(  b, x );
+    return;
+}
+
+   ///////////////////
+   // FactorLDLTRep //
+   ///////////////////
+template <typename T >
+FactorLDLTRep<T>::FactorLDLTRep()
+:   n(0), pivots(0), ldlt(0)
+{
+}
+
+template <typename T >
+    template < typename ELT >
+FactorLDLTRep<T>::FactorLDLTRep( const Matrix_<ELT>& mat )
+:   n( mat.nrow() ),
+    pivots( mat.nrow() ),
+    ldlt( mat.nrow()*mat.ncol() )
+{
+    FactorLDLTRep<T>::factor( mat );
+    isFactored = true;
+}
+
+template <typename T >
+FactorLDLTRepBase* FactorLDLTRep<T>::clone() const {
+   return( new FactorLDLTRep<T>(*this) );
+}
+
+template <typename T >
+FactorLDLTRep<T>::~FactorLDLTRep() {}
+
+template < class T >
+void FactorLDLTRep<T>::solve( const Vector_<T>& b, Vector_<T>& x ) const {
+    SimTK_APIARGCHECK2_ALWAYS(b.size()==n,"FactorLDLT","solve",
+       "number of rows in right hand side=%d does not match number of rows in original matrix=%d \n",
+        b.size(), n );
+    SimTK_APIARGCHECK2_ALWAYS(singularIndex==0,"FactorLDLT","solve",
+       "The matrix is singular; D(%d,%d) is exactly zero.",
+        singularIndex, singularIndex);
+
+    x.copyAssign(b);
+    LapackInterface::sytrs<T>( 'L', n, 1, ldlt.data, pivots.data, &x(0) );
+}
+
+template < class T >
+void FactorLDLTRep<T>::solve( const Matrix_<T>& b, Matrix_<T>& x ) const {
+    SimTK_APIARGCHECK2_ALWAYS(b.nrow()==n,"FactorLDLT","solve",
+       "number of rows in right hand side=%d does not match number of rows in original matrix=%d \n",
+        b.nrow(), n );
+    SimTK_APIARGCHECK2_ALWAYS(singularIndex==0,"FactorLDLT","solve",
+       "The matrix is singular; D(%d,%d) is exactly zero.",
+        singularIndex, singularIndex);
+
+    x.copyAssign(b);
+    if (x.ncol() > 0)
+        LapackInterface::sytrs<T>( 'L', n, x.ncol(), ldlt.data, pivots.data,
+                                   &x(0,0) );
+}
+
+template <class T>
+    template<typename ELT>
+void FactorLDLTRep<T>::factor(const Matrix_<ELT>&mat )  {
+    SimTK_APIARGCHECK2_ALWAYS(mat.nrow()==mat.ncol(),"FactorLDLT","factor",
+       "Can only factor a square matrix -- got %d X %d.",
+       (int)mat.nrow(), (int)mat.ncol());
+    SimTK_APIARGCHECK_ALWAYS(mat.nrow() > 0,"FactorLDLT","factor",
+       "Can't factor a matrix that has a zero dimension.");
+
+    // initialize the matrix we pass to LAPACK
+    // converts (negated,conjugated etc.) to LAPACK format
+    LapackConvert::convertMatrixToLapack( ldlt.data, mat );
+
+    // Ask for the optimal workspace size first.
+    int info;
+    T wsize[1];
+    LapackInterface::sytrf<T>('L', n, ldlt.data, n, pivots.data, wsize, -1,
+                              info);
+    const int lwork = std::max(1, LapackInterface::getLWork(wsize));
+    TypedWorkSpace<T> work(lwork);
+
+    LapackInterface::sytrf<T>('L', n, ldlt.data, n, pivots.data, work.data,
+                              lwork, info);
+    // info = i > 0 means D(i,i) is exactly zero.
+    singularIndex = (info > 0 ? info : 0);
+}
+
+// instantiate
+template SimTK_SIMMATH_EXPORT FactorLDLT::FactorLDLT( const Matrix_<double>& m );
+template SimTK_SIMMATH_EXPORT FactorLDLT::FactorLDLT( const Matrix_<float>& m );
+template SimTK_SIMMATH_EXPORT FactorLDLT::FactorLDLT( const Matrix_<negator< double> >& m );
+template SimTK_SIMMATH_EXPORT FactorLDLT::FactorLDLT( const Matrix_<negator< float> >& m );
+
+template SimTK_SIMMATH_EXPORT void FactorLDLT::factor( const Matrix_<double>& m );
+template SimTK_SIMMATH_EXPORT void FactorLDLT::factor( const Matrix_<float>& m );
+template SimTK_SIMMATH_EXPORT void FactorLDLT::factor( const Matrix_<negator< double> >& m );
+template SimTK_SIMMATH_EXPORT void FactorLDLT::factor( const Matrix_<negator< float> >& m );
+
+template class FactorLDLTRep<double>;
+template FactorLDLTRep<double>::FactorLDLTRep( const Matrix_<double>& m);
+template FactorLDLTRep<double>::FactorLDLTRep( const Matrix_<negator<double> >& m);
+template void FactorLDLTRep<double>::factor( const Matrix_<double>& m);
+template void FactorLDLTRep<double>::factor( const Matrix_<negator<double> >& m);
+
+template class FactorLDLTRep<float>;
+template FactorLDLTRep<float>::FactorLDLTRep( const Matrix_<float>& m );
+template FactorLDLTRep<float>::FactorLDLTRep( const Matrix_<negator<float> >& m );
+template void FactorLDLTRep<float>::factor( const Matrix_<float>& m);
+template void FactorLDLTRep<float>::factor( const Matrix_<negator<float> >& m);
+
+template SimTK_SIMMATH_EXPORT void FactorLDLT::solve<float>(const Vector_<float>&, Vector_<float>&) const;
+template SimTK_SIMMATH_EXPORT void FactorLDLT::solve<double>(const Vector_<double>&, Vector_<double>&) const;
+template SimTK_SIMMATH_EXPORT void FactorLDLT::solve<float>(const Matrix_<float>&, Matrix_<float>&) const;
+template SimTK_SIMMATH_EXPORT void FactorLDLT::solve<double>(const Matrix_<double>&, Matrix_<double>&) const;
+
+} // namespace SimTK
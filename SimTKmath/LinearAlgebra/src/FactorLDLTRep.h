@@ -0,0 +1,105 @@
+#ifndef SimTK_SIMMATH_FACTOR_LDLT_REP_H_
+#define SimTK_SIMMATH_FACTOR_LDLT_REP_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKmath.h"
+#include "WorkSpace.h"
+
+namespace SimTK {
+
+class FactorLDLTRepBase {
+public:
+    FactorLDLTRepBase() : isFactored(false), singularIndex(0) {}
+
+    virtual ~FactorLDLTRepBase(){};
+
+    virtual FactorLDLTRepBase* clone() const { return 0; };
+    virtual void solve( const Vector_<float>& b, Vector_<float>& x ) const {
+        checkIfFactored();
+        SimTK_APIARGCHECK_ALWAYS(false,"FactorLDLT","solve",
+        "solve called with rhs of type <float>  which does not match type of original linear system \n");
+    }
+    virtual void solve( const Vector_<double>& b, Vector_<double>& x ) const {
+        checkIfFactored();
+        SimTK_APIARGCHECK_ALWAYS(false,"FactorLDLT","solve",
+        "solve called with rhs of type <double>  which does not match type of original linear system \n");
+    }
+    virtual void solve( const Matrix_<float>& b, Matrix_<float>& x ) const {
+        checkIfFactored();
+        SimTK_APIARGCHECK_ALWAYS(false,"FactorLDLT","solve",
+        "solve called with rhs of type <float>  which does not match type of original linear system \n");
+    }
+    virtual void solve( const Matrix_<double>& b, Matrix_<double>& x ) const {
+        checkIfFactored();
+        SimTK_APIARGCHECK_ALWAYS(false,"FactorLDLT","solve",
+        "solve called with rhs of type <double>  which does not match type of original linear system \n");
+    }
+
+    bool isFactored;
+    int  singularIndex; // 1-based index of an exactly zero pivot, else 0
+
+    void checkIfFactored()  const {
+        if( !isFactored ) {
+            SimTK_APIARGCHECK_ALWAYS(false,"FactorLDLT","solve",
+            "solve called before the matrix was factored \n");
+        }
+    }
+
+}; // class FactorLDLTRepBase
+
+class FactorLDLTDefault : public FactorLDLTRepBase {
+public:
+    FactorLDLTDefault();
+    FactorLDLTRepBase* clone() const;
+};
+
+// T is float or double. Factorization is done with xSYTRF using the lower
+// triangle.
+template <typename T>
+class FactorLDLTRep : public FactorLDLTRepBase {
+public:
+    template <class ELT> FactorLDLTRep( const Matrix_<ELT>& );
+    FactorLDLTRep();
+
+    ~FactorLDLTRep();
+
+    template < class ELT > void factor(const Matrix_<ELT>& );
+    void solve( const Vector_<T>& b, Vector_<T>& x ) const;
+    void solve( const Matrix_<T>& b, Matrix_<T>& x ) const;
+
+    FactorLDLTRepBase* clone() const;
+
+private:
+    int                      n;        // dimension of the square matrix
+    // These are mutable only because LapackInterface::sytrs() takes non-const
+    // pointers; they are not modified by the solve.
+    mutable TypedWorkSpace<int> pivots; // Bunch-Kaufman pivots
+    mutable TypedWorkSpace<T>   ldlt;   // factored matrix
+
+}; // end class FactorLDLTRep
+
+} // namespace SimTK
+
+#endif   // SimTK_SIMMATH_FACTOR_LDLT_REP_H_
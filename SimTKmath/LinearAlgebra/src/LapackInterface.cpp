@@ -1178,6 +1178,26 @@ void LapackInterface::sytrf<std::complex<float> >( const char& uplo, const int n
 }
 template <typename T> 
 void LapackInterface::sytrf( const char& uplo, const int n, T* a,  const int lda, int *pivots, T* work, const int lwork, int& info ) { assert(false); }
+template <> 
+void LapackInterface::pstrf<float>( const char& uplo, const int n, float* a, const int lda, int* pivots, int& rank, const float& tol, float* work, int& info ){ 
+
+    spstrf_( uplo, n, a, lda, pivots, rank, tol, work, info );
+
+    if( info < 0 ) {
+        SimTK_THROW2( SimTK::Exception::IllegalLapackArg, "spstrf", info );
+    }
+    return;
+}
+template <> 
+void LapackInterface::pstrf<double>( const char& uplo, const int n, double* a, const int lda, int* pivots, int& rank, const double& tol, double* work, int& info ){ 
+
+    dpstrf_( uplo, n, a, lda, pivots, rank, tol, work, info );
+
+    if( info < 0 ) {
+        SimTK_THROW2( SimTK::Exception::IllegalLapackArg, "dpstrf", info );
+    }
+    return;
+}
 
 template <>
 int LapackInterface::ilaenv<double>( const int& ispec,  const char* name,  const char *opts, const int& n1, const int& n2, const int& n3, const int& n4 ) { 
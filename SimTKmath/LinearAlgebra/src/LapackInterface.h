@@ -100,6 +100,10 @@ void potrf( const char& uplo, const int n,  T* lu, const int lda, int& info );
 template <class T> static 
 void sytrf( const char& uplo, const int n, T* a,  const int lda, int* pivots, T* work, const int lwork, int& info );
 
+/* pivoted Cholesky of a positive semidefinite matrix; real types only */
+template <class T> static 
+void pstrf( const char& uplo, const int n, T* a, const int lda, int* pivots, int& rank, const T& tol, T* work, int& info );
+
 template <class T> static
 int ilaenv( const int& ispec,  const char* name,  const char* opts, const int& n1, const int& n2, const int& n3, const int& n4  );
 
@@ -53,6 +53,7 @@
 #include "simmath/MultibodyGraphMaker.h"
 #include "simmath/Integrator.h"
 #include "simmath/TimeStepper.h"
+#include "simmath/EnsembleTimeStepper.h"
 #include "simmath/CPodesIntegrator.h"
 #include "simmath/RungeKuttaMersonIntegrator.h"
 #include "simmath/RungeKuttaFeldbergIntegrator.h"
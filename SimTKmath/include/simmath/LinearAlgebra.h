@@ -140,6 +140,190 @@ class SimTK_SIMMATH_EXPORT FactorQTZ: public Factor {
     protected:
     class FactorQTZRepBase *rep;
 }; // class FactorQTZ
+
+
+class FactorCholeskyRepBase;
+/**
+ * Class to perform a Cholesky factorization A = L*~L of a real, symmetric 
+ * positive definite matrix. Only the lower triangle of A is referenced. This 
+ * takes about half the flops of an LU factorization and far fewer than a QTZ
+ * factorization, so it should be preferred for matrices like the mass matrix
+ * M or the projected inverse mass matrix G*M^-1*~G.
+ *
+ * If the matrix may be only positive \e semidefinite (that is, singular due 
+ * to redundancy), supply a reciprocal condition number when factoring. Then a
+ * pivoted, rank-revealing Cholesky factorization is done instead and pivots 
+ * smaller than rcond times the largest diagonal element are treated as zero. 
+ * This can be used in place of FactorQTZ for symmetric positive semidefinite
+ * matrices. For a consistent rank-deficient system the solution returned is 
+ * a "basic" solution with the components corresponding to the dropped pivots
+ * set to zero, rather than the minimum-norm solution FactorQTZ would return.
+ */
+class SimTK_SIMMATH_EXPORT FactorCholesky: public Factor {
+    public:
+
+    ~FactorCholesky();
+
+    FactorCholesky();
+    FactorCholesky( const FactorCholesky& c );
+    FactorCholesky& operator=(const FactorCholesky& rhs);
+
+    /// do an unpivoted Cholesky factorization of a positive definite matrix
+    template <typename ELT> FactorCholesky( const Matrix_<ELT>& m );
+    /// do a pivoted Cholesky factorization of a positive semidefinite matrix
+    /// for a given reciprocal condition number
+    template <typename ELT> FactorCholesky( const Matrix_<ELT>& m, double rcond );
+    /// do a pivoted Cholesky factorization of a positive semidefinite matrix
+    /// for a given reciprocal condition number
+    template <typename ELT> FactorCholesky( const Matrix_<ELT>& m, float rcond );
+    /// do an unpivoted Cholesky factorization of a positive definite matrix
+    template <typename ELT> void factor( const Matrix_<ELT>& m );
+    /// do a pivoted Cholesky factorization of a positive semidefinite matrix
+    /// for a given reciprocal condition number
+    template <typename ELT> void factor( const Matrix_<ELT>& m, double rcond );
+    /// do a pivoted Cholesky factorization of a positive semidefinite matrix
+    /// for a given reciprocal condition number
+    template <typename ELT> void factor( const Matrix_<ELT>& m, float rcond );
+    /// solve for a vector x given a right hand side vector b
+    template <typename ELT> void solve( const Vector_<ELT>& b, Vector_<ELT>& x ) const;
+    /// solve for an array of vectors given multiple right hand sides
+    template <typename ELT> void solve( const Matrix_<ELT>& b, Matrix_<ELT>& x ) const;
+
+    /// returns true if the matrix was found to be positive definite, that
+    /// is, the factorization succeeded with full rank
+    bool isPositiveDefinite() const;
+    /// returns the rank of the matrix; for an unpivoted factorization of a
+    /// matrix that wasn't positive definite this is the size of the largest
+    /// leading submatrix that was
+    int getRank() const;
+
+    protected:
+    class FactorCholeskyRepBase *rep;
+}; // class FactorCholesky
+
+
+class FactorLDLTRepBase;
+/**
+ * Class to perform an L*D*~L factorization of a real, symmetric matrix that
+ * need not be positive definite, using Bunch-Kaufman diagonal pivoting. D is
+ * block diagonal with 1x1 and 2x2 blocks. Only the lower triangle of the 
+ * matrix is referenced. This takes about the same number of flops as a 
+ * Cholesky factorization, half those of an LU factorization, and can be used 
+ * for symmetric indefinite systems like the KKT equations that arise in 
+ * constrained dynamics.
+ */
+class SimTK_SIMMATH_EXPORT FactorLDLT: public Factor {
+    public:
+
+    ~FactorLDLT();
+
+    FactorLDLT();
+    FactorLDLT( const FactorLDLT& c );
+    FactorLDLT& operator=(const FactorLDLT& rhs);
+
+    /// do an LDLT factorization of a symmetric matrix
+    template <typename ELT> FactorLDLT( const Matrix_<ELT>& m );
+    /// do an LDLT factorization of a symmetric matrix
+    template <typename ELT> void factor( const Matrix_<ELT>& m );
+    /// solve for a vector x given a right hand side vector b
+    template <typename ELT> void solve( const Vector_<ELT>& b, Vector_<ELT>& x ) const;
+    /// solve for an array of vectors given multiple right hand sides
+    template <typename ELT> void solve( const Matrix_<ELT>& b, Matrix_<ELT>& x ) const;
+
+    /// returns true if matrix was singular 
+    bool isSingular() const;
+    /// returns the first diagonal of D (1-based) which was found to be 
+    /// exactly zero, or 0 if the matrix was not singular
+    int getSingularIndex() const;
+
+    protected:
+    class FactorLDLTRepBase *rep;
+}; // class FactorLDLT
+
+
+/**
+ * Class for an n X n symmetric matrix with "branch-induced sparsity", such as
+ * the mass matrix M of a tree-structured multibody system. The sparsity
+ * pattern is given by a parent array p() with -1 <= p(i) < i; the only
+ * nonzero entries in row i below the diagonal are in the columns p(i),
+ * p(p(i)), and so on back to the root. Only those entries and the diagonal are
+ * stored, so the storage is O(n*d) for a tree of depth d rather than O(n^2).
+ *
+ * The matrix can be factored in place as ~L*L (if positive definite) or
+ * ~L*D*L (if only nonsingular), where L is lower triangular and has the same
+ * sparsity pattern as the matrix so there is no fill-in. Note that these are
+ * factorizations into ~L*L, not L*~L; working from the leaves toward the root
+ * is what avoids fill-in. Factoring costs O(n*d^2) and each solve O(n*d).
+ * The algorithms are from Featherstone, "Efficient factorization of the
+ * joint-space inertia matrix for branched kinematic trees", IJRR 2005.
+ */
+class SimTK_SIMMATH_EXPORT BranchInducedSparseMatrix {
+public:
+    /// Which factorization, if any, the stored entries currently represent.
+    enum FactorizationType {NotFactored, LTL, LTDL};
+
+    /// Create an empty 0 X 0 matrix.
+    BranchInducedSparseMatrix() : factorization(NotFactored) {}
+    /// Create a zero matrix with the sparsity pattern given by \a parents;
+    /// see setStructure().
+    explicit BranchInducedSparseMatrix(const Array_<int>& parents);
+
+    /// Set the size and sparsity pattern of this matrix from an array of
+    /// parents, one per row, with -1 for a row that has no parent. The parent
+    /// of row i must be less than i. All the entries are set to zero.
+    void setStructure(const Array_<int>& parents);
+    /// Set all the stored entries to zero, keeping the sparsity pattern.
+    void setToZero();
+
+    /// Return the number of rows (and columns) in this matrix.
+    int size() const {return (int)parent.size();}
+    /// Return the parent of row \a i, or -1 if it has none.
+    int getParent(int i) const {return parent[i];}
+    /// Return the number of entries actually stored, counting the diagonal
+    /// and only one of each symmetric pair of off-diagonal entries.
+    int getNumStoredEntries() const {return (int)entries.size();}
+    /// Return the factorization currently held by this matrix, if any.
+    FactorizationType getFactorization() const {return factorization;}
+
+    /// Return entry (i,j), which is zero if neither of \a i or \a j is an
+    /// ancestor of the other.
+    Real getEntry(int i, int j) const;
+    /// Return a writable reference to entry (i,j), which must be in the
+    /// sparsity pattern. Writing to an entry discards any factorization.
+    Real& updEntry(int i, int j);
+    /// Return the stored entries of row \a i: (i,i), then (i,p(i)),
+    /// (i,p(p(i))), and so on.
+    ArrayViewConst_<Real> getRow(int i) const;
+    /// Return the stored entries of row \a i for writing, in the same order as
+    /// getRow(). This discards any factorization.
+    ArrayView_<Real> updRow(int i);
+    /// Fill in a dense matrix with the same contents as this one.
+    void getAsMatrix(Matrix& M) const;
+
+    /// Calculate y = A*x in O(n*d) time. Not allowed after factoring.
+    void multiply(const Vector& x, Vector& y) const;
+
+    /// Factor this matrix in place as ~L*L. Throws an exception if the
+    /// matrix is not positive definite.
+    void factorLTL();
+    /// Factor this matrix in place as ~L*D*L with L unit lower triangular.
+    /// The matrix need not be positive definite but throws an exception if a
+    /// zero pivot is encountered.
+    void factorLTDL();
+
+    /// Solve A*x=b using the factorization; \a b and \a x may be the same.
+    void solve(const Vector& b, Vector& x) const;
+    /// Solve A*X=B for multiple right hand sides.
+    void solve(const Matrix& B, Matrix& X) const;
+
+private:
+    void solveInPlace(Real* x) const;
+
+    Array_<int>         parent;
+    Array_<int>         rowStart;   // row i is entries[rowStart[i]..rowStart[i+1]-1]
+    Array_<Real>        entries;
+    FactorizationType   factorization;
+}; // class BranchInducedSparseMatrix
 /**
  * Class to compute Eigen values and Eigen vectors of a matrix
  */
@@ -0,0 +1,147 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+/**@file
+ * Tests the BranchInducedSparseMatrix class and its LTL and LTDL 
+ * factorizations against dense factorizations of the same matrix.
+ */
+
+#include "SimTKmath.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+// Two trees: a root with two branches, one of which forks again, and a
+// separate little chain that doesn't connect to the first tree at all.
+static Array_<int> makeParents() {
+    //             0   1  2  3  4  5  6  7  8   9 10
+    const int p[] = {-1, 0, 1, 1, 3, 0, 5, 5, 7, -1, 9};
+    return Array_<int>(p, p+11);
+}
+
+// Fill in a random symmetric positive definite matrix with A's pattern. If B
+// is lower triangular with a tree-structured pattern then ~B*B is symmetric 
+// with that same pattern.
+static void fillRandomSPD(BranchInducedSparseMatrix& A) {
+    const int n = A.size();
+    Matrix B(n,n); B.setToZero();
+    for (int i=0; i < n; ++i) {
+        B(i,i) = 1 + Test::randReal();
+        for (int a=A.getParent(i); a >= 0; a=A.getParent(a))
+            B(i,a) = Test::randReal();
+    }
+    const Matrix dense = ~B*B;
+    for (int i=0; i < n; ++i) {
+        ArrayView_<Real> row = A.updRow(i);
+        for (int a=i, k=0; a >= 0; a=A.getParent(a), ++k)
+            row[k] = dense(i,a);
+    }
+}
+
+void testStructure() {
+    BranchInducedSparseMatrix A(makeParents());
+    SimTK_TEST(A.size() == 11);
+    SimTK_TEST(A.getParent(4) == 3 && A.getParent(9) == -1);
+    SimTK_TEST(A.getRow(4).size() == 4);  // 4,3,1,0
+    SimTK_TEST(A.getRow(10).size() == 2); // 10,9
+    SimTK_TEST(A.getNumStoredEntries() == 1+2+3+3+4+2+3+3+4+1+2);
+
+    A.updEntry(4,1) = 3;
+    SimTK_TEST(A.getEntry(4,1) == 3 && A.getEntry(1,4) == 3);
+    SimTK_TEST(A.getEntry(4,5) == 0); // not related
+    SimTK_TEST_MUST_THROW(A.updEntry(4,5));
+    SimTK_TEST_MUST_THROW(A.updEntry(10,0));
+
+    Array_<int> bad = makeParents(); bad[3] = 5; // parent after child
+    SimTK_TEST_MUST_THROW(A.setStructure(bad));
+}
+
+void testFactorizations() {
+    BranchInducedSparseMatrix A(makeParents());
+    fillRandomSPD(A);
+    const int n = A.size();
+
+    Matrix dense;
+    A.getAsMatrix(dense);
+    SimTK_TEST_EQ(dense, ~dense);
+
+    const Vector b = Test::randVector(n);
+    Vector Ab;
+    A.multiply(b, Ab);
+    SimTK_TEST_EQ_SIZE(Ab, dense*b, n);
+
+    Vector xlu;
+    FactorLU(dense).solve(b, xlu);
+
+    BranchInducedSparseMatrix ltl(A), ltdl(A);
+    ltl.factorLTL();
+    ltdl.factorLTDL();
+    SimTK_TEST(ltl.getFactorization() == BranchInducedSparseMatrix::LTL);
+    SimTK_TEST(ltdl.getFactorization() == BranchInducedSparseMatrix::LTDL);
+
+    // The factors must have stayed within the pattern.
+    Matrix L;
+    ltl.getAsMatrix(L); // symmetric; keep only the lower triangle
+    for (int j=1; j < n; ++j) for (int i=0; i < j; ++i) L(i,j) = 0;
+    SimTK_TEST_EQ_SIZE(~L*L, dense, n);
+
+    Vector x;
+    ltl.solve(b, x);
+    SimTK_TEST_EQ_SIZE(x, xlu, n);
+    ltdl.solve(b, x);
+    SimTK_TEST_EQ_SIZE(x, xlu, n);
+
+    // In place and multiple right hand sides.
+    x = b; ltdl.solve(x, x);
+    SimTK_TEST_EQ_SIZE(x, xlu, n);
+    Matrix bb(n, 2), xx;
+    bb(0) = b; bb(1) = 2*b;
+    ltl.solve(bb, xx);
+    SimTK_TEST_EQ_SIZE(dense*xx, bb, n);
+
+    SimTK_TEST_MUST_THROW(ltl.factorLTL());      // already factored
+    SimTK_TEST_MUST_THROW(A.solve(b, x));        // not factored
+    SimTK_TEST_MUST_THROW(ltl.multiply(b, x));   // holds factors now
+
+    // An indefinite matrix has an LTDL factorization (if no pivot is zero)
+    // but no LTL factorization.
+    BranchInducedSparseMatrix indef(A);
+    indef.updEntry(10,10) = -indef.getEntry(10,10);
+    BranchInducedSparseMatrix indefLTDL(indef);
+    SimTK_TEST_MUST_THROW(indef.factorLTL());
+    Matrix indefDense; indefLTDL.getAsMatrix(indefDense);
+    indefLTDL.factorLTDL();
+    indefLTDL.solve(b, x);
+    SimTK_TEST_EQ_SIZE(indefDense*x, b, n);
+}
+
+int main() {
+    SimTK_START_TEST("BranchInducedSparseMatrixTest");
+        SimTK_SUBTEST(testStructure);
+        SimTK_SUBTEST(testFactorizations);
+    SimTK_END_TEST();
+}
@@ -72,6 +72,9 @@ int main () {
         projInteg.setUseCPodesProjection();
         testIntegrator(projInteg, sys);
     }
+
+    CPodesIntegrator bdfInteg(sys, CPodes::BDF);
+    testDenseOutput(bdfInteg, sys);
     cout << "Done" << endl;
     return 0;
   }
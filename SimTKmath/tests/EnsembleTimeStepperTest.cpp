@@ -0,0 +1,165 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Run an ensemble of pendulums released from different angles for different
+// lengths of time, and check each member against the same trajectory computed
+// serially with an ordinary TimeStepper.
+
+#include "SimTKmath.h"
+
+#include "PendulumSystem.h"
+
+#include <cmath>
+#include <cstdio>
+
+#define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
+
+using namespace SimTK;
+
+// Each member's calls come from one thread at a time, so the members can
+// keep their own records without locking.
+class RecordingReporter : public EnsembleTimeStepper::Reporter {
+public:
+    explicit RecordingReporter(int numMembers)
+    :   times(numMembers), lastY(numMembers) {}
+    void handleState(int member, const State& state) {
+        times[member].push_back(state.getTime());
+        lastY[member] = state.getY();
+        ++numReports;
+    }
+    Array_< Array_<Real> >  times;
+    Array_<Vector>          lastY;
+    AtomicInteger           numReports;
+};
+
+const Real Accuracy = 1e-4;
+const Real ReportInterval = 0.1;
+
+State makeInitialState(const PendulumSystem& sys, int member) {
+    State state = sys.getDefaultState();
+    const Real angle = 0.1 + 0.2*member;
+    state.updQ()[0] = std::cos(angle);
+    state.updQ()[1] = -std::sin(angle);
+    return state;
+}
+
+Real getFinalTime(int member) {
+    return 0.5 + 0.37*(member % 5);
+}
+
+// Run one member the ordinary way, reporting at the same times.
+Vector runSerially(const PendulumSystem& sys, const State& initState,
+                   Real tFinal) {
+    RungeKuttaMersonIntegrator integ(sys);
+    integ.setAccuracy(Accuracy);
+    integ.setFinalTime(tFinal);
+    TimeStepper ts(sys, integ);
+    ts.initialize(initState);
+    for (int k=1; ts.getTime() < tFinal; ++k)
+        ts.stepTo(std::min(k*ReportInterval, tFinal));
+    return ts.getState().getY();
+}
+
+void testEnsemble(int numThreads) {
+    PendulumSystem sys;
+    sys.realizeTopology();
+
+    const int NumMembers = 13;
+    Array_<State> initStates;
+    Array_<Real>  finalTimes;
+    for (int i=0; i < NumMembers; ++i) {
+        initStates.push_back(makeInitialState(sys, i));
+        finalTimes.push_back(getFinalTime(i));
+    }
+    // This member can't be initialized; it should fail without affecting
+    // the others.
+    const int BadMember = 7;
+    initStates[BadMember] = State();
+
+    EnsembleTimeStepper::IntegratorFactory_<RungeKuttaMersonIntegrator>
+        factory(Accuracy);
+    EnsembleTimeStepper ensemble(sys, factory, numThreads);
+    ASSERT(ensemble.getNumThreads() == numThreads);
+    ASSERT(ensemble.getReportInterval() == Infinity);
+    ensemble.setReportInterval(ReportInterval);
+
+    // Run twice to check that the per-thread Integrators are reused cleanly.
+    for (int pass=0; pass < 2; ++pass) {
+        RecordingReporter reporter(NumMembers);
+        ensemble.run(initStates, finalTimes, reporter);
+        ASSERT(ensemble.getNumMembers() == NumMembers);
+        ASSERT(ensemble.getNumFailedMembers() == 1);
+        ASSERT(ensemble.hasMemberFailed(BadMember));
+        ASSERT(!ensemble.getMemberErrorMessage(BadMember).empty());
+        ASSERT(ensemble.getMemberTerminationReason(BadMember)
+               == Integrator::AnUnrecoverableErrorOccurred);
+        ASSERT(reporter.times[BadMember].empty());
+
+        int numReports = 0;
+        for (int i=0; i < NumMembers; ++i) {
+            if (i == BadMember) continue;
+            const Array_<Real>& times = reporter.times[i];
+            numReports += (int)times.size();
+            ASSERT(!ensemble.hasMemberFailed(i));
+            ASSERT(ensemble.getMemberErrorMessage(i).empty());
+            ASSERT(ensemble.getMemberTerminationReason(i)
+                   == Integrator::ReachedFinalTime);
+            ASSERT(ensemble.getMemberTime(i) == finalTimes[i]);
+            ASSERT(ensemble.getMemberNumStepsTaken(i) > 0);
+            ASSERT(times.front() == 0 && times.back() == finalTimes[i]);
+            ASSERT(std::abs(times[1]-ReportInterval) < 1e-14);
+            for (int k=1; k < (int)times.size(); ++k)
+                ASSERT(times[k] > times[k-1]);
+
+            // The integrators are deterministic, so we should get exactly
+            // the same answer no matter which thread ran the member.
+            const Vector y = runSerially(sys, initStates[i], finalTimes[i]);
+            ASSERT((reporter.lastY[i] - y).normInf() == 0);
+        }
+        ASSERT(reporter.numReports == numReports);
+    }
+
+    // Members can share a final time too.
+    initStates[BadMember] = makeInitialState(sys, BadMember);
+    RecordingReporter reporter(NumMembers);
+    ensemble.setReportInterval(Infinity);
+    ensemble.run(initStates, 1.25, reporter);
+    ASSERT(ensemble.getNumFailedMembers() == 0);
+    for (int i=0; i < NumMembers; ++i) {
+        ASSERT(reporter.times[i].size() == 2);
+        ASSERT(ensemble.getMemberTime(i) == 1.25);
+    }
+}
+
+int main () {
+    try {
+        testEnsemble(1);
+        testEnsemble(4);
+        std::printf("Done\n");
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::printf("FAILED: %s\n", e.what());
+        return 1;
+    }
+}
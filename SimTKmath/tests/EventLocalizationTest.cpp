@@ -0,0 +1,152 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Event localization realizes each probe state only as far as the remaining
+candidate triggers need. These handlers have triggers at the Time, Position
+and Acceleration stages, so each kind is localized both alone and together
+with the others, and each one checks that the state it is given is at the
+root of its own trigger. */
+
+#include "SimTKmath.h"
+
+#include "PendulumSystem.h"
+
+#define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
+
+using namespace SimTK;
+
+using std::cout;
+using std::endl;
+
+// Counts the triggers evaluated at each stage.
+static int numPositionValues = 0, numAccelerationValues = 0;
+
+// The pendulum passes through x == 0.
+class ZeroPositionHandler : public TriggeredEventHandler {
+public:
+    static int eventCount;
+    ZeroPositionHandler(PendulumSystem& pendulum)
+    :   TriggeredEventHandler(Stage::Position), pendulum(pendulum) {}
+    Real getValue(const State& state) const {
+        ++numPositionValues;
+        return state.getQ(pendulum.getGuts().getSubsysIndex())[0];
+    }
+    void handleEvent(State& state, Real accuracy, bool& shouldTerminate) const {
+        ASSERT(std::abs(getValue(state)) < 1e-3);
+        eventCount++;
+    }
+private:
+    PendulumSystem& pendulum;
+};
+
+// The pendulum's horizontal acceleration passes through a value that it
+// reaches away from x == 0.
+class AccelerationHandler : public TriggeredEventHandler {
+public:
+    static const Real Threshold;
+    static int eventCount;
+    AccelerationHandler(PendulumSystem& pendulum)
+    :   TriggeredEventHandler(Stage::Acceleration), pendulum(pendulum) {}
+    Real getValue(const State& state) const {
+        ++numAccelerationValues;
+        return state.getUDot(pendulum.getGuts().getSubsysIndex())[0]
+               - Threshold;
+    }
+    void handleEvent(State& state, Real accuracy, bool& shouldTerminate) const {
+        pendulum.realize(state, Stage::Acceleration);
+        ASSERT(std::abs(getValue(state)) < 1e-2);
+        eventCount++;
+    }
+private:
+    PendulumSystem& pendulum;
+};
+
+// Time passes through a value.
+class TimeHandler : public TriggeredEventHandler {
+public:
+    static const Real EventTime;
+    static int eventCount;
+    TimeHandler() : TriggeredEventHandler(Stage::Time) {}
+    Real getValue(const State& state) const {
+        return state.getTime() - EventTime;
+    }
+    void handleEvent(State& state, Real accuracy, bool& shouldTerminate) const {
+        ASSERT(std::abs(getValue(state)) < 1e-3);
+        eventCount++;
+    }
+};
+
+const Real AccelerationHandler::Threshold = 2;
+const Real TimeHandler::EventTime = 2.25;
+int ZeroPositionHandler::eventCount = 0;
+int AccelerationHandler::eventCount = 0;
+int TimeHandler::eventCount = 0;
+
+void runPendulum(bool useFastEventLocalization) {
+    ZeroPositionHandler::eventCount = 0;
+    AccelerationHandler::eventCount = 0;
+    TimeHandler::eventCount = 0;
+    numPositionValues = numAccelerationValues = 0;
+
+    PendulumSystem sys;
+    sys.addEventHandler(new ZeroPositionHandler(sys));
+    sys.addEventHandler(new AccelerationHandler(sys));
+    sys.addEventHandler(new TimeHandler());
+    sys.realizeTopology();
+
+    const Real qi[] = {1,0}; // (x,y)=(1,0)
+    const Real ui[] = {0,0}; // v=0
+    sys.setDefaultMass(10);
+    sys.setDefaultTimeAndState(0, Vector(2, qi), Vector(2, ui));
+
+    RungeKuttaMersonIntegrator integ(sys);
+    integ.setAccuracy(1e-4);
+    integ.setConstraintTolerance(1e-6);
+    integ.setUseFastEventLocalization(useFastEventLocalization);
+    TimeStepper ts(sys);
+    ts.setIntegrator(integ);
+    ts.initialize(sys.getDefaultState());
+    ts.stepTo(10);
+
+    ASSERT(ZeroPositionHandler::eventCount > 3);
+    ASSERT(AccelerationHandler::eventCount > 3);
+    ASSERT(TimeHandler::eventCount == 1);
+
+    // Localizing a Position or Time event alone doesn't evaluate the
+    // Acceleration trigger, so it is evaluated fewer times than the
+    // Position trigger.
+    ASSERT(numAccelerationValues < numPositionValues);
+}
+
+int main() {
+    try {
+        runPendulum(false);
+        runPendulum(true);
+        cout << "Done" << endl;
+        return 0;
+    }
+    catch (std::exception& e) {
+        std::printf("FAILED: %s\n", e.what());
+        return 1;
+    }
+}
@@ -43,6 +43,13 @@ int main () {
     testIntegrator(integ, sys, 1e-7);
     integ.setReturnEveryInternalStep(true);
     testIntegrator(integ, sys, 1e-7);
+
+    // Localize events without prescribing or projecting.
+    integ.setUseFastEventLocalization(true);
+    testIntegrator(integ, sys, 1e-7);
+    integ.setUseFastEventLocalization(false);
+    integ.setReturnEveryInternalStep(false);
+    testDenseOutput(integ, sys, 1e-7);
     cout << "Done" << endl;
     return 0;
   }
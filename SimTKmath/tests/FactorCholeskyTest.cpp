@@ -0,0 +1,168 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+/**@file
+ * Tests the FactorCholesky and FactorLDLT classes on symmetric positive 
+ * definite, positive semidefinite, and indefinite systems, checking the
+ * solutions against FactorLU and FactorQTZ.
+ */
+
+#include "SimTKmath.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+void testCholesky() {
+    const int n = 7;
+    Matrix a = Test::randMatrix(n, n);
+    a = a*~a;
+    a.diag() += 1; // well conditioned
+    const Vector b = Test::randVector(n);
+
+    Vector xlu;
+    FactorLU(a).solve(b, xlu);
+
+    FactorCholesky chol(a);
+    SimTK_TEST(chol.isPositiveDefinite());
+    SimTK_TEST(chol.getRank() == n);
+    Vector x;
+    chol.solve(b, x);
+    SimTK_TEST_EQ_SIZE(x, xlu, n);
+    SimTK_TEST_EQ_SIZE(a*x, b, n);
+
+    // Multiple right hand sides.
+    Matrix bb(n, 3), xx;
+    bb(0) = b; bb(1) = 2*b; bb(2) = Real(-1)*b;
+    chol.solve(bb, xx);
+    SimTK_TEST_EQ_SIZE(a*xx, bb, n);
+
+    // Only the lower triangle should be referenced.
+    Matrix lower = a;
+    for (int j=1; j < n; ++j)
+        for (int i=0; i < j; ++i)
+            lower(i,j) = NaN;
+    FactorCholesky(lower).solve(b, x);
+    SimTK_TEST_EQ_SIZE(x, xlu, n);
+
+    // Copy and assignment.
+    FactorCholesky copy(chol), assigned;
+    assigned = chol;
+    Vector xc, xa;
+    copy.solve(b, xc); assigned.solve(b, xa);
+    SimTK_TEST_EQ(xc, xlu); SimTK_TEST_EQ(xa, xlu);
+
+    // Float.
+    Matrix_<float> af(n,n); Vector_<float> bf(n), xf;
+    for (int i=0; i < n; ++i) {
+        bf[i] = (float)b[i];
+        for (int j=0; j < n; ++j) af(i,j) = (float)a(i,j);
+    }
+    FactorCholesky(af).solve(bf, xf);
+    for (int i=0; i < n; ++i)
+        SimTK_TEST_EQ_TOL(xf[i], xlu[i], 1e-3);
+
+    // The pivoted version should get the same answer.
+    FactorCholesky pchol(a, SignificantReal);
+    SimTK_TEST(pchol.isPositiveDefinite());
+    pchol.solve(b, x);
+    SimTK_TEST_EQ_SIZE(x, xlu, n);
+
+    // Not positive definite: the unpivoted factorization must say so and
+    // refuse to solve.
+    Matrix indef = a; indef(n-1,n-1) = -100;
+    FactorCholesky bad(indef);
+    SimTK_TEST(!bad.isPositiveDefinite());
+    SimTK_TEST(bad.getRank() == n-1);
+    SimTK_TEST_MUST_THROW(bad.solve(b, x));
+
+    SimTK_TEST_MUST_THROW(FactorCholesky(Matrix(3,4)));
+    SimTK_TEST_MUST_THROW(FactorCholesky().solve(b, x));
+}
+
+// A rank-deficient but consistent semidefinite system, like the projected
+// inverse mass matrix with redundant constraints.
+void testPivotedCholesky() {
+    const int n = 8, r = 5;
+    const Matrix B = Test::randMatrix(n, r);
+    const Matrix a = B*~B;
+    const Vector b = a*Test::randVector(n); // in the range of a
+
+    FactorQTZ qtz(a, n*SqrtEps*std::sqrt(SqrtEps));
+    FactorCholesky chol(a, n*SqrtEps*std::sqrt(SqrtEps));
+    SimTK_TEST(qtz.getRank() == r);
+    SimTK_TEST(chol.getRank() == r);
+    SimTK_TEST(!chol.isPositiveDefinite());
+
+    Vector xq, xc;
+    qtz.solve(b, xq);
+    chol.solve(b, xc);
+    // Solutions differ in the null space but both must satisfy the system.
+    SimTK_TEST_EQ_TOL(a*xc, b, 1e-8);
+    SimTK_TEST_EQ_TOL(a*xq, b, 1e-8);
+}
+
+void testLDLT() {
+    // Symmetric indefinite KKT-like matrix [M ~G; G 0].
+    const int n = 6, m = 2;
+    Matrix M = Test::randMatrix(n, n);
+    M = M*~M; M.diag() += 1;
+    const Matrix G = Test::randMatrix(m, n);
+    Matrix kkt(n+m, n+m, Real(0));
+    kkt(0,0,n,n) = M;
+    kkt(n,0,m,n) = G;
+    kkt(0,n,n,m) = ~G;
+    const Vector b = Test::randVector(n+m);
+
+    Vector xlu, x;
+    FactorLU(kkt).solve(b, xlu);
+    FactorLDLT ldlt(kkt);
+    SimTK_TEST(!ldlt.isSingular());
+    ldlt.solve(b, x);
+    SimTK_TEST_EQ_SIZE(x, xlu, n+m);
+
+    Matrix bb(n+m, 2), xx;
+    bb(0) = b; bb(1) = 3*b;
+    ldlt.solve(bb, xx);
+    SimTK_TEST_EQ_SIZE(kkt*xx, bb, n+m);
+
+    FactorLDLT copy(ldlt);
+    copy.solve(b, x);
+    SimTK_TEST_EQ_SIZE(x, xlu, n+m);
+
+    FactorLDLT zero(Matrix(3,3,Real(0)));
+    SimTK_TEST(zero.isSingular());
+    SimTK_TEST(zero.getSingularIndex() > 0);
+    SimTK_TEST_MUST_THROW(zero.solve(Vector(3,Real(1)), x));
+}
+
+int main() {
+    SimTK_START_TEST("FactorCholeskyTest");
+        SimTK_SUBTEST(testCholesky);
+        SimTK_SUBTEST(testPivotedCholesky);
+        SimTK_SUBTEST(testLDLT);
+    SimTK_END_TEST();
+}
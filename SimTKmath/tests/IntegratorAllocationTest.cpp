@@ -0,0 +1,160 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check that once the explicit integrators have taken a few steps, they can
+// keep stepping without allocating any heap memory, including when they have
+// to localize and handle triggered events. We count allocations by replacing
+// the global operator new. (Where the libraries are DLLs that have their own
+// operator new, nothing is counted and this test checks nothing.)
+
+#include "SimTKmath.h"
+
+#include "PendulumSystem.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
+
+using namespace SimTK;
+
+static bool countAllocations = false;
+static int  numAllocations = 0;
+
+void* operator new(std::size_t n) {
+    if (countAllocations) ++numAllocations;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t n) {
+    if (countAllocations) ++numAllocations;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) {std::free(p);}
+void operator delete[](void* p) {std::free(p);}
+
+// The pendulum passes through x == 0.
+class ZeroPositionHandler : public TriggeredEventHandler {
+public:
+    static int eventCount;
+    ZeroPositionHandler(PendulumSystem& pendulum)
+    :   TriggeredEventHandler(Stage::Position), pendulum(pendulum) {}
+    Real getValue(const State& state) const {
+        return state.getQ(pendulum.getGuts().getSubsysIndex())[0];
+    }
+    void handleEvent(State& state, Real accuracy, bool& shouldTerminate) const {
+        eventCount++;
+    }
+private:
+    PendulumSystem& pendulum;
+};
+
+// Time passes through a value inside the window where allocations are
+// counted.
+class TimeHandler : public TriggeredEventHandler {
+public:
+    static const Real EventTime;
+    static int eventCount;
+    TimeHandler() : TriggeredEventHandler(Stage::Time) {}
+    Real getValue(const State& state) const {
+        return state.getTime() - EventTime;
+    }
+    void handleEvent(State& state, Real accuracy, bool& shouldTerminate) const {
+        eventCount++;
+    }
+};
+
+const Real TimeHandler::EventTime = 2.255;
+int ZeroPositionHandler::eventCount = 0;
+int TimeHandler::eventCount = 0;
+
+template <class IntegratorType>
+void testNoAllocation(const char* name, bool realTime=false, 
+                      bool withEvents=false) {
+    PendulumSystem sys;
+    if (withEvents) {
+        sys.addEventHandler(new ZeroPositionHandler(sys));
+        sys.addEventHandler(new TimeHandler());
+    }
+    sys.realizeTopology();
+    State initState = sys.getDefaultState();
+    initState.updQ()[0] = 1;
+    initState.updQ()[1] = 0;
+
+    IntegratorType integ(sys);
+    integ.setAccuracy(1e-6);
+    if (realTime) {
+        integ.setUseRealTimeMode(true);
+        integ.setFixedStepSize(1e-3);
+    }
+    TimeStepper ts(sys, integ);
+    ts.initialize(initState);
+
+    // Let the workspaces get sized.
+    const Real Interval = 0.01;
+    for (int k=1; k <= 100; ++k)
+        ts.stepTo(k*Interval);
+
+    const int stepsBefore = integ.getNumStepsTaken();
+    ZeroPositionHandler::eventCount = TimeHandler::eventCount = 0;
+    numAllocations = 0;
+    countAllocations = true;
+    for (int k=101; k <= 500; ++k)
+        ts.stepTo(k*Interval);
+    countAllocations = false;
+
+    std::printf("%s: %d allocations in %d steps\n", name, numAllocations,
+                integ.getNumStepsTaken() - stepsBefore);
+    ASSERT(integ.getNumStepsTaken() > stepsBefore);
+    ASSERT(numAllocations == 0);
+    if (withEvents) {
+        ASSERT(ZeroPositionHandler::eventCount > 0);
+        ASSERT(TimeHandler::eventCount == 1);
+    }
+}
+
+int main () {
+    try {
+        testNoAllocation<RungeKuttaMersonIntegrator>("RungeKuttaMerson");
+        testNoAllocation<RungeKuttaFeldbergIntegrator>("RungeKuttaFeldberg");
+        testNoAllocation<RungeKutta3Integrator>("RungeKutta3");
+        testNoAllocation<RungeKutta2Integrator>("RungeKutta2");
+        testNoAllocation<ExplicitEulerIntegrator>("ExplicitEuler");
+        testNoAllocation<RungeKuttaMersonIntegrator>
+            ("RungeKuttaMerson (real-time mode)", true);
+        testNoAllocation<RungeKuttaMersonIntegrator>
+            ("RungeKuttaMerson (with events)", false, true);
+        testNoAllocation<RungeKutta3Integrator>
+            ("RungeKutta3 (with events)", false, true);
+        std::printf("Done\n");
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::printf("FAILED: %s\n", e.what());
+        return 1;
+    }
+}
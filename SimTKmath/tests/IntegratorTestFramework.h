@@ -205,7 +205,7 @@ PeriodicReporter* PeriodicReporter::reporter = 0;
 bool OnceOnlyEventReporter::hasOccurred = false;
 int DiscontinuousReporter::eventCount = 0;
 
-void testIntegrator (Integrator& integ, PendulumSystem& sys, Real accuracy=1e-4) {
+void resetEventCounts() {
     ZeroVelocityHandler::eventCount = 0;
     ZeroVelocityHandler::lastEventTime = 0.0;
     PeriodicHandler::eventCount = 0;
@@ -215,6 +215,10 @@ void testIntegrator (Integrator& integ, PendulumSystem& sys, Real accuracy=1e-4)
     PeriodicReporter::eventCount = 0;
     OnceOnlyEventReporter::hasOccurred = false;
     DiscontinuousReporter::eventCount = 0;
+}
+
+void testIntegrator (Integrator& integ, PendulumSystem& sys, Real accuracy=1e-4) {
+    resetEventCounts();
 
     const Real t0=0;
     const Real tFinal = 20.003;
@@ -266,4 +270,78 @@ void testIntegrator (Integrator& integ, PendulumSystem& sys, Real accuracy=1e-4)
     ASSERT(DiscontinuousReporter::eventCount == (int) (ts.getTime()/2.0));
 }
 
+// Check that the recorded continuous extensions of the steps cover the whole
+// trajectory without gaps and reproduce the interpolated states the 
+// integrator reports. Interpolated states aren't projected here so they 
+// should be the raw interpolant too.
+void testDenseOutput(Integrator& integ, PendulumSystem& sys,
+                     Real accuracy=1e-4) {
+    resetEventCounts();
+    const Real qi[] = {1,0}; // (x,y)=(1,0)
+    const Real ui[] = {0,0}; // v=0
+    sys.setDefaultMass(10);
+    sys.setDefaultTimeAndState(0, Vector(2, qi), Vector(2, ui));
+    integ.setAccuracy(accuracy);
+    integ.setConstraintTolerance(1e-4);
+    integ.setFinalTime(3);
+    const bool wasProjectingInterpolatedStates = 
+        integ.isInterpolatedStateProjectionInUse();
+    integ.setProjectInterpolatedStates(false);
+    integ.setRecordDenseOutput(true);
+    ASSERT(integ.isDenseOutputRecorded());
+
+    // Return every significant state so that we see the pre-event states
+    // that are interpolated during event localization.
+    TimeStepper ts(sys);
+    ts.setIntegrator(integ);
+    ts.setReportAllSignificantStates(true);
+    ts.initialize(sys.getDefaultState());
+    ASSERT(integ.getNumDenseOutputRecords() == 0);
+
+    // Drain the records after each call, keeping them all here. Each must
+    // start where the previous one ended. The interpolated states are kept
+    // too, since the record that covers one may not have been made yet.
+    Array_<Integrator::DenseOutput> records;
+    Array_<Real> interpolatedTimes;
+    Array_<Vector> interpolatedY;
+    while (ts.getTime() < 3) {
+        ts.stepTo(3);
+        for (int i=0; i < integ.getNumDenseOutputRecords(); ++i) {
+            const Integrator::DenseOutput& dense = integ.getDenseOutput(i);
+            ASSERT(dense.getNumY() == ts.getState().getNY());
+            ASSERT(dense.getStartTime() < dense.getEndTime());
+            const Real recordedTo = 
+                records.empty() ? Real(0) : records.back().getEndTime();
+            ASSERT(std::abs(dense.getStartTime() - recordedTo) < 1e-10);
+            records.push_back(dense);
+        }
+        integ.clearDenseOutput();
+        ASSERT(integ.getNumDenseOutputRecords() == 0);
+        if (integ.isStateInterpolated()) {
+            interpolatedTimes.push_back(ts.getTime());
+            interpolatedY.push_back(ts.getState().getY());
+        }
+    }
+    ASSERT(!interpolatedTimes.empty());
+
+    // Each interpolated state is reproduced by the record that covers it.
+    Vector y;
+    for (unsigned k=0; k < interpolatedTimes.size(); ++k) {
+        int i = records.size()-1;
+        while (i >= 0 && records[i].getStartTime() > interpolatedTimes[k])
+            --i;
+        ASSERT(i >= 0);
+        records[i].evaluate(interpolatedTimes[k], y);
+        ASSERT((y - interpolatedY[k]).normInf() < 1e-10);
+    }
+
+    // The records reach the final time, where they match the final state.
+    ASSERT(std::abs(records.back().getEndTime() - 3) < 1e-10);
+    records.back().evaluate(records.back().getEndTime(), y);
+    ASSERT((y - ts.getState().getY()).normInf() < 1e-8);
+
+    integ.setRecordDenseOutput(false);
+    integ.setProjectInterpolatedStates(wasProjectingInterpolatedStates);
+}
+
 #endif /*SimTK_SIMMATH_INTEGRATOR_TEST_FRAMEWORK_H_*/
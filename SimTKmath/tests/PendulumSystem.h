@@ -443,6 +443,8 @@ void PendulumSystemGuts::projectQImpl(State& s, Vector& qerrest,
 
     //cout << "BEFORE wperr=" << tp*ep << endl;
 
+    const int maxIterations = opts.getMaxIterations(); // 0 means no limit
+    int numIterations = 0;
     Real wqchg;
     do {
         // Position projection
@@ -462,7 +464,14 @@ void PendulumSystemGuts::projectQImpl(State& s, Vector& qerrest,
         realize(s, Stage::Position); // recalc QErr (ep)
     
         //cout << "AFTER q-=wdq/W wperr=" << tp*ep << " wqchg=" << wqchg << endl;
-    } while (std::abs(tp*ep) > consAccuracy && wqchg >= 0.01*consAccuracy);
+        ++numIterations;
+    } while (std::abs(tp*ep) > consAccuracy && wqchg >= 0.01*consAccuracy
+             && (maxIterations == 0 || numIterations < maxIterations));
+
+    // If we stopped at the caller's iteration limit the improved q's are
+    // kept, but the projection failed.
+    const bool hitIterationLimit = 
+        std::abs(tp*ep) > consAccuracy && wqchg >= 0.01*consAccuracy;
 
     // Now do error estimates.
 
@@ -487,7 +496,9 @@ void PendulumSystemGuts::projectQImpl(State& s, Vector& qerrest,
         //cout << "PW*eq=" << PW*eq << endl;
     }
 
-    results.setExitStatus(ProjectResults::Succeeded);
+    results.setExitStatus(hitIterationLimit 
+                          ? ProjectResults::FailedToAchieveAccuracy
+                          : ProjectResults::Succeeded);
 }
 
 void PendulumSystemGuts::projectUImpl(State& s, Vector& uerrest, 
@@ -0,0 +1,239 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Run a pendulum in real-time mode the way a fixed-rate control loop would,
+// and check the fixed steps, step-end event detection and step timing 
+// statistics.
+
+#include "SimTKmath.h"
+
+#include "PendulumSystem.h"
+
+#include <cmath>
+#include <cstdio>
+
+#define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
+
+using namespace SimTK;
+
+const Real StepSize = 1e-3;
+
+// Records the times at which the pendulum's x velocity crosses zero going up.
+class ZeroVelocityHandler : public TriggeredEventHandler {
+public:
+    static Array_<Real> eventTimes;
+    ZeroVelocityHandler(PendulumSystem& pendulum) 
+    :   TriggeredEventHandler(Stage::Velocity), pendulum(pendulum) {
+        getTriggerInfo().setTriggerOnFallingSignTransition(false);
+    }
+    Real getValue(const State& state) const {
+        return state.getU(pendulum.getGuts().getSubsysIndex())[0];
+    }
+    void handleEvent(State& state, Real accuracy, bool& shouldTerminate) const
+    {   eventTimes.push_back(state.getTime()); }
+private:
+    PendulumSystem& pendulum;
+};
+Array_<Real> ZeroVelocityHandler::eventTimes;
+
+int countSteps(const Array_<int>& histogram) {
+    int n = 0;
+    for (int i=0; i < (int)histogram.size(); ++i) 
+        n += histogram[i];
+    return n;
+}
+
+void testRealTimeMode() {
+    PendulumSystem sys;
+    sys.addEventHandler(new ZeroVelocityHandler(sys));
+    sys.realizeTopology();
+    State initState = sys.getDefaultState();
+    initState.updQ()[0] = 1;
+    initState.updQ()[1] = 0;
+
+    RungeKuttaMersonIntegrator integ(sys);
+    integ.setAccuracy(1e-4);
+    integ.setUseRealTimeMode(true);
+    ASSERT(integ.isRealTimeModeInUse());
+
+    // A fixed step size is required.
+    TimeStepper ts(sys, integ);
+    try {
+        ts.initialize(initState);
+        ASSERT(!"initialize() should have failed without a fixed step size");
+    } catch (const std::exception&) {}
+
+    integ.setFixedStepSize(StepSize);
+    // Every step misses this deadline.
+    integ.setStepDeadline(1e-12);
+    integ.setMaximumProjectionIterations(2);
+    ts.initialize(initState);
+    integ.resetAllStatistics();
+
+    // Report every 10 steps, like a controller running at a tenth of the
+    // simulation rate.
+    const int NumReports = 200;
+    for (int k=1; k <= NumReports; ++k) {
+        ts.stepTo(k*10*StepSize);
+        ASSERT(std::abs(ts.getTime() - k*10*StepSize) < 1e-12);
+    }
+
+    // Steps are never retried or shortened for events.
+    const int numSteps = integ.getNumStepsTaken();
+    ASSERT(numSteps == 10*NumReports);
+    ASSERT(integ.getNumStepsAttempted() == numSteps);
+    ASSERT(std::abs(integ.getPreviousStepSizeTaken() - StepSize) < 1e-12);
+
+    // Events are handled at the ends of steps.
+    const Array_<Real>& eventTimes = ZeroVelocityHandler::eventTimes;
+    ASSERT(!eventTimes.empty());
+    for (int i=0; i < (int)eventTimes.size(); ++i) {
+        const Real steps = eventTimes[i]/StepSize;
+        ASSERT(std::abs(steps - std::floor(steps + 0.5)) < 1e-6);
+    }
+
+    const Array_<int>& histogram = integ.getStepWallTimeHistogram();
+    std::printf("%d steps, worst %gs, %d events\nStep wall time histogram:\n",
+                numSteps, integ.getWorstStepWallTime(), 
+                (int)eventTimes.size());
+    for (int i=0; i < (int)histogram.size(); ++i)
+        if (histogram[i]) std::printf("  bin %d: %d\n", i, histogram[i]);
+    ASSERT(countSteps(histogram) == numSteps);
+    ASSERT(integ.getNumDeadlineMisses() == numSteps);
+    ASSERT(integ.getPreviousStepWallTime() > 0);
+    ASSERT(integ.getWorstStepWallTime() >= integ.getPreviousStepWallTime());
+
+    integ.resetAllStatistics();
+    ASSERT(countSteps(integ.getStepWallTimeHistogram()) == 0);
+    ASSERT(integ.getNumDeadlineMisses() == 0);
+    ASSERT(integ.getWorstStepWallTime() == 0);
+
+    // Without a deadline nothing is missed, but steps are still timed.
+    integ.setStepDeadline(Infinity);
+    ts.initialize(initState);
+    ts.stepTo(0.1);
+    ASSERT(integ.getNumDeadlineMisses() == 0);
+    ASSERT(countSteps(integ.getStepWallTimeHistogram()) == 100);
+
+    // Steps aren't timed outside of real-time mode.
+    integ.setUseRealTimeMode(false);
+    integ.resetAllStatistics();
+    ts.initialize(initState);
+    ts.stepTo(0.1);
+    ASSERT(integ.getNumStepsTaken() > 0);
+    ASSERT(countSteps(integ.getStepWallTimeHistogram()) == 0);
+}
+
+// Large steps take the pendulum far enough off its length constraint that
+// two projection iterations can't restore it to a tight tolerance. Each step
+// is kept anyway, along with the improvement the projection did make.
+void testProjectionLimit() {
+    PendulumSystem sys;
+    sys.realizeTopology();
+    State initState = sys.getDefaultState();
+    initState.updQ()[0] = 1;
+    initState.updQ()[1] = 0;
+
+    const Real BigStep = 0.05, Tolerance = 1e-12;
+    RungeKutta2Integrator integ(sys);
+    integ.setUseRealTimeMode(true);
+    integ.setFixedStepSize(BigStep);
+    integ.setConstraintTolerance(Tolerance);
+    integ.setMaximumProjectionIterations(2);
+    TimeStepper ts(sys, integ);
+    ts.initialize(initState);
+    integ.resetAllStatistics();
+
+    const int NumSteps = 20;
+    Real worstPerr = 0;
+    for (int k=1; k <= NumSteps; ++k) {
+        ts.stepTo(k*BigStep);
+        const Real perr = std::abs(ts.getState().getQErr()[0]);
+        worstPerr = std::max(worstPerr, perr);
+    }
+
+    ASSERT(integ.getNumStepsTaken() == NumSteps);
+    ASSERT(integ.getNumStepsAttempted() == NumSteps);
+    ASSERT(integ.getNumQProjectionFailures() > 0);
+    // The velocity constraint is linear in u so one iteration solves it.
+    ASSERT(integ.getNumUProjectionFailures() == 0);
+    ASSERT(Tolerance < worstPerr && worstPerr < 1e-6);
+
+    // Enough iterations bring every step back to the tolerance.
+    integ.setMaximumProjectionIterations(20);
+    ts.initialize(initState);
+    integ.resetAllStatistics();
+    ts.stepTo(NumSteps*BigStep);
+    ASSERT(integ.getNumQProjectionFailures() == 0);
+    ASSERT(std::abs(ts.getState().getQErr()[0]) <= Tolerance);
+}
+
+// Once real-time steps have locked the workspaces, a change to the number of
+// state variables can't be accommodated by growing them, so the next step
+// fails rather than allocating.
+void testResizeAfterLock() {
+    PendulumSystem sys;
+    sys.realizeTopology();
+    State initState = sys.getDefaultState();
+    initState.updQ()[0] = 1;
+    initState.updQ()[1] = 0;
+
+    RungeKuttaMersonIntegrator integ(sys);
+    integ.setUseRealTimeMode(true);
+    integ.setFixedStepSize(StepSize);
+    integ.initialize(initState);
+    integ.stepTo(10*StepSize);
+    integ.stepTo(10*StepSize);
+
+    // Add a z to the advanced state, as an event handler might.
+    State& advanced = integ.updAdvancedState();
+    advanced.invalidateAll(Stage::Model);
+    advanced.allocateZ(sys.getGuts().getSubsysIndex(), Vector(1, Real(0)));
+    sys.realizeModel(advanced);
+    sys.realize(advanced, Stage::Acceleration);
+    integ.reinitialize(Stage::Model, false);
+
+    bool threw = false;
+    try {
+        integ.stepTo(20*StepSize);
+        integ.stepTo(20*StepSize);
+    } catch (const std::exception& e) {
+        threw = true;
+        ASSERT(String(e.what()).find("locked") != String::npos);
+    }
+    ASSERT(threw);
+}
+
+int main () {
+    try {
+        testRealTimeMode();
+        testProjectionLimit();
+        testResizeAfterLock();
+        std::printf("Done\n");
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::printf("FAILED: %s\n", e.what());
+        return 1;
+    }
+}
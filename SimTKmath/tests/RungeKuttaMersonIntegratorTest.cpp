@@ -48,7 +48,14 @@ int main () {
         testIntegrator(integ, sys);
         integ.setReturnEveryInternalStep(true);
         testIntegrator(integ, sys);
+
+        // Localize events without prescribing or projecting.
+        integ.setUseFastEventLocalization(true);
+        testIntegrator(integ, sys);
     }
+
+    RungeKuttaMersonIntegrator integ(sys);
+    testDenseOutput(integ, sys);
     cout << "Done" << endl;
     return 0;
   }
@@ -24,6 +24,8 @@
 #include "SimTKmath.h"
 #include <vector>
 #include <exception>
+#include <fstream>
+#include <cstdio>
 
 using namespace SimTK;
 using namespace std;
@@ -201,6 +203,89 @@ void testOBBTree() {
         SimTK_TEST(faceReferenceCount[i] == 1);
 }
 
+void testLargeOBBTree() {
+    // Large enough that the tree may be built by several threads.
+    ContactGeometry::TriangleMesh mesh(PolygonalMesh::createSphereMesh(1, 6));
+    SimTK_TEST(mesh.getNumFaces() > 20000);
+    vector<int> faceReferenceCount(mesh.getNumFaces(), 0);
+    validateOBBTree(mesh, mesh.getOBBTreeNode(), mesh.getOBBTreeNode(), faceReferenceCount);
+    for (int i = 0; i < (int) faceReferenceCount.size(); i++)
+        SimTK_TEST(faceReferenceCount[i] == 1);
+}
+
+void compareOBBTrees(ContactGeometry::TriangleMesh::OBBTreeNode node1, ContactGeometry::TriangleMesh::OBBTreeNode node2) {
+    SimTK_TEST(node1.getBounds().getTransform().p() == node2.getBounds().getTransform().p());
+    SimTK_TEST(node1.getBounds().getTransform().R() == node2.getBounds().getTransform().R());
+    SimTK_TEST(node1.getBounds().getSize() == node2.getBounds().getSize());
+    SimTK_TEST(node1.getNumTriangles() == node2.getNumTriangles());
+    SimTK_TEST(node1.isLeafNode() == node2.isLeafNode());
+    if (node1.isLeafNode() != node2.isLeafNode())
+        return;
+    if (node1.isLeafNode()) {
+        SimTK_TEST(node1.getTriangles() == node2.getTriangles());
+    }
+    else {
+        compareOBBTrees(node1.getFirstChildNode(), node2.getFirstChildNode());
+        compareOBBTrees(node1.getSecondChildNode(), node2.getSecondChildNode());
+    }
+}
+
+void testBinaryFile() {
+    const ContactGeometry::TriangleMesh mesh(PolygonalMesh::createSphereMesh(1, 3), true);
+    const String pathname = "TestTriangleMesh_sphere.bin";
+    mesh.writeBinaryFile(pathname);
+    const ContactGeometry::TriangleMesh copy = ContactGeometry::TriangleMesh::createFromBinaryFile(pathname);
+
+    // Everything should be exactly the same.
+    
+    SimTK_TEST(copy.getNumVertices() == mesh.getNumVertices());
+    SimTK_TEST(copy.getNumFaces() == mesh.getNumFaces());
+    SimTK_TEST(copy.getNumEdges() == mesh.getNumEdges());
+    for (int i = 0; i < mesh.getNumVertices(); i++)
+        SimTK_TEST(copy.getVertexPosition(i) == mesh.getVertexPosition(i));
+    for (int i = 0; i < mesh.getNumFaces(); i++) {
+        for (int j = 0; j < 3; j++) {
+            SimTK_TEST(copy.getFaceVertex(i, j) == mesh.getFaceVertex(i, j));
+            SimTK_TEST(copy.getFaceEdge(i, j) == mesh.getFaceEdge(i, j));
+        }
+        SimTK_TEST(copy.getFaceNormal(i) == mesh.getFaceNormal(i));
+        SimTK_TEST(copy.getFaceArea(i) == mesh.getFaceArea(i));
+        const Vec2 uv(0.2, 0.3);
+        SimTK_TEST(copy.findNormalAtPoint(i, uv) == mesh.findNormalAtPoint(i, uv));
+    }
+    for (int i = 0; i < mesh.getNumEdges(); i++)
+        for (int j = 0; j < 2; j++) {
+            SimTK_TEST(copy.getEdgeVertex(i, j) == mesh.getEdgeVertex(i, j));
+            SimTK_TEST(copy.getEdgeFace(i, j) == mesh.getEdgeFace(i, j));
+        }
+    Vec3 center1, center2;
+    Real radius1, radius2;
+    mesh.getBoundingSphere(center1, radius1);
+    copy.getBoundingSphere(center2, radius2);
+    SimTK_TEST(center1 == center2 && radius1 == radius2);
+    compareOBBTrees(mesh.getOBBTreeNode(), copy.getOBBTreeNode());
+    bool inside1, inside2;
+    UnitVec3 normal1, normal2;
+    const Vec3 point(0.3, 2, -0.1);
+    SimTK_TEST(copy.findNearestPoint(point, inside2, normal2) == mesh.findNearestPoint(point, inside1, normal1));
+
+    // A file that is damaged or isn't a binary mesh file must be rejected.
+    
+    {
+        ofstream out(pathname.c_str(), ios::out | ios::binary);
+        out << "This is not a mesh.";
+    }
+    SimTK_TEST_MUST_THROW(ContactGeometry::TriangleMesh::createFromBinaryFile(pathname));
+    mesh.writeBinaryFile(pathname);
+    {
+        ofstream out(pathname.c_str(), ios::out | ios::binary | ios::app);
+        out << "extra";
+    }
+    SimTK_TEST_MUST_THROW(ContactGeometry::TriangleMesh::createFromBinaryFile(pathname));
+    std::remove(pathname.c_str());
+    SimTK_TEST_MUST_THROW(ContactGeometry::TriangleMesh::createFromBinaryFile(pathname));
+}
+
 void testRayIntersection() {
     // Create an octrohedral mesh.
     
@@ -277,6 +362,64 @@ void testFindNearestPoint() {
     }
 }
 
+// A batch of queries should find points just as near as separate queries do,
+// whether successive points are close together or far apart.
+void testFindNearestPoints() {
+    const ContactGeometry::TriangleMesh mesh
+       (PolygonalMesh::createSphereMesh(1, 4));
+    Random::Gaussian random(0, 1);
+    Array_<Vec3> positions;
+    for (int i = 0; i < 200; i++) {
+        if (i%50 == 0)
+            positions.push_back(Vec3(random.getValue(), random.getValue(), 
+                                     random.getValue()));
+        else
+            positions.push_back(positions.back()+0.02*Vec3(random.getValue(), 
+                                random.getValue(), random.getValue()));
+    }
+    Array_<Vec3> nearest;
+    Array_<bool> inside;
+    Array_<UnitVec3> normals;
+    mesh.findNearestPoints(positions, nearest, inside, normals);
+    SimTK_TEST(nearest.size() == positions.size());
+    SimTK_TEST(inside.size() == positions.size());
+    SimTK_TEST(normals.size() == positions.size());
+    for (unsigned i = 0; i < positions.size(); i++) {
+        bool expectedInside;
+        UnitVec3 expectedNormal;
+        const Vec3 expected = 
+            mesh.findNearestPoint(positions[i], expectedInside, expectedNormal);
+        SimTK_TEST(inside[i] == expectedInside);
+        SimTK_TEST_EQ((nearest[i]-positions[i]).norm(), 
+                      (expected-positions[i]).norm());
+        // No face is any nearer.
+        for (int face = 0; face < mesh.getNumFaces(); face++) {
+            Vec2 uv;
+            const Vec3 p = mesh.findNearestPointToFace(positions[i], face, uv);
+            SimTK_TEST((p-positions[i]).norm() 
+                       >= (nearest[i]-positions[i]).norm()-100*Eps);
+        }
+    }
+
+    // Leaving out the normals gives the same points.
+    Array_<Vec3> nearestOnly;
+    Array_<bool> insideOnly;
+    mesh.findNearestPoints(positions, nearestOnly, insideOnly);
+    SimTK_TEST(nearestOnly == nearest && insideOnly == inside);
+
+    // Other kinds of geometry answer each query separately.
+    const ContactGeometry::Sphere sphere(1.5);
+    sphere.findNearestPoints(positions, nearest, inside, normals);
+    for (unsigned i = 0; i < positions.size(); i++) {
+        bool expectedInside;
+        UnitVec3 expectedNormal;
+        SimTK_TEST_EQ(nearest[i], sphere.findNearestPoint
+                        (positions[i], expectedInside, expectedNormal));
+        SimTK_TEST(inside[i] == expectedInside);
+        SimTK_TEST_EQ(normals[i], expectedNormal);
+    }
+}
+
 void testBoundingSphere() {
     Random::Uniform random(0, 10);
     for (int i = 0; i < 100; i++) {
@@ -312,9 +455,12 @@ int main() {
         SimTK_SUBTEST(testTriangleMesh);
         SimTK_SUBTEST(testIncorrectMeshes);
         SimTK_SUBTEST(testOBBTree);
+        SimTK_SUBTEST(testLargeOBBTree);
+        SimTK_SUBTEST(testBinaryFile);
         SimTK_SUBTEST(testRayIntersection);
         SimTK_SUBTEST(testSmoothMesh);
         SimTK_SUBTEST(testFindNearestPoint);
+        SimTK_SUBTEST(testFindNearestPoints);
         SimTK_SUBTEST(testBoundingSphere);
     SimTK_END_TEST();
 }
@@ -0,0 +1,117 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check the mesh-mesh contact tracker against a brute force comparison of
+// every pair of triangles, and check that starting from the previous step's
+// contact gives the same answer as starting over.
+
+#include "SimTKmath.h"
+
+#include <algorithm>
+#include <set>
+
+using namespace SimTK;
+using namespace std;
+
+typedef ContactGeometry::TriangleMesh TriangleMesh;
+
+// Find the faces of each mesh that intersect some face of the other one.
+void findIntersectingFacesByBruteForce
+   (const TriangleMesh& mesh1, const TriangleMesh& mesh2,
+    const Transform& X_M1M2, set<int>& faces1, set<int>& faces2) {
+    faces1.clear(); faces2.clear();
+    for (int f2=0; f2 < mesh2.getNumFaces(); ++f2) {
+        const Geo::Triangle tri2
+           (X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(f2,0)),
+            X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(f2,1)),
+            X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(f2,2)));
+        for (int f1=0; f1 < mesh1.getNumFaces(); ++f1) {
+            const Geo::Triangle tri1
+               (mesh1.getVertexPosition(mesh1.getFaceVertex(f1,0)),
+                mesh1.getVertexPosition(mesh1.getFaceVertex(f1,1)),
+                mesh1.getVertexPosition(mesh1.getFaceVertex(f1,2)));
+            if (tri2.overlapsTriangle(tri1)) {
+                faces1.insert(f1); faces2.insert(f2);
+            }
+        }
+    }
+}
+
+bool includes(const set<int>& big, const set<int>& small) {
+    return std::includes(big.begin(), big.end(), small.begin(), small.end());
+}
+
+// A lumpy sphere is pushed into a brick while turning, then pulled out
+// again, with one large jump along the way.
+void testMeshMeshTracking() {
+    const TriangleMesh sphere(PolygonalMesh::createSphereMesh(1, 3));
+    const TriangleMesh brick
+       (PolygonalMesh::createBrickMesh(Vec3(1.5, 1, .8), 3));
+    const ContactSurfaceIndex surf1(0), surf2(1);
+    ContactTracker::TriangleMeshTriangleMesh tracker;
+
+    Contact prior = UntrackedContact(surf1, surf2);
+    int numTouching = 0;
+    const int NumSteps = 40;
+    for (int step=0; step <= NumSteps; ++step) {
+        const Real s = Real(step)/NumSteps;
+        // In and out along x, with a jump to the far side at the halfway
+        // point.
+        const Real x = step == NumSteps/2 ? Real(-1.9)
+                       : 2.8 - 2.2*std::sin(Pi*s);
+        const Transform X_GB(Rotation(.3*s, ZAxis), Vec3(0));
+        const Transform X_GS(Rotation(2*s, YAxis), Vec3(x, .2, .1));
+
+        Contact fromPrior, fromScratch;
+        tracker.trackContact(prior, X_GB, brick, X_GS, sphere, 0, fromPrior);
+        tracker.trackContact(UntrackedContact(surf1, surf2),
+                             X_GB, brick, X_GS, sphere, 0, fromScratch);
+
+        set<int> faces1, faces2;
+        findIntersectingFacesByBruteForce(brick, sphere, ~X_GB*X_GS,
+                                          faces1, faces2);
+        const bool touching = !faces1.empty() || !faces2.empty();
+        SimTK_TEST(fromPrior.isEmpty() == !touching);
+        SimTK_TEST(fromScratch.isEmpty() == !touching);
+        if (touching) {
+            ++numTouching;
+            const TriangleMeshContact& c1 = TriangleMeshContact::getAs(fromPrior);
+            const TriangleMeshContact& c2 =
+                TriangleMeshContact::getAs(fromScratch);
+            SimTK_TEST(c1.getSurface1Faces() == c2.getSurface1Faces());
+            SimTK_TEST(c1.getSurface2Faces() == c2.getSurface2Faces());
+            // The contact includes the buried faces too.
+            SimTK_TEST(includes(c1.getSurface1Faces(), faces1));
+            SimTK_TEST(includes(c1.getSurface2Faces(), faces2));
+        }
+        prior = fromPrior.isEmpty() ? Contact(UntrackedContact(surf1, surf2))
+                                    : fromPrior;
+    }
+    SimTK_TEST(numTouching > NumSteps/2);
+}
+
+int main() {
+    SimTK_START_TEST("TestTriangleMeshContactTracker");
+        SimTK_SUBTEST(testMeshMeshTracking);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,89 @@
+/* -------------------------------------------------------------------------- *
+ *                 Simbody(tm) Example: Convert Mesh To Binary                *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* This utility converts a mesh in Wavefront OBJ (.obj) or VTK PolyData (.vtp)
+format to a binary mesh file that PolygonalMesh::loadBinaryFile() can load in
+place, without parsing. With the -contact option it instead writes a
+ContactGeometry::TriangleMesh binary file, which also holds the mesh's
+adjacency and bounding box tree for use with
+ContactGeometry::TriangleMesh::createFromBinaryFile().
+
+Binary files are specific to the platform and precision they were written on,
+so keep the original mesh and convert it wherever it is needed. */
+
+#include "Simbody.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace SimTK;
+
+int main(int argc, const char* argv[]) {
+    bool contact = argc > 1 && std::strcmp(argv[1], "-contact") == 0;
+    const int first = contact ? 2 : 1;
+    if (argc - first != 2) {
+        std::cout << "Usage: " << argv[0]
+                  << " [-contact] input.obj|input.vtp output.bin\n";
+        return argc == 1 ? 0 : 1;
+    }
+    const std::string input = argv[first], output = argv[first+1];
+
+    try {
+        const double start = realTime();
+        PolygonalMesh mesh;
+        const std::string::size_type dot = input.rfind('.');
+        const std::string extension =
+            dot == std::string::npos ? "" : input.substr(dot);
+        if (extension == ".vtp")
+            mesh.loadVtpFile(input);
+        else {
+            std::ifstream file(input.c_str());
+            if (!file.good()) {
+                std::cout << "Can't open " << input << "\n";
+                return 1;
+            }
+            mesh.loadObjFile(file);
+        }
+        const double loaded = realTime();
+        std::printf("Read %s: %d vertices, %d faces in %.3fs\n",
+                    input.c_str(), mesh.getNumVertices(), mesh.getNumFaces(),
+                    loaded-start);
+
+        if (contact) {
+            const ContactGeometry::TriangleMesh triMesh(mesh);
+            std::printf("Built contact mesh with %d triangles in %.3fs\n",
+                        triMesh.getNumFaces(), realTime()-loaded);
+            triMesh.writeBinaryFile(output);
+        } else
+            mesh.writeBinaryFile(output);
+        std::printf("Wrote %s\n", output.c_str());
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -140,15 +140,64 @@ types of these Contact objects (for example, PointContact, LineContact,
 MeshContact) and the same algorithm may result in different kinds of Contact 
 under different circumstances. At each evaluation, the subsystem passes in the 
 previous Contact object, if any, that was associated with two ContactSurfaces,
-then receives an update from the algorithm. **/
+then receives an update from the algorithm.
+
+The subsystem's own bookkeeping (the broad phase, the list of surface pairs to
+examine, and the ContactSnapshots) reuses its heap space from step to step.
+However, each Contact object returned by a ContactTracker is newly allocated,
+so tracking still allocates heap space for every pair examined by the narrow
+phase. **/
 //==============================================================================
 //                          CONTACT TRACKER SUBSYSTEM
 //==============================================================================
 class SimTK_SIMBODY_EXPORT ContactTrackerSubsystem : public Subsystem {
 public:
+/** These are the available broad phase algorithms for finding the pairs of
+contact surfaces whose bounding volumes overlap.
+  - SweepAndPrune keeps the bounding box endpoints sorted along each of the
+    three Ground axes. It is the default and works best when the surfaces are
+    of similar sizes.
+  - DynamicAABBTree keeps the bounding boxes, enlarged by a margin, in a 
+    balanced tree that is updated only for surfaces that move out of their
+    enlarged boxes. It works better when the surface sizes are very uneven,
+    for example a large terrain plus many small objects.
+
+Both find exactly the same pairs. **/
+enum BroadPhaseMethod {
+    SweepAndPrune   = 0,
+    DynamicAABBTree = 1
+};
+
 ContactTrackerSubsystem();
 explicit ContactTrackerSubsystem(MultibodySystem&);
 
+/** Choose the broad phase algorithm. This is a Topology-stage change. 
+@see BroadPhaseMethod **/
+void setBroadPhaseMethod(BroadPhaseMethod method);
+/** Return the broad phase algorithm in use. **/
+BroadPhaseMethod getBroadPhaseMethod() const;
+
+/** Request that the narrow phase ContactTracker calls for the surface pairs
+that need examining be made concurrently on a pool of threads. Each pair's 
+result goes into its own slot, and the slots are then merged into the active
+contact set in surface pair order on the calling thread, so the contacts and
+their ContactIds are exactly the same as with serial tracking. Pairs whose
+tracker doesn't report itself thread safe (see 
+ContactTracker::isThreadSafe()) are tracked on the calling thread.
+
+Parallel tracking is off by default. This is a setting rather than part of 
+the topology, so changing it does not invalidate any State.
+@param      useParallel
+    Set true to enable parallel contact tracking, false to go back to serial.
+@param      numThreads
+    The number of threads in the pool; ignored if \a useParallel is false. 
+    The default is the number of processors on this machine. **/
+void setUseParallelContactTracking
+   (bool useParallel, int numThreads = ParallelExecutor::getNumProcessors());
+/** Return whether parallel contact tracking is currently enabled.
+@see setUseParallelContactTracking() **/
+bool getUseParallelContactTracking() const;
+
 /** Get the number of surfaces being managed by this contact tracker subsystem.
 These are identified by ContactSurfaceIndex values from 0 to 
 getNumSurfaces()-1. This is available after realizeTopology() and does not
@@ -216,6 +265,31 @@ to avoid that you should realize them explicitly first.
 @see realizePredictedContacts()  **/
 const ContactSnapshot& getPredictedContacts(const State& state) const;
 
+/** Get the pairs of contact surfaces whose bounding boxes currently 
+overlap, as found by the broad phase. Of these, only the pairs whose bounding
+spheres also overlap are examined by the ContactTracker algorithms. Pairs on
+the same body or in a common clique are omitted. Each pair has the 
+lower-numbered surface first. You can call this at Position stage or later. 
+
+The broad phase keeps its data structures from step to step in an 
+auto-update state variable, so its cost is nearly linear in the number of
+surfaces when the motion between steps is small. 
+@see setBroadPhaseMethod() **/
+void getBroadPhasePairs
+   (const State& state, 
+    Array_<std::pair<ContactSurfaceIndex,ContactSurfaceIndex> >& pairs) const;
+
+/** Get the pairs of contact surfaces that have started (\a added) or stopped
+(\a removed) overlapping in the broad phase since the broad phase state 
+variable was last updated, normally at the end of the previous step. Pairs
+are omitted and ordered as for getBroadPhasePairs(). You can call this at 
+Position stage or later. **/
+void getBroadPhasePairChanges
+   (const State& state,
+    Array_<std::pair<ContactSurfaceIndex,ContactSurfaceIndex> >& added,
+    Array_<std::pair<ContactSurfaceIndex,ContactSurfaceIndex> >& removed) 
+    const;
+
 /** Calculate the current ActiveContacts set at Position stage or later if
 it hasn't already been done and return true if successful. If we can't 
 unambiguously determine the contact status, we'll return false and give the
@@ -251,28 +325,30 @@ that are being tracked at a particular instant during a simulation. These are
 suitable for use as state variables for remembering past contact status and
 as calculated cache entries containing the current contact status. Each
 tracked surface pair has an integer ContactId that is persistent for as long
-as a particular interaction is being tracked. We maintain a map providing 
-very fast access to individual Contact entries by ContactId. There is also
-a map from ContactSurfaceIndex pairs to ContactId that can be used to see
+as a particular interaction is being tracked. We maintain a hash table 
+providing very fast access to individual Contact entries by ContactId. There
+is also a hash table keyed by ContactSurfaceIndex pairs that can be used to see
 whether we are already tracking a Contact between those surfaces; there can
-be at most one Contact between a given surface pair at any given moment. **/
+be at most one Contact between a given surface pair at any given moment.
+
+Both tables use open addressing in flat arrays that refer to slots in the
+Contact array. Clearing a snapshot, or removing a Contact from it, keeps all
+of its storage, so a snapshot that is refilled with about the same number of
+Contacts each step doesn't itself allocate any heap space. (The Contact 
+objects it refers to are allocated by the ContactTracker that created them.)
+**/
 class SimTK_SIMBODY_EXPORT ContactSnapshot {
-//TODO: replace with fast hash tables
-typedef std::map<ContactId,int>     ContactMap;
-// Note: we always order the key so that the first surface index is less than
-// the second (they can't be equal!).
-typedef std::map<std::pair<ContactSurfaceIndex,ContactSurfaceIndex>, 
-                 ContactId>         SurfaceMap;
 public:
 /** Default constructor sets timestamp to NaN. **/
 ContactSnapshot() : m_time(NaN) {}
 
-/** Restore to default-constructed condition. **/
+/** Restore to default-constructed condition. Heap space is retained for
+reuse. **/
 void clear() {
     m_time = NaN;
     m_contacts.clear();
-    m_id2contact.clear();
-    m_surfPair2id.clear();
+    m_id2contact.fill(-1);
+    m_surfPair2contact.fill(-1);
 }
 
 /** Set the time at which this snapshot was taken. **/
@@ -286,32 +362,29 @@ is assigned a slot in the array of Contact objects that can be used for
 very fast access; however, that index may change if other Contact objects
 are removed from the snapshot. **/
 void adoptContact(Contact& contact) {
-    const ContactId id = contact.getContactId();
-    ContactSurfaceIndex surf1(contact.getSurface1());
-    ContactSurfaceIndex surf2(contact.getSurface2());
-    assert(id.isValid() && surf1.isValid() && surf2.isValid());
-
-    // Surface pair must be ordered (low,high) for the map.
-    if (surf1 > surf2) std::swap(surf1,surf2);
-
-    assert(!hasContact(id));
-    assert(!hasContact(surf1,surf2));
+    assert(contact.getContactId().isValid() 
+           && contact.getSurface1().isValid() 
+           && contact.getSurface2().isValid());
+    assert(!hasContact(contact.getContactId()));
+    assert(!hasContact(contact.getSurface1(),contact.getSurface2()));
 
     const int indx = m_contacts.size();
     m_contacts.push_back(contact); // shallow copy
-    m_id2contact[id] = indx;
-    m_surfPair2id[std::make_pair(surf1,surf2)] = id;
+
+    // Keep the tables at most half full.
+    if (2*m_contacts.size() > (int)m_id2contact.size())
+        rebuildTables(std::max(16, 4*(int)m_contacts.size()));
+    else
+        insertInTables(indx);
 }
 
 /** Does this snapshot contain a Contact object with the given ContactId? **/
 bool hasContact(ContactId id) const 
-{   return m_id2contact.find(id) != m_id2contact.end(); }
+{   return findSlotById(id) >= 0; }
 /** Does this snapshot contain a Contact object for the given surface pair
 (in either order)? **/
 bool hasContact(ContactSurfaceIndex surf1, ContactSurfaceIndex surf2) const
-{   if (surf1 > surf2) std::swap(surf1,surf2);
-    return m_surfPair2id.find(std::make_pair(surf1,surf2)) 
-        != m_surfPair2id.end(); }
+{   return findSlotBySurfacePair(surf1,surf2) >= 0; }
 
 /** Find out how many Contacts are in this snapshot. **/
 int getNumContacts() const {return m_contacts.size();}
@@ -325,41 +398,134 @@ to it; otherwise, return a reference to an empty contact handle (you can check
 with isEmpty()). **/
 const Contact& getContactById(ContactId id) const
 {   static Contact empty;
-    ContactMap::const_iterator p = m_id2contact.find(id);
-    return p==m_id2contact.end() ? empty : m_contacts[p->second]; }
+    const int slot = findSlotById(id);
+    return slot < 0 ? empty : m_contacts[slot]; }
 /** If this snapshot contains a contact for the given pair of contact surfaces
 (order doesn't matter), return its ContactId; otherwise, return an invalid 
 ContactId (you can check with isValid()). **/
 ContactId getContactIdForSurfacePair(ContactSurfaceIndex surf1,
                                      ContactSurfaceIndex surf2) const
-{   if (surf1 > surf2) std::swap(surf1,surf2);
-    SurfaceMap::const_iterator p = 
-        m_surfPair2id.find(std::make_pair(surf1,surf2));
-    return p==m_surfPair2id.end() ? ContactId() : p->second; }
+{   const int slot = findSlotBySurfacePair(surf1,surf2);
+    return slot < 0 ? ContactId() : m_contacts[slot].getContactId(); }
 
 //--------------------------------------------------------------------------
                                 private:
 
 // Remove a Contact occupying a particular slot in the Contact array. This
 // will result in another Contact object being moved to occupy the now-empty
-// slot to keep the array compact.
+// slot to keep the array compact. Only the affected table entries are
+// changed.
 void removeContact(int n) {
     assert(0 <= n && n < m_contacts.size());
-    if (n+1 == m_contacts.size()) {
-        m_contacts.pop_back(); // this was the last one
-        return;
+    const int last = m_contacts.size()-1;
+    eraseTableEntry(m_id2contact, true, findTableEntry(m_id2contact, true, n));
+    eraseTableEntry(m_surfPair2contact, false, 
+                    findTableEntry(m_surfPair2contact, false, n));
+    if (n != last) {
+        m_id2contact[findTableEntry(m_id2contact, true, last)] = n;
+        m_surfPair2contact[findTableEntry(m_surfPair2contact, false, last)] = n;
+        m_contacts[n] = m_contacts[last];   // shallow copy
+    }
+    m_contacts.pop_back();                  // destruct
+}
+
+// Hash functions; the table sizes are powers of two so we mix the bits
+// (Knuth's multiplicative hash) and mask off the high ones. The surface
+// pair is ordered (low,high) first so that either order finds it.
+static unsigned hashId(ContactId id) 
+{   return (unsigned)(int)id * 2654435761U; }
+static unsigned hashSurfacePair(ContactSurfaceIndex surf1,
+                                ContactSurfaceIndex surf2) 
+{   if (surf1 > surf2) std::swap(surf1,surf2);
+    return ((unsigned)(int)surf1 * 2654435761U) ^ (unsigned)(int)surf2 
+            * 40503U; }
+
+static bool samePair(const Contact& c, ContactSurfaceIndex surf1,
+                     ContactSurfaceIndex surf2) 
+{   return (c.getSurface1()==surf1 && c.getSurface2()==surf2)
+        || (c.getSurface1()==surf2 && c.getSurface2()==surf1); }
+
+// Return the Contact array slot for this id or surface pair, or -1 if
+// there isn't one. Probing stops at the first empty table entry.
+int findSlotById(ContactId id) const {
+    if (m_id2contact.empty()) return -1;
+    const unsigned mask = m_id2contact.size() - 1;
+    for (unsigned h = hashId(id) & mask; ; h = (h+1) & mask) {
+        const int slot = m_id2contact[h];
+        if (slot < 0 || m_contacts[slot].getContactId() == id)
+            return slot;
+    }
+}
+int findSlotBySurfacePair(ContactSurfaceIndex surf1,
+                          ContactSurfaceIndex surf2) const {
+    if (m_surfPair2contact.empty()) return -1;
+    const unsigned mask = m_surfPair2contact.size() - 1;
+    for (unsigned h = hashSurfacePair(surf1,surf2) & mask; ; 
+         h = (h+1) & mask) {
+        const int slot = m_surfPair2contact[h];
+        if (slot < 0 || samePair(m_contacts[slot],surf1,surf2))
+            return slot;
     }
-    // Move the last one to replace this one and update the map.
-    m_contacts[n] = m_contacts.back();  // shallow copy
-    m_contacts.pop_back();              // destruct
-    m_id2contact[m_contacts[n].getContactId()] = n;
 }
 
+// Return the table entry where the Contact in slot n would be hashed to in
+// the id table (byId) or the surface pair table.
+unsigned getHomeEntry(int n, bool byId, unsigned mask) const {
+    const Contact& c = m_contacts[n];
+    return (byId ? hashId(c.getContactId())
+                 : hashSurfacePair(c.getSurface1(),c.getSurface2())) & mask;
+}
+
+// Return the entry of the given table that refers to slot n, which must be
+// there.
+unsigned findTableEntry(const Array_<int>& table, bool byId, int n) const {
+    const unsigned mask = table.size() - 1;
+    unsigned h = getHomeEntry(n, byId, mask);
+    while (table[h] != n) h = (h+1) & mask;
+    return h;
+}
+
+// Empty entry h of the given table by backward shift deletion: later entries
+// in the same probe run are moved back into the gap whenever that is still
+// at or after their home entry, so no lookup will stop short at the gap.
+void eraseTableEntry(Array_<int>& table, bool byId, unsigned h) {
+    const unsigned mask = table.size() - 1;
+    for (unsigned next = (h+1) & mask; table[next] >= 0; 
+         next = (next+1) & mask) {
+        const unsigned home = getHomeEntry(table[next], byId, mask);
+        if (((next - home) & mask) >= ((next - h) & mask)) {
+            table[h] = table[next];
+            h = next;
+        }
+    }
+    table[h] = -1;
+}
+
+// Enter the Contact in slot n into both tables, which must have room.
+void insertInTables(int n) {
+    const Contact& c = m_contacts[n];
+    const unsigned mask = m_id2contact.size() - 1;
+    unsigned h = hashId(c.getContactId()) & mask;
+    while (m_id2contact[h] >= 0) h = (h+1) & mask;
+    m_id2contact[h] = n;
+    h = hashSurfacePair(c.getSurface1(),c.getSurface2()) & mask;
+    while (m_surfPair2contact[h] >= 0) h = (h+1) & mask;
+    m_surfPair2contact[h] = n;
+}
+
+// Size both tables to tableSize (a power of two) and refill them.
+void rebuildTables(int tableSize) {
+    int size = 16; while (size < tableSize) size *= 2;
+    m_id2contact.resize(size); m_id2contact.fill(-1);
+    m_surfPair2contact.resize(size); m_surfPair2contact.fill(-1);
+    for (int n=0; n < m_contacts.size(); ++n)
+        insertInTables(n);
+}
 
-Real                m_time;         // when this snapshot was taken
-Array_<Contact,int> m_contacts;     // all the contact pairs
-ContactMap          m_id2contact;   // the contact pairs by contactId
-SurfaceMap          m_surfPair2id;  // surfacepair -> contactId map
+Real                m_time;             // when this snapshot was taken
+Array_<Contact,int> m_contacts;         // all the contact pairs
+Array_<int>         m_id2contact;       // hash table: contactId -> slot
+Array_<int>         m_surfPair2contact; // hash table: surface pair -> slot
 };
 
 // for debugging
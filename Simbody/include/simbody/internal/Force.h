@@ -180,6 +180,7 @@ public:
     class Thermostat;
     class UniformGravity;
     class Gravity;
+    class NonbondedPairs;
     class Custom;
     
     class TwoPointLinearSpringImpl;
@@ -198,6 +199,7 @@ public:
     class ThermostatImpl;
     class UniformGravityImpl;
     class GravityImpl;
+    class NonbondedPairsImpl;
     class CustomImpl;
 
 protected:
@@ -40,6 +40,7 @@ Force class definition. **/
 #include "simbody/internal/Force_MobilityLinearDamper.h"
 #include "simbody/internal/Force_MobilityLinearSpring.h"
 #include "simbody/internal/Force_MobilityLinearStop.h"
+#include "simbody/internal/Force_NonbondedPairs.h"
 #include "simbody/internal/Force_Thermostat.h"
 
 #endif // SimTK_SIMBODY_FORCE_BUILTINS_H_
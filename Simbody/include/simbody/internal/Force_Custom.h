@@ -247,6 +247,16 @@ public:
     virtual bool dependsOnlyOnPositions() const {
         return false;
     }
+    /**
+     * Get whether calcForce() may be called from a worker thread at the same time as other force elements' calcForce()
+     * methods are executing on other threads.  This matters only if parallel force evaluation has been enabled with
+     * GeneralForceSubsystem::setUseParallelForceEvaluation().  To be thread safe, calcForce() must only add into the
+     * arrays it is given and must not modify any other shared data, including lazily-evaluated cache entries in the
+     * State.  The default implementation returns false, in which case this force is always evaluated serially.
+     */
+    virtual bool isThreadSafe() const {
+        return false;
+    }
     /** The following methods may optionally be overridden to do specialized 
     realization for a Force. **/
     //@{
@@ -0,0 +1,167 @@
+#ifndef SimTK_SIMBODY_FORCE_NONBONDED_PAIRS_H_
+#define SimTK_SIMBODY_FORCE_NONBONDED_PAIRS_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simbody/internal/Force.h"
+
+/** @file
+ * This contains the user-visible API ("handle" class) for the SimTK::Force
+ * subclass Force::NonbondedPairs and is logically part of Force.h. The file
+ * assumes that Force.h will have included all necessary declarations.
+ */
+
+namespace SimTK {
+
+/**
+ * This force element applies pairwise central forces among a set of stations
+ * fixed on bodies, such as atoms in a molecular model or grains in a
+ * coarse-grained granular model. Each pair of stations closer together than
+ * a cutoff distance interacts through a short-range repulsive/attractive
+ * term plus a Coulomb term; pairs farther apart than the cutoff don't
+ * interact at all.
+ *
+ * Each station has a charge q, a radius R, and a strength e. For a pair of
+ * stations i and j separated by distance r, the mixed parameters are
+ * d = Ri+Rj, e = sqrt(ei*ej), and qq = kc*qi*qj where kc is the Coulomb
+ * constant (see setCoulombConstant()). The short-range term is one of:
+ *  - LennardJones: E = 4 e [(d/r)^12 - (d/r)^6], so the potential minimum
+ *    is at r = 2^(1/6) d with well depth e.
+ *  - SoftSphere: E = e/2 (d-r)^2 for r < d and zero otherwise, so e is a
+ *    stiffness and the stations repel only when they overlap.
+ *
+ * The Coulomb term is E = qq/r. The Lennard-Jones and Coulomb energies of
+ * each pair are shifted by their value at the cutoff so that the potential
+ * energy is continuous there; the forces are not shifted. Two stations at
+ * exactly the same location have no defined force direction, so such a pair
+ * is treated as though it were beyond the cutoff.
+ *
+ * Pairs of stations on the same body never interact. You can also exclude
+ * all the pairs between two particular bodies (for example, bodies that are
+ * bonded together), and all the pairs among stations placed in the same
+ * clique.
+ *
+ * \par Neighbor list:
+ *
+ * Rather than looking at all N^2 pairs, this element keeps a Verlet neighbor
+ * list of the pairs that are within the cutoff plus a "skin" distance, built
+ * in O(N log N) time by sorting the stations into a grid of cells. The list is
+ * rebuilt only when some station has moved more than half the skin since the
+ * last build, since until then no pair that was left off the list can have
+ * come within the cutoff. A larger skin means fewer rebuilds but more pairs
+ * to check on each evaluation. With a zero skin the list is rebuilt
+ * whenever the positions change.
+ *
+ * The list is kept in an auto-update discrete state variable, so during a
+ * simulation it is carried from step to step along with the State and is
+ * only replaced when a step that needed a rebuild is accepted.
+ */
+class SimTK_SIMBODY_EXPORT Force::NonbondedPairs : public Force {
+public:
+    /// These are the available short-range potentials.
+    enum Potential {
+        LennardJones    = 0,
+        SoftSphere      = 1
+    };
+
+    /// Create a pairwise force element with no stations yet.
+    ///
+    /// @param[in,out]      forces
+    ///     The subsystem to which this force should be added.
+    /// @param[in]          cutoff
+    ///     Pairs of stations farther apart than this don't interact; must be
+    ///     positive.
+    /// @param[in]          skin
+    ///     The extra distance beyond the cutoff used when building the
+    ///     neighbor list; must be nonnegative.
+    /// @param[in]          potential
+    ///     Which short-range potential to use.
+    NonbondedPairs(GeneralForceSubsystem& forces, Real cutoff, Real skin = 0,
+                   Potential potential = LennardJones);
+
+    /// Default constructor creates an empty handle.
+    NonbondedPairs() {}
+
+    /// Add a station to this force element, and return its index. This is a
+    /// Topology-stage change.
+    ///
+    /// @param[in]          body
+    ///     The body to which the station is fixed.
+    /// @param[in]          station
+    ///     The station location, given in the body frame.
+    /// @param[in]          charge
+    ///     The charge q used in the Coulomb term.
+    /// @param[in]          radius
+    ///     The radius R used in the short-range term; must be nonnegative.
+    /// @param[in]          strength
+    ///     The well depth (LennardJones) or stiffness (SoftSphere) used in the
+    ///     short-range term; must be nonnegative.
+    /// @param[in]          clique
+    ///     Stations with the same nonnegative clique number don't interact;
+    ///     the default -1 means this station isn't in any clique.
+    int addStation(const MobilizedBody& body, const Vec3& station,
+                   Real charge, Real radius, Real strength, int clique = -1);
+
+    /// Don't let any station on \a body1 interact with any station on
+    /// \a body2. This is a Topology-stage change.
+    NonbondedPairs& excludeBodyPair(const MobilizedBody& body1,
+                                    const MobilizedBody& body2);
+
+    /// Set the Coulomb constant kc that multiplies the product of two
+    /// charges; it must be expressed in units compatible with the charges,
+    /// lengths, and energies being used. The default is 1. This is a
+    /// Topology-stage change.
+    NonbondedPairs& setCoulombConstant(Real coulombConstant);
+
+    /// Get the number of stations that have been added.
+    int getNumStations() const;
+    /// Get the cutoff distance set on construction.
+    Real getCutoff() const;
+    /// Get the neighbor list skin distance set on construction.
+    Real getSkin() const;
+    /// Get the short-range potential set on construction.
+    Potential getPotential() const;
+    /// Get the Coulomb constant kc.
+    Real getCoulombConstant() const;
+
+    /// Get the number of station pairs in the neighbor list that is in
+    /// use for this State; that includes pairs within the skin distance that
+    /// aren't currently interacting. This requires Stage::Position.
+    int getNumNeighborPairs(const State& state) const;
+
+    /// Get the number of times the neighbor list in use for this State has
+    /// been built since the State was created, counting the build in the
+    /// current step if there was one. This requires Stage::Position.
+    int getNumNeighborListBuilds(const State& state) const;
+
+    /** @cond **/ // Don't show this in Doxygen.
+    SimTK_INSERT_DERIVED_HANDLE_DECLARATIONS
+       (NonbondedPairs, NonbondedPairsImpl, Force);
+    /** @endcond **/
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_FORCE_NONBONDED_PAIRS_H_
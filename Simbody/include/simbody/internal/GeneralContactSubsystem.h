@@ -26,6 +26,7 @@
 
 #include "SimTKmath.h"
 #include "simbody/internal/common.h"
+#include "simbody/internal/ContactTrackerSubsystem.h"
 
 namespace SimTK {
 
@@ -122,6 +123,16 @@ public:
      * may still invoke it to calculate forces based on contacts.
      */
     const Array_<Contact>& getContacts(const State& state, ContactSetIndex set) const;
+    /**
+     * Choose the broad phase algorithm used to find the bodies in each contact set whose
+     * bounding volumes overlap; see ContactTrackerSubsystem::BroadPhaseMethod.  The default
+     * is SweepAndPrune.  This is a Topology-stage change.
+     */
+    void setBroadPhaseMethod(ContactTrackerSubsystem::BroadPhaseMethod method);
+    /**
+     * Get the broad phase algorithm in use.
+     */
+    ContactTrackerSubsystem::BroadPhaseMethod getBroadPhaseMethod() const;
     SimTK_PIMPL_DOWNCAST(GeneralContactSubsystem, Subsystem);
 private:
     class GeneralContactSubsystemImpl& updImpl();
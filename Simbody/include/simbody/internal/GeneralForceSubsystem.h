@@ -86,6 +86,32 @@ public:
     void setForceIsDisabled
        (State& state, ForceIndex index, bool shouldBeDisabled) const;
 
+    /** Request that the force elements' calcForce() methods be evaluated 
+    concurrently on a pool of threads during Dynamics stage realization. The 
+    enabled force elements that report themselves thread safe are divided 
+    into one contiguous block per thread. Each block accumulates into its own
+    private force arrays, and those are then added into the system's force 
+    arrays in block order, so the results do not depend on thread timing and
+    are repeatable for a given number of threads. They may differ in the last
+    bits from a serial evaluation since the additions are done in a different
+    order. Force elements that aren't known to be thread safe, including any
+    Force::Custom whose Implementation doesn't override isThreadSafe(), are 
+    evaluated serially on the calling thread.
+
+    Parallel force evaluation is off by default. This is a setting rather 
+    than part of the topology, so changing it does not invalidate any State.
+    @param      useParallel
+        Set true to enable parallel force evaluation, false to go back to 
+        serial.
+    @param      numThreads
+        The number of threads in the pool; ignored if \a useParallel is 
+        false. The default is the number of processors on this machine. **/
+    void setUseParallelForceEvaluation
+       (bool useParallel, int numThreads = ParallelExecutor::getNumProcessors());
+    /** Return whether parallel force evaluation is currently enabled.
+    @see setUseParallelForceEvaluation() **/
+    bool getUseParallelForceEvaluation() const;
+
     /** Every Subsystem is owned by a System; a GeneralForceSubsystem expects
     to be owned by a MultibodySystem. This method returns a const reference
     to the containing MultibodySystem and will throw an exception if there is
@@ -39,6 +39,7 @@ namespace SimTK {
 class MobilizedBody;
 class MultibodySystem;
 class Constraint;
+class BranchInducedSparseMatrix;
 
 /** This subsystem contains the bodies ("matter") in the multibody system,
 the mobilizers (joints) that define the generalized coordinates used to 
@@ -203,6 +204,39 @@ void setShowDefaultGeometry(bool show);
 geometry that can be used to visualize this multibody system. **/
 bool getShowDefaultGeometry() const;
 
+/** Request that the base-to-tip and tip-to-base sweeps that realize the
+position, velocity, and dynamics kinematics and the articulated body inertias 
+be split across a pool of threads. All the mobilized bodies at the same 
+level of the tree (that is, at the same distance from Ground) are independent
+of one another and are processed concurrently; levels are still processed one
+after another. Only levels with at least getParallelTreeSweepThreshold() 
+bodies are split; narrower levels are processed serially since the per-body
+work is too small to be worth waking up the threads. Results are bitwise 
+identical to those of a serial sweep regardless of the number of threads.
+
+Parallel sweeps are off by default. This is a setting rather than part of the 
+topology, so changing it does not invalidate any State. If you turn this on,
+any MobilizedBody::Custom or MobilizedBody::FunctionBased mobilizers in the
+system must be safe to evaluate concurrently from different threads.
+
+@param      useParallel
+    Set true to enable parallel tree sweeps, false to go back to serial.
+@param      numThreads
+    The number of threads in the pool; ignored if \a useParallel is false. 
+    The default is the number of processors on this machine. **/
+void setUseParallelTreeSweeps
+   (bool useParallel, int numThreads = ParallelExecutor::getNumProcessors());
+/** Return whether parallel tree sweeps are currently enabled.
+@see setUseParallelTreeSweeps() **/
+bool getUseParallelTreeSweeps() const;
+/** Set the minimum number of mobilized bodies a tree level must have before 
+it is split across threads when parallel tree sweeps are enabled. The default
+is 32; the value must be at least 1. @see setUseParallelTreeSweeps() **/
+void setParallelTreeSweepThreshold(int minBodiesPerLevel);
+/** Return the current parallel tree sweep threshold.
+@see setParallelTreeSweepThreshold() **/
+int getParallelTreeSweepThreshold() const;
+
 /** The number of bodies includes all mobilized bodies \e including Ground,
 which is the 0th mobilized body. (Note: if special particle handling were
 implmemented, the count here would \e not include particles.) Bodies and their
@@ -1318,6 +1352,27 @@ void multiplyByMInv(const State& state,
     const Vector&               v,
     Vector&                     MinvV) const;
 
+/** Multiple right hand side version of multiplyByM(). Each column of \a A is
+treated as an acceleration-like vector a and the corresponding column of the
+result is M*a; \a A must have one row per mobility. This gives the same 
+answers as calling multiplyByM() once per column but is considerably faster 
+for more than a few columns, because several columns are carried through each
+tree sweep together so that the per-body data is fetched only once for all of
+them. \a MA will be resized if necessary.
+@par Required stage
+  \c Stage::Position **/
+void multiplyByM(const State& state, const Matrix& A, Matrix& MA) const;
+
+/** Multiple right hand side version of multiplyByMInv(). Each column of \a F
+is treated as a force-like vector f and the corresponding column of the 
+result is M^-1*f; \a F must have one row per mobility. As for the matrix
+version of multiplyByM(), this is faster than calling multiplyByMInv() once 
+per column because each articulated body sweep processes several columns. 
+\a MInvF will be resized if necessary.
+@par Required stage
+  \c Stage::Position **/
+void multiplyByMInv(const State& state, const Matrix& F, Matrix& MInvF) const;
+
 /** This operator explicitly calculates the n X n mass matrix M. Note that this
 is inherently an O(n^2) operation since the mass matrix has n^2 elements 
 (although only n(n+1)/2 are unique due to symmetry). <em>DO NOT USE THIS CALL 
@@ -1344,6 +1399,26 @@ with the calcM() method.
 @see multiplyByMInv(), calcM() **/
 void calcMInv(const State&, Matrix& MInv) const;
 
+/** This operator calculates the n X n mass matrix M explicitly but in sparse
+form, storing only the entries that can be nonzero for a tree-structured
+system. Entry M(i,j) can be nonzero only if the mobilities i and j belong to
+the same mobilized body or one belongs to an ancestor of the other's body, so
+a system of n mobilities on a tree of depth d has at most about n*d unique
+nonzero entries rather than n(n+1)/2. This is formed directly from the 
+composite body inertias in O(n*d) time, which for most systems is much less
+than the O(n^2) cost of calcM().
+
+The mobilities are the rows of \a M, in the usual order. The result can be
+factored in place without fill-in using BranchInducedSparseMatrix::factorLTL()
+and then solved in O(n*d) time per right hand side; this is an alternative 
+to multiplyByMInv() when many solves with the same M are needed and the tree 
+is shallow. Prescribed mobilities are not treated specially; this is the 
+whole mass matrix as calcM() would return it.
+@par Required stage
+  \c Stage::Position
+@see calcM(), multiplyByMInv() **/
+void calcSparseM(const State&, BranchInducedSparseMatrix& M) const;
+
 /** This operator calculates in O(m*n) time the m X m "projected inverse mass 
 matrix" or "constraint compliance matrix" W=G*M^-1*~G, where G (mXn) is the 
 acceleration-level constraint Jacobian mapped to generalized coordinates,
@@ -1439,6 +1514,23 @@ void solveForConstraintImpulses(const State&     state,
                                 const Vector&    deltaV,
                                 Vector&          impulse) const;
 
+/** (Advanced) Return the number of times Simbody needed the factored projected
+inverse mass matrix W=G*M^-1*~G (for forward dynamics with constraints, or
+for solveForConstraintImpulses()) and found an up-to-date factorization 
+already in the State cache. The factorization remains valid until the State's
+positions change, or its velocities too if any of the constraints in use are
+nonholonomic or acceleration-only.
+@see getNumProjectedMInvFactorizationMisses() **/
+int getNumProjectedMInvFactorizationHits() const;
+/** (Advanced) Return the number of times Simbody had to form and factor the
+projected inverse mass matrix W=G*M^-1*~G because there was no up-to-date
+factorization in the State cache. 
+@see getNumProjectedMInvFactorizationHits() **/
+int getNumProjectedMInvFactorizationMisses() const;
+/** (Advanced) Zero the projected inverse mass matrix factorization hit and
+miss counters. **/
+void resetProjectedMInvFactorizationCounters();
+
 
 /** Returns Gulike = G*ulike, the product of the mXn acceleration 
 constraint Jacobian G and a "u-like" (mobility space) vector of length n. 
@@ -1598,6 +1690,20 @@ time, and finally return the generalized force-like result f = ~J*F0 + f0.
 void multiplyByGTranspose(const State&  state,
                           const Vector& lambda,
                           Vector&       f) const;
+
+/** Multiple right hand side version of multiplyByGTranspose(). Each column
+of \a Lambda is a multiplier-like vector of length m and the corresponding 
+column of \a F is ~G*lambda. Each Constraint's force generating information
+and each body's kinematic data is used for several columns at a time, which
+makes this much faster than repeated calls to the single-column method.
+\a F will be resized to n X k if necessary, where k is the number of columns
+in \a Lambda.
+@par Required stage
+  \c Stage::Velocity (or Position if only position constraints are present)
+@see multiplyByGTranspose(), calcGTranspose() **/
+void multiplyByGTranspose(const State&  state,
+                          const Matrix& Lambda,
+                          Matrix&       F) const;
     
 /** This O(nm) operator explicitly calculates the n X m transpose of the 
 acceleration-level constraint Jacobian G = [P;V;A] which appears in the system 
@@ -1953,6 +2059,42 @@ void calcAccelerationIgnoringConstraints
     Vector&                     udot,    
     Vector_<SpatialVec>&        A_GB) const;
 
+/** Calculate the partial derivatives of the generalized accelerations
+produced by calcAccelerationIgnoringConstraints() with respect to the 
+generalized coordinates q and generalized speeds u, with the applied forces
+held fixed. That is, with udot(q,u) the solution of
+<pre>
+            M(q) udot + f_inertial(q,u) = f_applied
+</pre>
+this returns the nu X nq matrix dUDot_dQ = d udot/dq and the nu X nu matrix
+dUDot_dU = d udot/du. These are the dynamics-dependent blocks of the state
+Jacobian needed for implicit integration, linearization, and optimal control.
+If your applied forces depend on q or u, add M^-1 df_applied/dq and 
+M^-1 df_applied/du, which you can get with the multiple right hand side form
+of multiplyByMInv(). Constraints are ignored; prescribed accelerations are 
+treated as constants so the rows corresponding to prescribed mobilities are
+returned zero.
+
+Each column of the derivative of the inverse dynamics residual is obtained
+from an O(n) recursion that differentiates the tree inverse dynamics passes,
+followed by a single multiple right hand side M^-1 solve, for O(n^2) time
+overall. Only the matter subsystem is involved; no other subsystem is
+realized again. The one term mobilizers don't provide analytically, the
+change in HDot_FM with the mobilizer's own q's, is obtained by central
+differences for mobilizers whose H_FM is not constant (a Universal joint,
+say) using a copy of \p state. These are done for all mobilizers at once, so
+there are at most a few such realizations of the tree kinematics regardless
+of the size of the system.
+
+@par Required stage
+  \c Stage::Dynamics **/
+void calcAccelerationDerivativesIgnoringConstraints
+   (const State&                state,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    Matrix&                     dUDot_dQ,
+    Matrix&                     dUDot_dU) const;
+
 
 
 /** This is the inverse dynamics operator for the tree system; if there are
@@ -2460,6 +2602,31 @@ stage.
   \c Stage::Position **/
 void realizeArticulatedBodyInertias(const State&) const;
 
+    // BATCH realization //
+
+/** Realize a batch of States through the given \a stage. The States must all
+have been created by the System that contains this matter subsystem; this is
+intended for ensembles such as Monte Carlo variants that share one topology 
+and differ only in their state variable values. The batch is advanced one 
+stage at a time across all its States, each State being realized by 
+getSystem().realize(). The exception is the articulated body inertias, which
+are the most expensive part of Dynamics stage: just before that stage they are
+computed for the whole batch in a single tip-to-base sweep that applies each
+level's node computations to every State before moving on to the next level.
+The results are bitwise identical to realizing each State on its own.
+
+If parallel tree sweeps are enabled (see setUseParallelTreeSweeps()), the 
+batch is instead divided into contiguous chunks of States, one per thread of 
+the same thread pool, and each chunk is realized as above with its tree sweeps
+done serially. In that
+case everything invoked during realization must be safe to call concurrently 
+for different States; see EnsembleTimeStepper for which System elements are.
+
+If some States fail to realize, the rest of the batch is still processed and
+then an exception is thrown reporting the failure of the first such State in
+the batch. Null pointers are not allowed in the batch. **/
+void realizeBatch(const Array_<State*>& states, Stage stage) const;
+
 
     // INSTANCE STAGE responses //
 
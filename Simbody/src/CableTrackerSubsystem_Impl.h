@@ -102,6 +102,19 @@ void handleEventsImpl
     }
 }
 
+// A path that wraps over a surface obstacle has its geodesics computed by the
+// obstacle's ContactGeometry, which keeps the ones it shot most recently, so
+// such paths can't be realized for several States at once.
+bool isThreadSafeImpl() const OVERRIDE_11 {
+    for (CablePathIndex ix(0); ix < cablePaths.size(); ++ix) {
+        const CablePath::Impl& path = getCablePath(ix).getImpl();
+        for (CableObstacleIndex ox(0); ox < path.getNumObstacles(); ++ox)
+            if (path.getObstacle(ox).getImpl().getNumCoordsPerContactPoint())
+                return false;
+    }
+    return true;
+}
+
 // Allocate state variables.
 int realizeSubsystemTopologyImpl(State& state) const OVERRIDE_11 {
     // Briefly allow writing into the Topology cache; after this the
@@ -2468,7 +2468,7 @@ Constraint::CoordinateCouplerImpl::CoordinateCouplerImpl
     const Array_<MobilizerQIndex>&      coordQIndex)
 :   Implementation(matter, 1, 0, 0), function(function), 
     coordBodies(coordMobod.size()), coordIndices(coordQIndex),
-    temp(coordBodies.size()), referenceCount(new int[1]) 
+    referenceCount(new int[1]) 
 {
     assert(coordBodies.size() == coordIndices.size());
     assert(coordIndices.size() == function->getArgumentSize());
@@ -2480,6 +2480,19 @@ Constraint::CoordinateCouplerImpl::CoordinateCouplerImpl
     }
 }
 
+// Allocate the per-State scratch vector that holds the Function arguments.
+void Constraint::CoordinateCouplerImpl::
+realizeTopology(State& state) const {
+    argumentsIx = getMatterSubsystem().allocateLazyCacheEntry
+       (state, Stage::Topology, new Value<Vector>(Vector(coordBodies.size())));
+}
+
+Vector& Constraint::CoordinateCouplerImpl::
+updArguments(const State& state) const {
+    return Value<Vector>::updDowncast
+       (getMatterSubsystem().updCacheEntry(state, argumentsIx));
+}
+
 void Constraint::CoordinateCouplerImpl::
 calcPositionErrors     
    (const State&                                    s,
@@ -2487,6 +2500,7 @@ calcPositionErrors
     const Array_<Real,     ConstrainedQIndex>&      constrainedQ,
     Array_<Real>&                                   perr) const
 {
+    Vector& temp = updArguments(s);
     for (int i = 0; i < temp.size(); ++i)
         temp[i] = getOneQ(s, constrainedQ, coordBodies[i], coordIndices[i]);
     perr[0] = function->calcValue(temp);
@@ -2500,6 +2514,7 @@ calcPositionDotErrors
     Array_<Real>&                                   pverr) const
 {
     pverr[0] = 0;
+    Vector& temp = updArguments(s);
     for (int i = 0; i < temp.size(); ++i)
         temp[i] = getOneQFromState(s, coordBodies[i], coordIndices[i]);
     Array_<int> components(1);
@@ -2519,6 +2534,7 @@ calcPositionDotDotErrors
     Array_<Real>&                                   paerr) const
 {
     paerr[0] = 0.0;
+    Vector& temp = updArguments(s);
     for (int i = 0; i < temp.size(); ++i)
         temp[i] = getOneQFromState(s, coordBodies[i], coordIndices[i]);
 
@@ -2556,6 +2572,7 @@ addInPositionConstraintForces
 
     const Real lambda = multipliers[0];
 
+    Vector& temp = updArguments(s);
     for (int i = 0; i < temp.size(); ++i)
         temp[i] = getOneQFromState(s, coordBodies[i], coordIndices[i]);
 
@@ -2601,11 +2618,12 @@ Constraint::SpeedCouplerImpl::SpeedCouplerImpl
 :   Implementation(matter, 0, 1, 0), function(function), 
     speedBodies(speedBody.size()), speedIndices(speedIndex), 
     coordBodies(coordBody), coordIndices(coordIndex),
-    temp(speedBody.size()+coordBody.size()), referenceCount(new int[1]) 
+    referenceCount(new int[1]) 
 {
     assert(speedBodies.size() == speedIndices.size());
     assert(coordBodies.size() == coordIndices.size());
-    assert(temp.size() == function->getArgumentSize());
+    assert((int)(speedBodies.size()+coordBodies.size())
+           == function->getArgumentSize());
     assert(function->getMaxDerivativeOrder() >= 2);
 
     referenceCount[0] = 1;
@@ -2615,6 +2633,20 @@ Constraint::SpeedCouplerImpl::SpeedCouplerImpl
     }
 }
 
+// Allocate the per-State scratch vector that holds the Function arguments.
+void Constraint::SpeedCouplerImpl::
+realizeTopology(State& state) const {
+    argumentsIx = getMatterSubsystem().allocateLazyCacheEntry
+       (state, Stage::Topology, 
+        new Value<Vector>(Vector(speedBodies.size()+coordBodies.size())));
+}
+
+Vector& Constraint::SpeedCouplerImpl::
+updArguments(const State& state) const {
+    return Value<Vector>::updDowncast
+       (getMatterSubsystem().updCacheEntry(state, argumentsIx));
+}
+
 // Constraint is f(q,u)=0, i.e. verr=f(q,u).
 void Constraint::SpeedCouplerImpl::
 calcVelocityErrors     
@@ -2623,6 +2655,7 @@ calcVelocityErrors
     const Array_<Real,      ConstrainedUIndex>&     constrainedU,
     Array_<Real>&                                   verr) const
 {
+    Vector& temp = updArguments(s);
     for (int i = 0; i < (int) speedBodies.size(); ++i)
         temp[i] = getOneU(s, constrainedU, speedBodies[i], speedIndices[i]);
     for (int i = 0; i < (int) coordBodies.size(); ++i)
@@ -2640,6 +2673,7 @@ calcVelocityDotErrors
     const Array_<Real,      ConstrainedUIndex>&     constrainedUDot,
     Array_<Real>&                                   vaerr) const 
 {
+    Vector& temp = updArguments(s);
     for (int i = 0; i < (int)speedBodies.size(); ++i)
         temp[i] = getOneUFromState(s, speedBodies[i], speedIndices[i]);
     for (int i = 0; i < (int)coordBodies.size(); ++i) {
@@ -2677,6 +2711,7 @@ addInVelocityConstraintForces
     assert(multipliers.size() == 1);
     const Real lambda = multipliers[0];
 
+    Vector& temp = updArguments(s);
     for (int i = 0; i < (int) speedBodies.size(); ++i)
         temp[i] = getOneUFromState(s, speedBodies[i], speedIndices[i]);
     for (int i = 0; i < (int) coordBodies.size(); ++i)
@@ -2713,7 +2748,7 @@ Constraint::PrescribedMotionImpl::PrescribedMotionImpl
     MobilizedBodyIndex coordBody, 
     MobilizerQIndex coordIndex)
 :   Implementation(matter, 1, 0, 0), function(function), 
-    coordIndex(coordIndex), temp(1), referenceCount(new int[1]) 
+    coordIndex(coordIndex), referenceCount(new int[1]) 
 {
     assert(function->getArgumentSize() == 1);
     assert(function->getMaxDerivativeOrder() >= 2);
@@ -2723,6 +2758,19 @@ Constraint::PrescribedMotionImpl::PrescribedMotionImpl
     this->coordBody = addConstrainedMobilizer(mobod);
 }
 
+// Allocate the per-State scratch vector that holds the Function argument.
+void Constraint::PrescribedMotionImpl::
+realizeTopology(State& state) const {
+    argumentsIx = getMatterSubsystem().allocateLazyCacheEntry
+       (state, Stage::Topology, new Value<Vector>(Vector(1)));
+}
+
+Vector& Constraint::PrescribedMotionImpl::
+updArguments(const State& state) const {
+    return Value<Vector>::updDowncast
+       (getMatterSubsystem().updCacheEntry(state, argumentsIx));
+}
+
 void Constraint::PrescribedMotionImpl::
 calcPositionErrors     
    (const State&                                    s,
@@ -2730,6 +2778,7 @@ calcPositionErrors
     const Array_<Real,     ConstrainedQIndex>&      constrainedQ,
     Array_<Real>&                                   perr) const
 {
+    Vector& temp = updArguments(s);
     temp[0] = s.getTime();
     perr[0] = getOneQ(s, constrainedQ, coordBody, coordIndex) 
               - function->calcValue(temp);
@@ -2742,6 +2791,7 @@ calcPositionDotErrors
     const Array_<Real,      ConstrainedQIndex>&     constrainedQDot,
     Array_<Real>&                                   pverr) const
 {
+    Vector& temp = updArguments(s);
     temp[0] = s.getTime();
     Array_<int> components(1, 0); // i.e., components={0}
     pverr[0] = getOneQDot(s, constrainedQDot, coordBody, coordIndex) 
@@ -2755,6 +2805,7 @@ calcPositionDotDotErrors
     const Array_<Real,      ConstrainedQIndex>&     constrainedQDotDot,
     Array_<Real>&                                   paerr) const
 {
+    Vector& temp = updArguments(s);
     temp[0] = s.getTime();
     Array_<int> components(2, 0); // i.e., components={0,0}
     paerr[0] = getOneQDotDot(s, constrainedQDotDot, coordBody, coordIndex)  
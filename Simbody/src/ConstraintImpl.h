@@ -3074,6 +3074,8 @@ Implementation* clone() const {
     return newCoupler;
 }
 
+void realizeTopology(State&) const;
+
 void calcPositionErrors     
    (const State&                                    state,
     const Array_<Transform,ConstrainedBodyIndex>&   X_AB, 
@@ -3108,11 +3110,11 @@ Array_<ConstrainedMobilizerIndex>   coordBodies;
 Array_<MobilizerQIndex>             coordIndices;
 
 //  TOPOLOGY CACHE
-//  None.
-
-//  A reusable temporary variable allocated to the correct size
-//  to hold all the Function arguments.
-mutable Vector                      temp;
+//  A per-State scratch vector sized to hold all the Function arguments, so
+//  evaluating the Function doesn't allocate and States being realized on
+//  different threads don't share it.
+mutable CacheEntryIndex             argumentsIx;
+Vector& updArguments(const State&) const;
 
 // This allows copies to be made of this constraint which share
 // the function object.
@@ -3147,6 +3149,8 @@ Implementation* clone() const {
     return new SpeedCouplerImpl(*this);
 }
 
+void realizeTopology(State&) const;
+
 void calcVelocityErrors     
    (const State&                                    state,
     const Array_<SpatialVec,ConstrainedBodyIndex>&  V_AB, 
@@ -3174,7 +3178,9 @@ Array_<ConstrainedMobilizerIndex>   speedBodies;
 Array_<MobilizedBodyIndex>          coordBodies;
 Array_<MobilizerUIndex>             speedIndices;
 Array_<MobilizerQIndex>             coordIndices;
-mutable Vector                      temp;
+// Per-State scratch vector for the Function arguments; see CoordinateCoupler.
+mutable CacheEntryIndex             argumentsIx;
+Vector& updArguments(const State&) const;
 };
 
 
@@ -3202,6 +3208,8 @@ Implementation* clone() const {
     return new PrescribedMotionImpl(*this);
 }
 
+void realizeTopology(State&) const;
+
 void calcPositionErrors     
    (const State&                                    state,
     const Array_<Transform,ConstrainedBodyIndex>&   X_AB, 
@@ -3232,7 +3240,9 @@ const Function*             function;
 int*                        referenceCount;
 ConstrainedMobilizerIndex   coordBody;
 MobilizerQIndex             coordIndex;
-mutable Vector              temp;
+// Per-State scratch vector for the Function argument; see CoordinateCoupler.
+mutable CacheEntryIndex     argumentsIx;
+Vector& updArguments(const State&) const;
 };
 
 
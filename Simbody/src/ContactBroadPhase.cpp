@@ -0,0 +1,484 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ContactBroadPhase.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+using std::make_pair;
+
+namespace SimTK {
+
+std::ostream& operator<<(std::ostream& o, const ContactBroadPhase& bp) {
+    return o << "ContactBroadPhase(" << bp.getNumObjects() << " objects, "
+             << bp.getOverlaps().size() << " overlaps)";
+}
+
+void ContactBroadPhase::update() {
+    if (m_method == ContactTrackerSubsystem::DynamicAABBTree) updateTree();
+    else if (m_mustBuild) buildSweep();
+    else updateSweep();
+    m_mustBuild = false;
+}
+
+
+
+//==============================================================================
+//                              SWEEP AND PRUNE
+//==============================================================================
+
+// Note that the endpoints of objects i and j passed each other, so the pair
+// may have started or stopped overlapping.
+void ContactBroadPhase::touchPair(int i, int j) {
+    if (i == j) return;
+    m_touched.push_back(i < j ? make_pair(i,j) : make_pair(j,i));
+}
+
+// A pair whose endpoints never passed each other along any axis overlaps
+// now if and only if it did before, so only the touched pairs need to be
+// checked. Merge them into the previous overlaps, both sorted.
+void ContactBroadPhase::mergeTouchedPairs() {
+    std::sort(m_touched.begin(), m_touched.end());
+    m_touched.resize(std::unique(m_touched.begin(), m_touched.end())
+                     - m_touched.begin());
+    m_previous.swap(m_overlaps);
+    m_overlaps.clear(); m_added.clear(); m_removed.clear();
+    const int np = (int)m_previous.size(), nt = (int)m_touched.size();
+    int p = 0, t = 0;
+    while (p < np || t < nt) {
+        if (t == nt || (p < np && m_previous[p] < m_touched[t])) {
+            m_overlaps.push_back(m_previous[p++]); // untouched
+            continue;
+        }
+        const Pair& pair = m_touched[t++];
+        const bool was = p < np && m_previous[p] == pair;
+        if (was) ++p;
+        if (boxesOverlap(pair.first, pair.second)) {
+            m_overlaps.push_back(pair);
+            if (!was) m_added.push_back(pair);
+        } else if (was)
+            m_removed.push_back(pair);
+    }
+}
+
+// Sort the endpoints from scratch and sweep along the x axis to find all
+// the overlapping pairs.
+void ContactBroadPhase::buildSweep() {
+    const int n = getNumObjects();
+    clearOverlaps();
+    for (int axis=0; axis < 3; ++axis) {
+        Array_<SweepEndpoint>& ends = m_endpoints[axis];
+        ends.clear();
+        for (int i=0; i < n; ++i) {
+            ends.push_back(SweepEndpoint(m_lower[i][axis], i, false));
+            ends.push_back(SweepEndpoint(m_upper[i][axis], i, true));
+        }
+        std::sort(ends.begin(), ends.end());
+    }
+    Array_<int> open;
+    const Array_<SweepEndpoint>& ends = m_endpoints[0];
+    for (int e=0; e < (int)ends.size(); ++e) {
+        const int i = ends[e].object;
+        if (ends[e].isMax) {
+            open.erase(std::find(open.begin(), open.end(), i));
+            continue;
+        }
+        for (int k=0; k < (int)open.size(); ++k)
+            if (boxesOverlap(i, open[k]))
+                m_overlaps.push_back(i < open[k] ? make_pair(i, open[k])
+                                                 : make_pair(open[k], i));
+        open.push_back(i);
+    }
+    std::sort(m_overlaps.begin(), m_overlaps.end());
+    m_added = m_overlaps; // everything is new
+}
+
+// The boxes have moved; refresh the endpoint values then restore the sorted
+// order by insertion sort, noting the pair whenever a min passes a max or
+// vice versa. Then those are the only pairs that need checking.
+void ContactBroadPhase::updateSweep() {
+    m_touched.clear();
+    for (int axis=0; axis < 3; ++axis) {
+        Array_<SweepEndpoint>& ends = m_endpoints[axis];
+        for (int i=0; i < (int)ends.size(); ++i) {
+            SweepEndpoint& e = ends[i];
+            e.value = e.isMax ? m_upper[e.object][axis]
+                              : m_lower[e.object][axis];
+        }
+        for (int i=1; i < (int)ends.size(); ++i) {
+            const SweepEndpoint e = ends[i];
+            int j = i;
+            for (; j > 0 && e < ends[j-1]; --j) {
+                const SweepEndpoint& passed = ends[j-1];
+                if (e.isMax != passed.isMax)
+                    touchPair(e.object, passed.object);
+                ends[j] = passed;
+            }
+            ends[j] = e;
+        }
+    }
+    mergeTouchedPairs();
+}
+
+
+
+//==============================================================================
+//                             DYNAMIC AABB TREE
+//==============================================================================
+// This follows the incremental tree used in many game physics engines:
+// leaves are inserted next to the sibling that minimizes the increase in
+// surface area, and AVL-style rotations on the way back up keep the tree
+// balanced.
+
+namespace {
+
+// The fat box margin as a fraction of the box's largest side.
+const Real FatMargin = Real(0.1);
+
+Real surfaceArea(const Vec3& lower, const Vec3& upper) {
+    const Vec3 d = upper - lower;
+    return 2*(d[0]*d[1] + d[1]*d[2] + d[2]*d[0]);
+}
+
+Real unionArea(const Vec3& lower1, const Vec3& upper1,
+               const Vec3& lower2, const Vec3& upper2) {
+    Vec3 lower, upper;
+    for (int k=0; k < 3; ++k) {
+        lower[k] = std::min(lower1[k], lower2[k]);
+        upper[k] = std::max(upper1[k], upper2[k]);
+    }
+    return surfaceArea(lower, upper);
+}
+
+bool contains(const Vec3& outerLower, const Vec3& outerUpper,
+              const Vec3& lower, const Vec3& upper) {
+    for (int k=0; k < 3; ++k)
+        if (lower[k] < outerLower[k] || upper[k] > outerUpper[k])
+            return false;
+    return true;
+}
+
+bool touches(const Vec3& lower1, const Vec3& upper1,
+             const Vec3& lower2, const Vec3& upper2) {
+    for (int k=0; k < 3; ++k)
+        if (lower1[k] > upper2[k] || lower2[k] > upper1[k])
+            return false;
+    return true;
+}
+
+}
+
+int ContactBroadPhase::allocateNode() {
+    int node;
+    if (m_freeList >= 0) {
+        node = m_freeList;
+        m_freeList = m_nodes[node].parent;
+    } else {
+        node = (int)m_nodes.size();
+        m_nodes.push_back(TreeNode());
+    }
+    TreeNode& t = m_nodes[node];
+    t.parent = t.child1 = t.child2 = t.object = -1;
+    t.height = 0;
+    return node;
+}
+
+void ContactBroadPhase::freeNode(int node) {
+    m_nodes[node].parent = m_freeList;
+    m_nodes[node].height = -1;
+    m_freeList = node;
+}
+
+void ContactBroadPhase::insertLeaf(int leaf) {
+    if (m_root < 0) {
+        m_root = leaf;
+        m_nodes[leaf].parent = -1;
+        return;
+    }
+
+    // Walk down to the best sibling for the new leaf, choosing at each level
+    // the cheapest of pairing with this node or descending into a child.
+    const Vec3 leafLower = m_nodes[leaf].lower, leafUpper = m_nodes[leaf].upper;
+    int index = m_root;
+    while (!m_nodes[index].isLeaf()) {
+        const TreeNode& node = m_nodes[index];
+        const Real area = surfaceArea(node.lower, node.upper);
+        const Real combined = unionArea(node.lower, node.upper,
+                                        leafLower, leafUpper);
+        const Real cost = 2*combined;
+        const Real inheritance = 2*(combined - area);
+        Real childCost[2];
+        for (int c=0; c < 2; ++c) {
+            const TreeNode& child = m_nodes[c == 0 ? node.child1 : node.child2];
+            childCost[c] = unionArea(child.lower, child.upper,
+                                     leafLower, leafUpper) + inheritance;
+            if (!child.isLeaf())
+                childCost[c] -= surfaceArea(child.lower, child.upper);
+        }
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+        index = childCost[0] < childCost[1] ? node.child1 : node.child2;
+    }
+    const int sibling = index;
+
+    // Make a new parent for the sibling and the leaf.
+    const int oldParent = m_nodes[sibling].parent;
+    const int newParent = allocateNode();
+    TreeNode& p = m_nodes[newParent];
+    p.parent = oldParent;
+    p.child1 = sibling; p.child2 = leaf;
+    p.height = m_nodes[sibling].height + 1;
+    if (oldParent >= 0) {
+        if (m_nodes[oldParent].child1 == sibling)
+             m_nodes[oldParent].child1 = newParent;
+        else m_nodes[oldParent].child2 = newParent;
+    } else
+        m_root = newParent;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    refitAncestors(newParent);
+}
+
+void ContactBroadPhase::removeLeaf(int leaf) {
+    if (leaf == m_root) {
+        m_root = -1;
+        return;
+    }
+    const int parent = m_nodes[leaf].parent;
+    const int grandParent = m_nodes[parent].parent;
+    const int sibling = m_nodes[parent].child1 == leaf
+                        ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    // The sibling takes the parent's place.
+    if (grandParent >= 0) {
+        if (m_nodes[grandParent].child1 == parent)
+             m_nodes[grandParent].child1 = sibling;
+        else m_nodes[grandParent].child2 = sibling;
+        m_nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refitAncestors(grandParent);
+    } else {
+        m_root = sibling;
+        m_nodes[sibling].parent = -1;
+        freeNode(parent);
+    }
+}
+
+// Rebalance and recompute the heights and boxes of this node and everything
+// above it.
+void ContactBroadPhase::refitAncestors(int index) {
+    while (index >= 0) {
+        index = balance(index);
+        TreeNode& node = m_nodes[index];
+        const TreeNode& c1 = m_nodes[node.child1];
+        const TreeNode& c2 = m_nodes[node.child2];
+        node.height = 1 + std::max(c1.height, c2.height);
+        for (int k=0; k < 3; ++k) {
+            node.lower[k] = std::min(c1.lower[k], c2.lower[k]);
+            node.upper[k] = std::max(c1.upper[k], c2.upper[k]);
+        }
+        index = node.parent;
+    }
+}
+
+// If one of node A's subtrees is more than one level taller than the other,
+// rotate the taller child up into A's place, moving its taller grandchild
+// along with it and handing the shorter one to A. Returns the index of the
+// node now in A's place.
+int ContactBroadPhase::balance(int iA) {
+    TreeNode& A = m_nodes[iA];
+    if (A.isLeaf() || A.height < 2)
+        return iA;
+
+    const int iB = A.child1, iC = A.child2;
+    const int imbalance = m_nodes[iC].height - m_nodes[iB].height;
+    if (imbalance >= -1 && imbalance <= 1)
+        return iA;
+
+    // Let U be the taller child that moves up, and S the shorter one that
+    // stays with A.
+    const bool cIsTaller = imbalance > 1;
+    const int iU = cIsTaller ? iC : iB;
+    const int iS = cIsTaller ? iB : iC;
+    TreeNode& U = m_nodes[iU];
+    const TreeNode& S = m_nodes[iS];
+    const int iF = U.child1, iG = U.child2;
+    TreeNode& F = m_nodes[iF];
+    TreeNode& G = m_nodes[iG];
+
+    // U replaces A under A's parent, with A as its first child.
+    U.child1 = iA;
+    U.parent = A.parent;
+    A.parent = iU;
+    if (U.parent >= 0) {
+        if (m_nodes[U.parent].child1 == iA) m_nodes[U.parent].child1 = iU;
+        else                                 m_nodes[U.parent].child2 = iU;
+    } else
+        m_root = iU;
+
+    // The taller grandchild stays with U; A gets the other in U's old slot.
+    const bool fIsTaller = F.height > G.height;
+    const int iKeep = fIsTaller ? iF : iG;
+    const int iGive = fIsTaller ? iG : iF;
+    TreeNode& keep = m_nodes[iKeep];
+    TreeNode& give = m_nodes[iGive];
+    U.child2 = iKeep;
+    if (cIsTaller) A.child2 = iGive; else A.child1 = iGive;
+    give.parent = iA;
+
+    for (int k=0; k < 3; ++k) {
+        A.lower[k] = std::min(S.lower[k], give.lower[k]);
+        A.upper[k] = std::max(S.upper[k], give.upper[k]);
+        U.lower[k] = std::min(A.lower[k], keep.lower[k]);
+        U.upper[k] = std::max(A.upper[k], keep.upper[k]);
+    }
+    A.height = 1 + std::max(S.height, give.height);
+    U.height = 1 + std::max(A.height, keep.height);
+    return iU;
+}
+
+// Append to pairs every other object whose fat box touches this object's fat
+// box.
+void ContactBroadPhase::queryTree(int object, PairList& pairs) {
+    if (m_root < 0) return;
+    const TreeNode& leaf = m_nodes[m_leafOf[object]];
+    Array_<int>& stack = m_stack;
+    stack.clear();
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const int index = stack.back(); stack.pop_back();
+        const TreeNode& node = m_nodes[index];
+        if (!touches(node.lower, node.upper, leaf.lower, leaf.upper))
+            continue;
+        if (node.isLeaf()) {
+            if (node.object != object)
+                pairs.push_back(object < node.object
+                             ? make_pair(object, node.object)
+                             : make_pair(node.object, object));
+        } else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+// Reinsert the objects that left their fat boxes, drop their old candidate
+// pairs and query the tree for their new ones. Then the overlaps are the
+// candidates whose current boxes overlap, plus any overlaps with unbounded
+// objects, which aren't kept in the tree.
+void ContactBroadPhase::updateTree() {
+    const int n = getNumObjects();
+    if (m_mustBuild) {
+        m_nodes.clear(); m_root = m_freeList = -1;
+        m_leafOf.assign(n, -1);
+        m_candidates.clear();
+        clearOverlaps();
+    }
+
+    m_moved.assign(n, false);
+    m_unbounded.clear();
+    bool anyMoved = false;
+    for (int i=0; i < n; ++i) {
+        const bool bounded = m_lower[i].isFinite() && m_upper[i].isFinite();
+        int leaf = m_leafOf[i];
+        if (!bounded) {
+            if (leaf >= 0) {
+                removeLeaf(leaf); freeNode(leaf); m_leafOf[i] = -1;
+                m_moved[i] = anyMoved = true;
+            }
+            m_unbounded.push_back(i);
+            continue;
+        }
+        if (leaf >= 0 && contains(m_nodes[leaf].lower, m_nodes[leaf].upper,
+                                  m_lower[i], m_upper[i]))
+            continue;
+        m_moved[i] = anyMoved = true;
+        if (leaf >= 0)
+            removeLeaf(leaf);
+        else {
+            leaf = m_leafOf[i] = allocateNode();
+            m_nodes[leaf].object = i;
+        }
+        const Vec3 d = m_upper[i] - m_lower[i];
+        const Vec3 margin(FatMargin*std::max(d[0], std::max(d[1], d[2])));
+        m_nodes[leaf].lower = m_lower[i] - margin;
+        m_nodes[leaf].upper = m_upper[i] + margin;
+        insertLeaf(leaf);
+    }
+
+    if (anyMoved) {
+        // Keep the candidates that don't involve a moved object; they're
+        // still sorted. The new ones all involve a moved object, so once
+        // they're sorted the two runs can be merged without duplicates.
+        int kept = 0;
+        for (int c=0; c < (int)m_candidates.size(); ++c) {
+            const Pair& p = m_candidates[c];
+            if (!(m_moved[p.first] || m_moved[p.second]))
+                m_candidates[kept++] = p;
+        }
+        m_candidates.resize(kept);
+        for (int i=0; i < n; ++i)
+            if (m_moved[i] && m_leafOf[i] >= 0)
+                queryTree(i, m_candidates);
+        PairList::iterator mid = m_candidates.begin() + kept;
+        std::sort(mid, m_candidates.end());
+        m_previous.clear();
+        std::merge(m_candidates.begin(), mid,
+                   mid, std::unique(mid, m_candidates.end()),
+                   std::back_inserter(m_previous));
+        m_candidates.swap(m_previous);
+    }
+
+    m_previous.swap(m_overlaps);
+    m_overlaps.clear();
+    for (int c=0; c < (int)m_candidates.size(); ++c) {
+        const Pair& p = m_candidates[c];
+        if (boxesOverlap(p.first, p.second))
+            m_overlaps.push_back(p);
+    }
+    if (!m_unbounded.empty()) {
+        for (int u=0; u < (int)m_unbounded.size(); ++u) {
+            const int i = m_unbounded[u];
+            for (int j=0; j < n; ++j)
+                if (j != i && boxesOverlap(i, j))
+                    m_overlaps.push_back(i < j ? make_pair(i,j) 
+                                               : make_pair(j,i));
+        }
+        std::sort(m_overlaps.begin(), m_overlaps.end());
+        m_overlaps.resize(std::unique(m_overlaps.begin(), m_overlaps.end())
+                          - m_overlaps.begin());
+    }
+
+    m_added.clear(); m_removed.clear();
+    std::set_difference(m_overlaps.begin(), m_overlaps.end(),
+                        m_previous.begin(), m_previous.end(),
+                        std::back_inserter(m_added));
+    std::set_difference(m_previous.begin(), m_previous.end(),
+                        m_overlaps.begin(), m_overlaps.end(),
+                        std::back_inserter(m_removed));
+}
+
+} // namespace SimTK
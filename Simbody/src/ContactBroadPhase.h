@@ -0,0 +1,186 @@
+#ifndef SimTK_SIMBODY_CONTACT_BROAD_PHASE_H_
+#define SimTK_SIMBODY_CONTACT_BROAD_PHASE_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simbody/internal/common.h"
+#include "simbody/internal/ContactTrackerSubsystem.h"
+
+#include <iosfwd>
+#include <utility>
+
+namespace SimTK {
+
+//==============================================================================
+//                           CONTACT BROAD PHASE
+//==============================================================================
+// This is the persistent state of a broad phase collision detector for a set
+// of objects represented by axis-aligned bounding boxes in Ground. It finds
+// every pair of objects whose boxes overlap, and the pairs that started or
+// stopped overlapping since the previous update. It is meant to be kept in an
+// auto-update discrete variable so that the work done in one step is reused
+// in the next; both the contact subsystems use it.
+//
+// Boxes are compared strictly, so boxes that just touch don't overlap. A box
+// may be infinite (e.g. around a half space), in which case it overlaps
+// everything. Both methods produce exactly the same pairs:
+//
+//  - SweepAndPrune keeps both ends of every box in sorted order along each of
+//    the three Ground axes. When the boxes move a little the lists are nearly
+//    still sorted, so an insertion sort restores them in nearly linear time
+//    and the only pairs whose status can have changed are those whose
+//    endpoints were swapped along the way. A single large box spans many
+//    endpoints though, and gets swept past by everything that moves.
+//
+//  - DynamicAABBTree keeps a "fat" box, enlarged by a margin, for each object
+//    in a balanced bounding volume tree, along with the pairs whose fat boxes
+//    overlap. An object's leaf is reinserted only when its box leaves its fat
+//    box, and only those objects are used to query the tree for new pairs.
+//    The cost depends on how many objects moved, not on how their sizes
+//    compare.
+//
+// Usage: call setNumObjects(), fill in the boxes with updLower() and
+// updUpper(), then call update(). Changing the number of objects starts over.
+//
+// The pairs are kept in sorted flat arrays, and all the working storage is
+// kept here too, so once the arrays have grown to fit an update doesn't
+// allocate any heap space.
+class ContactBroadPhase {
+public:
+    typedef ContactTrackerSubsystem::BroadPhaseMethod   Method;
+    typedef std::pair<int,int>                          Pair; // low first
+    typedef Array_<Pair>                                PairList; // sorted
+
+    explicit ContactBroadPhase
+       (Method method = ContactTrackerSubsystem::SweepAndPrune)
+    :   m_method(method), m_mustBuild(true), m_root(-1), m_freeList(-1) {}
+
+    Method getMethod() const {return m_method;}
+    int getNumObjects() const {return (int)m_lower.size();}
+
+    void setNumObjects(int n) {
+        if (n == getNumObjects()) return;
+        m_lower.resize(n); m_upper.resize(n);
+        m_mustBuild = true;
+    }
+
+    // Box corners in Ground; fill these in before calling update().
+    Array_<Vec3>& updLower() {return m_lower;}
+    Array_<Vec3>& updUpper() {return m_upper;}
+    const Array_<Vec3>& getLower() const {return m_lower;}
+    const Array_<Vec3>& getUpper() const {return m_upper;}
+
+    // Bring the overlap set up to date with the current boxes.
+    void update();
+
+    const PairList& getOverlaps() const {return m_overlaps;}
+    const PairList& getAdded()    const {return m_added;}
+    const PairList& getRemoved()  const {return m_removed;}
+
+    // Return true if the current boxes of objects i and j overlap.
+    bool boxesOverlap(int i, int j) const {
+        for (int axis=0; axis < 3; ++axis)
+            if (!(m_lower[i][axis] < m_upper[j][axis]
+                  && m_lower[j][axis] < m_upper[i][axis]))
+                return false;
+        return true;
+    }
+
+    // Height of the tree; this is zero for SweepAndPrune.
+    int getTreeHeight() const
+    {   return m_root < 0 ? 0 : m_nodes[m_root].height; }
+
+private:
+    void clearOverlaps() {m_overlaps.clear(); m_added.clear();
+                          m_removed.clear();}
+
+    // Sweep and prune.
+    void buildSweep();
+    void updateSweep();
+    void touchPair(int i, int j);
+    void mergeTouchedPairs();
+
+    // Dynamic AABB tree.
+    void updateTree();
+    int  allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int  balance(int node);
+    void refitAncestors(int node);
+    void queryTree(int object, PairList& pairs);
+
+    // One end of a box along one of the sweep axes.
+    struct SweepEndpoint {
+        SweepEndpoint() {}
+        SweepEndpoint(Real value, int object, bool isMax)
+        :   value(value), object(object), isMax(isMax) {}
+        // On a tie a max sorts before a min, so boxes that just touch don't
+        // overlap.
+        bool operator<(const SweepEndpoint& e) const
+        {   return value < e.value || (value == e.value && isMax && !e.isMax); }
+        Real    value;
+        int     object;
+        bool    isMax;
+    };
+
+    // A node of the tree. Leaves hold an object's fat box; an internal node
+    // holds the union of its two children's boxes. Free nodes are chained
+    // through their parent field.
+    struct TreeNode {
+        bool isLeaf() const {return child1 < 0;}
+        Vec3    lower, upper;
+        int     parent, child1, child2;
+        int     object; // leaves only
+        int     height; // leaves are 0
+    };
+
+    Method                  m_method;
+    bool                    m_mustBuild;
+    Array_<Vec3>            m_lower, m_upper;   // current boxes
+    PairList                m_overlaps;
+    PairList                m_added, m_removed; // since the last update
+    PairList                m_previous;         // scratch
+
+    // SweepAndPrune only.
+    Array_<SweepEndpoint>   m_endpoints[3];     // x, y, z
+    PairList                m_touched;  // scratch; pairs whose ends swapped
+
+    // DynamicAABBTree only.
+    Array_<TreeNode>        m_nodes;
+    int                     m_root, m_freeList;
+    Array_<int>             m_leafOf;   // -1 if unbounded
+    Array_<int>             m_unbounded;// objects with infinite boxes
+    PairList                m_candidates; // bounded pairs with fat overlap
+    Array_<bool>            m_moved;    // scratch
+    Array_<int>             m_stack;    // scratch for queryTree()
+};
+
+// Required by Value<T>.
+std::ostream& operator<<(std::ostream& o, const ContactBroadPhase& bp);
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_CONTACT_BROAD_PHASE_H_
@@ -27,11 +27,12 @@
 #include "simbody/internal/SimbodyMatterSubsystem.h"
 #include "simbody/internal/ContactTrackerSubsystem.h"
 
+#include "ContactBroadPhase.h"
+
 #include <algorithm>
 using std::pair; using std::make_pair;
 #include <iostream>
 using std::cout; using std::endl;
-#include <set>
 
 
 namespace SimTK {
@@ -66,54 +67,80 @@ static std::ostream& operator<<(std::ostream& o, const Bubble& bb) {
     return o;
 }
 
-// For spatial sorting of bubbles.
-class BubbleExtent {
-public:
-    BubbleExtent(Real start, Real end, BubbleIndex index) 
-    :   start(start), end(end), index(index) {}
-    BubbleExtent() {}
-    bool operator<(const BubbleExtent& e) const 
-    {   return start < e.start; }
-    Real        start, end; // span along chosen sort axis
-    BubbleIndex index;
-};
-static std::ostream& operator<<(std::ostream& o, const BubbleExtent& bx) {
-    o << bx.index << ":(" << bx.start << "," << bx.end << ")";
-    return o;
-}
-
 typedef std::map< pair<ContactGeometryTypeId,ContactGeometryTypeId>,
                   pair<ContactTracker*,bool> > TrackerMap;
 
-// This type maps a contact surface onto a set of all the higher-numbered
-// contact surfaces it might be touching, and for each of those we keep
-// a pointer to that pair's Contact object if it is currently being tracked
-// (null if it is new). You must use the *lower* numbered surface as the key 
-// when inserting a pair so that any given pair of surfaces appears just once.
+// A pair of contact surfaces that might be touching, with a pointer to that
+// pair's Contact object if it is currently being tracked (null if it is new).
+// The *lower* numbered surface always comes first so that after sorting, any
+// appearances of a given pair are adjacent, with the tracked one first.
 // However, the surface order in the Contact object will be determined by
 // the order required by the corresponding tracker.
-// TODO: replace with a fast data structure
-typedef std::map<ContactSurfaceIndex,const Contact*> ContactSurfaceSet;
-typedef std::map<ContactSurfaceIndex,ContactSurfaceSet> PairMap;
-
-static std::ostream& operator<<(std::ostream& o, const ContactSurfaceSet& css) {
-    ContactSurfaceSet::const_iterator p = css.begin();
-    o << "{";
-    for (; p != css.end(); ++p) {
-        if (p!=css.begin()) o << ", ";
-        o << p->first << ":0x" << p->second;
+struct CandidatePair {
+    CandidatePair() {}
+    CandidatePair(ContactSurfaceIndex low, ContactSurfaceIndex high, 
+                  const Contact* prev) : low(low), high(high), prev(prev) {}
+    bool operator<(const CandidatePair& c) const {
+        if (low != c.low) return low < c.low;
+        if (high != c.high) return high < c.high;
+        return prev && !c.prev;
     }
-    return o << "}";
+    bool isSamePair(const CandidatePair& c) const 
+    {   return low == c.low && high == c.high; }
+
+    ContactSurfaceIndex low, high;
+    const Contact*      prev;
+};
+static std::ostream& operator<<(std::ostream& o, const CandidatePair& cp) {
+    return o << "(" << cp.low << "," << cp.high << "):0x" << cp.prev;
 }
-static std::ostream& operator<<(std::ostream& o, const PairMap& pm) {
-    PairMap::const_iterator p = pm.begin();
-    for (; p != pm.end(); ++p) {
-        if (p != pm.begin()) o << endl;
-        o << p->first << "->" << p->second;
-    }
-    return o;
+
+
+
+// One surface pair for the narrow phase to examine, with the surfaces in the
+// order required by its tracker. The previous Contact is null if the pair 
+// wasn't being tracked or its contact had broken.
+struct TrackedPair {
+    ContactSurfaceIndex     surf1, surf2;
+    const ContactTracker*   tracker;
+    bool                    mustReverse; // tracker order is (index2,index1)
+    const Contact*          prev;
+};
+
+// Working storage for the narrow phase. This is kept in a cache entry so 
+// that its heap space is reused from step to step.
+struct NarrowPhaseScratch {
+    Array_<CandidatePair>   candidates;
+    Array_<TrackedPair>     tracked;
+    Array_<int>             parallelPairs;
+    Array_<Contact>         results;
+};
+static std::ostream& operator<<(std::ostream& o, const NarrowPhaseScratch& s) {
+    return o << "NarrowPhaseScratch(" << s.candidates.size() << " candidates)";
 }
 
+class ContactTrackerSubsystemImpl;
+
+// This tracks a range of the thread safe pairs, each into its own slot.
+class TrackContactsTask : public TaskScheduler::RangeTask {
+public:
+    TrackContactsTask(const ContactTrackerSubsystemImpl&   subsys,
+                      const State&                         state,
+                      const Array_<TrackedPair>&           pairs,
+                      const Array_<int>&                   which,
+                      Array_<Contact>&                     results)
+    :   subsys(subsys), state(state), pairs(pairs), which(which), 
+        results(results) {}
+
+    void execute(int begin, int end);
+private:
+    const ContactTrackerSubsystemImpl&  subsys;
+    const State&                        state;
+    const Array_<TrackedPair>&          pairs;
+    const Array_<int>&                  which;
+    Array_<Contact>&                    results;
+};
+
 
 
 //==============================================================================
@@ -123,7 +150,10 @@ class ContactTrackerSubsystemImpl : public Subsystem::Guts {
 public:
 // Constructor registers a default set of Trackers to use with geometry
 // we know about. These can be overridden later.
-ContactTrackerSubsystemImpl() : m_defaultTracker(0) {
+ContactTrackerSubsystemImpl() 
+:   m_defaultTracker(0), 
+    m_broadPhaseMethod(ContactTrackerSubsystem::SweepAndPrune),
+    m_trackingScheduler(0) {
     adoptContactTracker(new ContactTracker::HalfSpaceSphere());
     adoptContactTracker(new ContactTracker::SphereSphere());
     adoptContactTracker(new ContactTracker::HalfSpaceEllipsoid());
@@ -141,7 +171,18 @@ ContactTrackerSubsystemImpl() : m_defaultTracker(0) {
                                  ContactGeometry::Ellipsoid::classTypeId()));
 }
 
+// The copy doesn't share our thread pool; it starts out serial.
+ContactTrackerSubsystemImpl(const ContactTrackerSubsystemImpl& src)
+:   Subsystem::Guts(src), m_contactTrackers(src.m_contactTrackers),
+    m_defaultTracker(src.m_defaultTracker), 
+    m_broadPhaseMethod(src.m_broadPhaseMethod), m_trackingScheduler(0),
+    m_surfaces(src.m_surfaces), m_bubbles(src.m_bubbles),
+    m_activeContactsIx(src.m_activeContactsIx), 
+    m_predictedContactsIx(src.m_predictedContactsIx),
+    m_broadPhaseIx(src.m_broadPhaseIx), m_scratchIx(src.m_scratchIx) {}
+
 ~ContactTrackerSubsystemImpl() {
+    delete m_trackingScheduler;
     delete m_defaultTracker;
     TrackerMap::iterator p = m_contactTrackers.begin();
     for (; p != m_contactTrackers.end(); ++p)
@@ -220,6 +261,12 @@ int realizeSubsystemTopologyImpl(State& state) const {
     wThis->m_predictedContactsIx = allocateAutoUpdateDiscreteVariable
         (state, Stage::Dynamics, new Value<ContactSnapshot>(), 
          Stage::Acceleration);  // update depends on accelerations
+    wThis->m_broadPhaseIx = allocateAutoUpdateDiscreteVariable
+        (state, Stage::Dynamics, 
+         new Value<ContactBroadPhase>(ContactBroadPhase(m_broadPhaseMethod)), 
+         Stage::Position);      // update depends on positions
+    wThis->m_scratchIx = allocateCacheEntry
+        (state, Stage::Dynamics, new Value<NarrowPhaseScratch>());
 
     const SimbodyMatterSubsystem& matter = getMatterSubsystem();
 
@@ -259,87 +306,150 @@ int realizeSubsystemVelocityImpl(const State& state) const {
     return 0;
 }
 
-// Adds new pairs to the existing set, if not already present.
-void addInBroadPhasePairs(const State& state, PairMap& pairs) const {
+// Call this any time after positions are known, to ensure that the broad
+// phase overlap set has been updated for those positions. The broad phase
+// from the previous step is the starting point, so when little has moved
+// there is little to do.
+void ensureBroadPhaseUpdated(const State& state) const {
+    if (isDiscreteVarUpdateValueRealized(state, m_broadPhaseIx))
+        return; // already done
+
+    const ContactBroadPhase& prev = Value<ContactBroadPhase>::downcast
+        (getDiscreteVariable(state, m_broadPhaseIx));
+    ContactBroadPhase& next = Value<ContactBroadPhase>::updDowncast
+        (updDiscreteVarUpdateValue(state, m_broadPhaseIx));
+
+    next = prev;
     const int numBubbles = getNumBubbles();
-    
-    // Perform a sweep-and-prune on a single axis to identify potential 
-    // contacts. First, find which axis has the most variation in body 
-    // locations. That is the axis we will use.
-    // TODO: this one-axis method is not good enough in general
-    
-    Vector_<Vec3> centers(numBubbles);
+    next.setNumObjects(numBubbles);
+    Array_<Vec3>& lower = next.updLower();
+    Array_<Vec3>& upper = next.updUpper();
     for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx) {
         const Bubble&  bubb = m_bubbles[bbx];
         const Surface& surf = m_surfaces[bubb.surface];
-        centers[bbx] = surf.mobod->getBodyTransform(state) 
-                        * bubb.getCenter();
+        const Vec3 center = surf.mobod->getBodyTransform(state) 
+                            * bubb.getCenter();
+        const Vec3 extent(bubb.getRadius());
+        lower[bbx] = center - extent;
+        upper[bbx] = center + extent;
     }
-    Vec3 average = mean(centers);
-    Vec3 var(0);
-    for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx)
-        var += abs(centers[bbx]-average);
-    int axis = (var[0] > var[1] ? 0 : 1);
-    if (var[2] > var[axis])
-        axis = 2;
-    
-    // Find the extent of each bubble along the axis and sort them by 
-    // starting location.
-    Array_<BubbleExtent,int> extents(numBubbles);
-    for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx) {
-        const Real radius = m_bubbles[bbx].getRadius();
-        const Real center = centers[bbx][axis];
-        extents[bbx] = BubbleExtent(center-radius, center+radius, bbx);
+    next.update();
+
+    markDiscreteVarUpdateValueRealized(state, m_broadPhaseIx);
+}
+
+const ContactBroadPhase& getBroadPhase(const State& state) const {
+    ensureBroadPhaseUpdated(state);
+    return Value<ContactBroadPhase>::downcast
+        (getDiscreteVarUpdateValue(state, m_broadPhaseIx));
+}
+
+// Return true if the two bubbles are on surfaces that are allowed to 
+// interact, and if so return the surfaces in low,high order.
+bool getSurfacePair(const ContactBroadPhase::Pair& bp, 
+                    ContactSurfaceIndex& low, ContactSurfaceIndex& high) const {
+    const Bubble&  bubb1 = m_bubbles[BubbleIndex(bp.first)];
+    const Bubble&  bubb2 = m_bubbles[BubbleIndex(bp.second)];
+    const Surface& surf1 = m_surfaces[bubb1.surface];
+    const Surface& surf2 = m_surfaces[bubb2.surface];
+    // Ignore if on the same body.
+    if (surf1.mobod == surf2.mobod) return false;
+    assert(bubb1.surface != bubb2.surface); // duh!
+    // Ignore if surfaces are in a common clique.
+    if (surf1.surface->isInSameClique(*surf2.surface)) return false;
+    low = bubb1.surface; high = bubb2.surface;
+    if (low > high) std::swap(low,high);
+    return true;
+}
+
+void appendSurfacePairs(const ContactBroadPhase::PairList& bubblePairs,
+                        Array_<pair<ContactSurfaceIndex,
+                                    ContactSurfaceIndex> >& surfPairs) const {
+    ContactBroadPhase::PairList::const_iterator p = bubblePairs.begin();
+    for (; p != bubblePairs.end(); ++p) {
+        ContactSurfaceIndex low, high;
+        if (getSurfacePair(*p, low, high))
+            surfPairs.push_back(make_pair(low,high));
     }
-    //cout << "Bubble extents:" << extents << "\n";
-
-    // Expensive: O(n log n)
-    std::sort(extents.begin(), extents.end());
-    
-    // Now sweep along the axis, finding potential contacts.
-    
-    for (int ex1=0; ex1 < numBubbles; ++ex1) {
-        const BubbleExtent& extent1 = extents[ex1];
-        const Bubble&       bubb1   = m_bubbles[extent1.index];
-        const Real          radius1 = bubb1.getRadius();
-        const Vec3&         center1 = centers[extent1.index];
-
-        // Loop over just the overlapping bubbles.
-        for (int ex2(ex1+1); ex2 < numBubbles; ++ex2) {
-            const BubbleExtent& extent2 = extents[ex2];
-            if (extent2.start > extent1.end)
-                break;  // no more bubbles can overlap with extent1
-
-            // These bubbles do overlap along this axis. See if they are
-            // actually touching.
-            const Bubble& bubb2   = m_bubbles[extent2.index];
-            const Real    radius2 = bubb2.getRadius();
-            const Vec3&   center2 = centers[extent2.index];
-            if ((center1-center2).normSqr() > square(radius1+radius2))
-                continue; // nope
-
-            // The bubbles are touching. We'll add the corresponding surfaces
-            // to the narrow-phase list unless there are relevant exclusions.
-            const Surface& surf1 = m_surfaces[bubb1.surface];
-            const Surface& surf2 = m_surfaces[bubb2.surface];
-            // Ignore if on the same body.
-            if (surf1.mobod == surf2.mobod) continue;
-            assert(bubb1.surface != bubb2.surface); // duh!
-            // Ignore if surfaces are in a common clique.
-            if (surf1.surface->isInSameClique(*surf2.surface)) continue;
-            // We'll need to do a narrow phase investigation of these two
-            // surfaces; use the lower-numbered one as the index to avoid
-            // duplicates.
-            ContactSurfaceIndex low=bubb1.surface, high=bubb2.surface;
-            if (low > high) std::swap(low,high);
-            ContactSurfaceSet& surfSet = pairs[low];
-            // Insert this pair with null Contact if the pair isn't already
-            // in the PairMap.
-            surfSet.insert(make_pair(high,(Contact*)0));
-        }
+}
+
+// Appends the broad phase pairs with null Contacts; the caller must remove
+// any that duplicate pairs already present.
+void addInBroadPhasePairs(const State& state, 
+                          Array_<CandidatePair>& pairs) const {
+    const ContactBroadPhase& broadPhase = getBroadPhase(state);
+    const Array_<Vec3>& lower = broadPhase.getLower();
+    const Array_<Vec3>& upper = broadPhase.getUpper();
+    ContactBroadPhase::PairList::const_iterator p = 
+        broadPhase.getOverlaps().begin();
+    for (; p != broadPhase.getOverlaps().end(); ++p) {
+        // The bubbles' bounding boxes overlap. See if the bubbles themselves
+        // are actually touching; each box is centered on its bubble.
+        const Vec3 center1 = (lower[p->first]  + upper[p->first])  / 2;
+        const Vec3 center2 = (lower[p->second] + upper[p->second]) / 2;
+        const Real radius1 = m_bubbles[BubbleIndex(p->first)].getRadius();
+        const Real radius2 = m_bubbles[BubbleIndex(p->second)].getRadius();
+        if ((center1-center2).normSqr() > square(radius1+radius2))
+            continue; // nope
+
+        // The bubbles are touching. We'll add the corresponding surfaces
+        // to the narrow-phase list unless there are relevant exclusions.
+        ContactSurfaceIndex low, high;
+        if (getSurfacePair(*p, low, high))
+            pairs.push_back(CandidatePair(low, high, 0));
+    }
+}
+
+// Adds the surface pairs of the Contacts in this snapshot.
+static void addInSnapshotPairs(const ContactSnapshot& snapshot, 
+                               Array_<CandidatePair>& pairs) {
+    for (int i=0; i < snapshot.getNumContacts(); ++i) {
+        const Contact& contact = snapshot.getContact(i);
+        ContactSurfaceIndex low=contact.getSurface1(), 
+                            high=contact.getSurface2();
+        if (low > high) std::swap(low,high);
+        pairs.push_back(CandidatePair(low, high, &contact));
     }
 }
 
+// Run the narrow phase tracker for one pair of surfaces. This may be called
+// concurrently for different pairs so must not modify anything shared.
+void trackPair(const State& state, const TrackedPair& pair, 
+               Contact& next) const {
+    const Surface& surf1 = m_surfaces[pair.surf1];
+    const Surface& surf2 = m_surfaces[pair.surf2];
+    const Transform X_GS1 = surf1.mobod->getBodyTransform(state)*surf1.X_BS;
+    const Transform X_GS2 = surf2.mobod->getBodyTransform(state)*surf2.X_BS;
+    const ContactGeometry& geom1 = surf1.surface->getShape();
+    const ContactGeometry& geom2 = surf2.surface->getShape();
+
+    if (pair.prev)
+        pair.tracker->trackContact
+           (*pair.prev, X_GS1,geom1, X_GS2,geom2, 0/*TODO*/, next);
+    else
+        pair.tracker->trackContact
+           (UntrackedContact(pair.surf1, pair.surf2), 
+            X_GS1,geom1, X_GS2,geom2, 0/*TODO*/, next);
+}
+
+void setUseParallelContactTracking(bool useParallel, int numThreads) {
+    SimTK_APIARGCHECK1_ALWAYS(!useParallel || numThreads > 0, 
+        "ContactTrackerSubsystem", "setUseParallelContactTracking",
+        "The number of threads must be positive but was %d.", numThreads);
+
+    if (useParallel && m_trackingScheduler 
+        && m_trackingScheduler->getNumThreads() == numThreads)
+        return; // nothing to do
+
+    delete m_trackingScheduler;
+    m_trackingScheduler = 0;
+    if (useParallel)
+        m_trackingScheduler = new TaskScheduler(numThreads);
+}
+
+bool getUseParallelContactTracking() const 
+{   return m_trackingScheduler != 0; }
+
 // Call this any time after positions are known, to ensure that the active
 // contact set has been updated for those positions. We can use three
 // sources of information to compute the update:
@@ -366,97 +476,93 @@ void ensureActiveContactsUpdated(const State& state) const {
     const ContactSnapshot& predicted  = getPrevPredictedContacts(state);
     ContactSnapshot&       nextActive = updNextActiveContacts(state);
 
-    // TODO: Can we reuse heap space in this cache entry?
+    // The snapshot and all the working arrays keep their heap space from
+    // earlier steps; only the Contacts made by the trackers are new.
     nextActive.clear();
+    NarrowPhaseScratch& scratch = Value<NarrowPhaseScratch>::updDowncast
+        (updCacheEntry(state, m_scratchIx));
+
+    // Collect the interesting pairs; previously tracked ones go in with
+    // their Contacts and new ones with null Contact pointers. Sorting puts
+    // the tracked entry for a pair ahead of any untracked duplicates, 
+    // which we then drop.
+    Array_<CandidatePair>& interesting = scratch.candidates;
+    interesting.clear();
+    addInSnapshotPairs(active, interesting);
+    addInSnapshotPairs(predicted, interesting);
+    addInBroadPhasePairs(state, interesting);
+    std::sort(interesting.begin(), interesting.end());
+    //cout << "Interesting pairs:\n" << interesting << "\n";
 
-    PairMap interesting;
-    for (int i=0; i < active.getNumContacts(); ++i) {
-        const Contact& contact = active.getContact(i);
-        ContactSurfaceIndex low=contact.getSurface1(), 
-                            high=contact.getSurface2();
-        if (low > high) std::swap(low,high);
-        ContactSurfaceSet& others = interesting[low];
-        assert(others.find(high)==others.end());
-        others[high] = &contact;
+    // Flatten the interesting pairs that have trackers into a list in 
+    // surface pair order, with a result slot for each.
+    Array_<TrackedPair>& tracked = scratch.tracked;
+    tracked.clear();
+    for (int i=0; i < (int)interesting.size(); ++i) {
+        const CandidatePair& candidate = interesting[i];
+        if (i > 0 && candidate.isSamePair(interesting[i-1]))
+            continue; // already have this one
+        const ContactSurfaceIndex index1 = candidate.low;
+        const ContactSurfaceIndex index2 = candidate.high;
+        const ContactGeometryTypeId typeId1 = 
+            m_surfaces[index1].surface->getShape().getTypeId();
+        const ContactGeometryTypeId typeId2 = 
+            m_surfaces[index2].surface->getShape().getTypeId();
+        if (!hasContactTracker(typeId1,typeId2))
+            continue; // No algorithm available for detecting collisions between these two objects.
+        TrackedPair pair;
+        pair.tracker = &getContactTracker(typeId1, typeId2, 
+                                          pair.mustReverse);
+        // Put the surfaces in the order required by the tracker.
+        pair.surf1 = pair.mustReverse ? index2 : index1;
+        pair.surf2 = pair.mustReverse ? index1 : index2;
+        pair.prev = candidate.prev;
+        if (pair.prev && pair.prev->getCondition() == Contact::Broken)
+            pair.prev = 0; // that contact expired
+        tracked.push_back(pair);
     }
-    for (int i=0; i < predicted.getNumContacts(); ++i) {
-        const Contact& contact = predicted.getContact(i);
-        ContactSurfaceIndex low=contact.getSurface1(), 
-                            high=contact.getSurface2();
-        if (low > high) std::swap(low,high);
-        ContactSurfaceSet& others = interesting[low];
-        assert(others.find(high)==others.end());
-        others[high] = &contact;
+
+    // Run the trackers, concurrently if we can.
+    const int numPairs = (int)tracked.size();
+    Array_<Contact>& results = scratch.results;
+    results.clear();
+    results.resize(numPairs); // empty handles
+    if (m_trackingScheduler && numPairs > 1) {
+        Array_<int>& parallelPairs = scratch.parallelPairs;
+        parallelPairs.clear();
+        for (int i=0; i < numPairs; ++i)
+            if (tracked[i].tracker->isThreadSafe()) 
+                parallelPairs.push_back(i);
+            else trackPair(state, tracked[i], results[i]);
+        TrackContactsTask task(*this, state, tracked, parallelPairs, results);
+        m_trackingScheduler->parallelFor(task, 0, (int)parallelPairs.size());
+    } else {
+        for (int i=0; i < numPairs; ++i)
+            trackPair(state, tracked[i], results[i]);
     }
-    // This will ignore pairs that we already inserted above; new ones
-    // will be inserted with null Contact object pointers.
-    addInBroadPhasePairs(state, interesting);
-    //cout << "Interesting pairs:\n" << interesting << "\n";
 
-    PairMap::const_iterator p = interesting.begin();
-    for (; p != interesting.end(); ++p) {
-        const ContactSurfaceIndex index1 = p->first;
-        const Transform transform1 = 
-            m_surfaces[index1].mobod->getBodyTransform(state)
-                * m_surfaces[index1].X_BS;
-        const ContactGeometry& geom1 = m_surfaces[index1].surface->getShape();
-        const ContactGeometryTypeId typeId1 = geom1.getTypeId();
-
-        const ContactSurfaceSet& others = p->second;
-        ContactSurfaceSet::const_iterator q = others.begin();
-        for (; q != others.end(); ++q) {
-            const ContactSurfaceIndex index2 = q->first;
-            const Transform transform2 = 
-                m_surfaces[index2].mobod->getBodyTransform(state)
-                    * m_surfaces[index2].X_BS;
-            const ContactGeometry& geom2 = 
-                m_surfaces[index2].surface->getShape();
-            const ContactGeometryTypeId typeId2 = geom2.getTypeId();
-            if (!hasContactTracker(typeId1,typeId2))
-                continue; // No algorithm available for detecting collisions between these two objects.
-            bool mustReverse;
-            const ContactTracker& tracker = 
-                getContactTracker(typeId1, typeId2, mustReverse);
-
-            // Put the surfaces in the order required by the tracker.
-            const ContactSurfaceIndex trackSurf1 = (mustReverse? index2:index1);
-            const ContactSurfaceIndex trackSurf2 = (mustReverse? index1:index2);
-
-            UntrackedContact untracked; // empty handle in case we need it
-            const Contact* prev = q->second;
-            if (prev && prev->getCondition() == Contact::Broken)
-                prev = 0; // that contact expired
-            if (!prev) { 
-                untracked = UntrackedContact(trackSurf1, trackSurf2);
-                prev = &untracked;
-            }
-            Contact next; // empty handle
-            if (mustReverse)
-                tracker.trackContact
-                   (*prev, transform2,geom2, transform1,geom1, 0/*TODO*/, next);
-            else
-                tracker.trackContact
-                   (*prev, transform1,geom1, transform2,geom2, 0/*TODO*/, next);
-
-            if (!next.isEmpty()) {
-                next.setSurfaces(trackSurf1,trackSurf2);
-                next.setContactId(prev->getCondition()==Contact::Untracked
-                                    ? Contact::createNewContactId()
-                                    : prev->getContactId()); // persistent
-                if (   prev->getCondition()==Contact::Untracked
-                    || prev->getCondition()==Contact::Anticipated)
-                    next.setCondition(Contact::NewContact);
-                else { // was NewContact or Ongoing; now Ongoing or Broken
-                    assert(prev->getCondition()==Contact::NewContact
-                           || prev->getCondition()==Contact::Ongoing);
-                    if (next.getTypeId() != BrokenContact::classTypeId())
-                        next.setCondition(Contact::Ongoing);
-                    // Condition will already by Broken for a BrokenContact
-                }
-                nextActive.adoptContact(next);
-            }
+    // Merge the results in pair order. New ContactIds are handed out here
+    // so that they don't depend on which thread finished first.
+    for (int i=0; i < numPairs; ++i) {
+        Contact& next = results[i];
+        if (next.isEmpty())
+            continue;
+        const Contact* prev = tracked[i].prev;
+        next.setSurfaces(tracked[i].surf1, tracked[i].surf2);
+        next.setContactId(prev ? prev->getContactId() // persistent
+                               : Contact::createNewContactId());
+        if (!prev || prev->getCondition()==Contact::Anticipated)
+            next.setCondition(Contact::NewContact);
+        else { // was NewContact or Ongoing; now Ongoing or Broken
+            assert(prev->getCondition()==Contact::NewContact
+                   || prev->getCondition()==Contact::Ongoing);
+            if (next.getTypeId() != BrokenContact::classTypeId())
+                next.setCondition(Contact::Ongoing);
+            // Condition will already by Broken for a BrokenContact
         }
+        nextActive.adoptContact(next);
     }
+    results.clear(); // the snapshot holds the Contacts now
 
     markDiscreteVarUpdateValueRealized(state, m_activeContactsIx);
 }
@@ -491,6 +597,16 @@ void ensurePredictedContactsUpdated(const State& state) const {
     markDiscreteVarUpdateValueRealized(state, m_predictedContactsIx);
 }
 
+// A SmoothHeightMap remembers the surface patch it used most recently, so
+// can't be tracked for several States at once.
+bool isThreadSafeImpl() const {
+    for (ContactSurfaceIndex surfx(0); surfx < m_surfaces.size(); ++surfx)
+        if (ContactGeometry::SmoothHeightMap::isInstance
+                (m_surfaces[surfx].surface->getShape()))
+            return false;
+    return true;
+}
+
 int realizeSubsystemDynamicsImpl(const State& state) const {
     ensureActiveContactsUpdated(state);
     return 0;
@@ -531,6 +647,14 @@ getContactTracker(ContactGeometryTypeId id1, ContactGeometryTypeId id2,
     return *m_defaultTracker;
 }
 
+void setBroadPhaseMethod(ContactTrackerSubsystem::BroadPhaseMethod method) {
+    invalidateSubsystemTopologyCache();
+    m_broadPhaseMethod = method;
+}
+
+ContactTrackerSubsystem::BroadPhaseMethod getBroadPhaseMethod() const
+{   return m_broadPhaseMethod; }
+
 int getNumSurfaces() const {return m_surfaces.size();}
 int getNumBubbles()  const {return m_bubbles.size();}
 
@@ -547,16 +671,28 @@ friend class ContactTrackerSubsystem;
 // delete it when replacing or destructing.
 TrackerMap          m_contactTrackers;
 ContactTracker*     m_defaultTracker;
+ContactTrackerSubsystem::BroadPhaseMethod m_broadPhaseMethod;
+// Not part of the topology; null unless tracking in parallel.
+TaskScheduler*      m_trackingScheduler;
 
     // TOPOLOGY CACHE
 Array_<Surface,ContactSurfaceIndex> m_surfaces;
 Array_<Bubble,BubbleIndex>          m_bubbles;
 DiscreteVariableIndex               m_activeContactsIx;
 DiscreteVariableIndex               m_predictedContactsIx;
+DiscreteVariableIndex               m_broadPhaseIx;
+CacheEntryIndex                     m_scratchIx;
 };
 
 
 
+void TrackContactsTask::execute(int begin, int end) {
+    for (int i=begin; i < end; ++i)
+        subsys.trackPair(state, pairs[which[i]], results[which[i]]);
+}
+
+
+
 //==============================================================================
 //                        CONTACT TRACKER SUBSYSTEM
 //==============================================================================
@@ -596,6 +732,20 @@ ContactTrackerSubsystem::ContactTrackerSubsystem(MultibodySystem& mbs)
 {   adoptSubsystemGuts(new ContactTrackerSubsystemImpl());
     mbs.adoptSubsystem(*this); } // steal ownership
 
+void ContactTrackerSubsystem::setBroadPhaseMethod(BroadPhaseMethod method)
+{   updImpl().setBroadPhaseMethod(method); }
+
+ContactTrackerSubsystem::BroadPhaseMethod ContactTrackerSubsystem::
+getBroadPhaseMethod() const
+{   return getImpl().getBroadPhaseMethod(); }
+
+void ContactTrackerSubsystem::
+setUseParallelContactTracking(bool useParallel, int numThreads)
+{   updImpl().setUseParallelContactTracking(useParallel, numThreads); }
+
+bool ContactTrackerSubsystem::getUseParallelContactTracking() const
+{   return getImpl().getUseParallelContactTracking(); }
+
 int ContactTrackerSubsystem::getNumSurfaces() const
 {   return getImpl().getNumSurfaces(); }
 
@@ -648,6 +798,25 @@ getPredictedContacts(const State& state) const {
     return getImpl().getNextPredictedContacts(state);
 }
 
+void ContactTrackerSubsystem::
+getBroadPhasePairs(const State& state, 
+                   Array_<std::pair<ContactSurfaceIndex,
+                                    ContactSurfaceIndex> >& pairs) const
+{   pairs.clear();
+    getImpl().appendSurfacePairs(getImpl().getBroadPhase(state)
+                                 .getOverlaps(), pairs); }
+
+void ContactTrackerSubsystem::
+getBroadPhasePairChanges(const State& state, 
+                         Array_<std::pair<ContactSurfaceIndex,
+                                          ContactSurfaceIndex> >& added,
+                         Array_<std::pair<ContactSurfaceIndex,
+                                          ContactSurfaceIndex> >& removed) const
+{   const ContactBroadPhase& broadPhase = getImpl().getBroadPhase(state);
+    added.clear(); removed.clear();
+    getImpl().appendSurfacePairs(broadPhase.getAdded(), added);
+    getImpl().appendSurfacePairs(broadPhase.getRemoved(), removed); }
+
 bool ContactTrackerSubsystem::
 realizeActiveContacts(const State& state, 
                       bool         lastTry,
@@ -27,7 +27,6 @@
 #include "simbody/internal/GeneralContactSubsystem.h"
 #include "simbody/internal/MobilizedBody.h"
 #include "ElasticFoundationForceImpl.h"
-#include <map>
 #include <set>
 
 namespace SimTK {
@@ -67,6 +66,8 @@ void ElasticFoundationForceImpl::setBodyParameters
                         == ContactGeometry::TriangleMesh::classTypeId(), 
         "ElasticFoundationForceImpl", "setBodyParameters",
         "Body %d is not a triangle mesh", (int)bodyIndex);
+    if (parameters.size() <= bodyIndex)
+        parameters.resize(bodyIndex+1);
     parameters[bodyIndex] = 
         Parameters(stiffness, dissipation, staticFriction, dynamicFriction, 
                    viscousFriction);
@@ -89,6 +90,15 @@ void ElasticFoundationForceImpl::setBodyParameters
     subsystem.invalidateSubsystemTopologyCache();
 }
 
+// Every mesh has at least one face, so a surface has parameters exactly when
+// it has springs.
+const ElasticFoundationForceImpl::Parameters* 
+ElasticFoundationForceImpl::findParameters(ContactSurfaceIndex surface) const {
+    if (surface >= parameters.size() || parameters[surface].springArea.empty())
+        return 0;
+    return &parameters[surface];
+}
+
 void ElasticFoundationForceImpl::calcForce
    (const State& state, Vector_<SpatialVec>& bodyForces, 
     Vector_<Vec3>& particleForces, Vector& mobilityForces) const 
@@ -96,101 +106,163 @@ void ElasticFoundationForceImpl::calcForce
     const Array_<Contact>& contacts = subsystem.getContacts(state, set);
     Real& pe = Value<Real>::downcast
                 (subsystem.updCacheEntry(state, energyCacheIndex));
+    SpringScratch& scratch = Value<SpringScratch>::updDowncast
+                (subsystem.updCacheEntry(state, scratchCacheIndex));
+    if (!subsystem.isCacheValueRealized(state, scratchCacheIndex)) {
+        scratch.contactFaces.resize(2*contacts.size());
+        for (int i = 0; i < (int) contacts.size(); i++) {
+            if (!TriangleMeshContact::isInstance(contacts[i]))
+                continue;
+            const TriangleMeshContact& contact = 
+                static_cast<const TriangleMeshContact&>(contacts[i]);
+            const std::set<int>& faces1 = contact.getSurface1Faces();
+            const std::set<int>& faces2 = contact.getSurface2Faces();
+            scratch.contactFaces[2*i].assign(faces1.begin(), faces1.end());
+            scratch.contactFaces[2*i+1].assign(faces2.begin(), faces2.end());
+        }
+        subsystem.markCacheValueRealized(state, scratchCacheIndex);
+    }
     pe = 0.0;
     for (int i = 0; i < (int) contacts.size(); i++) {
-        std::map<ContactSurfaceIndex, Parameters>::const_iterator iter1 = 
-            parameters.find(contacts[i].getSurface1());
-        std::map<ContactSurfaceIndex, Parameters>::const_iterator iter2 = 
-            parameters.find(contacts[i].getSurface2());
+        const Parameters* param1 = findParameters(contacts[i].getSurface1());
+        const Parameters* param2 = findParameters(contacts[i].getSurface2());
 
         // If there are two meshes, scale each one's contributions by 50%.
-        Real areaScale = (iter1==parameters.end() || iter2==parameters.end())
-                         ? Real(1) : Real(0.5);
+        Real areaScale = (param1 == 0 || param2 == 0) ? Real(1) : Real(0.5);
 
-        if (iter1 != parameters.end()) {
+        if (param1 != 0) {
             const TriangleMeshContact& contact = 
                 static_cast<const TriangleMeshContact&>(contacts[i]);
             processContact(state, contact.getSurface1(), 
-                contact.getSurface2(), iter1->second, 
-                contact.getSurface1Faces(), areaScale, bodyForces, pe);
+                contact.getSurface2(), *param1, 
+                scratch.contactFaces[2*i], areaScale, scratch, bodyForces, pe);
         }
 
-        if (iter2 != parameters.end()) {
+        if (param2 != 0) {
             const TriangleMeshContact& contact = 
                 static_cast<const TriangleMeshContact&>(contacts[i]);
             processContact(state, contact.getSurface2(), 
-                contact.getSurface1(), iter2->second, 
-                contact.getSurface2Faces(), areaScale, bodyForces, pe);
+                contact.getSurface1(), *param2, 
+                scratch.contactFaces[2*i+1], areaScale, scratch, bodyForces, 
+                pe);
         }
     }
 }
 
+// The springs are processed in passes over contiguous arrays rather than one
+// spring at a time: the nearest points are found in a single batch, which lets
+// the other object reuse each answer to speed up the next one, and the force
+// loop is then simple arithmetic on the arrays. The two bodies' kinematics are
+// looked up once, and the spring forces are summed into a single spatial
+// force on each body. The arrays are kept in a cache entry so that they don't
+// have to be allocated again for each evaluation. Normals aren't needed, so
+// they aren't computed.
 void ElasticFoundationForceImpl::processContact
    (const State& state, 
     ContactSurfaceIndex meshIndex, ContactSurfaceIndex otherBodyIndex, 
-    const Parameters& param, const std::set<int>& insideFaces,
-    Real areaScale, Vector_<SpatialVec>& bodyForces, Real& pe) const 
+    const Parameters& param, const Array_<int>& insideFaces,
+    Real areaScale, SpringScratch& scratch, Vector_<SpatialVec>& bodyForces, 
+    Real& pe) const 
 {
     const ContactGeometry& otherObject = subsystem.getBodyGeometry(set, otherBodyIndex);
     const MobilizedBody& body1 = subsystem.getBody(set, meshIndex);
     const MobilizedBody& body2 = subsystem.getBody(set, otherBodyIndex);
-    const Transform t1g = body1.getBodyTransform(state)*subsystem.getBodyTransform(set, meshIndex); // mesh to ground
-    const Transform t2g = body2.getBodyTransform(state)*subsystem.getBodyTransform(set, otherBodyIndex); // other object to ground
+    const Transform& X_GB1 = body1.getBodyTransform(state);
+    const Transform& X_GB2 = body2.getBodyTransform(state);
+    const Transform t1g = X_GB1*subsystem.getBodyTransform(set, meshIndex); // mesh to ground
+    const Transform t2g = X_GB2*subsystem.getBodyTransform(set, otherBodyIndex); // other object to ground
     const Transform t12 = ~t2g*t1g; // mesh to other object
 
-    // Loop over all the springs, and evaluate the force from each one.
+    // The velocity of body2 relative to body1 at a Ground point p is
+    // v0 + w % p, since each body's station velocity is v_B + w_B % (p - o_B).
 
-    for (std::set<int>::const_iterator iter = insideFaces.begin(); 
-                                       iter != insideFaces.end(); ++iter) {
-        int face = *iter;
-        UnitVec3 normal;
-        bool inside;
-        Vec3 nearestPoint = otherObject.findNearestPoint(t12*param.springPosition[face], inside, normal);
-        if (!inside)
+    const SpatialVec& V_GB1 = body1.getBodyVelocity(state);
+    const SpatialVec& V_GB2 = body2.getBodyVelocity(state);
+    const Vec3 w = V_GB2[0] - V_GB1[0];
+    const Vec3 v0 = (V_GB2[1] - V_GB2[0] % X_GB2.p()) 
+                  - (V_GB1[1] - V_GB1[0] % X_GB1.p());
+
+    // Gather the springs, find the nearest point on the other object to all of
+    // them at once, and keep only the ones that are inside it. Then move the
+    // springs and their nearest points into Ground.
+
+    Array_<int>&  face    = scratch.face;
+    Array_<Vec3>& nearest = scratch.nearest;
+    Array_<Vec3>& spring  = scratch.spring;
+    face.resize(insideFaces.size());
+    scratch.position.resize(insideFaces.size());
+    for (unsigned i = 0; i < insideFaces.size(); i++)
+        scratch.position[i] = t12*param.springPosition[insideFaces[i]];
+    otherObject.findNearestPoints(scratch.position, nearest, scratch.inside);
+    int numSprings = 0;
+    for (unsigned i = 0; i < insideFaces.size(); i++) {
+        if (!scratch.inside[i])
             continue;
-        
+        face[numSprings] = insideFaces[i];
+        nearest[numSprings] = t2g*nearest[i];
+        ++numSprings;
+    }
+    spring.resize(numSprings);
+    for (int i = 0; i < numSprings; i++)
+        spring[i] = t1g*param.springPosition[face[i]];
+
+    // Evaluate the force from each spring, accumulating the total force and
+    // its moment about body1's origin.
+
+    const Real stiffness = param.stiffness, dissipation = param.dissipation;
+    const Real us = param.staticFriction, ud = param.dynamicFriction, 
+               uv = param.viscousFriction;
+    Vec3 totalForce(0), totalMoment(0);
+    Real energy = 0;
+    for (int i = 0; i < numSprings; i++) {
         // Find how much the spring is displaced.
-        
-        nearestPoint = t2g*nearestPoint;
-        const Vec3 springPosInGround = t1g*param.springPosition[face];
-        const Vec3 displacement = nearestPoint-springPosInGround;
-        const Real distance = displacement.norm();
-        if (distance == 0.0)
+
+        const Vec3 displacement = nearest[i]-spring[i];
+        const Real distanceSqr = displacement.normSqr();
+        if (distanceSqr == 0.0)
             continue;
+        const Real distance = std::sqrt(distanceSqr);
         const Vec3 forceDir = displacement/distance;
-        
+
         // Calculate the relative velocity of the two bodies at the contact point.
-        
-        const Vec3 station1 = body1.findStationAtGroundPoint(state, nearestPoint);
-        const Vec3 station2 = body2.findStationAtGroundPoint(state, nearestPoint);
-        const Vec3 v1 = body1.findStationVelocityInGround(state, station1);
-        const Vec3 v2 = body2.findStationVelocityInGround(state, station2);
-        const Vec3 v = v2-v1;
+
+        const Vec3 v = v0 + w % nearest[i];
         const Real vnormal = dot(v, forceDir);
         const Vec3 vtangent = v-vnormal*forceDir;
-        
+
         // Calculate the damping force.
-        
-        const Real area = areaScale * param.springArea[face];
-        const Real f = param.stiffness*area*distance*(1+param.dissipation*vnormal);
-        Vec3 force = (f > 0 ? f*forceDir : Vec3(0));
-        
+
+        const Real area = areaScale * param.springArea[face[i]];
+        const Real f = stiffness*area*distance*(1+dissipation*vnormal);
+        energy += stiffness*area*distanceSqr/2;
+        if (f <= 0)
+            continue;
+        Vec3 force = f*forceDir;
+
         // Calculate the friction force.
-        
+
         const Real vslip = vtangent.norm();
-        if (f > 0 && vslip != 0) {
+        if (vslip != 0) {
             const Real vrel = vslip/transitionVelocity;
             const Real ffriction = 
                 f*(std::min(vrel, Real(1))
-                 *(param.dynamicFriction+2*(param.staticFriction-param.dynamicFriction)
-                 /(1+vrel*vrel))+param.viscousFriction*vslip);
+                 *(ud+2*(us-ud)/(1+vrel*vrel))+uv*vslip);
             force += ffriction*vtangent/vslip;
         }
 
-        body1.applyForceToBodyPoint(state, station1, force, bodyForces);
-        body2.applyForceToBodyPoint(state, station2, -force, bodyForces);
-        pe += param.stiffness*area*displacement.normSqr()/2;
+        totalForce += force;
+        totalMoment += (nearest[i]-X_GB1.p()) % force;
     }
+
+    // Apply the total to each body; body2 gets the opposite force, whose 
+    // moment about its own origin differs by the shift between the origins.
+
+    bodyForces[body1.getMobilizedBodyIndex()] += 
+        SpatialVec(totalMoment, totalForce);
+    bodyForces[body2.getMobilizedBodyIndex()] -= 
+        SpatialVec(totalMoment + (X_GB1.p()-X_GB2.p()) % totalForce, 
+                   totalForce);
+    pe += energy;
 }
 
 Real ElasticFoundationForceImpl::calcPotentialEnergy(const State& state) const {
@@ -201,6 +273,8 @@ Real ElasticFoundationForceImpl::calcPotentialEnergy(const State& state) const {
 void ElasticFoundationForceImpl::realizeTopology(State& state) const {
     energyCacheIndex = subsystem.allocateCacheEntry
                         (state, Stage::Dynamics, new Value<Real>());
+    scratchCacheIndex = subsystem.allocateLazyCacheEntry
+                        (state, Stage::Position, new Value<SpringScratch>());
 }
 
 
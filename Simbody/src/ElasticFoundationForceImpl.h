@@ -34,6 +34,7 @@ namespace SimTK {
 class ElasticFoundationForceImpl : public ForceImpl {
 public:
     class Parameters;
+    class SpringScratch;
     ElasticFoundationForceImpl(GeneralContactSubsystem& subystem, 
                                ContactSetIndex set);
     ElasticFoundationForceImpl* clone() const {
@@ -49,16 +50,22 @@ public:
     void processContact(const State& state, ContactSurfaceIndex meshIndex, 
                         ContactSurfaceIndex otherBodyIndex, 
                         const Parameters& param, 
-                        const std::set<int>& insideFaces,
-                        Real areaScale,
+                        const Array_<int>& insideFaces,
+                        Real areaScale, SpringScratch& scratch,
                         Vector_<SpatialVec>& bodyForces, Real& pe) const;
 private:
     friend class ElasticFoundationForce;
+    // Get the parameters for a surface, or null if none have been set.
+    const Parameters* findParameters(ContactSurfaceIndex surface) const;
+
     const GeneralContactSubsystem& subsystem;
     const ContactSetIndex set;
-    std::map<ContactSurfaceIndex, Parameters> parameters;
+    // Indexed by surface; surfaces with no springs haven't been given
+    // parameters.
+    Array_<Parameters, ContactSurfaceIndex> parameters;
     Real transitionVelocity;
     mutable CacheEntryIndex energyCacheIndex;
+    mutable CacheEntryIndex scratchCacheIndex;
 };
 
 class ElasticFoundationForceImpl::Parameters {
@@ -74,6 +81,23 @@ public:
     Array_<Real> springArea;
 };
 
+// Working arrays for the springs of one mesh that are in contact. This lives
+// in a cache entry and is reused by every evaluation, so once the arrays have
+// grown no memory is allocated.
+// The contacts only change when the positions do, so the faces of each one are
+// copied out of the contact once per Position stage; the other arrays are 
+// overwritten on every evaluation.
+class ElasticFoundationForceImpl::SpringScratch {
+public:
+    Array_<Array_<int> > contactFaces;  // surface1 then surface2 faces of
+                                        //   each contact, in order
+    Array_<int>         face;       // face at which each spring is located
+    Array_<Vec3>        position;   // spring in the other surface's frame
+    Array_<Vec3>        nearest;    // nearest point on the other surface
+    Array_<bool>        inside;     // whether the spring is inside it
+    Array_<Vec3>        spring;     // spring position in Ground
+};
+
 } // namespace SimTK
 
 #endif // SimTK_SIMBODY_HUNT_CROSSLEY_FORCE_IMPL_H_
@@ -49,6 +49,16 @@ public:
     virtual bool dependsOnlyOnPositions() const {
         return false;
     }
+    // Return true if calcForce() may be called concurrently with the 
+    // calcForce() methods of other force elements, from a different thread,
+    // when GeneralForceSubsystem is evaluating forces in parallel. That 
+    // requires that calcForce() write only into the arrays it is given and
+    // not modify anything else, including lazily-evaluated cache entries. 
+    // The default is false, so force elements run serially unless they 
+    // have been checked and marked safe.
+    virtual bool isThreadSafe() const {
+        return false;
+    }
     ForceIndex getForceIndex() const {return index;}
     const GeneralForceSubsystem& getForceSubsystem() const 
     {   assert(forces); return *forces; }
@@ -110,6 +120,9 @@ public:
     TwoPointLinearSpringImpl* clone() const {
         return new TwoPointLinearSpringImpl(*this);
     }
+    bool isThreadSafe() const {
+        return true;
+    }
     bool dependsOnlyOnPositions() const {
         return true;
     }
@@ -133,6 +146,9 @@ public:
     TwoPointLinearDamperImpl* clone() const {
         return new TwoPointLinearDamperImpl(*this);
     }
+    bool isThreadSafe() const {
+        return true;
+    }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const;
     Real calcPotentialEnergy(const State& state) const;
 private:
@@ -153,6 +169,9 @@ public:
     TwoPointConstantForceImpl* clone() const {
         return new TwoPointConstantForceImpl(*this);
     }
+    bool isThreadSafe() const {
+        return true;
+    }
     bool dependsOnlyOnPositions() const {
         return true;
     }
@@ -189,6 +208,7 @@ friend class MobilityLinearSpring;
 
     MobilityLinearSpringImpl* clone() const OVERRIDE_11
     {   return new MobilityLinearSpringImpl(*this); }
+    bool isThreadSafe() const OVERRIDE_11 {return true;}
     bool dependsOnlyOnPositions() const OVERRIDE_11 {return true;}
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, 
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const
@@ -239,6 +259,7 @@ friend class MobilityLinearDamper;
 
     MobilityLinearDamperImpl* clone() const OVERRIDE_11 
     {   return new MobilityLinearDamperImpl(*this); }
+    bool isThreadSafe() const OVERRIDE_11 {return true;}
 
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, 
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const
@@ -291,6 +312,7 @@ friend class MobilityConstantForce;
 
     MobilityConstantForceImpl* clone() const OVERRIDE_11 
     {   return new MobilityConstantForceImpl(*this); }
+    bool isThreadSafe() const OVERRIDE_11 {return true;}
 
     // Has to wait for Dynamics stage because that's all that gets invalidated
     // if the constant force is changed.
@@ -349,6 +371,7 @@ friend class MobilityLinearStop;
     // Implementation of virtual methods from ForceImpl:
     MobilityLinearStopImpl* clone() const OVERRIDE_11 
     {   return new MobilityLinearStopImpl(*this); }
+    bool isThreadSafe() const OVERRIDE_11 {return true;}
     bool dependsOnlyOnPositions() const OVERRIDE_11 {return false;}
 
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
@@ -499,6 +522,9 @@ public:
     ConstantForceImpl* clone() const {
         return new ConstantForceImpl(*this);
     }
+    bool isThreadSafe() const {
+        return true;
+    }
     bool dependsOnlyOnPositions() const {
         return true;
     }
@@ -521,6 +547,9 @@ public:
     ConstantTorqueImpl* clone() const {
         return new ConstantTorqueImpl(*this);
     }
+    bool isThreadSafe() const {
+        return true;
+    }
     bool dependsOnlyOnPositions() const {
         return true;
     }
@@ -543,6 +572,9 @@ public:
     GlobalDamperImpl* clone() const {
         return new GlobalDamperImpl(*this);
     }
+    bool isThreadSafe() const {
+        return true;
+    }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const;
     Real calcPotentialEnergy(const State& state) const;
 private:
@@ -561,6 +593,9 @@ public:
     UniformGravityImpl* clone() const {
         return new UniformGravityImpl(*this);
     }
+    bool isThreadSafe() const {
+        return true;
+    }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const;
     Real calcPotentialEnergy(const State& state) const;
     Vec3 getGravity() const {
@@ -597,6 +632,9 @@ public:
     bool dependsOnlyOnPositions() const {
         return implementation->dependsOnlyOnPositions();
     }
+    bool isThreadSafe() const {
+        return implementation->isThreadSafe();
+    }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, 
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) 
                    const OVERRIDE_11;
@@ -95,10 +95,11 @@ friend class Force::Gravity;
     GravityImpl(const SimbodyMatterSubsystem&   matter,
                 const Vec3&                     gravityVec,
                 Real                            zeroHeight)
-    :   matter(matter)
-    {   // Invoke the general constructor using system up direction. 
-        new (this) GravityImpl(matter, -matter.getSystem().getUpDirection(),
-                               gravityVec.norm(), zeroHeight);
+    :   matter(matter), defDirection(-matter.getSystem().getUpDirection()),
+        defMagnitude(gravityVec.norm()), defZeroHeight(zeroHeight), 
+        defMobodIsImmune(matter.getNumBodies(), false),
+        numEvaluations(0)
+    {   defMobodIsImmune.front() = true; // Ground is always immune
         if (defMagnitude > 0) 
             defDirection=UnitVec3(gravityVec/defMagnitude,true);
     }
@@ -108,11 +109,11 @@ friend class Force::Gravity;
     GravityImpl(const SimbodyMatterSubsystem&   matter,
                 Real                            magnitude,
                 Real                            zeroHeight)
-    :   matter(matter)
-    {   // Invoke the general constructor using system up direction. 
-        new (this) GravityImpl(matter, -matter.getSystem().getUpDirection(),
-                               magnitude, zeroHeight);
-    }
+    :   matter(matter), defDirection(-matter.getSystem().getUpDirection()),
+        defMagnitude(magnitude), defZeroHeight(zeroHeight), 
+        defMobodIsImmune(matter.getNumBodies(), false),
+        numEvaluations(0)
+    {   defMobodIsImmune.front() = true; } // Ground is always immune
 
     void setMobodIsImmuneByDefault(MobilizedBodyIndex mbx, bool isImmune) {
         if (mbx == 0) return; // can't change Ground's innate immunity
@@ -193,7 +194,9 @@ friend class Force::Gravity;
     DiscreteVariableIndex           parametersIx;
     CacheEntryIndex                 forceCacheIx;
 
-    mutable long long               numEvaluations;
+    // This is bumped from const methods, possibly by several threads at once
+    // when different States are being realized concurrently.
+    mutable AtomicLongLong          numEvaluations;
 };
 
 
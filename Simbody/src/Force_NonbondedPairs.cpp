@@ -0,0 +1,461 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+
+#include "simbody/internal/common.h"
+#include "simbody/internal/MobilizedBody.h"
+#include "simbody/internal/MultibodySystem.h"
+#include "simbody/internal/SimbodyMatterSubsystem.h"
+#include "simbody/internal/Force_NonbondedPairs.h"
+
+#include "ForceImpl.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+namespace SimTK {
+
+//==============================================================================
+//                           NEIGHBOR LIST
+//==============================================================================
+// This is the Verlet list of station pairs within cutoff+skin of each other,
+// along with the station locations used to build it. The mixed pair
+// parameters are stored along with each pair, in separate arrays, so that the
+// force loop just streams through them.
+namespace {
+struct NeighborList {
+    NeighborList() : numBuilds(0) {}
+
+    Array_<Vec3>    builtPositions;     // station locations in G at build time
+    Array_<int>     first, second;      // station pair, first < second
+    Array_<Real>    a;      // d^2 (LennardJones) or d (SoftSphere)
+    Array_<Real>    b;      // 4e (LennardJones) or e (SoftSphere)
+    Array_<Real>    qq;     // kc*qi*qj
+    Array_<Real>    shift;  // pair energy at the cutoff
+    int             numBuilds;
+};
+
+std::ostream& operator<<(std::ostream& o, const NeighborList& list) {
+    return o << "NeighborList(" << list.first.size() << " pairs, "
+             << list.numBuilds << " builds)";
+}
+
+// These are the per-pair and per-station forces, kept per thread so that
+// they don't have to be reallocated for every force evaluation. They aren't
+// kept in the State since calcForce() may run on a worker thread alongside
+// other force elements, and so mustn't write into the State.
+struct ForceScratch {
+    Array_<Vec3>    pairForces;     // on the first station of each pair
+    Array_<Vec3>    stationForces;
+};
+
+ThreadLocal<ForceScratch> forceScratch;
+
+// A station's grid cell; these are sorted to bin the stations.
+struct CellEntry {
+    CellEntry() {}
+    CellEntry(const Vec3& p, Real cellSize, int station) : station(station) {
+        for (int k=0; k < 3; ++k)
+            cell[k] = (long long)std::floor(p[k]/cellSize);
+    }
+    bool operator<(const CellEntry& other) const {
+        return    cell[0] != other.cell[0] ? cell[0] < other.cell[0]
+                : cell[1] != other.cell[1] ? cell[1] < other.cell[1]
+                : cell[2] <  other.cell[2];
+    }
+    long long   cell[3];
+    int         station;
+};
+}
+
+//==============================================================================
+//                      FORCE :: NONBONDED PAIRS IMPL
+//==============================================================================
+// This is the hidden implementation class for Force::NonbondedPairs.
+class Force::NonbondedPairsImpl : public ForceImpl {
+friend class Force::NonbondedPairs;
+public:
+    NonbondedPairsImpl(Real cutoff, Real skin,
+                       Force::NonbondedPairs::Potential potential)
+    :   cutoff(cutoff), skin(skin), potential(potential),
+        coulombConstant(1) {}
+
+    NonbondedPairsImpl* clone() const {return new NonbondedPairsImpl(*this);}
+
+    // The forces depend only on the station locations so the subsystem can
+    // cache them; and calcForce() writes only into its arguments and its
+    // own thread's scratch space.
+    bool dependsOnlyOnPositions() const {return true;}
+    bool isThreadSafe() const {return true;}
+
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+                   Vector_<Vec3>& particleForces, Vector& mobilityForces) const;
+    Real calcPotentialEnergy(const State& state) const;
+
+    void realizeTopology(State& state) const;
+    void realizePosition(const State& state) const;
+
+    // Return the neighbor list for use with this State; that's the
+    // auto-update value if a rebuild has been done, otherwise the one
+    // carried in the State.
+    const NeighborList& getNeighborList(const State& state) const {
+        const GeneralForceSubsystem& forces = getForceSubsystem();
+        return Value<NeighborList>::downcast
+           (forces.isDiscreteVarUpdateValueRealized(state, listIndex)
+            ? forces.getDiscreteVarUpdateValue(state, listIndex)
+            : forces.getDiscreteVariable(state, listIndex));
+    }
+
+    // Station locations in Ground, available after Stage::Position.
+    const Array_<Vec3>& getStationPositions(const State& state) const {
+        return Value<Array_<Vec3> >::downcast
+           (getForceSubsystem().getCacheEntry(state, positionsIndex));
+    }
+
+private:
+    bool needsRebuild(const Array_<Vec3>& p, const NeighborList& list) const;
+    void buildNeighborList(const Array_<Vec3>& p, NeighborList& list) const;
+    void calcPairTerms(const NeighborList& list, const Array_<Vec3>& p,
+                       Array_<Vec3>* pairForces, Real* energy) const;
+    bool isExcluded(int i, int j) const;
+
+    const SimbodyMatterSubsystem& getMatter() const {
+        return getForceSubsystem().getMultibodySystem().getMatterSubsystem();
+    }
+
+    // TOPOLOGY "STATE"
+    const Real                          cutoff, skin;
+    const Force::NonbondedPairs::Potential potential;
+    Real                                coulombConstant;
+
+    // Per-station parameters.
+    Array_<MobilizedBodyIndex>          body;
+    Array_<Vec3>                        station;    // in body frame
+    Array_<Real>                        charge, radius, strength;
+    Array_<int>                         clique;
+
+    // Pairs of bodies (lower index first) whose stations don't interact.
+    std::set<std::pair<MobilizedBodyIndex,MobilizedBodyIndex> >
+                                        excludedBodyPairs;
+
+    // TOPOLOGY "CACHE"
+    DiscreteVariableIndex               listIndex;      // NeighborList
+    CacheEntryIndex                     positionsIndex; // Array_<Vec3>
+};
+
+void Force::NonbondedPairsImpl::realizeTopology(State& state) const {
+    // Make these writable just here where we need to fill in the Topology
+    // "cache" variables; after this they are const.
+    Force::NonbondedPairsImpl* mutableThis =
+        const_cast<Force::NonbondedPairsImpl*>(this);
+
+    // The neighbor list update is computed from the station locations, so
+    // depends on Position stage.
+    mutableThis->listIndex =
+        getForceSubsystem().allocateAutoUpdateDiscreteVariable(state,
+            Stage::Dynamics, new Value<NeighborList>(), Stage::Position);
+    mutableThis->positionsIndex =
+        getForceSubsystem().allocateCacheEntry(state, Stage::Position,
+            new Value<Array_<Vec3> >());
+}
+
+// Find where the stations are, then see whether the neighbor list we've been
+// carrying along is still good for this configuration.
+void Force::NonbondedPairsImpl::realizePosition(const State& state) const {
+    const GeneralForceSubsystem& forces = getForceSubsystem();
+    const SimbodyMatterSubsystem& matter = getMatter();
+    Array_<Vec3>& p = Value<Array_<Vec3> >::updDowncast
+                            (forces.updCacheEntry(state, positionsIndex));
+    p.resize(station.size());
+    for (int i=0; i < (int)station.size(); ++i)
+        p[i] = matter.getMobilizedBody(body[i]).getBodyTransform(state)
+               * station[i];
+
+    const NeighborList& current = Value<NeighborList>::downcast
+                            (forces.getDiscreteVariable(state, listIndex));
+    if (!needsRebuild(p, current))
+        return;
+
+    NeighborList& next = Value<NeighborList>::updDowncast
+                            (forces.updDiscreteVarUpdateValue(state, listIndex));
+    buildNeighborList(p, next);
+    next.numBuilds = current.numBuilds + 1;
+    forces.markDiscreteVarUpdateValueRealized(state, listIndex);
+}
+
+// No pair that was left off the list can have come within the cutoff unless
+// some station has moved more than half the skin.
+bool Force::NonbondedPairsImpl::
+needsRebuild(const Array_<Vec3>& p, const NeighborList& list) const {
+    if (list.builtPositions.size() != p.size())
+        return true;
+    const Real maxMove2 = square(skin/2);
+    for (int i=0; i < (int)p.size(); ++i)
+        if ((p[i] - list.builtPositions[i]).normSqr() > maxMove2)
+            return true;
+    return false;
+}
+
+bool Force::NonbondedPairsImpl::isExcluded(int i, int j) const {
+    if (body[i] == body[j])
+        return true;
+    if (clique[i] >= 0 && clique[i] == clique[j])
+        return true;
+    if (excludedBodyPairs.empty())
+        return false;
+    const std::pair<MobilizedBodyIndex,MobilizedBodyIndex> bodies =
+        body[i] < body[j] ? std::make_pair(body[i], body[j])
+                          : std::make_pair(body[j], body[i]);
+    return excludedBodyPairs.count(bodies) != 0;
+}
+
+// Bin the stations into cubic cells whose size is the list distance, so that
+// a station's neighbors must be in its own cell or one of the 26 cells
+// around it. Then for each occupied cell, look in each of those neighboring
+// cells for pairs within the list distance.
+void Force::NonbondedPairsImpl::
+buildNeighborList(const Array_<Vec3>& p, NeighborList& list) const {
+    const int  n = (int)p.size();
+    const Real listDistance = cutoff + skin;
+    const Real listDistance2 = square(listDistance);
+
+    list.builtPositions = p;
+    list.first.clear(); list.second.clear();
+    list.a.clear(); list.b.clear(); list.qq.clear(); list.shift.clear();
+
+    Array_<CellEntry> cells(n);
+    for (int i=0; i < n; ++i)
+        cells[i] = CellEntry(p[i], listDistance, i);
+    std::sort(cells.begin(), cells.end());
+
+    for (int begin=0; begin < n; ) {
+        int end = begin+1;
+        while (end < n && !(cells[begin] < cells[end]))
+            ++end;
+
+        for (int dx=-1; dx <= 1; ++dx)
+        for (int dy=-1; dy <= 1; ++dy)
+        for (int dz=-1; dz <= 1; ++dz) {
+            CellEntry neighbor = cells[begin];
+            neighbor.cell[0] += dx; neighbor.cell[1] += dy;
+            neighbor.cell[2] += dz;
+            const std::pair<const CellEntry*,const CellEntry*> range =
+                std::equal_range(cells.cbegin(), cells.cend(), neighbor);
+
+            for (int c1=begin; c1 < end; ++c1) {
+                const int i = cells[c1].station;
+                for (const CellEntry* c2=range.first; c2 != range.second; ++c2) {
+                    const int j = c2->station;
+                    if (j <= i || (p[i]-p[j]).normSqr() > listDistance2
+                        || isExcluded(i, j))
+                        continue;
+                    list.first.push_back(i);
+                    list.second.push_back(j);
+                }
+            }
+        }
+        begin = end;
+    }
+
+    // Fill in the mixed parameters for each pair.
+    const int nPairs = (int)list.first.size();
+    list.a.resize(nPairs); list.b.resize(nPairs);
+    list.qq.resize(nPairs); list.shift.resize(nPairs);
+    for (int k=0; k < nPairs; ++k) {
+        const int i = list.first[k], j = list.second[k];
+        const Real d = radius[i] + radius[j];
+        const Real e = std::sqrt(strength[i]*strength[j]);
+        list.qq[k] = coulombConstant*charge[i]*charge[j];
+        list.shift[k] = list.qq[k]/cutoff;
+        if (potential == Force::NonbondedPairs::LennardJones) {
+            list.a[k] = d*d;
+            list.b[k] = 4*e;
+            const Real s6 = cube(list.a[k]/square(cutoff));
+            list.shift[k] += list.b[k]*(s6*s6 - s6);
+        } else {
+            list.a[k] = d;
+            list.b[k] = e;
+        }
+    }
+}
+
+// Calculate the force on the first station of each pair and/or the total
+// energy. Pairs beyond the cutoff, and coincident stations whose force
+// direction is undefined, are masked out rather than skipped so that the
+// loops have no branches.
+void Force::NonbondedPairsImpl::
+calcPairTerms(const NeighborList& list, const Array_<Vec3>& p,
+              Array_<Vec3>* pairForces, Real* energy) const
+{
+    const int nPairs = (int)list.first.size();
+    const Real cutoff2 = square(cutoff);
+    const int*  first  = list.first.cbegin();
+    const int*  second = list.second.cbegin();
+    const Real* a      = list.a.cbegin();
+    const Real* b      = list.b.cbegin();
+    const Real* qq     = list.qq.cbegin();
+    const Real* shift  = list.shift.cbegin();
+
+    if (pairForces) pairForces->resize(nPairs);
+    Real pe = 0;
+    if (potential == Force::NonbondedPairs::LennardJones) {
+        for (int k=0; k < nPairs; ++k) {
+            const Vec3 r = p[first[k]] - p[second[k]];
+            const Real r2 = r.normSqr();
+            const Real inside = r2 < cutoff2 && r2 > 0 ? Real(1) : Real(0);
+            const Real rinv2 = 1/(r2 > 0 ? r2 : Real(1));
+            const Real rinv = std::sqrt(rinv2);
+            const Real s6 = cube(a[k]*rinv2);
+            const Real fOverR =
+                inside*(qq[k]*rinv + b[k]*(12*s6*s6 - 6*s6))*rinv2;
+            if (pairForces) (*pairForces)[k] = fOverR*r;
+            pe += inside*(qq[k]*rinv + b[k]*(s6*s6 - s6) - shift[k]);
+        }
+    } else {
+        for (int k=0; k < nPairs; ++k) {
+            const Vec3 r = p[first[k]] - p[second[k]];
+            const Real r2 = r.normSqr();
+            const Real inside = r2 < cutoff2 && r2 > 0 ? Real(1) : Real(0);
+            const Real rinv2 = 1/(r2 > 0 ? r2 : Real(1));
+            const Real rinv = std::sqrt(rinv2);
+            const Real overlap = std::max(a[k] - r2*rinv, Real(0));
+            const Real fOverR =
+                inside*(qq[k]*rinv2 + b[k]*overlap)*rinv;
+            if (pairForces) (*pairForces)[k] = fOverR*r;
+            pe += inside*(qq[k]*rinv + b[k]*overlap*overlap/2 - shift[k]);
+        }
+    }
+    if (energy) *energy = pe;
+}
+
+void Force::NonbondedPairsImpl::
+calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+          Vector_<Vec3>& particleForces, Vector& mobilityForces) const
+{
+    const NeighborList& list = getNeighborList(state);
+    const Array_<Vec3>& p = getStationPositions(state);
+    ForceScratch& scratch = forceScratch.upd();
+    Array_<Vec3>& pairForces = scratch.pairForces;
+    calcPairTerms(list, p, &pairForces, 0);
+
+    // Scatter the pair forces to the stations, then shift them to the body
+    // origins.
+    Array_<Vec3>& stationForces = scratch.stationForces;
+    stationForces.resize(p.size());
+    stationForces.fill(Vec3(0));
+    for (int k=0; k < (int)pairForces.size(); ++k) {
+        stationForces[list.first[k]]  += pairForces[k];
+        stationForces[list.second[k]] -= pairForces[k];
+    }
+    const SimbodyMatterSubsystem& matter = getMatter();
+    for (int i=0; i < (int)p.size(); ++i) {
+        const Vec3& p_GB =
+            matter.getMobilizedBody(body[i]).getBodyOriginLocation(state);
+        bodyForces[body[i]] += SpatialVec((p[i]-p_GB) % stationForces[i],
+                                          stationForces[i]);
+    }
+}
+
+Real Force::NonbondedPairsImpl::calcPotentialEnergy(const State& state) const {
+    Real pe;
+    calcPairTerms(getNeighborList(state), getStationPositions(state), 0, &pe);
+    return pe;
+}
+
+//==============================================================================
+//                        FORCE :: NONBONDED PAIRS
+//==============================================================================
+
+SimTK_INSERT_DERIVED_HANDLE_DEFINITIONS(Force::NonbondedPairs,
+                                        Force::NonbondedPairsImpl, Force);
+
+Force::NonbondedPairs::NonbondedPairs
+   (GeneralForceSubsystem& forces, Real cutoff, Real skin,
+    Potential potential)
+:   Force(new NonbondedPairsImpl(cutoff, skin, potential))
+{
+    SimTK_APIARGCHECK1_ALWAYS(cutoff > 0,
+        "Force::NonbondedPairs","ctor", "Illegal cutoff %g.", cutoff);
+    SimTK_APIARGCHECK1_ALWAYS(skin >= 0,
+        "Force::NonbondedPairs","ctor", "Illegal skin %g.", skin);
+
+    updImpl().setForceSubsystem(forces, forces.adoptForce(*this));
+}
+
+int Force::NonbondedPairs::addStation
+   (const MobilizedBody& body, const Vec3& station, Real charge, Real radius,
+    Real strength, int clique)
+{
+    SimTK_APIARGCHECK1_ALWAYS(radius >= 0,
+        "Force::NonbondedPairs","addStation", "Illegal radius %g.", radius);
+    SimTK_APIARGCHECK1_ALWAYS(strength >= 0,
+        "Force::NonbondedPairs","addStation", "Illegal strength %g.", strength);
+
+    getImpl().invalidateTopologyCache();
+    NonbondedPairsImpl& impl = updImpl();
+    impl.body.push_back(body.getMobilizedBodyIndex());
+    impl.station.push_back(station);
+    impl.charge.push_back(charge);
+    impl.radius.push_back(radius);
+    impl.strength.push_back(strength);
+    impl.clique.push_back(clique);
+    return (int)impl.station.size() - 1;
+}
+
+Force::NonbondedPairs& Force::NonbondedPairs::excludeBodyPair
+   (const MobilizedBody& body1, const MobilizedBody& body2)
+{
+    const MobilizedBodyIndex mbx1 = body1.getMobilizedBodyIndex();
+    const MobilizedBodyIndex mbx2 = body2.getMobilizedBodyIndex();
+    getImpl().invalidateTopologyCache();
+    updImpl().excludedBodyPairs.insert(mbx1 < mbx2 ? std::make_pair(mbx1, mbx2)
+                                                   : std::make_pair(mbx2, mbx1));
+    return *this;
+}
+
+Force::NonbondedPairs& Force::NonbondedPairs::
+setCoulombConstant(Real coulombConstant) {
+    getImpl().invalidateTopologyCache();
+    updImpl().coulombConstant = coulombConstant;
+    return *this;
+}
+
+int Force::NonbondedPairs::getNumStations() const
+{   return (int)getImpl().station.size(); }
+Real Force::NonbondedPairs::getCutoff() const
+{   return getImpl().cutoff; }
+Real Force::NonbondedPairs::getSkin() const
+{   return getImpl().skin; }
+Force::NonbondedPairs::Potential Force::NonbondedPairs::getPotential() const
+{   return getImpl().potential; }
+Real Force::NonbondedPairs::getCoulombConstant() const
+{   return getImpl().coulombConstant; }
+
+int Force::NonbondedPairs::getNumNeighborPairs(const State& state) const
+{   return (int)getImpl().getNeighborList(state).first.size(); }
+int Force::NonbondedPairs::getNumNeighborListBuilds(const State& state) const
+{   return getImpl().getNeighborList(state).numBuilds; }
+
+} // namespace SimTK
@@ -28,6 +28,8 @@
 #include "simbody/internal/MultibodySystem.h"
 #include "simbody/internal/SimbodyMatterSubsystem.h"
 
+#include "ContactBroadPhase.h"
+
 #include <algorithm>
 
 namespace SimTK {
@@ -47,24 +49,13 @@ public:
     mutable Array_<Real,ContactSurfaceIndex>    sphereRadii;
 };
 
-class ContactBodyExtent {
-public:
-    ContactBodyExtent(Real start, Real end, ContactSurfaceIndex index) 
-    :   start(start), end(end), index(index) {}
-    ContactBodyExtent() {}
-    bool operator<(const ContactBodyExtent& e) const 
-    {   return start < e.start; }
-    Real start, end;
-    ContactSurfaceIndex index;
-};
-
-
 //==============================================================================
 //                      GENERAL CONTACT SUBSYSTEM IMPL
 //==============================================================================
 class GeneralContactSubsystemImpl : public Subsystem::Guts {
 public:
-    GeneralContactSubsystemImpl() {}
+    GeneralContactSubsystemImpl() 
+    :   broadPhaseMethod(ContactTrackerSubsystem::SweepAndPrune) {}
 
     GeneralContactSubsystemImpl* cloneImpl() const {
         return new GeneralContactSubsystemImpl(*this);
@@ -133,9 +124,22 @@ public:
         return contacts[set];
     }
     
+    void setBroadPhaseMethod(ContactTrackerSubsystem::BroadPhaseMethod method) {
+        invalidateSubsystemTopologyCache();
+        broadPhaseMethod = method;
+    }
+
+    ContactTrackerSubsystem::BroadPhaseMethod getBroadPhaseMethod() const {
+        return broadPhaseMethod;
+    }
+    
     int realizeSubsystemTopologyImpl(State& state) const {
         contactsCacheIndex = state.allocateCacheEntry(getMySubsystemIndex(), Stage::Dynamics, new Value<Array_<Array_<Contact> > >());
         contactsValidCacheIndex = state.allocateCacheEntry(getMySubsystemIndex(), Stage::Position, new Value<bool>());
+        // One broad phase per contact set, carried from step to step.
+        broadPhaseIndex = allocateAutoUpdateDiscreteVariable(state, Stage::Dynamics, 
+            new Value<Array_<ContactBroadPhase> >(Array_<ContactBroadPhase>(sets.size(), ContactBroadPhase(broadPhaseMethod))),
+            Stage::Position);
         for (int i = 0; i < (int) sets.size(); ++i) {
             const ContactSet& set = sets[i];
             int numBodies = set.bodies.size();
@@ -162,6 +166,12 @@ public:
         int numSets = getNumContactSets();
         contacts.resize(numSets);
         
+        // Bring each set's broad phase up to date, starting from the previous step's.
+        
+        const Array_<ContactBroadPhase>& prevBroadPhase = Value<Array_<ContactBroadPhase> >::downcast(getDiscreteVariable(state, broadPhaseIndex));
+        Array_<ContactBroadPhase>& broadPhase = Value<Array_<ContactBroadPhase> >::updDowncast(updDiscreteVarUpdateValue(state, broadPhaseIndex));
+        broadPhase = prevBroadPhase;
+        
         // Loop over all contact sets.
         
         for (int setIndex = 0; setIndex < numSets; setIndex++) {
@@ -169,66 +179,57 @@ public:
             const ContactSet& set = sets[setIndex];
             int numBodies = set.bodies.size();
             
-            // Perform a sweep-and-prune on a single axis to identify potential contacts.  First, find which
-            // axis has the most variation in body locations.  That is the axis we will use.
+            // Find all pairs of bodies whose bounding spheres' boxes overlap.
             
             Vector_<Vec3> centers(numBodies);
-            for (ContactSurfaceIndex i(0); i < numBodies; i++)
+            ContactBroadPhase& bp = broadPhase[setIndex];
+            bp.setNumObjects(numBodies);
+            for (ContactSurfaceIndex i(0); i < numBodies; i++) {
                 centers[i] = set.bodies[i].getBodyTransform(state)*set.sphereCenters[i];
-            Vec3 average = mean(centers);
-            Vec3 var(0);
-            for (int i = 0; i < numBodies; i++)
-                var += abs(centers[i]-average);
-            int axis = (var[0] > var[1] ? 0 : 1);
-            if (var[2] > var[axis])
-                axis = 2;
-            
-            // Find the extent of each body along the axis and sort them by starting location.
-            
-            Array_<ContactBodyExtent> extents(numBodies);
-            for (ContactSurfaceIndex i(0); i < numBodies; i++)
-                extents[i] = ContactBodyExtent(centers[i][axis]-set.sphereRadii[i], centers[i][axis]+set.sphereRadii[i], i);
-            std::sort(extents.begin(), extents.end());
+                bp.updLower()[i] = centers[i]-Vec3(set.sphereRadii[i]);
+                bp.updUpper()[i] = centers[i]+Vec3(set.sphereRadii[i]);
+            }
+            bp.update();
             
-            // Now sweep along the axis, finding potential contacts.
+            // Now check each of those pairs more carefully.
             
-            for (int i = 0; i < numBodies; i++) {
-                const ContactSurfaceIndex index1 = extents[i].index;
-                const Transform transform1 = set.bodies[index1].getBodyTransform(state)*set.transforms[index1];
-                const ContactGeometry& geom1 = set.geometry[index1];
-                const ContactGeometryTypeId typeId1 = geom1.getTypeId();
-                for (int j = i+1; j < numBodies && extents[j].start <= extents[i].end; j++) {
-                    // They overlap along this axis.  See if the bounding spheres overlap.
-                    
-                    const ContactSurfaceIndex index2 = extents[j].index;
-                    const Real sumRadius = set.sphereRadii[index1]+set.sphereRadii[index2];
-                    if ((centers[index1]-centers[index2]).normSqr() <= sumRadius*sumRadius) {
-                        // Do a full collision detection.
-
-                        const Transform transform2 = set.bodies[index2].getBodyTransform(state)*set.transforms[index2];
-                        const ContactGeometry& geom2 = set.geometry[index2];
-                        const ContactGeometryTypeId typeId2 = geom2.getTypeId();
-                        CollisionDetectionAlgorithm* algorithm = 
-                            CollisionDetectionAlgorithm::getAlgorithm
-                                                            (typeId1, typeId2);
-                        if (algorithm == NULL) {
-                            algorithm = CollisionDetectionAlgorithm::
-                                                getAlgorithm(typeId2, typeId1);
-                            if (algorithm == NULL)
-                                continue; // No algorithm available for detecting collisions between these two objects.
-                            algorithm->processObjects(index2, geom2, transform2,
-                                                      index1, geom1, transform1,
-                                                      contacts[setIndex]);
-                        }
-                        else {
-                            algorithm->processObjects(index1, geom1, transform1,
-                                                      index2, geom2, transform2,
-                                                      contacts[setIndex]);
-                        }
+            const ContactBroadPhase::PairList& overlaps = bp.getOverlaps();
+            for (ContactBroadPhase::PairList::const_iterator p = overlaps.begin(); p != overlaps.end(); ++p) {
+                const ContactSurfaceIndex index1(p->first), index2(p->second);
+                
+                // See if the bounding spheres overlap.
+                
+                const Real sumRadius = set.sphereRadii[index1]+set.sphereRadii[index2];
+                if ((centers[index1]-centers[index2]).normSqr() <= sumRadius*sumRadius) {
+                    // Do a full collision detection.
+
+                    const Transform transform1 = set.bodies[index1].getBodyTransform(state)*set.transforms[index1];
+                    const ContactGeometry& geom1 = set.geometry[index1];
+                    const ContactGeometryTypeId typeId1 = geom1.getTypeId();
+                    const Transform transform2 = set.bodies[index2].getBodyTransform(state)*set.transforms[index2];
+                    const ContactGeometry& geom2 = set.geometry[index2];
+                    const ContactGeometryTypeId typeId2 = geom2.getTypeId();
+                    CollisionDetectionAlgorithm* algorithm = 
+                        CollisionDetectionAlgorithm::getAlgorithm
+                                                        (typeId1, typeId2);
+                    if (algorithm == NULL) {
+                        algorithm = CollisionDetectionAlgorithm::
+                                            getAlgorithm(typeId2, typeId1);
+                        if (algorithm == NULL)
+                            continue; // No algorithm available for detecting collisions between these two objects.
+                        algorithm->processObjects(index2, geom2, transform2,
+                                                  index1, geom1, transform1,
+                                                  contacts[setIndex]);
+                    }
+                    else {
+                        algorithm->processObjects(index1, geom1, transform1,
+                                                  index2, geom2, transform2,
+                                                  contacts[setIndex]);
                     }
                 }
             }
         }
+        markDiscreteVarUpdateValueRealized(state, broadPhaseIndex);
         contactsValid = true;
         return 0;
     }
@@ -237,9 +238,11 @@ public:
 
 private:
     Array_<ContactSet>      sets;
+    ContactTrackerSubsystem::BroadPhaseMethod broadPhaseMethod;
 
     mutable CacheEntryIndex contactsCacheIndex;
     mutable CacheEntryIndex contactsValidCacheIndex;
+    mutable DiscreteVariableIndex broadPhaseIndex;
 };
 
 
@@ -287,6 +290,14 @@ const Array_<Contact>& GeneralContactSubsystem::getContacts(const State& state,
     return getImpl().getContacts(state, set);
 }
 
+void GeneralContactSubsystem::setBroadPhaseMethod(ContactTrackerSubsystem::BroadPhaseMethod method) {
+    updImpl().setBroadPhaseMethod(method);
+}
+
+ContactTrackerSubsystem::BroadPhaseMethod GeneralContactSubsystem::getBroadPhaseMethod() const {
+    return getImpl().getBroadPhaseMethod();
+}
+
 bool GeneralContactSubsystem::isInstanceOf(const Subsystem& s) {
     return GeneralContactSubsystemImpl::isA(s.getSubsystemGuts());
 }
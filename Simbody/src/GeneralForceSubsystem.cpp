@@ -37,9 +37,44 @@
 
 #include "ForceImpl.h"
 
+#include <algorithm>
+
 
 namespace SimTK {
 
+// This evaluates contiguous blocks of the thread safe force elements in 
+// parallel, each block into its own private force arrays.
+class CalcForceBlocksTask : public TaskScheduler::RangeTask {
+public:
+    CalcForceBlocksTask(const State&                    s,
+                        const Array_<Force*>&           forces,
+                        const Array_<ForceIndex>&       which,
+                        int                             nBlocks,
+                        Array_<Vector_<SpatialVec> >&   rigidBodyForces,
+                        Array_<Vector_<Vec3> >&         particleForces,
+                        Array_<Vector>&                 mobilityForces)
+    :   s(s), forces(forces), which(which), nBlocks(nBlocks),
+        rigidBodyForces(rigidBodyForces), particleForces(particleForces),
+        mobilityForces(mobilityForces) {}
+
+    void execute(int begin, int end) {
+        const int n = (int)which.size();
+        for (int b = begin; b < end; ++b)
+            for (int i = (b*n)/nBlocks; i < ((b+1)*n)/nBlocks; ++i)
+                forces[which[i]]->getImpl().calcForce
+                   (s, rigidBodyForces[b], particleForces[b], 
+                    mobilityForces[b]);
+    }
+private:
+    const State&                    s;
+    const Array_<Force*>&           forces;
+    const Array_<ForceIndex>&       which;
+    const int                       nBlocks;
+    Array_<Vector_<SpatialVec> >&   rigidBodyForces;
+    Array_<Vector_<Vec3> >&         particleForces;
+    Array_<Vector>&                 mobilityForces;
+};
+
 // There is some tricky caching being done here for forces that have overridden
 // dependsOnlyOnPositions() (and returned "true"). This is probably only worth
 // doing for very expensive position-only forces like atomic force fields. We
@@ -49,7 +84,25 @@ namespace SimTK {
 class GeneralForceSubsystemRep : public ForceSubsystem::Guts {
 public:
     GeneralForceSubsystemRep()
-     : ForceSubsystemRep("GeneralForceSubsystem", "0.0.1")
+     : ForceSubsystemRep("GeneralForceSubsystem", "0.0.1"), forceScheduler(0)
+    {
+    }
+
+    // The copy doesn't share our thread pool; it starts out serial.
+    GeneralForceSubsystemRep(const GeneralForceSubsystemRep& src)
+     : ForceSubsystemRep(src), forces(src.forces), 
+       forceEnabledIndex(src.forceEnabledIndex),
+       cachedForcesAreValidCacheIndex(src.cachedForcesAreValidCacheIndex),
+       rigidBodyForceCacheIndex(src.rigidBodyForceCacheIndex),
+       mobilityForceCacheIndex(src.mobilityForceCacheIndex),
+       particleForceCacheIndex(src.particleForceCacheIndex),
+       parallelRigidBodyForcesIndex(src.parallelRigidBodyForcesIndex),
+       parallelParticleForcesIndex(src.parallelParticleForcesIndex),
+       parallelMobilityForcesIndex(src.parallelMobilityForcesIndex),
+       forcesToCalcIndex(src.forcesToCalcIndex),
+       forcesToCacheIndex(src.forcesToCacheIndex),
+       parallelForcesIndex(src.parallelForcesIndex),
+       forceScheduler(0)
     {
     }
     
@@ -57,6 +110,7 @@ public:
         // Delete in reverse order to be nice to heap system.
         for (int i = (int)forces.size()-1; i >= 0; --i)
             delete forces[i]; 
+        delete forceScheduler;
     }
     
     ForceIndex adoptForce(Force& force) {
@@ -107,6 +161,25 @@ public:
         }
     }
 
+
+    void setUseParallelForceEvaluation(bool useParallel, int numThreads) {
+        SimTK_APIARGCHECK1_ALWAYS(!useParallel || numThreads > 0, 
+            "GeneralForceSubsystem", "setUseParallelForceEvaluation",
+            "The number of threads must be positive but was %d.", numThreads);
+
+        if (useParallel && forceScheduler 
+            && forceScheduler->getNumThreads() == numThreads)
+            return; // nothing to do
+
+        delete forceScheduler;
+        forceScheduler = 0;
+        if (useParallel)
+            forceScheduler = new TaskScheduler(numThreads);
+    }
+
+    bool getUseParallelForceEvaluation() const 
+    {   return forceScheduler != 0; }
+
     
     // These override default implementations of virtual methods in the 
     // Subsystem::Guts class.
@@ -120,6 +193,12 @@ public:
         rigidBodyForceCacheIndex.invalidate();
         mobilityForceCacheIndex.invalidate();
         particleForceCacheIndex.invalidate();
+        parallelRigidBodyForcesIndex.invalidate();
+        parallelParticleForcesIndex.invalidate();
+        parallelMobilityForcesIndex.invalidate();
+        forcesToCalcIndex.invalidate();
+        forcesToCacheIndex.invalidate();
+        parallelForcesIndex.invalidate();
 
         // Some forces are disabled by default; initialize the enabled flags
         // accordingly. Also, see if we're going to need to do any caching
@@ -136,6 +215,26 @@ public:
         forceEnabledIndex = allocateDiscreteVariable(s, Stage::Instance, 
             new Value<Array_<bool> >(forceEnabled));
 
+        // Private per-block force arrays for parallel evaluation. These stay
+        // empty unless parallel evaluation is turned on, but are allocated
+        // anyway since that is a setting that can change at any time.
+        parallelRigidBodyForcesIndex = allocateCacheEntry(s, Stage::Dynamics,
+            new Value<Array_<Vector_<SpatialVec> > >());
+        parallelParticleForcesIndex = allocateCacheEntry(s, Stage::Dynamics,
+            new Value<Array_<Vector_<Vec3> > >());
+        parallelMobilityForcesIndex = allocateCacheEntry(s, Stage::Dynamics,
+            new Value<Array_<Vector> >());
+
+        // Lists of the force elements to be evaluated during this Dynamics
+        // realization. These are cleared rather than rebuilt each time so
+        // that they keep their capacity from one realization to the next.
+        forcesToCalcIndex = allocateCacheEntry(s, Stage::Dynamics,
+            new Value<Array_<ForceIndex> >());
+        forcesToCacheIndex = allocateCacheEntry(s, Stage::Dynamics,
+            new Value<Array_<ForceIndex> >());
+        parallelForcesIndex = allocateCacheEntry(s, Stage::Dynamics,
+            new Value<Array_<ForceIndex> >());
+
         // Note that we'll allocate these even if all the needs-caching 
         // elements are presently disabled. That way they'll be around when
         // the force gets enabled.
@@ -220,15 +319,19 @@ public:
         Vector&                mobilityForces  = 
                                     mbs.updMobilityForces (s, Stage::Dynamics);
 
+        // The list of enabled forces to be evaluated comes from the cache.
+        Array_<ForceIndex>& toCalc = Value<Array_<ForceIndex> >::updDowncast
+                                    (updCacheEntry(s, forcesToCalcIndex));
+        toCalc.clear();
+
         // Short circuit if we're not doing any caching here. Note that we're
         // checking whether the *index* is valid (i.e. does the cache entry
         // exist?), not the contents.
         if (!cachedForcesAreValidCacheIndex.isValid()) {
-            for (int i = 0; i < (int)forces.size(); ++i) {
-                if (forceEnabled[i]) 
-                    forces[i]->getImpl().calcForce
-                       (s, rigidBodyForces, particleForces, mobilityForces);
-            }
+            for (ForceIndex i(0); i < (int)forces.size(); ++i)
+                if (forceEnabled[i]) toCalc.push_back(i);
+            calcForces(s, toCalc, rigidBodyForces, particleForces, 
+                       mobilityForces);
 
             // Allow forces to do their own realization, but wait until all
             // forces have executed calcForce(). TODO: not sure if that is
@@ -255,6 +358,18 @@ public:
             mobilityForceCache  = Value<Vector>::downcast
                                  (updCacheEntry(s, mobilityForceCacheIndex));
 
+        // Sort the enabled forces into those that go directly into the force
+        // arrays and those whose results are cached.
+        Array_<ForceIndex>& toCache = Value<Array_<ForceIndex> >::updDowncast
+                                    (updCacheEntry(s, forcesToCacheIndex));
+        toCache.clear();
+        for (ForceIndex i(0); i < (int)forces.size(); ++i) {
+            if (!forceEnabled[i]) continue;
+            if (!forces[i]->getImpl().dependsOnlyOnPositions())
+                toCalc.push_back(i); // ordinary velocity dependent force
+            else if (!cachedForcesAreValid)
+                toCache.push_back(i);
+        }
 
         if (!cachedForcesAreValid) {
             // We need to calculate the velocity independent forces.
@@ -265,29 +380,12 @@ public:
             mobilityForceCache.resize(matter.getNumMobilities());
             mobilityForceCache = 0;
 
-            // Run through all the forces, accumulating directly into the
-            // force arrays or indirectly into the cache as appropriate.
-            for (int i = 0; i < (int) forces.size(); ++i) {
-                if (!forceEnabled[i]) continue;
-                const ForceImpl& impl = forces[i]->getImpl();
-                if (impl.dependsOnlyOnPositions())
-                    impl.calcForce(s, rigidBodyForceCache, particleForceCache, 
-                                      mobilityForceCache);
-                else // ordinary velocity dependent force
-                    impl.calcForce(s, rigidBodyForces, particleForces, 
-                                      mobilityForces);
-            }
+            calcForces(s, toCache, rigidBodyForceCache, particleForceCache,
+                       mobilityForceCache);
             cachedForcesAreValid = true;
-        } else {
-            // Cache already valid; just need to do the non-cached ones.
-            for (int i = 0; i < (int) forces.size(); ++i) {
-                if (!forceEnabled[i]) continue;
-                const ForceImpl& impl = forces[i]->getImpl();
-                if (!impl.dependsOnlyOnPositions())
-                    impl.calcForce(s, rigidBodyForces, particleForces, 
-                                      mobilityForces);
-            }
         }
+        // Now the non-cached ones.
+        calcForces(s, toCalc, rigidBodyForces, particleForces, mobilityForces);
 
         // Accumulate the values from the cache into the global arrays.
         rigidBodyForces += rigidBodyForceCache;
@@ -301,6 +399,74 @@ public:
         return 0;
     }
     
+    // Add the forces from the listed force elements into the given arrays.
+    // In parallel mode, the thread safe elements are split into one 
+    // contiguous block per thread, each accumulating into its own zeroed
+    // arrays taken from the State cache; the blocks are then summed in order
+    // so that the result is deterministic. The rest are done serially first.
+    void calcForces(const State&                s,
+                    const Array_<ForceIndex>&   which,
+                    Vector_<SpatialVec>&        rigidBodyForces,
+                    Vector_<Vec3>&              particleForces,
+                    Vector&                     mobilityForces) const
+    {
+        // calcForces() may be called twice in one realization but the calls
+        // don't overlap so they can share this list.
+        Array_<ForceIndex>& parallelForces = 
+            Value<Array_<ForceIndex> >::updDowncast
+                (updCacheEntry(s, parallelForcesIndex));
+        parallelForces.clear();
+        for (int i = 0; i < (int)which.size(); ++i) {
+            const ForceImpl& impl = forces[which[i]]->getImpl();
+            if (forceScheduler && impl.isThreadSafe())
+                parallelForces.push_back(which[i]);
+            else 
+                impl.calcForce(s, rigidBodyForces, particleForces, 
+                                  mobilityForces);
+        }
+
+        const int nBlocks = 
+            std::min((int)parallelForces.size(), 
+                     forceScheduler ? forceScheduler->getNumThreads() : 0);
+        if (nBlocks <= 1) {
+            for (int i = 0; i < (int)parallelForces.size(); ++i)
+                forces[parallelForces[i]]->getImpl().calcForce
+                   (s, rigidBodyForces, particleForces, mobilityForces);
+            return;
+        }
+
+        Array_<Vector_<SpatialVec> >& blockRigidBodyForces = 
+            Value<Array_<Vector_<SpatialVec> > >::updDowncast
+                (updCacheEntry(s, parallelRigidBodyForcesIndex));
+        Array_<Vector_<Vec3> >& blockParticleForces = 
+            Value<Array_<Vector_<Vec3> > >::updDowncast
+                (updCacheEntry(s, parallelParticleForcesIndex));
+        Array_<Vector>& blockMobilityForces = 
+            Value<Array_<Vector> >::updDowncast
+                (updCacheEntry(s, parallelMobilityForcesIndex));
+        blockRigidBodyForces.resize(nBlocks);
+        blockParticleForces.resize(nBlocks);
+        blockMobilityForces.resize(nBlocks);
+        for (int b = 0; b < nBlocks; ++b) {
+            blockRigidBodyForces[b].resize(rigidBodyForces.size());
+            blockRigidBodyForces[b] = SpatialVec(Vec3(0), Vec3(0));
+            blockParticleForces[b].resize(particleForces.size());
+            blockParticleForces[b] = Vec3(0);
+            blockMobilityForces[b].resize(mobilityForces.size());
+            blockMobilityForces[b] = 0;
+        }
+
+        CalcForceBlocksTask task(s, forces, parallelForces, nBlocks,
+            blockRigidBodyForces, blockParticleForces, blockMobilityForces);
+        forceScheduler->parallelFor(task, 0, nBlocks, 1);
+
+        for (int b = 0; b < nBlocks; ++b) {
+            rigidBodyForces += blockRigidBodyForces[b];
+            particleForces  += blockParticleForces[b];
+            mobilityForces  += blockMobilityForces[b];
+        }
+    }
+
     Real calcPotentialEnergy(const State& state) const OVERRIDE_11 {
         const Array_<bool>& forceEnabled = Value<Array_<bool> >::downcast
            (getDiscreteVariable(state, forceEnabledIndex)).get();
@@ -358,6 +524,24 @@ private:
     mutable CacheEntryIndex         rigidBodyForceCacheIndex;
     mutable CacheEntryIndex         mobilityForceCacheIndex;
     mutable CacheEntryIndex         particleForceCacheIndex;
+
+    // These Dynamics-stage cache entries hold the private force arrays for
+    // each block of forces when evaluating in parallel.
+    mutable CacheEntryIndex         parallelRigidBodyForcesIndex;
+    mutable CacheEntryIndex         parallelParticleForcesIndex;
+    mutable CacheEntryIndex         parallelMobilityForcesIndex;
+
+    // These Dynamics-stage cache entries hold the lists of force elements
+    // to evaluate, kept so that realization doesn't need to allocate.
+    mutable CacheEntryIndex         forcesToCalcIndex;
+    mutable CacheEntryIndex         forcesToCacheIndex;
+    mutable CacheEntryIndex         parallelForcesIndex;
+
+    // PARALLEL EVALUATION
+    // This is a setting rather than topology; null means serial.
+    TaskScheduler*                  forceScheduler;
+
+    GeneralForceSubsystemRep& operator=(const GeneralForceSubsystemRep&);
 };
 
     ///////////////////////////
@@ -420,6 +604,13 @@ void GeneralForceSubsystem::setForceIsDisabled
    (State& state, ForceIndex index, bool disabled) const 
 {   getRep().setForceIsDisabled(state, index, disabled); }
 
+void GeneralForceSubsystem::setUseParallelForceEvaluation
+   (bool useParallel, int numThreads)
+{   updRep().setUseParallelForceEvaluation(useParallel, numThreads); }
+
+bool GeneralForceSubsystem::getUseParallelForceEvaluation() const
+{   return getRep().getUseParallelForceEvaluation(); }
+
 const MultibodySystem& GeneralForceSubsystem::getMultibodySystem() const
 {   return MultibodySystem::downcast(getSystem()); }
 
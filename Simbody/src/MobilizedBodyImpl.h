@@ -128,6 +128,12 @@ public:
     // instead which has a nicer interface and does some error checking.
     virtual void copyOutDefaultQImpl(int nq, Real* q) const = 0;
 
+    // Return false if this mobilizer's cross-mobilizer kinematics might 
+    // depend on anything besides its own q's, such as time or discrete 
+    // variables. Position realization can then never reuse the kinematics of
+    // bodies whose q's are unchanged.
+    virtual bool kinematicsDependOnlyOnQ() const {return true;}
+
     virtual void calcDecorativeGeometryAndAppendImpl
        (const State& s, Stage stage, Array_<DecorativeGeometry>& geom) const
     {
@@ -1146,6 +1152,9 @@ public:
             q[0] = 1.0;
     }
 
+    // User-written kinematics can depend on anything in the State.
+    bool kinematicsDependOnlyOnQ() const {return false;}
+
     // Forward all the virtuals to the Custom::Implementation virtuals.
     void realizeTopologyVirtual(State& s)       const {getImplementation().realizeTopology(s);}
     void realizeModelVirtual   (State& s)       const {getImplementation().realizeModel(s);}
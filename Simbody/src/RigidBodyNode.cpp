@@ -176,6 +176,104 @@ RigidBodyNode::calcJointIndependentKinematicsVel(
 
 
 
+//==============================================================================
+//                 CALC JOINT INDEPENDENT DERIV PASS 1 OUTWARD
+//==============================================================================
+// Differentiate V_GB = ~Phi*V_GP + H*u, Amob (see above) and
+// A_GB = ~Phi*A_GP + H*udot + Amob along one direction of change in q and u.
+// The change in q moves this body's frame with spatial velocity VPrime_GB,
+// which is its parent's plus this mobilizer's contribution, so the change in
+// the shift vector p_PB_G is the difference of the two linear velocities.
+// Must be called base to tip.
+void RigidBodyNode::calcJointIndependentDerivPass1Outward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const SpatialVec*           allA_GB,
+    const SpatialVec&           VPrime_PB_G,
+    const SpatialVec&           dV_PB_G,
+    const SpatialVec&           dVD_PB_G,
+    const SpatialVec&           dHUDot,
+    SpatialVec*                 allVPrime,
+    SpatialVec*                 allDV,
+    SpatialVec*                 allDA) const
+{
+    const int parentNum = parent->getNodeNum();
+    const SpatialVec& V_GP      = parent->getV_GB(vc);
+    const SpatialVec& V_GB      = getV_GB(vc);
+    const SpatialVec& A_GP      = allA_GB[parentNum];
+    const SpatialVec& VPrime_GP = allVPrime[parentNum];
+    const SpatialVec& dV_GP     = allDV[parentNum];
+    const PhiMatrixTranspose PhiT = ~getPhi(pc);
+
+    const SpatialVec VPrime_GB = PhiT*VPrime_GP + VPrime_PB_G;
+    allVPrime[nodeNum] = VPrime_GB;
+    const Vec3 dp_PB_G = VPrime_GB[1] - VPrime_GP[1];
+
+    const SpatialVec dV_GB = PhiT*dV_GP + dV_PB_G
+                             + SpatialVec(Vec3(0), V_GP[0] % dp_PB_G);
+    allDV[nodeNum] = dV_GB;
+
+    const SpatialVec dAmob(dVD_PB_G[0],
+                           dVD_PB_G[1] + dV_GP[0] % (V_GB[1]-V_GP[1])
+                                       + V_GP[0] % (dV_GB[1]-dV_GP[1]));
+
+    allDA[nodeNum] = PhiT*allDA[parentNum] + dHUDot + dAmob
+                     + SpatialVec(Vec3(0), A_GP[0] % dp_PB_G);
+}
+
+
+
+//==============================================================================
+//                 CALC JOINT INDEPENDENT DERIV PASS 2 INWARD
+//==============================================================================
+// Differentiate F = Mk_G*A_GB + gyroscopic force - applied body force, plus
+// the children's F shifted to this body. Mk_G and the inertia G and center
+// of mass vector c that go into the gyroscopic force are fixed in B and just
+// rotate with it at VPrime_GB[0]; for example d(Mk_G)*A = w'%(Mk_G*A) -
+// Mk_G*(w'%A) where w'% crosses both halves of a SpatialVec. Must be called
+// tip to base.
+void RigidBodyNode::calcJointIndependentDerivPass2Inward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const SpatialVec*           allA_GB,
+    const SpatialVec*           allF,
+    const SpatialVec*           allVPrime,
+    const SpatialVec*           allDV,
+    const SpatialVec*           allDA,
+    SpatialVec*                 allDF) const
+{
+    const SpatialInertia& Mk     = getMk_G(pc);
+    const SpatialVec&     A_GB   = allA_GB[nodeNum];
+    const Vec3&           wPrime = allVPrime[nodeNum][0];
+    const Vec3&           w      = getV_GB(vc)[0];
+    const Vec3&           dw     = allDV[nodeNum][0];
+    SpatialVec&           dF     = allDF[nodeNum];
+
+    const SpatialVec MkA = Mk*A_GB;
+    dF = Mk*allDA[nodeNum] + SpatialVec(wPrime % MkA[0], wPrime % MkA[1])
+         - Mk*SpatialVec(wPrime % A_GB[0], wPrime % A_GB[1]);
+
+    const UnitInertia& G  = getUnitInertia_OB_G(pc);
+    const Vec3&        c  = getCB_G(pc);
+    const Vec3         Gw = G*w;
+    const Vec3         dGw = wPrime % Gw - G*(wPrime % w) + G*dw;
+    const Vec3         dc  = wPrime % c;
+    dF += getMass() * SpatialVec(dw % Gw + w % dGw,
+                                 dw % (w % c) + w % (dw % c + w % dc));
+
+    for (unsigned i=0; i<children.size(); ++i) {
+        const int         childNum  = children[i]->getNodeNum();
+        const PhiMatrix&  phiChild  = children[i]->getPhi(pc);
+        const SpatialVec& FChild    = allF[childNum];
+        const Vec3        dp_BC_G   = allVPrime[childNum][1]
+                                      - allVPrime[nodeNum][1];
+        dF += phiChild * allDF[childNum]
+              + SpatialVec(dp_BC_G % FChild[1], Vec3(0));
+    }
+}
+
+
+
 //==============================================================================
 //                          CALC KINETIC ENERGY
 //==============================================================================
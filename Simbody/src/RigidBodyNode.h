@@ -457,6 +457,15 @@ virtual void realizeInstance(
 virtual void realizePosition(
     const SBStateDigest&      sbs) const=0;
 
+// When this node's q's and those of all its ancestors are unchanged since
+// the last realizePosition(), its position kinematics in the State cache are
+// still good and realizePosition() can be skipped. However, qerr is not kept
+// with the rest of the cache, so nodes that generate qerr entries (that is,
+// those using quaternions) must recalculate them here. The default does
+// nothing, which is right for nodes without quaternions.
+virtual void realizePositionQErr(
+    const SBStateDigest&      sbs) const {}
+
 // Introduce new values for generalized speeds and calculate
 // all the velocity-dependent kinematic terms. Assumes realizePosition()
 // has already been called on all nodes. Must be called base to tip.
@@ -557,6 +566,93 @@ virtual void multiplyByMInvPass2Outward(
     SpatialVec*                             allA_GB,
     Real*                                   allUDot) const=0;
 
+    // BATCHED OPERATORS //
+
+// The tree sweeps don't call the hot O(n) operators above one node at a time.
+// Instead, at topology time the nodes at each level are grouped into runs of
+// nodes that share the same getBatchKind(), and the batched form of the 
+// operator is invoked once per run on the run's first node. A node type 
+// that knows all the nodes in a run have its own concrete type can then 
+// call its own implementation directly, without virtual dispatch. The 
+// default implementations here just make the ordinary virtual call for each 
+// node, so they are correct for any mix of node types; that's what we use for
+// nodes whose batch kind is null (Ground, Weld, and particles).
+
+// Nodes that return the same non-null batch kind must be of the same concrete
+// type as far as the batched operators are concerned.
+virtual const void* getBatchKind() const {return 0;}
+
+virtual void realizeArticulatedBodyInertiasInwardBatch(
+    const RigidBodyNode* const*     nodes,
+    int                             nNodes,
+    const SBInstanceCache&          ic,
+    const SBTreePositionCache&      pc,
+    SBArticulatedBodyInertiaCache&  abc) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->realizeArticulatedBodyInertiasInward(ic,pc,abc); }
+
+virtual void calcUDotPass1InwardBatch(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             jointForces,
+    const SpatialVec*                       bodyForces,
+    const Real*                             allUDot,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allGepsilon,
+    Real*                                   allEpsilon) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->calcUDotPass1Inward(ic,pc,abc,dc,jointForces,bodyForces,
+                                      allUDot,allZ,allGepsilon,allEpsilon); }
+
+virtual void calcUDotPass2OutwardBatch(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBTreeVelocityCache&              vc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             epsilonTmp,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot,
+    Real*                                   allTau) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->calcUDotPass2Outward(ic,pc,abc,vc,dc,epsilonTmp,
+                                       allA_GB,allUDot,allTau); }
+
+virtual void multiplyByMInvPass1InwardBatch(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             f,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allGepsilon,
+    Real*                                   allEpsilon) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->multiplyByMInvPass1Inward(ic,pc,abc,dc,f,
+                                            allZ,allGepsilon,allEpsilon); }
+
+virtual void multiplyByMInvPass2OutwardBatch(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             epsilonTmp,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->multiplyByMInvPass2Outward(ic,pc,abc,dc,epsilonTmp,
+                                             allA_GB,allUDot); }
+
 // Also serves as pass 1 for inverse dynamics.
 virtual void calcBodyAccelerationsFromUdotOutward(
     const SBTreePositionCache&  pc,
@@ -574,6 +670,43 @@ virtual void calcInverseDynamicsPass2Inward(
     Real*                       allTau) const
   { SimTK_THROW2(Exception::UnimplementedVirtualMethod, "RigidBodeNode", "calcInverseDynamicsPass2Inward"); }
 
+// Derivative of the two inverse dynamics passes above along one direction of
+// change in q and u, with udot and the applied forces held fixed. The change
+// in q is given as the generalized speeds allUPrime = N^-1 dq that would
+// produce it, and the change in u as allDU. allDH_FM and allDHDot_FM hold the
+// resulting changes in each mobilizer's H_FM and HDot_FM, one SpatialVec per
+// u. Pass 1 produces each body's spatial velocity under allUPrime (that is,
+// the rate at which dq moves its frame) in allVPrime, and the changes in V_GB
+// and A_GB; pass 2 produces the changes in the body forces and in the
+// residual mobility forces.
+virtual void calcInverseDynamicsDerivPass1Outward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const Real*                 allU,
+    const Real*                 allUDot,
+    const SpatialVec*           allA_GB,
+    const Real*                 allUPrime,
+    const Real*                 allDU,
+    const SpatialVec*           allDH_FM,
+    const SpatialVec*           allDHDot_FM,
+    SpatialVec*                 allVPrime,
+    SpatialVec*                 allDV,
+    SpatialVec*                 allDA) const
+  { SimTK_THROW2(Exception::UnimplementedVirtualMethod, "RigidBodeNode", "calcInverseDynamicsDerivPass1Outward"); }
+virtual void calcInverseDynamicsDerivPass2Inward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const SpatialVec*           allA_GB,
+    const SpatialVec*           allF,
+    const Real*                 allUPrime,
+    const SpatialVec*           allDH_FM,
+    const SpatialVec*           allVPrime,
+    const SpatialVec*           allDV,
+    const SpatialVec*           allDA,
+    SpatialVec*                 allDF,
+    Real*                       allDTau) const
+  { SimTK_THROW2(Exception::UnimplementedVirtualMethod, "RigidBodeNode", "calcInverseDynamicsDerivPass2Inward"); }
+
 virtual void multiplyByMPass1Outward(
     const SBTreePositionCache&  pc,
     const Real*                 allUDot,
@@ -586,6 +719,79 @@ virtual void multiplyByMPass2Inward(
     Real*                       allTau) const
   { SimTK_THROW2(Exception::UnimplementedVirtualMethod, "RigidBodeNode", "multiplyByMPass2Inward"); }
 
+    // MULTIPLE RIGHT HAND SIDE OPERATORS //
+
+// These perform the same calculation as the corresponding single-column
+// operators above, but for nCols right hand sides at once so that a node's
+// per-node data need only be fetched once per sweep rather than once per
+// column. The columns are stored one after another: column j of a u-space
+// array begins at j*nu and column j of a body-space array begins at j*nb.
+// The default implementations just call the single-column operator for each
+// column; RigidBodyNodeSpec provides real implementations.
+
+virtual void multiplyByMInvPass1InwardMulti(
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    int                                     nCols,
+    int                                     nu,
+    int                                     nb,
+    const Real*                             f,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allGepsilon,
+    Real*                                   allEpsilon) const
+{   for (int j=0; j < nCols; ++j)
+        multiplyByMInvPass1Inward(ic,pc,abc,dc,f+j*nu,allZ+j*nb,
+                                  allGepsilon+j*nb,allEpsilon+j*nu); }
+
+virtual void multiplyByMInvPass2OutwardMulti(
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    int                                     nCols,
+    int                                     nu,
+    int                                     nb,
+    const Real*                             epsilonTmp,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot) const
+{   for (int j=0; j < nCols; ++j)
+        multiplyByMInvPass2Outward(ic,pc,abc,dc,epsilonTmp+j*nu,
+                                   allA_GB+j*nb,allUDot+j*nu); }
+
+virtual void multiplyByMPass1OutwardMulti(
+    const SBTreePositionCache&  pc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    const Real*                 allUDot,
+    SpatialVec*                 allA_GB) const
+{   for (int j=0; j < nCols; ++j)
+        multiplyByMPass1Outward(pc,allUDot+j*nu,allA_GB+j*nb); }
+
+virtual void multiplyByMPass2InwardMulti(
+    const SBTreePositionCache&  pc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    const SpatialVec*           allA_GB,
+    SpatialVec*                 allFTmp,
+    Real*                       allTau) const
+{   for (int j=0; j < nCols; ++j)
+        multiplyByMPass2Inward(pc,allA_GB+j*nb,allFTmp+j*nb,allTau+j*nu); }
+
+virtual void multiplyBySystemJacobianTransposeMulti(
+    const SBTreePositionCache&  pc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    SpatialVec*                 zTmp,
+    const SpatialVec*           X,
+    Real*                       JtX) const
+{   for (int j=0; j < nCols; ++j)
+        multiplyBySystemJacobianTranspose(pc,zTmp+j*nb,X+j*nb,JtX+j*nu); }
+
 
 virtual void setVelFromSVel(const SBStateDigest&,
                             const SpatialVec&, Vector& u) const {SimTK_THROW2(Exception::UnimplementedVirtualMethod, "RigidBodeNode", "setVelFromSVel");}
@@ -597,6 +803,9 @@ virtual const SpatialVec& getHCol(const SBTreePositionCache&, int j) const
 virtual const SpatialVec& getH_FMCol(const SBTreePositionCache&, int j) const 
 {SimTK_THROW2(Exception::UnimplementedVirtualMethod, "RigidBodeNode", "getH_FMCol");}
 
+virtual SpatialVec getHDot_FMCol(const SBTreeVelocityCache&, int j) const
+{SimTK_THROW2(Exception::UnimplementedVirtualMethod, "RigidBodeNode", "getHDot_FMCol");}
+
 //TODO (does this even belong here?)
 virtual void velFromCartesian() {}
 
@@ -985,6 +1194,31 @@ void calcJointIndependentKinematicsVel(
     const SBTreePositionCache& pc,
     SBTreeVelocityCache&       vc) const;
 
+// The mobilizer independent parts of calcInverseDynamicsDerivPass1Outward()
+// and calcInverseDynamicsDerivPass2Inward(). Pass 1 takes this mobilizer's
+// contributions VPrime_PB_G = H*uPrime, dV_PB_G = dH*u + H*du,
+// dVD_PB_G = dHDot*u + HDot*du and dHUDot = dH*udot.
+void calcJointIndependentDerivPass1Outward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const SpatialVec*           allA_GB,
+    const SpatialVec&           VPrime_PB_G,
+    const SpatialVec&           dV_PB_G,
+    const SpatialVec&           dVD_PB_G,
+    const SpatialVec&           dHUDot,
+    SpatialVec*                 allVPrime,
+    SpatialVec*                 allDV,
+    SpatialVec*                 allDA) const;
+void calcJointIndependentDerivPass2Inward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const SpatialVec*           allA_GB,
+    const SpatialVec*           allF,
+    const SpatialVec*           allVPrime,
+    const SpatialVec*           allDV,
+    const SpatialVec*           allDA,
+    SpatialVec*                 allDF) const;
+
 // Calculate velocity-dependent quantities which will be needed for
 // computing accelerations.
 void calcJointIndependentDynamicsVel(
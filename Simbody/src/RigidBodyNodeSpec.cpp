@@ -645,6 +645,139 @@ calcInverseDynamicsPass2Inward(
 
 
 
+//==============================================================================
+//                     CALC INVERSE DYNAMICS DERIVATIVES
+//==============================================================================
+// These differentiate the two inverse dynamics passes above along one
+// direction of change in q and u (see RigidBodyNode.h). Only the terms that
+// involve H and HDot are here; the rest is mobilizer independent and done in
+// calcJointIndependentDerivPass1Outward() and ..Pass2Inward().
+//
+// A change dq = N*uPrime turns F in Ground at the parent's wPrime_GP and M in
+// F at wPrime_FM = (H_FM*uPrime)[0], and changes H_FM by dH_FM. The change in
+// H then follows from the same formula as HDot. Differentiating
+//      HDot = R_GF*(HDot_FM + HDot_MB_F) + w_GF % H
+// where HDot_MB_F = -r_MB_F % HDot_FM[0] - (w_FM % r_MB_F) % H_FM[0] (see
+// calcParentToChildVelocityJacobianInGroundDot()) gives
+//      dHDot = wPrime_GP % (R_GF*(HDot_FM + HDot_MB_F))
+//            + R_GF*(dHDot_FM + dHDot_MB_F) + dw_GF % H + w_GF % dH
+// with r_MB_F turning at wPrime_FM.
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> 
+typename RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::HType
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+calcParentToChildVelocityJacobianInGroundDeriv(
+    const SBTreePositionCache&  pc,
+    const Vec3&                 wPrime_GP,
+    const Vec3&                 wPrime_FM,
+    const HType&                dH_FM) const
+{
+    const HType&    H_FM = getH_FM(pc);
+    const HType&    H    = getH(pc);
+    const Rotation& R_GP = getX_GP(pc).R();
+    const Rotation  R_GF = (noR_PF ? R_GP : R_GP * getX_PF().R());
+    const Vec3      r_MB_F = getX_FM(pc).R() * getX_MB().p();
+
+    HType dH_MB_F;
+    dH_MB_F[0] = Vec3(0);
+    dH_MB_F[1] = -r_MB_F % dH_FM[0] - (wPrime_FM % r_MB_F) % H_FM[0];
+
+    return R_GF * (dH_FM + dH_MB_F) 
+           + HType(wPrime_GP % H[0], wPrime_GP % H[1]);
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+calcInverseDynamicsDerivPass1Outward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const Real*                 allU,
+    const Real*                 allUDot,
+    const SpatialVec*           allA_GB,
+    const Real*                 allUPrime,
+    const Real*                 allDU,
+    const SpatialVec*           allDH_FM,
+    const SpatialVec*           allDHDot_FM,
+    SpatialVec*                 allVPrime,
+    SpatialVec*                 allDV,
+    SpatialVec*                 allDA) const
+{
+    const HType&    H_FM     = getH_FM(pc);
+    const HType&    HDot_FM  = getHDot_FM(vc);
+    const HType&    H        = getH(pc);
+    const HType&    HDot     = getHDot(vc);
+    const HType&    dH_FM    = HType::getAs(&allDH_FM[uIndex][0]);
+    const HType&    dHDot_FM = HType::getAs(&allDHDot_FM[uIndex][0]);
+    const Vec<dof>& u        = fromU(allU);
+    const Vec<dof>& udot     = fromU(allUDot);
+    const Vec<dof>& uPrime   = fromU(allUPrime);
+    const Vec<dof>& du       = fromU(allDU);
+
+    const int   parentNum = parent->getNodeNum();
+    const Vec3& w_GP      = getV_GP(vc)[0];
+    const Vec3& wPrime_GP = allVPrime[parentNum][0];
+    const Vec3& dw_GP     = allDV[parentNum][0];
+    const Vec3& w_FM      = getV_FM(vc)[0];
+    const Vec3  wPrime_FM = (H_FM*uPrime)[0];
+    const Vec3  dw_FM     = (dH_FM*u + H_FM*du)[0];
+
+    const HType dH = calcParentToChildVelocityJacobianInGroundDeriv
+                        (pc, wPrime_GP, wPrime_FM, dH_FM);
+
+    const Rotation& R_GP    = getX_GP(pc).R();
+    const Rotation  R_GF    = (noR_PF ? R_GP : R_GP * getX_PF().R());
+    const Vec3      r_MB_F  = getX_FM(pc).R() * getX_MB().p();
+    const Vec3      dr_MB_F = wPrime_FM % r_MB_F;
+
+    HType dHDot_MB_F;
+    dHDot_MB_F[0] = Vec3(0);
+    dHDot_MB_F[1] = - dr_MB_F % HDot_FM[0] - r_MB_F % dHDot_FM[0]
+                    - (dw_FM % r_MB_F + w_FM % dr_MB_F) % H_FM[0]
+                    - (w_FM % r_MB_F) % dH_FM[0];
+
+    // This is R_GF*(HDot_FM + HDot_MB_F).
+    const HType HDot_F = HDot - HType(w_GP % H[0], w_GP % H[1]);
+
+    const HType dHDot = HType(wPrime_GP % HDot_F[0], wPrime_GP % HDot_F[1])
+                        + R_GF * (dHDot_FM + dHDot_MB_F)
+                        + HType(dw_GP % H[0], dw_GP % H[1])
+                        + HType(w_GP % dH[0], w_GP % dH[1]);
+
+    calcJointIndependentDerivPass1Outward(pc, vc, allA_GB,
+        H*uPrime, dH*u + H*du, dHDot*u + HDot*du, dH*udot,
+        allVPrime, allDV, allDA);
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+calcInverseDynamicsDerivPass2Inward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const SpatialVec*           allA_GB,
+    const SpatialVec*           allF,
+    const Real*                 allUPrime,
+    const SpatialVec*           allDH_FM,
+    const SpatialVec*           allVPrime,
+    const SpatialVec*           allDV,
+    const SpatialVec*           allDA,
+    SpatialVec*                 allDF,
+    Real*                       allDTau) const
+{
+    calcJointIndependentDerivPass2Inward(pc, vc, allA_GB, allF,
+        allVPrime, allDV, allDA, allDF);
+
+    // Recalculate rather than save dH from pass 1; it is cheap.
+    const HType& dH_FM     = HType::getAs(&allDH_FM[uIndex][0]);
+    const Vec3&  wPrime_GP = allVPrime[parent->getNodeNum()][0];
+    const Vec3   wPrime_FM = (getH_FM(pc)*fromU(allUPrime))[0];
+    const HType  dH = calcParentToChildVelocityJacobianInGroundDeriv
+                        (pc, wPrime_GP, wPrime_FM, dH_FM);
+
+    // tau = ~H*F - applied mobility forces
+    toU(allDTau) = ~dH*allF[nodeNum] + ~getH(pc)*allDF[nodeNum];
+}
+
+
+
 //==============================================================================
 //                                 CALC M V
 //==============================================================================
@@ -862,6 +995,298 @@ RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::setVelFromSVel(
     toU(u) = ~getH(pc) * (sVel - (~getPhi(pc) * parent->getV_GB(mc)));
 }
 
+//==============================================================================
+//                            BATCHED OPERATORS
+//==============================================================================
+// These are invoked once for a run of nodes which all have this node's batch
+// kind, meaning they are all exactly this RigidBodyNodeSpec instantiation.
+// That lets us call the operators with a qualified (non-virtual) name so the
+// compiler can inline them into the loop. The batch kind is the address of a
+// static that is unique to each instantiation.
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> const void*
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::getBatchKind() const {
+    static const char kind = 0;
+    return &kind;
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+realizeArticulatedBodyInertiasInwardBatch(
+    const RigidBodyNode* const*     nodes,
+    int                             nNodes,
+    const SBInstanceCache&          ic,
+    const SBTreePositionCache&      pc,
+    SBArticulatedBodyInertiaCache&  abc) const
+{
+    for (int i=0; i < nNodes; ++i) {
+        assert(nodes[i]->getBatchKind() == getBatchKind());
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])
+            ->RigidBodyNodeSpec::realizeArticulatedBodyInertiasInward
+                (ic,pc,abc);
+    }
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+calcUDotPass1InwardBatch(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             jointForces,
+    const SpatialVec*                       bodyForces,
+    const Real*                             allUDot,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allGepsilon,
+    Real*                                   allEpsilon) const
+{
+    for (int i=0; i < nNodes; ++i) {
+        assert(nodes[i]->getBatchKind() == getBatchKind());
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])
+            ->RigidBodyNodeSpec::calcUDotPass1Inward
+                (ic,pc,abc,dc,jointForces,bodyForces,allUDot,
+                 allZ,allGepsilon,allEpsilon);
+    }
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+calcUDotPass2OutwardBatch(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBTreeVelocityCache&              vc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             epsilonTmp,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot,
+    Real*                                   allTau) const
+{
+    for (int i=0; i < nNodes; ++i) {
+        assert(nodes[i]->getBatchKind() == getBatchKind());
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])
+            ->RigidBodyNodeSpec::calcUDotPass2Outward
+                (ic,pc,abc,vc,dc,epsilonTmp,allA_GB,allUDot,allTau);
+    }
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+multiplyByMInvPass1InwardBatch(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             f,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allGepsilon,
+    Real*                                   allEpsilon) const
+{
+    for (int i=0; i < nNodes; ++i) {
+        assert(nodes[i]->getBatchKind() == getBatchKind());
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])
+            ->RigidBodyNodeSpec::multiplyByMInvPass1Inward
+                (ic,pc,abc,dc,f,allZ,allGepsilon,allEpsilon);
+    }
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+multiplyByMInvPass2OutwardBatch(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             epsilonTmp,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot) const
+{
+    for (int i=0; i < nNodes; ++i) {
+        assert(nodes[i]->getBatchKind() == getBatchKind());
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])
+            ->RigidBodyNodeSpec::multiplyByMInvPass2Outward
+                (ic,pc,abc,dc,epsilonTmp,allA_GB,allUDot);
+    }
+}
+
+
+
+//==============================================================================
+//                     MULTIPLE RIGHT HAND SIDE OPERATORS
+//==============================================================================
+// Each of these does the same computation as its single-column counterpart
+// above for nCols columns. Column j of a u-space array starts at j*nu, and of
+// a body-space array at j*nb. The per-node matrices are looked up once and
+// then held while we run down the columns, and each child's Phi is applied to
+// all the columns before moving on to the next child.
+
+// Pass 1 of multiplyByMInv, tip to base.
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+multiplyByMInvPass1InwardMulti(
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    int                                     nCols,
+    int                                     nu,
+    int                                     nb,
+    const Real*                             jointForces,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allZPlus,
+    Real*                                   allEpsilon) const
+{
+    const bool isPrescribed = isUDotKnown(ic);
+    const HType&              H = getH(pc);
+    const HType&              G = getG(abc);
+
+    for (int j=0; j < nCols; ++j)
+        allZ[j*nb + nodeNum] = 0;
+
+    for (unsigned i=0; i<children.size(); i++) {
+        const PhiMatrix& phiChild = children[i]->getPhi(pc);
+        const int        child    = children[i]->getNodeNum();
+        for (int j=0; j < nCols; ++j)
+            allZ[j*nb + nodeNum] += phiChild * allZPlus[j*nb + child];
+    }
+
+    for (int j=0; j < nCols; ++j) {
+        const SpatialVec& z     = allZ[j*nb + nodeNum];
+        SpatialVec&       zPlus = allZPlus[j*nb + nodeNum];
+        zPlus = z;
+        if (!isPrescribed) {
+            Vec<dof>& eps = toU(allEpsilon + j*nu);
+            eps    = fromU(jointForces + j*nu) - ~H*z;
+            zPlus += G*eps;
+        }
+    }
+}
+
+// Pass 2 of multiplyByMInv, base to tip.
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+multiplyByMInvPass2OutwardMulti(
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBDynamicsCache&                  dc,
+    int                                     nCols,
+    int                                     nu,
+    int                                     nb,
+    const Real*                             allEpsilon,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot) const
+{
+    const bool isPrescribed = isUDotKnown(ic);
+    const HType&        H   = getH(pc);
+    const PhiMatrix&    phi = getPhi(pc);
+    const Mat<dof,dof>& DI  = getDI(abc);
+    const HType&        G   = getG(abc);
+    const int           parentNum = parent->getNodeNum();
+
+    for (int j=0; j < nCols; ++j) {
+        SpatialVec*     A_GBj = allA_GB + j*nb;
+        Vec<dof>&       udot  = toU(allUDot + j*nu);
+        const SpatialVec APlus = ~phi * A_GBj[parentNum];
+        if (isPrescribed) {
+            udot = 0;
+            A_GBj[nodeNum] = APlus;
+        } else {
+            udot = DI*fromU(allEpsilon + j*nu) - ~G*APlus;
+            A_GBj[nodeNum] = APlus + H*udot;
+        }
+    }
+}
+
+// Pass 1 of multiplyByM, base to tip.
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+multiplyByMPass1OutwardMulti(
+    const SBTreePositionCache&  pc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    const Real*                 allUDot,
+    SpatialVec*                 allA_GB) const
+{
+    const HType&     H   = getH(pc);
+    const PhiMatrix& phi = getPhi(pc);
+    const int        parentNum = parent->getNodeNum();
+
+    for (int j=0; j < nCols; ++j) {
+        SpatialVec* A_GBj = allA_GB + j*nb;
+        A_GBj[nodeNum] = ~phi * A_GBj[parentNum]
+                         + H*fromU(allUDot + j*nu);
+    }
+}
+
+// Pass 2 of multiplyByM, tip to base.
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+multiplyByMPass2InwardMulti(
+    const SBTreePositionCache&  pc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    const SpatialVec*           allA_GB,
+    SpatialVec*                 allF,   // temp
+    Real*                       allTau) const
+{
+    const SpatialInertia& Mk = getMk_G(pc);
+    const HType&          H  = getH(pc);
+
+    for (int j=0; j < nCols; ++j)
+        allF[j*nb + nodeNum] = Mk*allA_GB[j*nb + nodeNum];
+
+    for (unsigned i=0; i<children.size(); ++i) {
+        const PhiMatrix& phiChild = children[i]->getPhi(pc);
+        const int        child    = children[i]->getNodeNum();
+        for (int j=0; j < nCols; ++j)
+            allF[j*nb + nodeNum] += phiChild * allF[j*nb + child];
+    }
+
+    for (int j=0; j < nCols; ++j)
+        toU(allTau + j*nu) = ~H*allF[j*nb + nodeNum];
+}
+
+// Multiply by ~J, tip to base.
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+multiplyBySystemJacobianTransposeMulti(
+    const SBTreePositionCache&  pc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    SpatialVec*                 zTmp,
+    const SpatialVec*           X,
+    Real*                       JtX) const
+{
+    const HType& H = getH(pc);
+
+    for (int j=0; j < nCols; ++j)
+        zTmp[j*nb + nodeNum] = X[j*nb + nodeNum];
+
+    for (unsigned i=0; i<children.size(); ++i) {
+        const PhiMatrix& phiChild = children[i]->getPhi(pc);
+        const int        child    = children[i]->getNodeNum();
+        for (int j=0; j < nCols; ++j)
+            zTmp[j*nb + nodeNum] += phiChild * zTmp[j*nb + child];
+    }
+
+    for (int j=0; j < nCols; ++j)
+        toU(JtX + j*nu) = ~H*zTmp[j*nb + nodeNum];
+}
+
+
+
     ////////////////////
     // INSTANTIATIONS //
     ////////////////////
@@ -275,6 +275,29 @@ void realizePosition(const SBStateDigest& sbs) const
     calcJointIndependentKinematicsPos(pc);
 }
 
+// Only the quaternion normalization error needs recalculating here; see
+// RigidBodyNode::realizePositionQErr(). This repeats the q precalculations
+// but those produce the same values as are already in the cache.
+void realizePositionQErr(const SBStateDigest& sbs) const 
+{
+    const SBModelCache& mc = sbs.getModelCache();
+    const SBModelPerMobodInfo& mbInfo = getModelInfo(mc);
+    if (!mbInfo.hasQuaternionInUse)
+        return;
+
+    const SBInstanceCache&  ic   = sbs.getInstanceCache();
+    const Vector&           allQ = sbs.getQ();
+    SBTreePositionCache&    pc   = sbs.updTreePositionCache();
+    Vector&                 allQErr = sbs.updQErr();
+
+    const int nq=mbInfo.nQInUse, nqpool=mbInfo.nQPoolInUse;
+    const Real* q0    = &allQ[mbInfo.firstQIndex];
+    Real*       qpool0= nqpool ? &pc.mobilizerQCache[mbInfo.startInQPool] : 0;
+    Real*       qerr0 = &allQErr[ic.firstQuaternionQErrSlot
+                                 + mbInfo.quaternionPoolIndex];
+    performQPrecalculations(sbs, q0, nq, qpool0, nqpool, qerr0, 1);
+}
+
 // Set new velocities for the current configuration, and calculate
 // all the velocity-dependent terms. Must call base-to-tip.
 // This routine may assume that *all* position 
@@ -534,6 +557,11 @@ const SpatialVec& getH_FMCol(const SBTreePositionCache& pc, int j) const {
     return getH_FM(pc)(j);
 }
 
+// Get a column of HDot_FM, the time derivative of H_FM taken in F.
+SpatialVec getHDot_FMCol(const SBTreeVelocityCache& vc, int j) const {
+    return getHDot_FM(vc)(j);
+}
+
 // Access to body-oriented state and cache entries is the same for all nodes,
 // and joint oriented access is almost the same but parametrized by dof. There is a special
 // case for quaternions because they use an extra state variable, and although we don't
@@ -730,6 +758,69 @@ void multiplyByMInvPass2Outward(
     SpatialVec*                 allA_GB,
     Real*                       allUDot) const;
 
+// Batched operators. Every RigidBodyNodeSpec instantiation is its own batch
+// kind so we can call the operators above directly for each node in a run,
+// bypassing the virtual function table and allowing inlining. Note that 
+// these operators are never overridden by the concrete mobilizers.
+const void* getBatchKind() const;
+
+void realizeArticulatedBodyInertiasInwardBatch(
+    const RigidBodyNode* const*     nodes,
+    int                             nNodes,
+    const SBInstanceCache&          ic,
+    const SBTreePositionCache&      pc,
+    SBArticulatedBodyInertiaCache&  abc) const;
+
+void calcUDotPass1InwardBatch(
+    const RigidBodyNode* const* nodes,
+    int                         nNodes,
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const SBDynamicsCache&      dc,
+    const Real*                 jointForces,
+    const SpatialVec*           bodyForces,
+    const Real*                 allUDot,
+    SpatialVec*                 allZ,
+    SpatialVec*                 allGepsilon,
+    Real*                       allEpsilon) const;
+
+void calcUDotPass2OutwardBatch(
+    const RigidBodyNode* const* nodes,
+    int                         nNodes,
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const SBTreeVelocityCache&  vc,
+    const SBDynamicsCache&      dc,
+    const Real*                 epsilonTmp,
+    SpatialVec*                 allA_GB,
+    Real*                       allUDot,
+    Real*                       allTau) const;
+
+void multiplyByMInvPass1InwardBatch(
+    const RigidBodyNode* const* nodes,
+    int                         nNodes,
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const SBDynamicsCache&      dc,
+    const Real*                 f,
+    SpatialVec*                 allZ,
+    SpatialVec*                 allGepsilon,
+    Real*                       allEpsilon) const;
+
+void multiplyByMInvPass2OutwardBatch(
+    const RigidBodyNode* const* nodes,
+    int                         nNodes,
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const SBDynamicsCache&      dc,
+    const Real*                 epsilonTmp,
+    SpatialVec*                 allA_GB,
+    Real*                       allUDot) const;
+
 // Also serves as pass 1 for inverse dynamics.
 void calcBodyAccelerationsFromUdotOutward(
     const SBTreePositionCache&  pc,
@@ -746,6 +837,43 @@ void calcInverseDynamicsPass2Inward(
     SpatialVec*                 allFTmp,
     Real*                       allTau) const; 
 
+void calcInverseDynamicsDerivPass1Outward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const Real*                 allU,
+    const Real*                 allUDot,
+    const SpatialVec*           allA_GB,
+    const Real*                 allUPrime,
+    const Real*                 allDU,
+    const SpatialVec*           allDH_FM,
+    const SpatialVec*           allDHDot_FM,
+    SpatialVec*                 allVPrime,
+    SpatialVec*                 allDV,
+    SpatialVec*                 allDA) const;
+
+void calcInverseDynamicsDerivPass2Inward(
+    const SBTreePositionCache&  pc,
+    const SBTreeVelocityCache&  vc,
+    const SpatialVec*           allA_GB,
+    const SpatialVec*           allF,
+    const Real*                 allUPrime,
+    const SpatialVec*           allDH_FM,
+    const SpatialVec*           allVPrime,
+    const SpatialVec*           allDV,
+    const SpatialVec*           allDA,
+    SpatialVec*                 allDF,
+    Real*                       allDTau) const;
+
+// Change in H (==H_PB_G) when the parent moves with angular velocity
+// wPrime_GP and this mobilizer's H_FM changes by dH_FM while M turns in F
+// with angular velocity wPrime_FM. This is calcParentToChildVelocityJacobian-
+// InGroundDot() with those in place of the time derivatives.
+HType calcParentToChildVelocityJacobianInGroundDeriv(
+    const SBTreePositionCache&  pc,
+    const Vec3&                 wPrime_GP,
+    const Vec3&                 wPrime_FM,
+    const HType&                dH_FM) const;
+
 void multiplyByMPass1Outward(
     const SBTreePositionCache&  pc,
     const Real*                 allUDot,
@@ -756,6 +884,59 @@ void multiplyByMPass2Inward(
     SpatialVec*                 allFTmp,
     Real*                       allTau) const;
 
+// Multiple right hand side operators. These fetch H, G, Phi and the other
+// per-node quantities once and then apply them to every column.
+void multiplyByMInvPass1InwardMulti(
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const SBDynamicsCache&      dc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    const Real*                 f,
+    SpatialVec*                 allZ,
+    SpatialVec*                 allGepsilon,
+    Real*                       allEpsilon) const;
+
+void multiplyByMInvPass2OutwardMulti(
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const SBDynamicsCache&      dc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    const Real*                 epsilonTmp,
+    SpatialVec*                 allA_GB,
+    Real*                       allUDot) const;
+
+void multiplyByMPass1OutwardMulti(
+    const SBTreePositionCache&  pc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    const Real*                 allUDot,
+    SpatialVec*                 allA_GB) const;
+
+void multiplyByMPass2InwardMulti(
+    const SBTreePositionCache&  pc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    const SpatialVec*           allA_GB,
+    SpatialVec*                 allFTmp,
+    Real*                       allTau) const;
+
+void multiplyBySystemJacobianTransposeMulti(
+    const SBTreePositionCache&  pc,
+    int                         nCols,
+    int                         nu,
+    int                         nb,
+    SpatialVec*                 zTmp,
+    const SpatialVec*           X,
+    Real*                       JtX) const;
+
 };
 
 #endif // SimTK_SIMBODY_RIGID_BODY_NODE_SPEC_H_
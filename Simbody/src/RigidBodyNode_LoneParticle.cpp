@@ -388,6 +388,41 @@ void calcInverseDynamicsPass2Inward(
     tau = F[1] - myJointForce;
 }
 
+// A lone particle never rotates, so its inverse dynamics depends on neither
+// q nor u.
+void calcInverseDynamicsDerivPass1Outward(
+        const SBTreePositionCache&  pc,
+        const SBTreeVelocityCache&  vc,
+        const Real*                 allU,
+        const Real*                 allUDot,
+        const SpatialVec*           allA_GB,
+        const Real*                 allUPrime,
+        const Real*                 allDU,
+        const SpatialVec*           allDH_FM,
+        const SpatialVec*           allDHDot_FM,
+        SpatialVec*                 allVPrime,
+        SpatialVec*                 allDV,
+        SpatialVec*                 allDA) const {
+    allVPrime[nodeNum] = SpatialVec(Vec3(0), Vec3::getAs(&allUPrime[uIndex]));
+    allDV[nodeNum] = SpatialVec(Vec3(0), Vec3::getAs(&allDU[uIndex]));
+    allDA[nodeNum] = SpatialVec(Vec3(0), Vec3(0));
+}
+void calcInverseDynamicsDerivPass2Inward(
+        const SBTreePositionCache&  pc,
+        const SBTreeVelocityCache&  vc,
+        const SpatialVec*           allA_GB,
+        const SpatialVec*           allF,
+        const Real*                 allUPrime,
+        const SpatialVec*           allDH_FM,
+        const SpatialVec*           allVPrime,
+        const SpatialVec*           allDV,
+        const SpatialVec*           allDA,
+        SpatialVec*                 allDF,
+        Real*                       allDTau) const {
+    allDF[nodeNum] = SpatialVec(Vec3(0), Vec3(0));
+    Vec3::updAs(&allDTau[uIndex]) = 0;
+}
+
 void multiplyByMPass1Outward(
         const SBTreePositionCache&  pc,
         const Real*                 allUDot,
@@ -424,6 +459,10 @@ const SpatialVec& getH_FMCol(const SBTreePositionCache& pc, int j) const {
     return col;
 }
 
+SpatialVec getHDot_FMCol(const SBTreeVelocityCache& vc, int j) const {
+    return SpatialVec(Vec3(0), Vec3(0));
+}
+
 void setQToFitTransformImpl(const SBStateDigest&, const Transform& X_F0M0, Vector& q) const {
     Vec3::updAs(&q[qIndex]) = X_F0M0.p();
 }
@@ -293,6 +293,43 @@ public:
         // no taus
     }
 
+    // Ground doesn't move.
+    void calcInverseDynamicsDerivPass1Outward(
+        const SBTreePositionCache&  pc,
+        const SBTreeVelocityCache&  vc,
+        const Real*                 allU,
+        const Real*                 allUDot,
+        const SpatialVec*           allA_GB,
+        const Real*                 allUPrime,
+        const Real*                 allDU,
+        const SpatialVec*           allDH_FM,
+        const SpatialVec*           allDHDot_FM,
+        SpatialVec*                 allVPrime,
+        SpatialVec*                 allDV,
+        SpatialVec*                 allDA) const
+    {
+        allVPrime[0] = 0;
+        allDV[0]     = 0;
+        allDA[0]     = 0;
+    }
+
+    // Nothing needs the change in the force on Ground.
+    void calcInverseDynamicsDerivPass2Inward(
+        const SBTreePositionCache&  pc,
+        const SBTreeVelocityCache&  vc,
+        const SpatialVec*           allA_GB,
+        const SpatialVec*           allF,
+        const Real*                 allUPrime,
+        const SpatialVec*           allDH_FM,
+        const SpatialVec*           allVPrime,
+        const SpatialVec*           allDV,
+        const SpatialVec*           allDA,
+        SpatialVec*                 allDF,
+        Real*                       allDTau) const
+    {
+        allDF[0] = 0;
+    }
+
     void multiplyByMPass1Outward(
         const SBTreePositionCache&  pc,
         const Real*                 allUDot,
@@ -614,6 +651,44 @@ public:
         // no taus.
     }
 
+    // A weld contributes no motion of its own.
+    void calcInverseDynamicsDerivPass1Outward(
+        const SBTreePositionCache&  pc,
+        const SBTreeVelocityCache&  vc,
+        const Real*                 allU,
+        const Real*                 allUDot,
+        const SpatialVec*           allA_GB,
+        const Real*                 allUPrime,
+        const Real*                 allDU,
+        const SpatialVec*           allDH_FM,
+        const SpatialVec*           allDHDot_FM,
+        SpatialVec*                 allVPrime,
+        SpatialVec*                 allDV,
+        SpatialVec*                 allDA) const
+    {
+        const SpatialVec zero(Vec3(0), Vec3(0));
+        calcJointIndependentDerivPass1Outward(pc, vc, allA_GB,
+            zero, zero, zero, zero, allVPrime, allDV, allDA);
+    }
+
+    void calcInverseDynamicsDerivPass2Inward(
+        const SBTreePositionCache&  pc,
+        const SBTreeVelocityCache&  vc,
+        const SpatialVec*           allA_GB,
+        const SpatialVec*           allF,
+        const Real*                 allUPrime,
+        const SpatialVec*           allDH_FM,
+        const SpatialVec*           allVPrime,
+        const SpatialVec*           allDV,
+        const SpatialVec*           allDA,
+        SpatialVec*                 allDF,
+        Real*                       allDTau) const
+    {
+        calcJointIndependentDerivPass2Inward(pc, vc, allA_GB, allF,
+            allVPrime, allDV, allDA, allDF);
+        // no taus.
+    }
+
     void multiplyByMPass1Outward(
         const SBTreePositionCache&  pc,
         const Real*                 allUDot,
@@ -107,6 +107,24 @@ void SimbodyMatterSubsystem::setShowDefaultGeometry(bool show) {
     updRep().setShowDefaultGeometry(show);
 }
 
+void SimbodyMatterSubsystem::
+setUseParallelTreeSweeps(bool useParallel, int numThreads) {
+    updRep().setUseParallelTreeSweeps(useParallel, numThreads);
+}
+
+bool SimbodyMatterSubsystem::getUseParallelTreeSweeps() const {
+    return getRep().getUseParallelTreeSweeps();
+}
+
+void SimbodyMatterSubsystem::
+setParallelTreeSweepThreshold(int minBodiesPerLevel) {
+    updRep().setParallelTreeSweepThreshold(minBodiesPerLevel);
+}
+
+int SimbodyMatterSubsystem::getParallelTreeSweepThreshold() const {
+    return getRep().getParallelTreeSweepThreshold();
+}
+
 
 ConstraintIndex SimbodyMatterSubsystem::adoptConstraint(Constraint& child) {
     return updRep().adoptConstraint(child);
@@ -203,6 +221,35 @@ void SimbodyMatterSubsystem::calcAccelerationIgnoringConstraints
 
 
 
+//==============================================================================
+//            CALC ACCELERATION DERIVATIVES IGNORING CONSTRAINTS
+//==============================================================================
+void SimbodyMatterSubsystem::calcAccelerationDerivativesIgnoringConstraints
+   (const State&                state,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    Matrix&                     dUDot_dQ,
+    Matrix&                     dUDot_dU) const
+{
+    SimTK_APIARGCHECK2_ALWAYS(
+        appliedMobilityForces.size()==getNumMobilities(),
+        "SimbodyMatterSubsystem", 
+        "calcAccelerationDerivativesIgnoringConstraints",
+        "Got %d appliedMobilityForces but there are %d mobilities.",
+        appliedMobilityForces.size(), getNumMobilities());
+    SimTK_APIARGCHECK2_ALWAYS(
+        appliedBodyForces.size()==getNumBodies(),
+        "SimbodyMatterSubsystem", 
+        "calcAccelerationDerivativesIgnoringConstraints",
+        "Got %d appliedBodyForces but there are %d bodies (including Ground).",
+        appliedBodyForces.size(), getNumBodies());
+
+    getRep().calcAccelerationDerivativesIgnoringConstraints(state,
+        appliedMobilityForces, appliedBodyForces, dUDot_dQ, dUDot_dU);
+}
+
+
+
 //==============================================================================
 //                  CALC RESIDUAL FORCE IGNORING CONSTRAINTS
 //==============================================================================
@@ -448,12 +495,55 @@ void SimbodyMatterSubsystem::multiplyByMInv(const State&    state,
 
 
 
+//==============================================================================
+//                 MULTIPLY BY M and M INV -- MULTIPLE COLUMNS
+//==============================================================================
+// Check arguments and forward; the matrix implementation methods don't need
+// contiguous storage.
+void SimbodyMatterSubsystem::multiplyByM(const State&  state, 
+                                         const Matrix& A, 
+                                         Matrix&       MA) const
+{
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nu = rep.getNU(state);
+
+    SimTK_ERRCHK2_ALWAYS(A.nrow() == nu,
+        "SimbodyMatterSubsystem::multiplyByM()",
+        "Argument 'A' had %d rows but should have one row for each"
+        " of the mobilities (generalized speeds u) %d.", 
+        A.nrow(), nu);
+
+    rep.multiplyByM(state, A, MA);
+}
+
+void SimbodyMatterSubsystem::multiplyByMInv(const State&  state,
+                                            const Matrix& F,
+                                            Matrix&       MInvF) const
+{
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nu = rep.getNU(state);
+
+    SimTK_ERRCHK2_ALWAYS(F.nrow() == nu,
+        "SimbodyMatterSubsystem::multiplyByMInv()",
+        "Argument 'F' had %d rows but should have one row for each"
+        " of the mobilities (generalized speeds u) %d.", 
+        F.nrow(), nu);
+
+    rep.multiplyByMInv(state, F, MInvF);
+}
+
+
+
 void SimbodyMatterSubsystem::calcM(const State& s, Matrix& M) const 
 {   getRep().calcM(s, M); }
 
 void SimbodyMatterSubsystem::calcMInv(const State& s, Matrix& MInv) const 
 {   getRep().calcMInv(s, MInv); }
 
+void SimbodyMatterSubsystem::calcSparseM(const State& s, 
+                                         BranchInducedSparseMatrix& M) const 
+{   getRep().calcSparseM(s, M); }
+
 
 // Note: the implementation methods that generate matrices do *not* require 
 // contiguous storage, so we can just forward to them with no preliminaries.
@@ -467,6 +557,13 @@ solveForConstraintImpulses(const State&     state,
                            Vector&          impulse) const
 {   getRep().solveForConstraintImpulses(state,deltaV,impulse); }
 
+int SimbodyMatterSubsystem::getNumProjectedMInvFactorizationHits() const
+{   return getRep().getNumGMInvGtFactorizationHits(); }
+int SimbodyMatterSubsystem::getNumProjectedMInvFactorizationMisses() const
+{   return getRep().getNumGMInvGtFactorizationMisses(); }
+void SimbodyMatterSubsystem::resetProjectedMInvFactorizationCounters()
+{   updRep().resetGMInvGtFactorizationCounters(); }
+
 
 void SimbodyMatterSubsystem::calcG(const State& s, Matrix& G) const 
 {   getRep().calcPVA(s, true, true, true, G); }
@@ -550,6 +647,28 @@ multiplyByGTranspose(const State&  s,
         f = *cf;
 }
 
+// The matrix implementation method doesn't need contiguous storage.
+void SimbodyMatterSubsystem::
+multiplyByGTranspose(const State&  s,
+                     const Matrix& Lambda,
+                     Matrix&       F) const
+{
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const SBInstanceCache& ic = rep.getInstanceCache(s);
+
+    const int m = ic.totalNHolonomicConstraintEquationsInUse
+                + ic.totalNNonholonomicConstraintEquationsInUse
+                + ic.totalNAccelerationOnlyConstraintEquationsInUse;
+
+    SimTK_ERRCHK2_ALWAYS(Lambda.nrow() == m,
+        "SimbodyMatterSubsystem::multiplyByGTranspose()",
+        "Argument 'Lambda' had %d rows but should have one row for each"
+        " of the active constraint equations m=%d.", 
+        Lambda.nrow(), m);
+
+    rep.multiplyByPVATranspose(s, true, true, true, Lambda, F);
+}
+
 
 
 
@@ -1981,6 +2100,10 @@ void SimbodyMatterSubsystem::realizeCompositeBodyInertias(const State& s) const
 void SimbodyMatterSubsystem::realizeArticulatedBodyInertias(const State& s) const {
     getRep().realizeArticulatedBodyInertias(s);
 }
+void SimbodyMatterSubsystem::
+realizeBatch(const Array_<State*>& states, Stage stage) const {
+    getRep().realizeBatch(states, stage);
+}
 
 
 const Array_<QIndex>& SimbodyMatterSubsystem::
@@ -42,12 +42,500 @@
 using std::cout; using std::endl;
 
 SimbodyMatterSubsystemRep::SimbodyMatterSubsystemRep(const SimbodyMatterSubsystemRep& src)
-  : SimTK::Subsystem::Guts("SimbodyMatterSubsystemRep", "X.X.X")
+  : SimTK::Subsystem::Guts("SimbodyMatterSubsystemRep", "X.X.X"),
+    treeSweepExecutor(0), treeSweepNumThreads(0),
+    parallelTreeSweepThreshold(DefaultParallelTreeSweepThreshold)
 {
     assert(!"SimbodyMatterSubsystemRep copy constructor ... TODO!");
 }
 
 
+//==============================================================================
+//                            PARALLEL TREE SWEEPS
+//==============================================================================
+// All the nodes at one level of the tree are independent of one another. On
+// an outward (base-to-tip) pass a node reads only its parent's results, which
+// belong to the previous level, and on an inward (tip-to-base) pass only its
+// children's results from the following level. Each node writes only into
+// its own slots in the cache. So a level can be split across threads with no
+// synchronization other than waiting for the whole level to finish before
+// starting the next one. Every node performs exactly the same arithmetic 
+// regardless of which thread runs it, so the results are bitwise identical to
+// those of a serial sweep.
+//
+// The sweeps work from the execution plan in rbNodeBatchLevels, where each
+// level's nodes are grouped into runs that share a batch kind. The node
+// operators are handed a whole run at a time so that they can use the batched
+// (devirtualized) node methods where those exist.
+//
+// In parallel, the level is divided into one contiguous chunk of nodes per
+// thread, and each chunk is further cut at run boundaries. An exception 
+// can't propagate out of a ParallelExecutor worker thread, so we catch it in
+// the chunk that threw and rethrow on the calling thread after the level is
+// done. If several chunks fail we report the lowest-numbered one so that the
+// error doesn't depend on thread timing.
+
+namespace {
+
+template <class NodeOp>
+class LevelSweepTask : public ParallelExecutor::Task {
+public:
+    LevelSweepTask(const RBNodePtrList& nodes, const Array_<int>& runStart,
+                   int nChunks, const NodeOp& op)
+    :   nodes(nodes), runStart(runStart), op(op), errors(nChunks) {}
+
+    int getNumChunks() const {return (int)errors.size();}
+
+    void execute(int chunk) {
+        const int n = (int)nodes.size(), nChunks = getNumChunks();
+        const int begin = (chunk*n)/nChunks, end = ((chunk+1)*n)/nChunks;
+        try {
+            for (int r=0; r < (int)runStart.size()-1; ++r) {
+                const int lo = std::max(begin, runStart[r]);
+                const int hi = std::min(end, runStart[r+1]);
+                if (lo < hi) op(&nodes[lo], hi-lo);
+            }
+        } catch (const std::exception& e) {
+            errors[chunk] = e.what();
+            if (errors[chunk].empty()) errors[chunk] = "unknown error";
+        } catch (...) {
+            errors[chunk] = "unknown error";
+        }
+    }
+
+    void rethrowFirstError() const {
+        for (int i=0; i < getNumChunks(); ++i)
+            SimTK_ERRCHK1_ALWAYS(errors[i].empty(), 
+                "SimbodyMatterSubsystem::sweepLevel()",
+                "A parallel tree sweep failed: %s", errors[i].c_str());
+    }
+private:
+    const RBNodePtrList&    nodes;
+    const Array_<int>&      runStart;
+    const NodeOp&           op;
+    Array_<std::string>     errors; // one per chunk; empty if OK
+};
+
+// These are the per-node operations used in the realization sweeps.
+
+// Only nodes marked as needing realization get the full treatment; the
+// others just refresh their qerr entries.
+class RealizePositionOp {
+public:
+    RealizePositionOp(const SBStateDigest&                      sbs,
+                      const Array_<bool,MobilizedBodyIndex>&    needsRealizing)
+    :   sbs(sbs), needsRealizing(needsRealizing) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i)
+            if (needsRealizing[nodes[i]->getNodeNum()])
+                nodes[i]->realizePosition(sbs); 
+            else nodes[i]->realizePositionQErr(sbs); }
+private:
+    const SBStateDigest&                    sbs;
+    const Array_<bool,MobilizedBodyIndex>&  needsRealizing;
+};
+
+class RealizeVelocityOp {
+public:
+    explicit RealizeVelocityOp(const SBStateDigest& sbs) : sbs(sbs) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i) nodes[i]->realizeVelocity(sbs); }
+private:
+    const SBStateDigest& sbs;
+};
+
+class RealizeDynamicsOp {
+public:
+    RealizeDynamicsOp(const SBArticulatedBodyInertiaCache& abc,
+                      const SBStateDigest& sbs) : abc(abc), sbs(sbs) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i) nodes[i]->realizeDynamics(abc, sbs); }
+private:
+    const SBArticulatedBodyInertiaCache&    abc;
+    const SBStateDigest&                    sbs;
+};
+
+class RealizeArticulatedBodyInertiasOp {
+public:
+    RealizeArticulatedBodyInertiasOp(const SBInstanceCache&         ic,
+                                     const SBTreePositionCache&     tpc,
+                                     SBArticulatedBodyInertiaCache& abc)
+    :   ic(ic), tpc(tpc), abc(abc) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   nodes[0]->realizeArticulatedBodyInertiasInwardBatch
+                                                    (nodes,n,ic,tpc,abc); }
+private:
+    const SBInstanceCache&          ic;
+    const SBTreePositionCache&      tpc;
+    SBArticulatedBodyInertiaCache&  abc;
+};
+
+class CalcCompositeBodyInertiasOp {
+public:
+    CalcCompositeBodyInertiasOp(const SBTreePositionCache& tpc,
+                                Array_<SpatialInertia,MobilizedBodyIndex>& R)
+    :   tpc(tpc), R(R) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i) 
+            nodes[i]->calcCompositeBodyInertiasInward(tpc,R); }
+private:
+    const SBTreePositionCache&                  tpc;
+    Array_<SpatialInertia,MobilizedBodyIndex>&  R;
+};
+
+class RealizeYOp {
+public:
+    RealizeYOp(const SBInstanceCache&                ic,
+               const SBTreePositionCache&            tpc,
+               const SBArticulatedBodyInertiaCache&  abc,
+               SBDynamicsCache&                      dc)
+    :   ic(ic), tpc(tpc), abc(abc), dc(dc) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i) nodes[i]->realizeYOutward(ic,tpc,abc,dc); }
+private:
+    const SBInstanceCache&                  ic;
+    const SBTreePositionCache&              tpc;
+    const SBArticulatedBodyInertiaCache&    abc;
+    SBDynamicsCache&                        dc;
+};
+
+class CalcUDotPass1Op {
+public:
+    CalcUDotPass1Op(const SBInstanceCache&                  ic,
+                    const SBTreePositionCache&              tpc,
+                    const SBArticulatedBodyInertiaCache&    abc,
+                    const SBDynamicsCache&                  dc,
+                    const Real*                             jointForces,
+                    const SpatialVec*                       bodyForces,
+                    const Real*                             allUDot,
+                    SpatialVec*                             allZ,
+                    SpatialVec*                             allZPlus,
+                    Real*                                   allEpsilon)
+    :   ic(ic), tpc(tpc), abc(abc), dc(dc), jointForces(jointForces),
+        bodyForces(bodyForces), allUDot(allUDot), allZ(allZ), 
+        allZPlus(allZPlus), allEpsilon(allEpsilon) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   nodes[0]->calcUDotPass1InwardBatch(nodes,n,ic,tpc,abc,dc,
+            jointForces,bodyForces,allUDot,allZ,allZPlus,allEpsilon); }
+private:
+    const SBInstanceCache&                  ic;
+    const SBTreePositionCache&              tpc;
+    const SBArticulatedBodyInertiaCache&    abc;
+    const SBDynamicsCache&                  dc;
+    const Real*                             jointForces;
+    const SpatialVec*                       bodyForces;
+    const Real*                             allUDot;
+    SpatialVec*                             allZ;
+    SpatialVec*                             allZPlus;
+    Real*                                   allEpsilon;
+};
+
+class CalcUDotPass2Op {
+public:
+    CalcUDotPass2Op(const SBInstanceCache&                  ic,
+                    const SBTreePositionCache&              tpc,
+                    const SBArticulatedBodyInertiaCache&    abc,
+                    const SBTreeVelocityCache&              tvc,
+                    const SBDynamicsCache&                  dc,
+                    const Real*                             allEpsilon,
+                    SpatialVec*                             allA_GB,
+                    Real*                                   allUDot,
+                    Real*                                   allTau)
+    :   ic(ic), tpc(tpc), abc(abc), tvc(tvc), dc(dc), allEpsilon(allEpsilon),
+        allA_GB(allA_GB), allUDot(allUDot), allTau(allTau) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   nodes[0]->calcUDotPass2OutwardBatch(nodes,n,ic,tpc,abc,tvc,dc,
+            allEpsilon,allA_GB,allUDot,allTau); }
+private:
+    const SBInstanceCache&                  ic;
+    const SBTreePositionCache&              tpc;
+    const SBArticulatedBodyInertiaCache&    abc;
+    const SBTreeVelocityCache&              tvc;
+    const SBDynamicsCache&                  dc;
+    const Real*                             allEpsilon;
+    SpatialVec*                             allA_GB;
+    Real*                                   allUDot;
+    Real*                                   allTau;
+};
+
+class MultiplyByMInvPass1Op {
+public:
+    MultiplyByMInvPass1Op(const SBInstanceCache&                ic,
+                          const SBTreePositionCache&            tpc,
+                          const SBArticulatedBodyInertiaCache&  abc,
+                          const SBDynamicsCache&                dc,
+                          const Real*                           f,
+                          SpatialVec*                           allZ,
+                          SpatialVec*                           allZPlus,
+                          Real*                                 allEpsilon)
+    :   ic(ic), tpc(tpc), abc(abc), dc(dc), f(f), allZ(allZ), 
+        allZPlus(allZPlus), allEpsilon(allEpsilon) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   nodes[0]->multiplyByMInvPass1InwardBatch(nodes,n,ic,tpc,abc,dc,
+            f,allZ,allZPlus,allEpsilon); }
+private:
+    const SBInstanceCache&                  ic;
+    const SBTreePositionCache&              tpc;
+    const SBArticulatedBodyInertiaCache&    abc;
+    const SBDynamicsCache&                  dc;
+    const Real*                             f;
+    SpatialVec*                             allZ;
+    SpatialVec*                             allZPlus;
+    Real*                                   allEpsilon;
+};
+
+class MultiplyByMInvPass2Op {
+public:
+    MultiplyByMInvPass2Op(const SBInstanceCache&                ic,
+                          const SBTreePositionCache&            tpc,
+                          const SBArticulatedBodyInertiaCache&  abc,
+                          const SBDynamicsCache&                dc,
+                          const Real*                           allEpsilon,
+                          SpatialVec*                           allA_GB,
+                          Real*                                 allUDot)
+    :   ic(ic), tpc(tpc), abc(abc), dc(dc), allEpsilon(allEpsilon),
+        allA_GB(allA_GB), allUDot(allUDot) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   nodes[0]->multiplyByMInvPass2OutwardBatch(nodes,n,ic,tpc,abc,dc,
+            allEpsilon,allA_GB,allUDot); }
+private:
+    const SBInstanceCache&                  ic;
+    const SBTreePositionCache&              tpc;
+    const SBArticulatedBodyInertiaCache&    abc;
+    const SBDynamicsCache&                  dc;
+    const Real*                             allEpsilon;
+    SpatialVec*                             allA_GB;
+    Real*                                   allUDot;
+};
+
+// The multiple right hand side operators work one node at a time since each
+// node already loops over all the columns.
+class MultiplyByMInvPass1MultiOp {
+public:
+    MultiplyByMInvPass1MultiOp(const SBInstanceCache&                ic,
+                               const SBTreePositionCache&            tpc,
+                               const SBArticulatedBodyInertiaCache&  abc,
+                               const SBDynamicsCache&                dc,
+                               int nCols, int nu, int nb,
+                               const Real*                           f,
+                               SpatialVec*                           allZ,
+                               SpatialVec*                           allZPlus,
+                               Real*                                 allEpsilon)
+    :   ic(ic), tpc(tpc), abc(abc), dc(dc), nCols(nCols), nu(nu), nb(nb),
+        f(f), allZ(allZ), allZPlus(allZPlus), allEpsilon(allEpsilon) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i)
+            nodes[i]->multiplyByMInvPass1InwardMulti(ic,tpc,abc,dc,
+                nCols,nu,nb,f,allZ,allZPlus,allEpsilon); }
+private:
+    const SBInstanceCache&                  ic;
+    const SBTreePositionCache&              tpc;
+    const SBArticulatedBodyInertiaCache&    abc;
+    const SBDynamicsCache&                  dc;
+    const int                               nCols, nu, nb;
+    const Real*                             f;
+    SpatialVec*                             allZ;
+    SpatialVec*                             allZPlus;
+    Real*                                   allEpsilon;
+};
+
+class MultiplyByMInvPass2MultiOp {
+public:
+    MultiplyByMInvPass2MultiOp(const SBInstanceCache&                ic,
+                               const SBTreePositionCache&            tpc,
+                               const SBArticulatedBodyInertiaCache&  abc,
+                               const SBDynamicsCache&                dc,
+                               int nCols, int nu, int nb,
+                               const Real*                           allEpsilon,
+                               SpatialVec*                           allA_GB,
+                               Real*                                 allUDot)
+    :   ic(ic), tpc(tpc), abc(abc), dc(dc), nCols(nCols), nu(nu), nb(nb),
+        allEpsilon(allEpsilon), allA_GB(allA_GB), allUDot(allUDot) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i)
+            nodes[i]->multiplyByMInvPass2OutwardMulti(ic,tpc,abc,dc,
+                nCols,nu,nb,allEpsilon,allA_GB,allUDot); }
+private:
+    const SBInstanceCache&                  ic;
+    const SBTreePositionCache&              tpc;
+    const SBArticulatedBodyInertiaCache&    abc;
+    const SBDynamicsCache&                  dc;
+    const int                               nCols, nu, nb;
+    const Real*                             allEpsilon;
+    SpatialVec*                             allA_GB;
+    Real*                                   allUDot;
+};
+
+class MultiplyByMPass1MultiOp {
+public:
+    MultiplyByMPass1MultiOp(const SBTreePositionCache& tpc,
+                            int nCols, int nu, int nb,
+                            const Real* allUDot, SpatialVec* allA_GB)
+    :   tpc(tpc), nCols(nCols), nu(nu), nb(nb), 
+        allUDot(allUDot), allA_GB(allA_GB) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i)
+            nodes[i]->multiplyByMPass1OutwardMulti(tpc,nCols,nu,nb,
+                                                   allUDot,allA_GB); }
+private:
+    const SBTreePositionCache&  tpc;
+    const int                   nCols, nu, nb;
+    const Real*                 allUDot;
+    SpatialVec*                 allA_GB;
+};
+
+class MultiplyByMPass2MultiOp {
+public:
+    MultiplyByMPass2MultiOp(const SBTreePositionCache& tpc,
+                            int nCols, int nu, int nb,
+                            const SpatialVec* allA_GB, SpatialVec* allFTmp,
+                            Real* allTau)
+    :   tpc(tpc), nCols(nCols), nu(nu), nb(nb), 
+        allA_GB(allA_GB), allFTmp(allFTmp), allTau(allTau) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i)
+            nodes[i]->multiplyByMPass2InwardMulti(tpc,nCols,nu,nb,
+                                                  allA_GB,allFTmp,allTau); }
+private:
+    const SBTreePositionCache&  tpc;
+    const int                   nCols, nu, nb;
+    const SpatialVec*           allA_GB;
+    SpatialVec*                 allFTmp;
+    Real*                       allTau;
+};
+
+class MultiplyBySystemJacobianTransposeMultiOp {
+public:
+    MultiplyBySystemJacobianTransposeMultiOp
+       (const SBTreePositionCache& tpc, int nCols, int nu, int nb,
+        SpatialVec* zTmp, const SpatialVec* X, Real* JtX)
+    :   tpc(tpc), nCols(nCols), nu(nu), nb(nb), zTmp(zTmp), X(X), JtX(JtX) {}
+    void operator()(const RigidBodyNode* const* nodes, int n) const
+    {   for (int i=0; i < n; ++i)
+            nodes[i]->multiplyBySystemJacobianTransposeMulti(tpc,nCols,nu,nb,
+                                                             zTmp,X,JtX); }
+private:
+    const SBTreePositionCache&  tpc;
+    const int                   nCols, nu, nb;
+    SpatialVec*                 zTmp;
+    const SpatialVec*           X;
+    Real*                       JtX;
+};
+
+// Number of right hand sides we push through the tree together in the
+// multiple right hand side operators. The temporaries are sized for this many
+// columns, so larger isn't necessarily better.
+static const int MultiRHSBlockSize = 8;
+
+// Copy columns [j0,j0+nCols) of a Matrix into contiguous column-major 
+// storage, and back.
+void packColumns(const Matrix& A, int j0, int nCols, Real* buf) {
+    const int nr = A.nrow();
+    for (int j=0; j < nCols; ++j)
+        for (int i=0; i < nr; ++i)
+            buf[j*nr + i] = A(i, j0+j);
+}
+void unpackColumns(const Real* buf, int j0, int nCols, Matrix& A) {
+    const int nr = A.nrow();
+    for (int j=0; j < nCols; ++j)
+        for (int i=0; i < nr; ++i)
+            A(i, j0+j) = buf[j*nr + i];
+}
+
+}
+
+template <class NodeOp> void SimbodyMatterSubsystemRep::
+sweepLevel(int level, const NodeOp& op) const {
+    const RBNodePtrList& nodes    = rbNodeBatchLevels[level].nodes;
+    const Array_<int>&   runStart = rbNodeBatchLevels[level].runStart;
+    const int nNodes = (int)nodes.size();
+
+    // Go serial if parallel sweeps are off, the level is too narrow, or we
+    // are already running inside some other parallel task.
+    if (!treeSweepExecutor || nNodes < parallelTreeSweepThreshold
+        || ParallelExecutor::isWorkerThread()) 
+    {
+        for (int r=0; r < (int)runStart.size()-1; ++r)
+            op(&nodes[runStart[r]], runStart[r+1]-runStart[r]);
+        return;
+    }
+
+    LevelSweepTask<NodeOp> task(nodes, runStart, 
+                                std::min(treeSweepNumThreads,nNodes), op);
+    treeSweepExecutor->execute(task, task.getNumChunks());
+    task.rethrowFirstError();
+}
+
+template <class NodeOp> void SimbodyMatterSubsystemRep::
+sweepOutward(const NodeOp& op) const {
+    for (int i=0 ; i<(int)rbNodeBatchLevels.size() ; ++i)
+        sweepLevel(i, op);
+}
+
+template <class NodeOp> void SimbodyMatterSubsystemRep::
+sweepInward(const NodeOp& op) const {
+    for (int i=rbNodeBatchLevels.size()-1 ; i>=0 ; --i)
+        sweepLevel(i, op);
+}
+
+// Group the nodes at each level by batch kind. We want the plan to be the 
+// same from run to run so we order the runs by first appearance rather than
+// by the batch kind itself (which is an address). Nodes with a null batch
+// kind (Ground, Weld, particles) are collected into a run of their own; their
+// batched methods just call the virtual ones node by node.
+void SimbodyMatterSubsystemRep::buildNodeBatchLevels() {
+    rbNodeBatchLevels.clear();
+    rbNodeBatchLevels.resize(rbNodeLevels.size());
+    for (int i=0 ; i<(int)rbNodeLevels.size() ; ++i) {
+        const RBNodePtrList& level = rbNodeLevels[i];
+        NodeBatchLevel& plan = rbNodeBatchLevels[i];
+
+        Array_<const void*> kinds; // in order of first appearance
+        for (int j=0 ; j<(int)level.size() ; ++j) {
+            const void* kind = level[j]->getBatchKind();
+            if (std::find(kinds.begin(), kinds.end(), kind) == kinds.end())
+                kinds.push_back(kind);
+        }
+
+        // rbNodeLevels is already in node number order within a level.
+        for (int k=0; k < (int)kinds.size(); ++k) {
+            plan.runStart.push_back((int)plan.nodes.size());
+            for (int j=0 ; j<(int)level.size() ; ++j)
+                if (level[j]->getBatchKind() == kinds[k])
+                    plan.nodes.push_back(level[j]);
+        }
+        plan.runStart.push_back((int)plan.nodes.size());
+    }
+}
+
+void SimbodyMatterSubsystemRep::
+setUseParallelTreeSweeps(bool useParallel, int numThreads) {
+    SimTK_APIARGCHECK1_ALWAYS(!useParallel || numThreads > 0, 
+        "SimbodyMatterSubsystem", "setUseParallelTreeSweeps",
+        "The number of threads must be positive but was %d.", numThreads);
+
+    if (useParallel && treeSweepExecutor && numThreads == treeSweepNumThreads)
+        return; // nothing to do
+
+    delete treeSweepExecutor;
+    treeSweepExecutor = 0; treeSweepNumThreads = 0;
+    if (useParallel) {
+        treeSweepExecutor = new ParallelExecutor(numThreads);
+        treeSweepNumThreads = numThreads;
+    }
+}
+
+void SimbodyMatterSubsystemRep::
+setParallelTreeSweepThreshold(int minNodesPerLevel) {
+    SimTK_APIARGCHECK1_ALWAYS(minNodesPerLevel >= 1, 
+        "SimbodyMatterSubsystem", "setParallelTreeSweepThreshold",
+        "The threshold must be at least one node but was %d.", 
+        minNodesPerLevel);
+    parallelTreeSweepThreshold = minNodesPerLevel;
+}
+//........................... PARALLEL TREE SWEEPS .............................
+
+
 void SimbodyMatterSubsystemRep::clearTopologyState() {
     // Constraints are independent from one another, so any deletion order
     // is fine. However, they depend on bodies and not vice versa so we'll
@@ -91,6 +579,7 @@ void SimbodyMatterSubsystemRep::clearTopologyCache() {
     // be deleted when the MobilizedBodyImpl objects are.
     rbNodeLevels.clear();
     nodeNum2NodeMap.clear();
+    rbNodeBatchLevels.clear();
 
     showDefaultGeometry = true;
 }
@@ -225,6 +714,7 @@ void SimbodyMatterSubsystemRep::endConstruction(State& s) {
     nodeNum2NodeMap.clear();
     rbNodeLevels.clear();
     DOFTotal = SqDOFTotal = maxNQTotal = 0;
+    canReusePositionKinematics = true;
 
     // state allocation
     nextUSlot   = UIndex(0);
@@ -250,7 +740,12 @@ void SimbodyMatterSubsystemRep::endConstruction(State& s) {
         const int ndof = n.getDOF();
         DOFTotal += ndof; SqDOFTotal += ndof*ndof;
         maxNQTotal += n.getMaxNQ();
+        if (!mbr.kinematicsDependOnlyOnQ())
+            canReusePositionKinematics = false;
     }
+
+    // Compile the execution plan used by the tree sweeps.
+    buildNodeBatchLevels();
     
     // Order doesn't matter for constraints as long as the bodies are already 
     // there. Quaternion normalization constraints exist only at the 
@@ -551,6 +1046,17 @@ int SimbodyMatterSubsystemRep::realizeSubsystemModelImpl(State& s) const {
         allocateLazyCacheEntry(s, Stage::Position,
                                new Value<SBConstrainedVelocityCache>());
 
+    // The factored G*M^-1*~G matrix used to calculate constraint multipliers
+    // is expensive to form and is often needed repeatedly at the same
+    // configuration. It depends only on positions if all the constraints in
+    // use are holonomic; otherwise it depends on velocities too. We don't 
+    // know which case we're in until Instance stage, so allocate a lazy 
+    // entry for each case and use the appropriate one.
+    mc.qGMInvGtFactorCacheIndex = 
+        allocateLazyCacheEntry(s, Stage::Position, new Value<FactorQTZ>());
+    mc.uGMInvGtFactorCacheIndex = 
+        allocateLazyCacheEntry(s, Stage::Velocity, new Value<FactorQTZ>());
+
     // no z's
     // Probably no dynamics-stage variables but we'll allocate anyway.
     SBDynamicsVars dvars;
@@ -993,10 +1499,19 @@ int SimbodyMatterSubsystemRep::realizeSubsystemPositionImpl(const State& s) cons
 
     // Any body which is using quaternions should calculate the quaternion
     // constraint here and put it in the appropriate slot of qErr.
-    // Set generalized coordinates: sweep from base to tips.
-    for (int i=0 ; i<(int)rbNodeLevels.size() ; i++) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++)
-            rbNodeLevels[i][j]->realizePosition(stateDigest); 
+    // Set generalized coordinates: sweep from base to tips. Only the bodies
+    // whose q's or ancestors' q's have changed since the kinematics in the
+    // cache were calculated need to be recalculated; see markBodiesNeeding-
+    // PositionRealization().
+    markBodiesNeedingPositionRealization(stateDigest.getQ(), mc, tpc);
+    // If the sweep throws partway, the kinematics are a mix of old and new
+    // so there must be nothing recorded to compare against. (Clearing keeps
+    // the storage.)
+    tpc.lastQ.clear();
+    sweepOutward(RealizePositionOp(stateDigest, tpc.needsRealizing));
+    const Vector& q = stateDigest.getQ();
+    tpc.lastQ.resize(q.size());
+    for (int i=0; i < q.size(); ++i) tpc.lastQ[i] = q[i];
 
     // Ask the constraints to calculate ancestor-relative kinematics (still 
     // goes in TreePositionCache).
@@ -1040,6 +1555,53 @@ int SimbodyMatterSubsystemRep::realizeSubsystemPositionImpl(const State& s) cons
 
 
 
+//==============================================================================
+//               MARK BODIES NEEDING POSITION REALIZATION
+//==============================================================================
+// When only a few q's change between position realizations (as happens in 
+// assembly, inverse kinematics, and finite differencing) most bodies' 
+// kinematics are unchanged and the values left in the TreePositionCache from 
+// the last realization can be reused even though that cache entry has been
+// invalidated. A body must be recalculated only if one of its own q's or
+// one of its ancestors' q's changed; otherwise its transforms are exactly
+// what they would be if recalculated. The cache is reallocated whenever 
+// Instance stage is realized, so there is nothing to reuse after a change to
+// anything other than q. Custom mobilizers may depend on time or discrete
+// variables too, so if there are any we always recalculate everything. This 
+// costs O(nq) and a comparison per q.
+void SimbodyMatterSubsystemRep::
+markBodiesNeedingPositionRealization(const Vector&          q,
+                                     const SBModelCache&    mc,
+                                     SBTreePositionCache&   tpc) const
+{
+    Array_<bool,MobilizedBodyIndex>& needsRealizing = tpc.needsRealizing;
+    const int nq = q.size();
+
+    if (!canReusePositionKinematics || (int)tpc.lastQ.size() != nq) {
+        needsRealizing.fill(true); // nothing valid to reuse
+        return;
+    }
+
+    // Parents always have lower indices than their children so we can 
+    // propagate changes outward in a single pass.
+    needsRealizing[GroundIndex] = false;
+    for (MobilizedBodyIndex mbx(1); mbx < getNumBodies(); ++mbx) {
+        const RigidBodyNode& node = getRigidBodyNode(mbx);
+        if (needsRealizing[node.getParent()->getNodeNum()]) {
+            needsRealizing[mbx] = true;
+            continue;
+        }
+        const SBModelPerMobodInfo& mbInfo = mc.getMobodModelInfo(mbx);
+        const int q0 = mbInfo.firstQIndex;
+        bool changed = false;
+        for (int i=0; i < mbInfo.nQInUse && !changed; ++i)
+            changed = (q[q0+i] != tpc.lastQ[q0+i]);
+        needsRealizing[mbx] = changed;
+    }
+}
+
+
+
 //==============================================================================
 //                      REALIZE COMPOSITE BODY INERTIAS
 //==============================================================================
@@ -1080,13 +1642,160 @@ realizeArticulatedBodyInertias(const State& state) const {
     SBArticulatedBodyInertiaCache&  abc = updArticulatedBodyInertiaCache(state);
 
     // tip-to-base sweep
-    for (int i=rbNodeLevels.size()-1 ; i>=0 ; --i) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j)
-            rbNodeLevels[i][j]->realizeArticulatedBodyInertiasInward(ic,tpc,abc);
+    sweepInward(RealizeArticulatedBodyInertiasOp(ic,tpc,abc));
 
     markCacheValueRealized(state, abx);
 }
 
+// This is the same tip-to-base sweep for a whole batch of States. The loops
+// are ordered level, run, State, so a run's nodes stay in cache while only the
+// per-State cache entries change. States not yet realized through Position
+// stage, or whose articulated body inertias are already realized, are left 
+// alone. If a State's sweep throws, that State is dropped from the rest of
+// the sweep and left unrealized; realizing it in the ordinary way afterwards
+// will report the error.
+void SimbodyMatterSubsystemRep::
+realizeArticulatedBodyInertiasInLockstep(const Array_<State*>& states) const {
+    Array_<const State*>                    pending;
+    Array_<const SBInstanceCache*>          ic;
+    Array_<const SBTreePositionCache*>      tpc;
+    Array_<SBArticulatedBodyInertiaCache*>  abc;
+    for (int k=0; k < (int)states.size(); ++k) {
+        const State& state = *states[k];
+        if (getStage(state) < Stage::Position || isCacheValueRealized(state, 
+                getModelCache(state).articulatedBodyInertiaCacheIndex))
+            continue;
+        pending.push_back(&state);
+        ic.push_back(&getInstanceCache(state));
+        tpc.push_back(&getTreePositionCache(state));
+        abc.push_back(&updArticulatedBodyInertiaCache(state));
+    }
+
+    Array_<bool> failed(pending.size(), false);
+    for (int i=rbNodeBatchLevels.size()-1 ; i>=0 ; --i) {
+        const RBNodePtrList& nodes    = rbNodeBatchLevels[i].nodes;
+        const Array_<int>&   runStart = rbNodeBatchLevels[i].runStart;
+        for (int r=0; r < (int)runStart.size()-1; ++r) {
+            const RigidBodyNode* const* run = &nodes[runStart[r]];
+            const int n = runStart[r+1]-runStart[r];
+            for (int k=0; k < (int)pending.size(); ++k) {
+                if (failed[k]) continue;
+                try {
+                    run[0]->realizeArticulatedBodyInertiasInwardBatch
+                                            (run,n,*ic[k],*tpc[k],*abc[k]);
+                } catch (...) {
+                    failed[k] = true;
+                }
+            }
+        }
+    }
+
+    for (int k=0; k < (int)pending.size(); ++k)
+        if (!failed[k])
+            markCacheValueRealized(*pending[k], 
+                getModelCache(*pending[k]).articulatedBodyInertiaCacheIndex);
+}
+
+
+
+//==============================================================================
+//                               REALIZE BATCH
+//==============================================================================
+// Realize a batch of States that share this subsystem's System. Each State is
+// realized by System::realize(), one stage at a time across the whole batch 
+// (or across each thread's chunk of it). Before the Dynamics stage, the 
+// articulated body inertias, which are the most expensive part of it, are
+// realized for the whole chunk at once by the lockstep sweep above; 
+// realizeDynamics() then finds them already done. Concurrent chunks rely on
+// the System's realization counters being atomic. Failures are caught per 
+// State and the first one in batch order is reported after all the States 
+// have been processed, so the error doesn't depend on how the batch was 
+// divided among threads.
+
+namespace {
+
+class StateBatchTask : public ParallelExecutor::Task {
+public:
+    StateBatchTask(const SimbodyMatterSubsystemRep& matter,
+                   const Array_<State*>& states, Stage stage, int nChunks)
+    :   matter(matter), system(matter.getSystem()), states(states), 
+        stage(stage), nChunks(nChunks), errors(states.size()) {}
+
+    void execute(int chunk) {
+        const int n = (int)states.size();
+        realizeRange((chunk*n)/nChunks, ((chunk+1)*n)/nChunks);
+    }
+
+    void realizeRange(int begin, int end) {
+        // Find the least-realized State in this range; nothing below that
+        // needs doing.
+        Stage lowest = stage;
+        for (int i=begin; i < end; ++i)
+            lowest = std::min(lowest, states[i]->getSystemStage());
+
+        for (Stage g = lowest; g < stage; ) {
+            g = g.next(); // can't step past Report, so advance first
+            if (g == Stage::Dynamics) {
+                Array_<State*> pending;
+                for (int i=begin; i < end; ++i)
+                    if (errors[i].empty() && states[i]->getSystemStage() < g)
+                        pending.push_back(states[i]);
+                matter.realizeArticulatedBodyInertiasInLockstep(pending);
+            }
+            for (int i=begin; i < end; ++i) {
+                if (!errors[i].empty() || states[i]->getSystemStage() >= g)
+                    continue;
+                try {
+                    system.realize(*states[i], g);
+                } catch (const std::exception& e) {
+                    errors[i] = e.what();
+                    if (errors[i].empty()) errors[i] = "unknown error";
+                } catch (...) {
+                    errors[i] = "unknown error";
+                }
+            }
+        }
+    }
+
+    void rethrowFirstError() const {
+        for (int i=0; i < (int)errors.size(); ++i)
+            SimTK_ERRCHK2_ALWAYS(errors[i].empty(), 
+                "SimbodyMatterSubsystem::realizeBatch()",
+                "Realization of State %d in the batch failed: %s", 
+                i, errors[i].c_str());
+    }
+private:
+    const SimbodyMatterSubsystemRep&    matter;
+    const System&                       system;
+    const Array_<State*>&               states;
+    const Stage                         stage;
+    const int                           nChunks;
+    Array_<std::string>                 errors; // one per State; empty if OK
+};
+
+}
+
+void SimbodyMatterSubsystemRep::
+realizeBatch(const Array_<State*>& states, Stage stage) const {
+    for (int i=0; i < (int)states.size(); ++i)
+        SimTK_APIARGCHECK1_ALWAYS(states[i] != 0, 
+            "SimbodyMatterSubsystem", "realizeBatch",
+            "The State pointer at index %d of the batch was null.", i);
+
+    const int nStates = (int)states.size();
+    if (nStates == 0 || stage == Stage::Empty)
+        return;
+
+    const int nChunks = treeSweepExecutor && !ParallelExecutor::isWorkerThread()
+                        ? std::min(treeSweepNumThreads, nStates) : 1;
+
+    StateBatchTask task(*this, states, stage, nChunks);
+    if (nChunks == 1) task.realizeRange(0, nStates);
+    else treeSweepExecutor->execute(task, nChunks);
+    task.rethrowFirstError();
+}
+//.............................. REALIZE BATCH ................................
+
 
 
 //==============================================================================
@@ -1125,9 +1834,7 @@ int SimbodyMatterSubsystemRep::realizeSubsystemVelocityImpl(const State& s) cons
     // and all global velocities relative to Ground (G).
 
     // Set generalized speeds: sweep from base to tips.
-    for (int i=0 ; i<(int)rbNodeLevels.size() ; ++i) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j)
-            rbNodeLevels[i][j]->realizeVelocity(stateDigest); 
+    sweepOutward(RealizeVelocityOp(stateDigest));
 
     // Ask the constraints to calculate ancestor-relative velocity kinematics 
     // (still goes in TreePositionCache).
@@ -1201,9 +1908,7 @@ int SimbodyMatterSubsystemRep::realizeSubsystemDynamicsImpl(const State& s)  con
 
     // Realize velocity-dependent articulated body quantities needed for 
     // dynamics: base-to-tip.
-    for (int i=0; i < (int)rbNodeLevels.size(); ++i)
-        for (int j=0; j < (int)rbNodeLevels[i].size(); ++j)
-            rbNodeLevels[i][j]->realizeDynamics(abc, stateDigest);
+    sweepOutward(RealizeDynamicsOp(abc, stateDigest));
 
     // MobilizedBodies
     // This will include writing the prescribed accelerations into
@@ -2203,13 +2908,138 @@ multiplyByPVATranspose( const State&     s,
     allfuVector += ftmp;
 }
 
+// This is the multiple right hand side version of the above, where each
+// column of lambda is a set of multipliers and we produce the corresponding
+// column of fu=~G*lambda. We work on MultiRHSBlockSize columns at a time; for
+// each constraint we look up its force-generating information once and use
+// it for all the columns of the block, then map all the accumulated body 
+// forces into u-space with a single blocked ~J sweep.
+// It is OK if lambda and fu don't use contiguous storage.
+// Complexity is O(k*(m+n)) for k columns.
+void SimbodyMatterSubsystemRep::
+multiplyByPVATranspose( const State&     s,
+                        bool             includeP,
+                        bool             includeV,
+                        bool             includeA,
+                        const Matrix&    lambda,
+                        Matrix&          fu) const
+{
+    const SBInstanceCache&     ic  = getInstanceCache(s);
+    const SBTreePositionCache& tpc = getTreePositionCache(s);
+
+    // Global problem dimensions.
+    const int mHolo    = includeP ? 
+        ic.totalNHolonomicConstraintEquationsInUse : 0;
+    const int mNonholo = includeV ? 
+        ic.totalNNonholonomicConstraintEquationsInUse : 0;
+    const int mAccOnly = includeA ? 
+        ic.totalNAccelerationOnlyConstraintEquationsInUse : 0;
+    const int m = mHolo+mNonholo+mAccOnly;
+
+    const int nu = getNU(s);
+    const int nb = getNumBodies();
+    const int nc = lambda.ncol();
+
+    assert(lambda.nrow() == m);
+
+    fu.resize(nu, nc);
+    if (nu==0 || nc==0) return;
+    if (m==0) {fu.setToZero(); return;}
+
+    const int k = std::min(nc, MultiRHSBlockSize);
+
+    // Block temporaries, one column per right hand side.
+    Array_<Real>       allLambda(k*m), allfu(k*nu), Jtf(k*nu);
+    Array_<SpatialVec> allF_G(k*nb), zTmp(k*nb);
+
+    // Per-constraint temporaries; see the single-column method above.
+    Array_<SpatialVec,ConstrainedBodyIndex> oneF_G; // body spatial forces
+    Array_<Real,      ConstrainedUIndex>    onefu;  // u-space generalized forces     
+    Array_<Real,      ConstrainedQIndex>    onefq;  // q-space generalized forces     
+
+    for (int j0=0; j0 < nc; j0 += k) {
+        const int ncols = std::min(k, nc-j0);
+        packColumns(lambda, j0, ncols, allLambda.begin());
+        allF_G.fill(SpatialVec(Vec3(0)));
+        allfu.fill(Real(0));
+
+        for (ConstraintIndex cx(0); cx < constraints.size(); ++cx) {
+            if (isConstraintDisabled(s,cx))
+                continue;
+
+            const ConstraintImpl& crep = constraints[cx]->getImpl();
+            const SBInstancePerConstraintInfo& 
+                                  cInfo = ic.getConstraintInstanceInfo(cx);
+            const int ncb = crep.getNumConstrainedBodies();
+            const int ncu = cInfo.getNumConstrainedU();
+            const int ncq = cInfo.getNumConstrainedQ();
+
+            const Segment& holoSeg    = cInfo.holoErrSegment;
+            const Segment& nonholoSeg = cInfo.nonholoErrSegment;
+            const Segment& accOnlySeg = cInfo.accOnlyErrSegment;
+            const int mp = includeP ? holoSeg.length    : 0;
+            const int mv = includeV ? nonholoSeg.length : 0;
+            const int ma = includeA ? accOnlySeg.length : 0;
+            if (mp+mv+ma == 0)
+                continue;
+
+            const bool reexpress = crep.isAncestorDifferentFromGround();
+            const Rotation& R_GA = reexpress 
+                ? crep.getAncestorMobilizedBody().getBodyRotation(s)
+                : Rotation();
+
+            for (int j=0; j < ncols; ++j) {
+                const Real* lambdaj = &allLambda[j*m];
+                oneF_G.resize(ncb);                onefu.resize(ncu);
+                oneF_G.fill(SpatialVec(Vec3(0)));  onefu.fill(Real(0));
+
+                if (mp) {
+                    onefq.resize(ncq); onefq.fill(Real(0));
+                    const Real* p = lambdaj + holoSeg.offset;
+                    crep.addInPositionConstraintForces
+                       (s, ArrayViewConst_<Real>(p, p+mp), oneF_G, onefq);
+                    crep.convertQForcesToUForces(s, onefq, onefu);
+                }
+                if (mv) {
+                    const Real* p = lambdaj + mHolo + nonholoSeg.offset;
+                    crep.addInVelocityConstraintForces
+                       (s, ArrayViewConst_<Real>(p, p+mv), oneF_G, onefu);
+                }
+                if (ma) {
+                    const Real* p = lambdaj+mHolo+mNonholo+accOnlySeg.offset;
+                    crep.addInAccelerationConstraintForces
+                       (s, ArrayViewConst_<Real>(p, p+ma), oneF_G, onefu);
+                }
+
+                SpatialVec* F_Gj  = &allF_G[j*nb];
+                Real*       fuj   = &allfu[j*nu];
+                for (ConstrainedBodyIndex cbx(0); cbx < ncb; ++cbx) {
+                    const MobilizedBodyIndex mbx = 
+                        crep.getMobilizedBodyIndexOfConstrainedBody(cbx);
+                    F_Gj[mbx] += reexpress ? R_GA*oneF_G[cbx] : oneF_G[cbx];
+                }
+                for (ConstrainedUIndex cux(0); cux < ncu; ++cux) 
+                    fuj[cInfo.getUIndexFromConstrainedU(cux)] += onefu[cux]; 
+            }
+        }
+
+        // Map all the body forces into u-space generalized forces at once.
+        sweepInward(MultiplyBySystemJacobianTransposeMultiOp
+           (tpc, ncols, nu, nb, zTmp.begin(), allF_G.cbegin(), Jtf.begin()));
+        for (int i=0; i < ncols*nu; ++i)
+            allfu[i] += Jtf[i];
+
+        unpackColumns(allfu.cbegin(), j0, ncols, fu);
+    }
+}
+
 
 
 //==============================================================================
 //                             CALC PVA TRANSPOSE
 //==============================================================================
-// Arranges for contiguous workspace if necessary, then makes repeated calls
-// to multiplyByPVATranspose() to compute one column at a time of ~G.
+// Makes repeated calls to the multiple right hand side form of 
+// multiplyByPVATranspose() to compute a block of columns of ~G at a time.
 // Complexity is O(m^2 + m*n) = O(m*n).
 void SimbodyMatterSubsystemRep::
 calcPVATranspose(   const State&     s,
@@ -2235,22 +3065,13 @@ calcPVATranspose(   const State&     s,
     if (m==0 || nu==0)
         return;
 
-    Vector lambda(m, Real(0));
-
-    // If PVAt's columns are contiguous we can avoid copying.
-    const bool isContiguous = PVAt(0).hasContiguousData();
-    Vector contig_col(isContiguous ? 0 : m);
-    for (int j=0; j < m; ++j) {
-        lambda[j] = 1; // column we're working on
-        if (isContiguous) {
-            multiplyByPVATranspose(s, includeP, includeV, includeA, lambda, 
-                                   PVAt(j));
-        } else {
-            multiplyByPVATranspose(s, includeP, includeV, includeA, lambda, 
-                                   contig_col);
-            PVAt(j) = contig_col;
-        }
-        lambda[j] = 0;
+    Matrix E, col; // one block of identity columns and the result
+    for (int j0=0; j0 < m; j0 += MultiRHSBlockSize) {
+        const int ncols = std::min(MultiRHSBlockSize, m-j0);
+        E.resize(m, ncols); E.setToZero();
+        for (int j=0; j < ncols; ++j) E(j0+j, j) = 1;
+        multiplyByPVATranspose(s, includeP, includeV, includeA, E, col);
+        PVAt(0, j0, nu, ncols) = col;
     }
 }
 
@@ -3233,52 +4054,105 @@ calcGMInvGt(const State&   s,
     const bool columnsAreContiguous = GMInvGt(0).hasContiguousData();
     Vector GMInvGt_j(columnsAreContiguous ? 0 : m);
 
-    // These two temporaries are always needed to hold one column of Gt,
-    // then one column of M^-1 * Gt.
-    Vector Gtcol(nu), MInvGtcol(nu);
-
     // Precalculate bias so we can perform multiplication by G efficiently.
     Vector bias(m);
     calcBiasForMultiplyByPVA(s,true,true,true,bias);
-   
-    // Lambda is used to pluck out one column at a time of Gt. Exactly one
-    // element at a time of lambda will be 1, the rest are 0.
-    Vector lambda(m, Real(0));
-
-    for (int j=0; j < m; ++j) {
-        lambda[j] = 1;
-        multiplyByPVATranspose(s, true, true, true, lambda, Gtcol);
-        lambda[j] = 0;
-        multiplyByMInv(s, Gtcol, MInvGtcol);
-        if (columnsAreContiguous)
-            multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt(j));
-        else {
-            multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt_j);
-            GMInvGt(j) = GMInvGt_j;
+
+    // We work on a block of columns at a time. E holds identity columns
+    // which pluck out a block of columns of Gt; then we form the same block
+    // of M^-1 Gt with a single pair of blocked sweeps. Multiplying by G is 
+    // still done a column at a time.
+    Matrix E, Gt, MInvGt;
+    Vector MInvGtcol(nu);
+    for (int j0=0; j0 < m; j0 += MultiRHSBlockSize) {
+        const int ncols = std::min(MultiRHSBlockSize, m-j0);
+        E.resize(m, ncols); E.setToZero();
+        for (int j=0; j < ncols; ++j) E(j0+j, j) = 1;
+        multiplyByPVATranspose(s, true, true, true, E, Gt);
+        multiplyByMInv(s, Gt, MInvGt);
+        for (int j=0; j < ncols; ++j) {
+            MInvGtcol = MInvGt(j);
+            if (columnsAreContiguous)
+                multiplyByPVA(s, true, true, true, bias, MInvGtcol, 
+                              GMInvGt(j0+j));
+            else {
+                multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt_j);
+                GMInvGt(j0+j) = GMInvGt_j;
+            }
         }
     }
 } 
 
 
 
+// =============================================================================
+//                       GET G M^-1 ~G FACTORIZATION
+// =============================================================================
+// Return the factored G*M^-1*~G matrix from the State cache, forming and 
+// factoring it first if the cached one is out of date. If every constraint
+// equation in use is holonomic then G=P(t,q) and the factorization is good
+// until the positions change; otherwise V(t,q,u) and A(t,q,u) may depend on
+// velocities too so we have to use the Velocity-stage entry.
+const FactorQTZ& SimbodyMatterSubsystemRep::
+getGMInvGtFactorization(const State& s) const {
+    const SBModelCache&    mc = getModelCache(s);
+    const SBInstanceCache& ic = getInstanceCache(s);
+
+    const bool holonomicOnly = 
+        ic.totalNNonholonomicConstraintEquationsInUse == 0
+        && ic.totalNAccelerationOnlyConstraintEquationsInUse == 0;
+    const Stage dependsOn = holonomicOnly ? Stage::Position : Stage::Velocity;
+    const CacheEntryIndex fx = holonomicOnly ? mc.qGMInvGtFactorCacheIndex
+                                             : mc.uGMInvGtFactorCacheIndex;
+
+    SimTK_STAGECHECK_GE_ALWAYS(getStage(s), dependsOn, 
+        "SimbodyMatterSubsystemRep::getGMInvGtFactorization()");
+
+    if (isCacheValueRealized(s, fx)) {
+        ++numGMInvGtFactorizationHits;
+        return Value<FactorQTZ>::downcast(getCacheEntry(s, fx));
+    }
+
+    ++numGMInvGtFactorizationMisses;
+    Matrix GMInvGt;
+    calcGMInvGt(s, GMInvGt);
+
+    // Conditioning tolerance. This determines when we'll drop a 
+    // constraint. 
+    // TODO: this is probably too tight; should depend on constraint tolerance
+    // and should be consistent with position and velocity projection ranks.
+    // Tricky here because conditioning depends on mass matrix as well as
+    // constraints.
+    const Real conditioningTol = GMInvGt.nrow() 
+        //* SignificantReal;
+        * SqrtEps*std::sqrt(SqrtEps); // Eps^(3/4)
+
+    // specify 1/cond at which we declare rank deficiency
+    FactorQTZ& qtz = Value<FactorQTZ>::updDowncast(updCacheEntry(s, fx));
+    qtz.factor(GMInvGt, conditioningTol);
+
+    //printf("GMInvGt factor: m=%d condTol=%g rank=%d rcond=%g\n",
+    //    GMInvGt.nrow(), conditioningTol, qtz.getRank(),
+    //    qtz.getRCondEstimate());
+
+    markCacheValueRealized(s, fx);
+    return qtz;
+}
+
+
+
 // =============================================================================
 //                     SOLVE FOR CONSTRAINT IMPULSES
 // =============================================================================
-// Current implementation computes G*M^-1*~G, factors it, and does a single
-// solve all at great expense.
-// TODO: should realize factored matrix if needed and reuse if possible.
+// This uses the same factored G*M^-1*~G that forward dynamics uses, so it
+// deals with constraint redundancies exactly the same way. The factorization
+// is reused from the State cache if possible.
 void SimbodyMatterSubsystemRep::
 solveForConstraintImpulses(const State&     state,
                            const Vector&    deltaV,
                            Vector&          impulse) const
 {
-    Matrix GMInvGt;
-    calcGMInvGt(state, GMInvGt);
-    // MUST DUPLICATE SIMBODY'S METHOD HERE:
-    const Real conditioningTol = GMInvGt.nrow() 
-                                    * SqrtEps*std::sqrt(SqrtEps); // Eps^(3/4)
-    FactorQTZ qtz(GMInvGt, conditioningTol); 
-    qtz.solve(deltaV, impulse);
+    getGMInvGtFactorization(state).solve(deltaV, impulse);
 }
 
 
@@ -3970,7 +4844,8 @@ int SimbodyMatterSubsystemRep::projectQ
     FactorQTZ Pqwr_qtz;
     Real prevPerrNormAchieved = perrNormAchieved; // watch for divergence
     bool diverged = false;
-    const int MaxIterations  = 20;
+    const int MaxIterations  = opts.getMaxIterations() > 0 // caller's cap
+        ? std::min(opts.getMaxIterations(), 20) : 20;
     do {
         calcWeightedPqrTranspose(s, perrWeights, uAbsScale, Pqwrt);//nfq X mp
 
@@ -4519,7 +5394,8 @@ int SimbodyMatterSubsystemRep::projectU
 
     Real prevPVerrNormAchieved = pverrNormAchieved; // watch for divergence
     bool diverged = false;
-    const int MaxIterations  = 7;
+    const int MaxIterations  = opts.getMaxIterations() > 0 // caller's cap
+        ? std::min(opts.getMaxIterations(), 7) : 7;
     do {
         PVwr_qtz.solve(scaledPVerrs, dfu_WLS);
         lastChangeMadeWRMS = dfu_WLS.normRMS(); // change in weighted norm
@@ -4811,32 +5687,14 @@ void SimbodyMatterSubsystemRep::calcLoopForwardDynamicsOperator
     if (m==0) return;
     if (nu==0) {multipliers.setToZero(); return;}
 
-    // Conditioning tolerance. This determines when we'll drop a 
-    // constraint. 
-    // TODO: this is probably too tight; should depend on constraint tolerance
-    // and should be consistent with position and velocity projection ranks.
-    // Tricky here because conditioning depends on mass matrix as well as
-    // constraints.
-    const Real conditioningTol = m 
-        //* SignificantReal;
-        * SqrtEps*std::sqrt(SqrtEps); // Eps^(3/4)
-
     // Calculate multipliers lambda as
     //     (G M^-1 ~G) lambda = aerr
-    // The method here calculates the mXm matrix G*M^-1*G^T as fast as 
-    // I know how to do, O(m*n) with O(n) temporary memory, using a series
-    // of O(n) operators. Then we'll factor it here in O(m^3) time. 
-    Matrix GMInvGt(m,m);
-    calcGMInvGt(s, GMInvGt);
-    
-    // specify 1/cond at which we declare rank deficiency
-    FactorQTZ qtz(GMInvGt, conditioningTol); 
-
-    //printf("fwdDynamics: m=%d condTol=%g rank=%d rcond=%g\n",
-    //    GMInvGt.nrow(), conditioningTol, qtz.getRank(),
-    //    qtz.getRCondEstimate());
-
-    qtz.solve(udotErr, multipliers);
+    // The mXm matrix G*M^-1*G^T is calculated as fast as I know how to do,
+    // O(m*n) with O(n) temporary memory, using a series of O(n) operators,
+    // and then factored in O(m^3) time. But that only happens if we don't
+    // already have a valid factorization in the cache; repeated calls at the
+    // same configuration just do the O(m^2) solve.
+    getGMInvGtFactorization(s).solve(udotErr, multipliers);
 
     // We have the multipliers, now turn them into forces.
 
@@ -4905,9 +5763,7 @@ void SimbodyMatterSubsystemRep::calcCompositeBodyInertias(const State& s,
     const SBTreePositionCache& tpc = getTreePositionCache(s);
     R.resize(getNumBodies());
 
-    for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++)
-            rbNodeLevels[i][j]->calcCompositeBodyInertiasInward(tpc,R);
+    sweepInward(CalcCompositeBodyInertiasOp(tpc,R));
 }
 //....................... CALC COMPOSITE BODY INERTIAS .........................
 
@@ -4926,9 +5782,7 @@ void SimbodyMatterSubsystemRep::realizeY(const State& s) const {
     const SBArticulatedBodyInertiaCache&  abc = getArticulatedBodyInertiaCache(s);
     SBDynamicsCache&                      dc  = updDynamicsCache(s);
 
-    for (int i=0; i < (int)rbNodeLevels.size(); i++)
-        for (int j=0; j < (int)rbNodeLevels[i].size(); j++)
-            rbNodeLevels[i][j]->realizeYOutward(ic,tpc,abc,dc);
+    sweepOutward(RealizeYOp(ic,tpc,abc,dc));
 }
 //.................................. REALIZE Y .................................
 
@@ -5020,19 +5874,18 @@ void SimbodyMatterSubsystemRep::calcTreeAccelerations(const State& s,
     for (int i=0; i < (int)ic.zeroUDot.size(); ++i)
         udotPtr[ic.zeroUDot[i]] = 0;
 
-    for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
-            const RigidBodyNode& node = *rbNodeLevels[i][j];
-            node.calcUDotPass1Inward(ic,tpc,abc,dc,
-                mobilityForcePtr, bodyForcePtr, udotPtr, zPtr, zPlusPtr,
-                hingeForcePtr);
-        }
+    sweepInward(CalcUDotPass1Op(ic,tpc,abc,dc,
+        mobilityForcePtr, bodyForcePtr, udotPtr, zPtr, zPlusPtr,
+        hingeForcePtr));
+
+    sweepOutward(CalcUDotPass2Op(ic,tpc,abc,tvc,dc, 
+        hingeForcePtr, aPtr, udotPtr, tauPtr));
 
+    // Each node's qdotdot depends only on its own udot, so this doesn't have
+    // to be part of the outward sweep.
     for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
         for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
             const RigidBodyNode& node = *rbNodeLevels[i][j];
-            node.calcUDotPass2Outward(ic,tpc,abc,tvc,dc, 
-                hingeForcePtr, aPtr, udotPtr, tauPtr);
             node.calcQDotDot(sbs, &udotPtr[node.getUIndex()], 
                              &qdotdotPtr[node.getQIndex()]);
         }
@@ -5077,22 +5930,57 @@ void SimbodyMatterSubsystemRep::multiplyByMInv(const State& s,
     const Real* fPtr     = &f[0];       
     Real*       MInvfPtr = &MInvf[0];
 
-    for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
-            const RigidBodyNode& node = *rbNodeLevels[i][j];
-            node.multiplyByMInvPass1Inward(ic,tpc,abc,dc,
-                fPtr, z.begin(), zPlus.begin(), eps.begin());
-        }
+    sweepInward(MultiplyByMInvPass1Op(ic,tpc,abc,dc,
+        fPtr, z.begin(), zPlus.begin(), eps.begin()));
 
-    for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
-            const RigidBodyNode& node = *rbNodeLevels[i][j];
-            node.multiplyByMInvPass2Outward(ic,tpc,abc,dc, 
-                eps.cbegin(), A_GB.begin(), MInvfPtr);
-        }
+    sweepOutward(MultiplyByMInvPass2Op(ic,tpc,abc,dc, 
+        eps.cbegin(), A_GB.begin(), MInvfPtr));
 }
 //............................. CALC M INVERSE F ...............................
 
+// Calculate M^-1 F for a Matrix F whose columns are generalized forces. The 
+// columns are pushed through the two articulated body sweeps MultiRHSBlockSize
+// at a time so that each node's data is loaded only once per block rather 
+// than once per column. It is OK if F and MInvF don't use contiguous storage.
+void SimbodyMatterSubsystemRep::multiplyByMInv(const State& s,
+    const Matrix&                                           F,
+    Matrix&                                                 MInvF) const 
+{
+    const SBInstanceCache&                  ic  = getInstanceCache(s);
+    const SBTreePositionCache&              tpc = getTreePositionCache(s);
+    const SBDynamicsCache&                  dc  = getDynamicsCache(s);
+    const SBArticulatedBodyInertiaCache&    abc = getArticulatedBodyInertiaCache(s);
+
+    const int nb = getNumBodies();
+    const int nu = getNU(s);
+    const int nc = F.ncol();
+
+    assert(F.nrow() == nu);
+
+    MInvF.resize(nu, nc);
+    if (nu==0 || nc==0)
+        return;
+
+    const int k = std::min(nc, MultiRHSBlockSize);
+
+    // Temporaries, one column per right hand side in the block.
+    Array_<Real>        f(k*nu), eps(k*nu), udot(k*nu);
+    Array_<SpatialVec>  z(k*nb), zPlus(k*nb), A_GB(k*nb);
+
+    for (int j0=0; j0 < nc; j0 += k) {
+        const int ncols = std::min(k, nc-j0);
+        packColumns(F, j0, ncols, f.begin());
+
+        sweepInward(MultiplyByMInvPass1MultiOp(ic,tpc,abc,dc, ncols,nu,nb,
+            f.cbegin(), z.begin(), zPlus.begin(), eps.begin()));
+
+        sweepOutward(MultiplyByMInvPass2MultiOp(ic,tpc,abc,dc, ncols,nu,nb,
+            eps.cbegin(), A_GB.begin(), udot.begin()));
+
+        unpackColumns(udot.cbegin(), j0, ncols, MInvF);
+    }
+}
+
 
 
 //==============================================================================
@@ -5139,6 +6027,44 @@ void SimbodyMatterSubsystemRep::multiplyByM(const State&    s,
         }
 }
 
+// Calculate M A for a Matrix A whose columns are u-space accelerations, 
+// MultiRHSBlockSize columns per pair of sweeps. This Subsystem must already 
+// have been realized to Position stage. It is OK if A and MA don't use 
+// contiguous storage.
+void SimbodyMatterSubsystemRep::multiplyByM(const State&    s,
+                                            const Matrix&   A,
+                                            Matrix&         MA) const 
+{
+    const SBTreePositionCache& tpc = getTreePositionCache(s);
+    const int nb = getNumBodies();
+    const int nu = getNU(s);
+    const int nc = A.ncol();
+
+    assert(A.nrow() == nu);
+    MA.resize(nu, nc);
+
+    if (nu == 0 || nc == 0)
+        return;
+
+    const int k = std::min(nc, MultiRHSBlockSize);
+
+    // Temporaries, one column per right hand side in the block.
+    Array_<Real>        a(k*nu), Ma(k*nu);
+    Array_<SpatialVec>  fTmp(k*nb), A_GB(k*nb);
+
+    for (int j0=0; j0 < nc; j0 += k) {
+        const int ncols = std::min(k, nc-j0);
+        packColumns(A, j0, ncols, a.begin());
+
+        sweepOutward(MultiplyByMPass1MultiOp(tpc, ncols,nu,nb,
+                                             a.cbegin(), A_GB.begin()));
+        sweepInward(MultiplyByMPass2MultiOp(tpc, ncols,nu,nb,
+                                A_GB.cbegin(), fTmp.begin(), Ma.begin()));
+
+        unpackColumns(Ma.cbegin(), j0, ncols, MA);
+    }
+}
+
 
 
 //==============================================================================
@@ -5154,22 +6080,14 @@ void SimbodyMatterSubsystemRep::calcM(const State& s, Matrix& M) const {
 
     // This could be calculated much faster by doing it directly and calculating
     // only half of it. As a placeholder, however, we're doing this with 
-    // repeated O(n) calls to multiplyByM() to get M one column at a time.
-
-    // If M's columns are contiguous we can avoid copying.
-    const bool isContiguous = M(0).hasContiguousData();
-    Vector contig_col(isContiguous ? 0 : nu);
-
-    Vector v(nu); v.setToZero();
-    for (int i=0; i < nu; ++i) {
-        v[i] = 1;
-        if (isContiguous) {
-            multiplyByM(s, v, M(i));
-        } else {
-            multiplyByM(s, v, contig_col);
-            M(i) = contig_col;
-        }
-        v[i] = 0;
+    // blocked O(n) multiplyByM() sweeps, each producing several columns of M.
+    Matrix E, col; // one block of identity columns and the result
+    for (int j0=0; j0 < nu; j0 += MultiRHSBlockSize) {
+        const int ncols = std::min(MultiRHSBlockSize, nu-j0);
+        E.resize(nu, ncols); E.setToZero();
+        for (int j=0; j < ncols; ++j) E(j0+j, j) = 1;
+        multiplyByM(s, E, col);
+        M(0, j0, nu, ncols) = col;
     }
 }
 
@@ -5187,24 +6105,313 @@ void SimbodyMatterSubsystemRep::calcMInv(const State& s, Matrix& MInv) const {
     if (nu==0) return;
 
     // This could probably be calculated faster by doing it directly and
-    // filling in only half. For now we're doing it with repeated calls to
-    // the O(n) operator multiplyByMInv().
+    // filling in only half. For now we're doing it with blocked O(n) 
+    // multiplyByMInv() sweeps, each producing several columns of M^-1.
+    Matrix E, col; // one block of identity columns and the result
+    for (int j0=0; j0 < nu; j0 += MultiRHSBlockSize) {
+        const int ncols = std::min(MultiRHSBlockSize, nu-j0);
+        E.resize(nu, ncols); E.setToZero();
+        for (int j=0; j < ncols; ++j) E(j0+j, j) = 1;
+        multiplyByMInv(s, E, col);
+        MInv(0, j0, nu, ncols) = col;
+    }
+}
 
-    // If M's columns are contiguous we can avoid copying.
-    const bool isContiguous = MInv(0).hasContiguousData();
-    Vector contig_col(isContiguous ? 0 : nu);
 
-    Vector f(nu); f.setToZero();
-    for (int i=0; i < nu; ++i) {
-        f[i] = 1;
-        if (isContiguous) {
-            multiplyByMInv(s, f, MInv(i));
-        } else {
-            multiplyByMInv(s, f, contig_col);
-            MInv(i) = contig_col;
+
+//==============================================================================
+//                              CALC SPARSE M
+//==============================================================================
+// Calculate the mass matrix M in branch-induced sparse form using the
+// composite rigid body algorithm. For a mobility c of body k, the force
+// needed to produce a unit acceleration of that mobility is F=R_k*H_k(c),
+// where R_k is k's composite body inertia. Then M(c,c') = ~H(c')*F for every
+// mobility c' of k and of each of k's ancestors, shifting F inward across
+// each joint on the way. Only those entries can be nonzero.
+//
+// The u's are numbered so that a body's u's follow those of its parent, so
+// the row parent of a body's first u is the parent body's last u, and the
+// row parent of each of its other u's is the previous u. Bodies with no u's
+// are transparent; their children's first u's inherit from further inboard.
+// That is exactly the order in which we have to fill each sparse row.
+//
+// Complexity is O(n*d) for n mobilities and a tree of depth d. This Subsystem
+// must already have been realized to Position stage.
+void SimbodyMatterSubsystemRep::
+calcSparseM(const State& s, BranchInducedSparseMatrix& M) const {
+    const SBTreePositionCache& tpc = getTreePositionCache(s);
+    const int nu = getTotalDOF();
+    const int nb = getNumBodies();
+
+    // lastU[mbx] is the last u on the path from Ground to mbx, or -1.
+    Array_<int,MobilizedBodyIndex> lastU(nb, -1);
+    Array_<int> parents(nu);
+    for (MobilizedBodyIndex mbx(1); mbx < nb; ++mbx) {
+        const RigidBodyNode& node = getRigidBodyNode(mbx);
+        const int u0 = node.getUIndex(), dof = node.getDOF();
+        const int parentLast = lastU[node.getParent()->getNodeNum()];
+        for (int c=0; c < dof; ++c)
+            parents[u0+c] = (c==0 ? parentLast : u0+c-1);
+        lastU[mbx] = dof ? u0+dof-1 : parentLast;
+    }
+
+    M.setStructure(parents);
+    if (nu==0) return;
+
+    Array_<SpatialInertia,MobilizedBodyIndex> R;
+    calcCompositeBodyInertias(s, R);
+
+    for (MobilizedBodyIndex mbx(1); mbx < nb; ++mbx) {
+        const RigidBodyNode& node = getRigidBodyNode(mbx);
+        const int u0 = node.getUIndex(), dof = node.getDOF();
+        for (int c=0; c < dof; ++c) {
+            ArrayView_<Real> row = M.updRow(u0+c);
+            SpatialVec F = R[mbx]*node.getHCol(tpc,c);
+            int k = 0; // next entry in row
+            for (int c2=c; c2 >= 0; --c2)
+                row[k++] = ~node.getHCol(tpc,c2)*F;
+            const RigidBodyNode* child = &node;
+            for (const RigidBodyNode* anc = node.getParent();
+                 !anc->isGroundNode(); child = anc, anc = anc->getParent())
+            {
+                F = child->getPhi(tpc)*F; // shift inward across child's joint
+                for (int c2=anc->getDOF()-1; c2 >= 0; --c2)
+                    row[k++] = ~anc->getHCol(tpc,c2)*F;
+            }
+            assert(k == (int)row.size());
+        }
+    }
+}
+
+
+
+//==============================================================================
+//            CALC ACCELERATION DERIVATIVES IGNORING CONSTRAINTS
+//==============================================================================
+// With applied forces held fixed, the tree forward dynamics udot(q,u) is the
+// solution of r(q,u,udot) = M(q) udot + f_inertial(q,u) - f_applied = 0. So
+// if udot0 is the solution at the current state, differentiating gives
+//      M dudot/dx = -dr/dx, evaluated at udot=udot0
+// for x either q or u, and we get both Jacobians with a single multiple right
+// hand side M^-1 operation once the columns of dr/dx are known.
+//
+// Each column of dr/dx comes from differentiating the two inverse dynamics
+// passes along that one q or u; see calcInverseDynamicsDerivPass1Outward().
+// A change dq in one mobilizer's q's moves its outboard bodies as though the
+// mobilizer had generalized speeds uPrime = N^-1 dq, and changes its H_FM by
+// HDot_FM evaluated at uPrime. The mobilizers only supply HDot_FM at the
+// State's own u, but it is linear in u and depends only on the mobilizer's
+// own u's, so realizing tree velocities on a copy of the State with the i'th
+// u of every mobilizer set to one gives the i'th column of all of them at
+// once. The derivative with respect to q of HDot_FM at fixed u is a second
+// derivative that mobilizers don't supply. It is zero for mobilizers whose
+// H_FM is constant (pins, sliders, balls, free joints and so on); if there
+// are any others we take central differences of HDot_FM, again perturbing
+// the j'th q of every mobilizer at once. So the State copy's tree kinematics
+// (matter subsystem only) is realized at most 1 + max(dof) + 2*max(nq) times,
+// however big the system is, and the rest is O(n) per column.
+//
+// Kinematics uses the normalized quaternion but N^-1 is unnormalized, which
+// makes N^-1 dq too big by |q|^2 for a quaternion q that is not unit length.
+//
+// The supplied State must be realized through Dynamics stage.
+void SimbodyMatterSubsystemRep::calcAccelerationDerivativesIgnoringConstraints
+   (const State&                s,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    Matrix&                     dUDot_dQ,
+    Matrix&                     dUDot_dU) const
+{
+    const SBModelVars&          mv  = getModelVars(s);
+    const SBTreePositionCache&  tpc = getTreePositionCache(s);
+    const SBTreeVelocityCache&  tvc = getTreeVelocityCache(s);
+    const SBDynamicsCache&      dc  = getDynamicsCache(s);
+    const int nq = getNQ(s), nu = getNU(s), nb = getNumBodies();
+
+    // The tree operators below want contiguous storage.
+    const Vector              mobForces(appliedMobilityForces);
+    const Vector_<SpatialVec> bodyForces(appliedBodyForces);
+    const Vector              q(s.getQ()), u(s.getU());
+
+    Vector udot0;
+    {   Vector netHingeForces(nu), tau, qdotdot;
+        Array_<SpatialVec,MobilizedBodyIndex> abForcesZ(nb), abForcesZPlus(nb);
+        Vector_<SpatialVec> A_GB;
+        calcTreeAccelerations(s, mobForces, bodyForces, dc.presUDotPool,
+            netHingeForces, abForcesZ, abForcesZPlus, A_GB, udot0, qdotdot,
+            tau);
+    }
+
+    if (nu == 0) {
+        dUDot_dQ.resize(nu, nq); dUDot_dQ.setToZero();
+        dUDot_dU.resize(nu, nu); dUDot_dU.setToZero();
+        return;
+    }
+
+    // Inverse dynamics at udot0, keeping the body accelerations and forces.
+    Vector_<SpatialVec> A_GB(nb), F(nb);
+    Vector residual(nu);
+    for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
+        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++)
+            rbNodeLevels[i][j]->calcBodyAccelerationsFromUdotOutward
+               (tpc,tvc,&udot0[0],&A_GB[0]);
+    for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
+        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++)
+            rbNodeLevels[i][j]->calcInverseDynamicsPass2Inward
+               (tpc,tvc,&A_GB[0],&mobForces[0],&bodyForces[0],
+                &F[0],&residual[0]);
+
+    const SpatialVec zero(Vec3(0), Vec3(0));
+    int maxDOF = 0, maxNQ = 0;
+    for (int i=1 ; i<(int)rbNodeLevels.size() ; i++)
+        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
+            const RigidBodyNode& node = *rbNodeLevels[i][j];
+            maxDOF = std::max(maxDOF, node.getDOF());
+            maxNQ  = std::max(maxNQ,  node.getNQInUse(mv));
+        }
+
+    // HDot_FM at unit u's: hdotPerU[i][ux+c] is column c of HDot_FM for the
+    // mobilizer whose first u is ux, with its i'th u one and the rest zero.
+    // A copy of a State keeps only its Instance stage realization.
+    State tmp(s);
+    realizeSubsystemTime(tmp);
+    realizeSubsystemPosition(tmp);
+    Array_< Vector_<SpatialVec> > hdotPerU(maxDOF, Vector_<SpatialVec>(nu));
+    bool isHConstant = true;
+    for (int i=0; i < maxDOF; ++i) {
+        Vector& tmpU = tmp.updU();
+        tmpU = 0;
+        for (int l=1 ; l<(int)rbNodeLevels.size() ; l++)
+            for (int j=0 ; j<(int)rbNodeLevels[l].size() ; j++) {
+                const RigidBodyNode& node = *rbNodeLevels[l][j];
+                if (i < node.getDOF()) tmpU[node.getUIndex()+i] = 1;
+            }
+        realizeSubsystemVelocity(tmp);
+        const SBTreeVelocityCache& vc = getTreeVelocityCache(tmp);
+        for (int l=1 ; l<(int)rbNodeLevels.size() ; l++)
+            for (int j=0 ; j<(int)rbNodeLevels[l].size() ; j++) {
+                const RigidBodyNode& node = *rbNodeLevels[l][j];
+                const int ux = node.getUIndex();
+                for (int c=0; c < node.getDOF(); ++c) {
+                    hdotPerU[i][ux+c] = node.getHDot_FMCol(vc, c);
+                    if (hdotPerU[i][ux+c] != zero) isHConstant = false;
+                }
+            }
+    }
+
+    // dHDotPerQ[j][ux+c] is the derivative of column c of that mobilizer's
+    // HDot_FM with respect to its j'th q, at the State's u.
+    Array_< Vector_<SpatialVec> > dHDotPerQ;
+    if (!isHConstant) {
+        static const Real qStepScale = 
+            std::pow(NTraits<Real>::getEps(), Real(1)/3);
+        dHDotPerQ.resize(maxNQ, Vector_<SpatialVec>(nu));
+        Vector_<SpatialVec> hdotPlus(nu);
+        Vector step(nq);
+        tmp.updU() = u;
+        for (int jq=0; jq < maxNQ; ++jq) {
+            step = 0;
+            for (int l=1 ; l<(int)rbNodeLevels.size() ; l++)
+                for (int j=0 ; j<(int)rbNodeLevels[l].size() ; j++) {
+                    const RigidBodyNode& node = *rbNodeLevels[l][j];
+                    const int qx = node.getQIndex() + jq;
+                    if (jq < node.getNQInUse(mv))
+                        step[qx] = qStepScale*std::max(Real(1),std::abs(q[qx]));
+                }
+            for (int sign=1; sign >= -1; sign -= 2) {
+                tmp.updQ() = q + Real(sign)*step;
+                realizeSubsystemPosition(tmp);
+                realizeSubsystemVelocity(tmp);
+                const SBTreeVelocityCache& vc = getTreeVelocityCache(tmp);
+                for (int l=1 ; l<(int)rbNodeLevels.size() ; l++)
+                    for (int j=0 ; j<(int)rbNodeLevels[l].size() ; j++) {
+                        const RigidBodyNode& node = *rbNodeLevels[l][j];
+                        if (jq >= node.getNQInUse(mv)) continue;
+                        const int ux = node.getUIndex();
+                        const Real h = step[node.getQIndex() + jq];
+                        for (int c=0; c < node.getDOF(); ++c) {
+                            const SpatialVec col = node.getHDot_FMCol(vc, c);
+                            if (sign > 0) hdotPlus[ux+c] = col;
+                            else dHDotPerQ[jq][ux+c] = 
+                                    (hdotPlus[ux+c] - col) / (2*h);
+                        }
+                    }
+            }
         }
-        f[i] = 0;
     }
+
+    // Columns 0..nq-1 are dr/dq; the rest are dr/du. Columns for q's that
+    // aren't in use stay zero.
+    Matrix dr_dx(nu, nq+nu);
+    dr_dx.setToZero();
+
+    // Only the mobilizer whose q or u we're differentiating with respect to
+    // has nonzero entries in these.
+    Vector              uPrime(nu, Real(0)), du(nu, Real(0)), dTau(nu);
+    Vector_<SpatialVec> dH_FM(nu, zero), dHDot_FM(nu, zero);
+    Vector_<SpatialVec> VPrime(nb), dV(nb), dA(nb), dF(nb);
+
+    const SBStateDigest digest(s, *this, Stage(Stage::Position).next());
+    for (int l=1 ; l<(int)rbNodeLevels.size() ; l++)
+        for (int m=0 ; m<(int)rbNodeLevels[l].size() ; m++) {
+            const RigidBodyNode& node = *rbNodeLevels[l][m];
+            const int dof = node.getDOF(), nqInUse = node.getNQInUse(mv);
+            const int ux = node.getUIndex(), qx = node.getQIndex();
+            if (dof == 0) continue;
+
+            MobilizerQIndex quatIx;
+            const bool isQuat = node.isUsingQuaternion(digest, quatIx);
+            const Real quatNormSqr = 
+                isQuat ? Vec4::getAs(&q[qx+quatIx]).normSqr() : Real(1);
+
+            for (int k=0; k < nqInUse+dof; ++k) {
+                if (k < nqInUse) {
+                    Vec<7> dq(0); dq[k] = 1;
+                    node.multiplyByNInv(digest, false, &dq[0], &uPrime[ux]);
+                    if (isQuat && quatIx <= k && k < quatIx+4)
+                        for (int c=0; c < dof; ++c) uPrime[ux+c] /= quatNormSqr;
+                    for (int c=0; c < dof; ++c) {
+                        dH_FM[ux+c] = zero;
+                        for (int i=0; i < dof; ++i)
+                            dH_FM[ux+c] += uPrime[ux+i]*hdotPerU[i][ux+c];
+                        dHDot_FM[ux+c] = isHConstant ? zero 
+                                                     : dHDotPerQ[k][ux+c];
+                    }
+                } else {
+                    du[ux+k-nqInUse] = 1;
+                    for (int c=0; c < dof; ++c)
+                        dHDot_FM[ux+c] = hdotPerU[k-nqInUse][ux+c];
+                }
+
+                for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
+                    for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++)
+                        rbNodeLevels[i][j]->calcInverseDynamicsDerivPass1Outward
+                           (tpc,tvc,&u[0],&udot0[0],&A_GB[0],
+                            &uPrime[0],&du[0],&dH_FM[0],&dHDot_FM[0],
+                            &VPrime[0],&dV[0],&dA[0]);
+                for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
+                    for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++)
+                        rbNodeLevels[i][j]->calcInverseDynamicsDerivPass2Inward
+                           (tpc,tvc,&A_GB[0],&F[0],&uPrime[0],&dH_FM[0],
+                            &VPrime[0],&dV[0],&dA[0],&dF[0],&dTau[0]);
+
+                dr_dx(k < nqInUse ? qx+k : nq+ux+k-nqInUse) = dTau;
+
+                for (int c=0; c < dof; ++c) {
+                    uPrime[ux+c] = du[ux+c] = 0;
+                    dH_FM[ux+c] = dHDot_FM[ux+c] = zero;
+                }
+            }
+        }
+
+    // Prescribed rows of the result aren't written by M^-1; they are zero.
+    Matrix dudot_dx(nu, nq+nu);
+    dudot_dx.setToZero();
+    multiplyByMInv(s, dr_dx, dudot_dx);
+    dudot_dx *= -1;
+
+    dUDot_dQ = dudot_dx(0,  0, nu, nq);
+    dUDot_dU = dudot_dx(0, nq, nu, nu);
 }
 
 
@@ -141,7 +141,9 @@ private:
 class SimbodyMatterSubsystemRep : public SimTK::Subsystem::Guts {
 public:
     SimbodyMatterSubsystemRep() 
-      : Subsystem::Guts("SimbodyMatterSubsystem", "0.7.1")
+      : Subsystem::Guts("SimbodyMatterSubsystem", "0.7.1"),
+        treeSweepExecutor(0), treeSweepNumThreads(0),
+        parallelTreeSweepThreshold(DefaultParallelTreeSweepThreshold)
     { 
         clearTopologyCache();
     }
@@ -157,6 +159,7 @@ public:
         invalidateSubsystemTopologyCache();
         clearTopologyCache(); // should do cache before state
         clearTopologyState();
+        delete treeSweepExecutor;
     }
 
     SimbodyMatterSubsystemRep* cloneImpl() const {
@@ -429,6 +432,16 @@ public:
     // Call at Position Stage or later.
     void realizeArticulatedBodyInertias(const State&) const;
 
+    // Realize each of a batch of States through the given stage, stage by
+    // stage in lockstep, using the tree sweep thread pool if there is one.
+    void realizeBatch(const Array_<State*>& states, Stage stage) const;
+
+    // Realize the articulated body inertias of a batch of States with a
+    // single inward sweep that applies each run's batched node kernel to
+    // every State before moving on.
+    void realizeArticulatedBodyInertiasInLockstep
+       (const Array_<State*>& states) const;
+
         // OPERATORS //
 
     Real calcKineticEnergy(const State&) const;
@@ -498,6 +511,18 @@ public:
         const Vector&                   f,
         Vector&                         MInvf) const; 
 
+    // Multiple right hand side versions of the above. Each column of the
+    // input Matrix is treated as a separate right hand side and produces the
+    // corresponding column of the result, but a block of columns is carried 
+    // through each tree sweep together so that each node's data is loaded 
+    // once per block. The Matrices need not have contiguous storage.
+    void multiplyByM(const State& s,
+        const Matrix&             A,
+        Matrix&                   MA) const;
+    void multiplyByMInv(const State&    s,
+        const Matrix&                   F,
+        Matrix&                         MInvF) const; 
+
     // Calculate the mass matrix in O(n^2) time. State must have already
     // been realized to Position stage. M must be resizeable or already the
     // right size (nXn). The result is symmetric but the entire matrix is
@@ -511,6 +536,21 @@ public:
     // are not written.
     void calcMInv(const State& s, Matrix& MInv) const;
 
+    // Calculate the mass matrix in sparse form directly from the composite
+    // body inertias, in O(n*d) time for a tree of depth d. State must have
+    // already been realized to Position stage.
+    void calcSparseM(const State& s, BranchInducedSparseMatrix& M) const;
+
+    // Calculate the partial derivatives of the tree forward dynamics udot
+    // with respect to q and u, with the applied forces held fixed. State must
+    // have already been realized to Dynamics stage. Input Vectors need not be
+    // contiguous. O(n^2) time.
+    void calcAccelerationDerivativesIgnoringConstraints(const State& s,
+        const Vector&               appliedMobilityForces,
+        const Vector_<SpatialVec>&  appliedBodyForces,
+        Matrix&                     dUDot_dQ,
+        Matrix&                     dUDot_dU) const;
+
     void calcTreeResidualForces(const State&,
         const Vector&               appliedMobilityForces,
         const Vector_<SpatialVec>&  appliedBodyForces,
@@ -722,6 +762,14 @@ public:
                                 bool             includeA,
                                 const Vector&    lambda,
                                 Vector&          fu) const;
+    // Same, but for each column of lambda. Per-constraint and per-node data
+    // are loaded once for a block of columns.
+    void multiplyByPVATranspose(const State&     state,
+                                bool             includeP,
+                                bool             includeV,
+                                bool             includeA,
+                                const Matrix&    lambda,
+                                Matrix&          fu) const;
 
     // Explicitly form the u-space constraint Jacobian transpose 
     // ~G=[~P ~V ~A] or selected submatrices of it. Performance is best if the 
@@ -847,6 +895,19 @@ public:
                                     const Vector&    deltaV,
                                     Vector&          impulse) const;
 
+    // Return the factored G M^-1 G^T matrix, forming and factoring it only if
+    // there isn't already an up-to-date factorization in the State cache. The
+    // stage requirement is the same as for calcGMInvGt().
+    const FactorQTZ& getGMInvGtFactorization(const State& state) const;
+
+    // Statistics for the G M^-1 G^T factorization cache.
+    int getNumGMInvGtFactorizationHits() const 
+    {   return numGMInvGtFactorizationHits; }
+    int getNumGMInvGtFactorizationMisses() const 
+    {   return numGMInvGtFactorizationMisses; }
+    void resetGMInvGtFactorizationCounters() 
+    {   numGMInvGtFactorizationHits = 0; numGMInvGtFactorizationMisses = 0; }
+
     // Given an array of nu udots, return nb body accelerations in G (including
     // Ground as the 0th body with A_GB[0]=0). The returned accelerations are
     // A = J*udot + Jdot*u, with the Jdot*u (coriolis acceleration) term
@@ -1091,6 +1152,20 @@ public:
     bool getShowDefaultGeometry() const;
     void setShowDefaultGeometry(bool show);
 
+    // Parallel tree sweeps are off by default. When on, any level of the
+    // multibody tree with at least parallelTreeSweepThreshold nodes is split
+    // across a pool of numThreads threads during the base-to-tip and 
+    // tip-to-base realization sweeps.
+    bool getUseParallelTreeSweeps() const {return treeSweepExecutor != 0;}
+    void setUseParallelTreeSweeps(bool useParallel, int numThreads);
+    int  getParallelTreeSweepThreshold() const 
+    {   return parallelTreeSweepThreshold; }
+    void setParallelTreeSweepThreshold(int minNodesPerLevel);
+
+    // Levels with fewer nodes than this are swept serially by default since
+    // the per-node work is too small to pay for waking up the thread pool.
+    static const int DefaultParallelTreeSweepThreshold = 32;
+
 private:
     void calcTreeForwardDynamicsOperator(const State&,
         const Vector&                   mobilityForces,
@@ -1194,6 +1269,23 @@ private:
     // a properly-zeroed unpackedFreeU.
     void zeroKnownU(const State& s, Vector& ulike) const;
 
+    // Apply a node operator to every node at the given level, splitting the 
+    // level across the tree sweep threads if that is enabled and the level is
+    // wide enough. The operator is a function object that is called with a 
+    // run of nodes (const RigidBodyNode* const*, int) which all share the 
+    // same batch kind. The outward and inward versions apply the operator to 
+    // every level in base-to-tip or tip-to-base order, respectively.
+    template <class NodeOp> void sweepLevel(int level, const NodeOp&) const;
+    template <class NodeOp> void sweepOutward(const NodeOp&) const;
+    template <class NodeOp> void sweepInward(const NodeOp&) const;
+
+    // Compare q with the q's last used to calculate the kinematics in the
+    // TreePositionCache and set tpc.needsRealizing for every body whose
+    // kinematics would be different now.
+    void markBodiesNeedingPositionRealization(const Vector&          q,
+                                              const SBModelCache&    mc,
+                                              SBTreePositionCache&   tpc) const;
+
     friend std::ostream& operator<<(std::ostream&, const SimbodyMatterSubsystemRep&);
     friend class SimTK::SimbodyMatterSubsystem;
 
@@ -1244,6 +1336,23 @@ private:
     // Map nodeNum (a.k.a. MobilizedBodyIndex) to (level,offset).
     Array_<RigidBodyNodeIndex,MobilizedBodyIndex> nodeNum2NodeMap;
 
+    // This is the execution plan used by the tree sweeps. It holds the same
+    // nodes as rbNodeLevels, but within each level the nodes are grouped into
+    // runs that share a batch kind (see RigidBodyNode::getBatchKind()) so 
+    // that the hot operators can be applied to a whole run without virtual 
+    // dispatch. Runs appear in order of the first node number of each kind,
+    // and nodes within a run are in node number order. runStart holds the 
+    // offset of each run's first node, followed by the number of nodes in 
+    // the level.
+    struct NodeBatchLevel {
+        RBNodePtrList   nodes;
+        Array_<int>     runStart;
+    };
+    Array_<NodeBatchLevel> rbNodeBatchLevels;
+
+    // Build rbNodeBatchLevels from rbNodeLevels.
+    void buildNodeBatchLevels();
+
         // Constraints
 
     // Here we sort the above constraints by branch (ancestor's base body), then by
@@ -1311,11 +1420,32 @@ private:
     int SqDOFTotal; // sum of squares of ndofs per node
     int maxNQTotal; // sum of dofs with room for quaternions
 
+    // Whether position realization may reuse the kinematics of bodies whose
+    // q's haven't changed; false if any mobilizer depends on more than q.
+    bool canReusePositionKinematics;
+
     SBTopologyCache topologyCache;
     CacheEntryIndex topologyCacheIndex; // topologyCache is copied here in the State
     
     // Specifies whether default decorative geometry should be shown.
     bool showDefaultGeometry;
+
+        // PARALLEL SWEEP SETTINGS
+
+    // These are settings rather than topology; they don't affect results so
+    // changing them doesn't invalidate anything. The executor is null unless
+    // parallel tree sweeps have been requested.
+    ParallelExecutor*   treeSweepExecutor;
+    int                 treeSweepNumThreads;
+    int                 parallelTreeSweepThreshold;
+
+        // STATISTICS
+
+    // How often getGMInvGtFactorization() found a usable factorization in the
+    // State cache, and how often it had to form and factor the matrix. These
+    // are bumped from const methods, possibly on several threads at once.
+    mutable AtomicInteger numGMInvGtFactorizationHits;
+    mutable AtomicInteger numGMInvGtFactorizationMisses;
 };
 
 std::ostream& operator<<(std::ostream&, const SimbodyMatterSubsystemRep&);
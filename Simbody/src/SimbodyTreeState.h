@@ -258,6 +258,7 @@ public:
                           treePositionCacheIndex, constrainedPositionCacheIndex,
                           compositeBodyInertiaCacheIndex, articulatedBodyInertiaCacheIndex,
                           treeVelocityCacheIndex, constrainedVelocityCacheIndex,
+                          qGMInvGtFactorCacheIndex, uGMInvGtFactorCacheIndex,
                           dynamicsCacheIndex, 
                           treeAccelerationCacheIndex, constrainedAccelerationCacheIndex;
 
@@ -696,6 +697,16 @@ public:
     // the Ancestor frame rather than Ground.
     Array_<Transform> constrainedBodyConfigInAncestor;   // nacb (X_AB)
 
+        // Incremental realization
+
+    // These are the q's from which the above kinematics were last calculated;
+    // empty if they haven't been calculated since this entry was allocated.
+    // Since the kinematics of a body depend only on its own q's and those of
+    // its ancestors, a body whose q's and whose ancestors' q's all match 
+    // still has valid kinematics here even though the cache entry is stale.
+    Array_<Real>                        lastQ;      // nq
+    Array_<bool,MobilizedBodyIndex>     needsRealizing; // nb (temp)
+
 public:
     void allocate(const SBTopologyCache& tree,
                   const SBModelCache&    model,
@@ -736,6 +747,11 @@ public:
         bodyCOMInGround[GroundIndex] = Vec3(0);
 
         constrainedBodyConfigInAncestor.resize(nacb);
+
+        // Nothing calculated yet so there is nothing to reuse.
+        lastQ.clear();
+        needsRealizing.resize(nBodies);
+        needsRealizing.fill(true);
     }
 };
 //.......................... TREE POSITION CACHE ...............................
@@ -0,0 +1,150 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check the recursively calculated partial derivatives of the tree forward
+// dynamics against brute force central differences of
+// calcAccelerationIgnoringConstraints() using fully realized perturbed
+// States.
+
+#include "SimTKsimbody.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+// A branched tree with quaternions, a reversed mobilizer, a mobilizer whose
+// qdot and u differ, mobilizers whose H_FM depends on q, and a weld.
+static void buildTree(SimbodyMatterSubsystem& matter) {
+    const Body::Rigid body(MassProperties(1.5, Vec3(.1,.2,-.05),
+                                          Inertia(Vec3(.3,.2,.1))));
+    MobilizedBody::Pin      shoulder(matter.Ground(), Vec3(0,1,0),
+                                     body, Vec3(0,.5,0));
+    MobilizedBody::Ball     elbow(shoulder, Vec3(0,-.5,0), body, Vec3(0,.5,0));
+    MobilizedBody::Universal wrist(elbow, Vec3(0,-.5,0), body, Vec3(0,.2,0));
+    MobilizedBody::Slider   finger(wrist, Vec3(.1,-.2,0), body, Vec3(0));
+    MobilizedBody::Pin      thumb(wrist, Vec3(-.1,-.2,0), body, Vec3(0),
+                                  MobilizedBody::Reverse);
+    MobilizedBody::Free     side(shoulder, Vec3(1,0,0), body, Vec3(0));
+    MobilizedBody::Gimbal   head(side, Vec3(0,.3,0), body, Vec3(0));
+    MobilizedBody::Weld     hat(head, Vec3(0,.2,0), body, Vec3(0,-.1,0));
+    MobilizedBody::Ellipsoid feather(hat, Vec3(.1,.1,0), body, Vec3(0,-.2,0),
+                                     Vec3(.3,.2,.1));
+}
+
+static void calcUDot(const MultibodySystem& system, State& state,
+                     const Vector& mobForces, 
+                     const Vector_<SpatialVec>& bodyForces,
+                     Vector& udot) {
+    Vector_<SpatialVec> A_GB;
+    system.realize(state, Stage::Dynamics);
+    system.getMatterSubsystem().calcAccelerationIgnoringConstraints
+        (state, mobForces, bodyForces, udot, A_GB);
+}
+
+void testAgainstFiniteDifferences() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    buildTree(matter);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    const int nq = state.getNQ(), nu = state.getNU();
+    Random::Uniform rand(-1, 1);
+    rand.setSeed(7);
+    for (int i=0; i < nq; ++i) state.updQ()[i] = rand.getValue();
+    for (int i=0; i < nu; ++i) state.updU()[i] = 2*rand.getValue();
+    system.realize(state, Stage::Dynamics);
+
+    Vector mobForces(nu);
+    for (int i=0; i < nu; ++i) mobForces[i] = rand.getValue();
+    Vector_<SpatialVec> bodyForces(matter.getNumBodies());
+    for (int i=0; i < bodyForces.size(); ++i)
+        bodyForces[i] = SpatialVec(Vec3(rand.getValue(), rand.getValue(),
+                                        rand.getValue()),
+                                   Vec3(rand.getValue(), rand.getValue(),
+                                        rand.getValue()));
+
+    Matrix dUDot_dQ, dUDot_dU;
+    matter.calcAccelerationDerivativesIgnoringConstraints(state,
+        mobForces, bodyForces, dUDot_dQ, dUDot_dU);
+    SimTK_TEST(dUDot_dQ.nrow() == nu && dUDot_dQ.ncol() == nq);
+    SimTK_TEST(dUDot_dU.nrow() == nu && dUDot_dU.ncol() == nu);
+
+    const Real h = 1e-5;
+    State tmp(state);
+    Vector udotPlus, udotMinus;
+    Matrix fdQ(nu, nq), fdU(nu, nu);
+    for (int j=0; j < nq; ++j) {
+        const Real qj = state.getQ()[j];
+        tmp.updQ()[j] = qj + h;
+        calcUDot(system, tmp, mobForces, bodyForces, udotPlus);
+        tmp.updQ()[j] = qj - h;
+        calcUDot(system, tmp, mobForces, bodyForces, udotMinus);
+        tmp.updQ()[j] = qj;
+        fdQ(j) = (udotPlus - udotMinus) / (2*h);
+    }
+    for (int j=0; j < nu; ++j) {
+        const Real uj = state.getU()[j];
+        tmp.updU()[j] = uj + h;
+        calcUDot(system, tmp, mobForces, bodyForces, udotPlus);
+        tmp.updU()[j] = uj - h;
+        calcUDot(system, tmp, mobForces, bodyForces, udotMinus);
+        tmp.updU()[j] = uj;
+        fdU(j) = (udotPlus - udotMinus) / (2*h);
+    }
+
+    SimTK_TEST_EQ_TOL(dUDot_dQ, fdQ, 1e-6);
+    SimTK_TEST_EQ_TOL(dUDot_dU, fdU, 1e-6);
+
+    // The State we were given must not have been disturbed.
+    SimTK_TEST(state.getSystemStage() >= Stage::Dynamics);
+}
+
+// Zero velocity means no inertial forces, so udot doesn't depend on u.
+void testAtRest() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    buildTree(matter);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    system.realize(state, Stage::Dynamics);
+
+    Matrix dUDot_dQ, dUDot_dU;
+    matter.calcAccelerationDerivativesIgnoringConstraints(state,
+        Vector(state.getNU(), Real(0)),
+        Vector_<SpatialVec>(matter.getNumBodies(), SpatialVec(Vec3(0),Vec3(0))),
+        dUDot_dQ, dUDot_dU);
+    SimTK_TEST_EQ(dUDot_dU, Matrix(state.getNU(), state.getNU(), Real(0)));
+    // No forces and no motion: nothing happens wherever we are.
+    SimTK_TEST_EQ(dUDot_dQ, Matrix(state.getNU(), state.getNQ(), Real(0)));
+}
+
+int main() {
+    SimTK_START_TEST("TestAccelerationDerivatives");
+        SimTK_SUBTEST(testAgainstFiniteDifferences);
+        SimTK_SUBTEST(testAtRest);
+    SimTK_END_TEST();
+}
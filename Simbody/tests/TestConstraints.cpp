@@ -582,6 +582,51 @@ void testConstraintMatrices() {
 
 }
 
+// The factored G*M^-1*~G should be reused as long as the quantities it
+// depends on haven't changed, and give the same answers when it is.
+void testProjectedMInvFactorizationReuse() {
+    State state;
+    MultibodySystem& system = createSystem();
+    SimbodyMatterSubsystem& matter = system.updMatterSubsystem();
+    MobilizedBody& first = matter.updMobilizedBody(MobilizedBodyIndex(1));
+    MobilizedBody& last = matter.updMobilizedBody(MobilizedBodyIndex(NUM_BODIES));
+    Constraint::Ball ball(first, last);
+    createState(system, state);
+
+    matter.resetProjectedMInvFactorizationCounters();
+    state.invalidateAll(Stage::Dynamics);
+    system.realize(state, Stage::Acceleration); // positions didn't change
+    SimTK_TEST(matter.getNumProjectedMInvFactorizationHits() == 1);
+    SimTK_TEST(matter.getNumProjectedMInvFactorizationMisses() == 0);
+    const Vector udot = state.getUDot();
+
+    // Holonomic constraints only, so changing velocities is OK.
+    state.updU() *= 2;
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST(matter.getNumProjectedMInvFactorizationHits() == 2);
+    Vector impulse;
+    matter.solveForConstraintImpulses(state, Vector(3, Real(1)), impulse);
+    SimTK_TEST(matter.getNumProjectedMInvFactorizationHits() == 3);
+    SimTK_TEST(matter.getNumProjectedMInvFactorizationMisses() == 0);
+
+    // Recalculating from scratch must give the same udots.
+    state.updU() /= 2;
+    state.invalidateAll(Stage::Position);
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST(matter.getNumProjectedMInvFactorizationMisses() == 1);
+    SimTK_TEST_EQ(state.getUDot(), udot);
+
+    // With a nonholonomic constraint the factorization depends on u too.
+    Constraint::ConstantSpeed speed(last, MobilizerUIndex(1), .1);
+    createState(system, state);
+    matter.resetProjectedMInvFactorizationCounters();
+    state.updU() *= 2;
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST(matter.getNumProjectedMInvFactorizationHits() == 0);
+    SimTK_TEST(matter.getNumProjectedMInvFactorizationMisses() == 1);
+    delete &system;
+}
+
 int main() {
     SimTK_START_TEST("TestConstraints");
         SimTK_SUBTEST(testBallConstraint);
@@ -596,6 +641,7 @@ int main() {
         SimTK_SUBTEST(testWeldConstraintWithPreAssembly);
         SimTK_SUBTEST(testConstraintForces);
         SimTK_SUBTEST(testConstraintMatrices);
+        SimTK_SUBTEST(testProjectedMInvFactorizationReuse);
         SimTK_SUBTEST(testDisablingConstraints);
     SimTK_END_TEST();
 }
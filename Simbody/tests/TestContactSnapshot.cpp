@@ -0,0 +1,171 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check ContactSnapshot's lookups by ContactId and by surface pair as it
+// grows, and after it has been cleared and refilled. Also check that 
+// refilling a snapshot with existing Contacts doesn't allocate heap space;
+// we count allocations by replacing the global operator new. (Where the 
+// libraries are DLLs that have their own operator new, nothing is counted
+// and that part checks nothing.)
+
+#include "SimTKsimbody.h"
+#include "SimTKcommon/Testing.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+static bool countAllocations = false;
+static int  numAllocations = 0;
+
+void* operator new(std::size_t n) {
+    if (countAllocations) ++numAllocations;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t n) {
+    if (countAllocations) ++numAllocations;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) {std::free(p);}
+void operator delete[](void* p) {std::free(p);}
+
+// Fill the snapshot with contacts between surfaces (i, 3i+1) for
+// i = first..first+n-1, recording the ContactIds.
+void fillSnapshot(ContactSnapshot& snapshot, int first, int n,
+                  Array_<ContactId>& ids) {
+    ids.clear();
+    for (int i=first; i < first+n; ++i) {
+        UntrackedContact contact(ContactSurfaceIndex(3*i+1),
+                                 ContactSurfaceIndex(i));
+        contact.setContactId(Contact::createNewContactId());
+        ids.push_back(contact.getContactId());
+        snapshot.adoptContact(contact);
+    }
+}
+
+void checkSnapshot(const ContactSnapshot& snapshot, int first, int n,
+                   const Array_<ContactId>& ids) {
+    SimTK_TEST(snapshot.getNumContacts() == n);
+    for (int i=first; i < first+n; ++i) {
+        const ContactSurfaceIndex low(i), high(3*i+1);
+        const ContactId id = ids[i-first];
+        SimTK_TEST(snapshot.hasContact(id));
+        SimTK_TEST(snapshot.hasContact(low, high));
+        SimTK_TEST(snapshot.hasContact(high, low));
+        SimTK_TEST(snapshot.getContactIdForSurfacePair(low, high) == id);
+        SimTK_TEST(snapshot.getContactIdForSurfacePair(high, low) == id);
+        const Contact& contact = snapshot.getContactById(id);
+        SimTK_TEST(!contact.isEmpty());
+        SimTK_TEST(contact.getContactId() == id);
+        SimTK_TEST(contact.getSurface1() == high);
+        // Pairs that share one surface aren't confused with these.
+        SimTK_TEST(!snapshot.hasContact(low, ContactSurfaceIndex(3*i+2)));
+    }
+}
+
+void testLookups() {
+    ContactSnapshot snapshot;
+    SimTK_TEST(snapshot.getNumContacts() == 0);
+    SimTK_TEST(!snapshot.hasContact(ContactId(1)));
+    SimTK_TEST(!snapshot.hasContact(ContactSurfaceIndex(0),
+                                    ContactSurfaceIndex(1)));
+    SimTK_TEST(snapshot.getContactById(ContactId(1)).isEmpty());
+    SimTK_TEST(!snapshot.getContactIdForSurfacePair
+                    (ContactSurfaceIndex(0), ContactSurfaceIndex(1)).isValid());
+
+    // Enough contacts that the tables have to grow several times.
+    Array_<ContactId> ids;
+    fillSnapshot(snapshot, 0, 500, ids);
+    checkSnapshot(snapshot, 0, 500, ids);
+    SimTK_TEST(!snapshot.hasContact(ContactId(ids.back()+1)));
+    SimTK_TEST(snapshot.getContactById(ContactId(ids.back()+1)).isEmpty());
+
+    // Clearing forgets everything, and refilling with different contacts
+    // works the same.
+    snapshot.clear();
+    SimTK_TEST(snapshot.getNumContacts() == 0);
+    SimTK_TEST(!snapshot.hasContact(ids[0]));
+    SimTK_TEST(!snapshot.hasContact(ContactSurfaceIndex(0),
+                                    ContactSurfaceIndex(1)));
+    fillSnapshot(snapshot, 1000, 300, ids);
+    checkSnapshot(snapshot, 1000, 300, ids);
+    SimTK_TEST(!snapshot.hasContact(ContactSurfaceIndex(0),
+                                    ContactSurfaceIndex(1)));
+
+    // A copy has its own tables.
+    ContactSnapshot copy(snapshot);
+    snapshot.clear();
+    checkSnapshot(copy, 1000, 300, ids);
+}
+
+// Refilling a snapshot each step with Contacts that already exist, as the 
+// ContactTrackerSubsystem does with the Contacts its trackers return, reuses
+// the snapshot's Contact array and hash tables.
+void testRefillDoesNotAllocate() {
+    const int NumContacts = 200;
+    Array_<Contact> contacts;
+    for (int i=0; i < NumContacts; ++i) {
+        UntrackedContact contact(ContactSurfaceIndex(3*i+1),
+                                 ContactSurfaceIndex(i));
+        contact.setContactId(Contact::createNewContactId());
+        contacts.push_back(contact);
+    }
+
+    ContactSnapshot snapshot;
+    for (int i=0; i < NumContacts; ++i)
+        snapshot.adoptContact(contacts[i]);
+
+    int numFound = 0;
+    numAllocations = 0;
+    countAllocations = true;
+    for (int step=0; step < 10; ++step) {
+        snapshot.clear();
+        snapshot.setTimestamp(step);
+        // Fewer contacts on some steps, as when contacts break.
+        const int n = NumContacts - 10*(step % 3);
+        for (int i=0; i < n; ++i)
+            snapshot.adoptContact(contacts[i]);
+        for (int i=0; i < n; ++i)
+            if (snapshot.hasContact(contacts[i].getContactId())) ++numFound;
+    }
+    countAllocations = false;
+
+    cout << numAllocations << " allocations refilling the snapshot\n";
+    SimTK_TEST(numAllocations == 0);
+    SimTK_TEST(numFound == 10*NumContacts - 10*(0+1+2+0+1+2+0+1+2+0));
+    SimTK_TEST(snapshot.getNumContacts() == NumContacts);
+}
+
+int main() {
+    SimTK_START_TEST("TestContactSnapshot");
+        SimTK_SUBTEST(testLookups);
+        SimTK_SUBTEST(testRefillDoesNotAllocate);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,249 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check both of ContactTrackerSubsystem's incremental broad phase methods
+// against a brute force comparison of every pair of bounding boxes, as the
+// bodies move from step to step, and check that GeneralContactSubsystem finds
+// the same contacts with either method.
+
+#include "SimTKsimbody.h"
+#include "SimTKcommon/Testing.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+typedef std::pair<ContactSurfaceIndex,ContactSurfaceIndex> SurfacePair;
+typedef std::set<SurfacePair> PairSet;
+
+const int NumBodies = 150;
+
+PairSet toSet(const Array_<SurfacePair>& pairs) {
+    PairSet result(pairs.begin(), pairs.end());
+    SimTK_TEST(result.size() == pairs.size()); // no duplicates
+    return result;
+}
+
+// Compare the axis-aligned boxes around every pair of bounding spheres.
+PairSet findPairsByBruteForce(const ContactTrackerSubsystem& tracker,
+                              const State& state) {
+    const int n = tracker.getNumSurfaces();
+    Array_<Vec3> lower(n), upper(n);
+    for (ContactSurfaceIndex i(0); i < n; ++i) {
+        Vec3 center; Real radius;
+        tracker.getContactSurface(i).getShape()
+            .getBoundingSphere(center, radius);
+        center = tracker.getMobilizedBody(i).getBodyTransform(state)
+                 * (tracker.getContactSurfaceTransform(i) * center);
+        lower[i] = center - Vec3(radius);
+        upper[i] = center + Vec3(radius);
+    }
+    PairSet pairs;
+    for (ContactSurfaceIndex i(0); i < n; ++i)
+        for (ContactSurfaceIndex j(i+1); j < n; ++j) {
+            if (  tracker.getMobilizedBody(i).getMobilizedBodyIndex()
+               == tracker.getMobilizedBody(j).getMobilizedBodyIndex())
+                continue;
+            bool overlap = true;
+            for (int k=0; k < 3; ++k)
+                if (!(lower[i][k] < upper[j][k] && lower[j][k] < upper[i][k]))
+                    overlap = false;
+            if (overlap)
+                pairs.insert(std::make_pair(i,j));
+        }
+    return pairs;
+}
+
+// Spheres of assorted sizes on Translation mobilizers above a ground plane,
+// with a few bodies carrying two spheres. The plane's bounding sphere is
+// infinite so it overlaps everything.
+void testBroadPhase(ContactTrackerSubsystem::BroadPhaseMethod method) {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    ContactTrackerSubsystem tracker(system);
+    const ContactMaterial   material(1e6, 0, 0, 0, 0);
+    tracker.setBroadPhaseMethod(method);
+    SimTK_TEST(tracker.getBroadPhaseMethod() == method);
+
+    matter.updGround().updBody().addContactSurface
+       (Transform(Rotation(-Pi/2, ZAxis)),
+        ContactSurface(ContactGeometry::HalfSpace(), material));
+
+    Random::Uniform rand(0, 1);
+    rand.setSeed(3);
+    for (int i=0; i < NumBodies; ++i) {
+        const Real radius = .05 + .15*rand.getValue();
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia::sphere(1)));
+        body.addContactSurface(Transform(),
+            ContactSurface(ContactGeometry::Sphere(radius), material));
+        if (i % 10 == 0)
+            body.addContactSurface(Transform(Vec3(.1,0,0)),
+                ContactSurface(ContactGeometry::Sphere(radius), material));
+        MobilizedBody::Translation(matter.updGround(), body);
+    }
+
+    State state = system.realizeTopology();
+    for (int i=0; i < state.getNQ(); ++i)
+        state.updQ()[i] = 3*rand.getValue();
+    system.realize(state, Stage::Position);
+
+    Array_<SurfacePair> pairs, added, removed;
+    tracker.getBroadPhasePairs(state, pairs);
+    PairSet expected = findPairsByBruteForce(tracker, state);
+    SimTK_TEST(toSet(pairs) == expected);
+    SimTK_TEST(pairs.size() > (unsigned)NumBodies); // more than the plane
+
+    // Everything is new the first time.
+    tracker.getBroadPhasePairChanges(state, added, removed);
+    SimTK_TEST(toSet(added) == expected);
+    SimTK_TEST(removed.empty());
+
+    // Now take a series of small random steps, accepting each one, and make
+    // sure the reported changes are exactly the difference between steps.
+    int numChanges = 0;
+    for (int step=0; step < 20; ++step) {
+        state.autoUpdateDiscreteVariables();
+        const PairSet before = expected;
+        const Real stepSize = step < 19 ? .05 : 2; // last one is a big jump
+        for (int i=0; i < state.getNQ(); ++i)
+            state.updQ()[i] += stepSize*(rand.getValue() - .5);
+        system.realize(state, Stage::Position);
+
+        tracker.getBroadPhasePairs(state, pairs);
+        expected = findPairsByBruteForce(tracker, state);
+        SimTK_TEST(toSet(pairs) == expected);
+
+        tracker.getBroadPhasePairChanges(state, added, removed);
+        PairSet expectedAdded, expectedRemoved;
+        std::set_difference(expected.begin(), expected.end(),
+                            before.begin(), before.end(),
+                            std::inserter(expectedAdded,
+                                          expectedAdded.begin()));
+        std::set_difference(before.begin(), before.end(),
+                            expected.begin(), expected.end(),
+                            std::inserter(expectedRemoved,
+                                          expectedRemoved.begin()));
+        SimTK_TEST(toSet(added) == expectedAdded);
+        SimTK_TEST(toSet(removed) == expectedRemoved);
+        numChanges += added.size() + removed.size();
+    }
+    SimTK_TEST(numChanges > 0);
+
+    // A rejected step leaves the previous broad phase in place.
+    state.autoUpdateDiscreteVariables();
+    const Vector q = state.getQ();
+    state.updQ() += 1;
+    system.realize(state, Stage::Position);
+    state.updQ() = q;
+    system.realize(state, Stage::Position);
+    tracker.getBroadPhasePairChanges(state, added, removed);
+    SimTK_TEST(added.empty() && removed.empty());
+}
+
+void testSweepAndPrune() 
+{   testBroadPhase(ContactTrackerSubsystem::SweepAndPrune); }
+
+void testDynamicAABBTree() 
+{   testBroadPhase(ContactTrackerSubsystem::DynamicAABBTree); }
+
+// A ground plane and a big sphere with small ones scattered around and
+// inside it, using the given broad phase method.
+struct GeneralContactModel {
+    explicit GeneralContactModel
+       (ContactTrackerSubsystem::BroadPhaseMethod method)
+    :   matter(system), contacts(system) {
+        setIndex = contacts.createContactSet();
+        contacts.setBroadPhaseMethod(method);
+        contacts.addBody(setIndex, matter.updGround(), 
+                         ContactGeometry::HalfSpace(), 
+                         Transform(Rotation(-Pi/2, ZAxis), Vec3(0,-1,0)));
+        Random::Uniform rand(0, 1);
+        rand.setSeed(7);
+        const Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+        for (int i=0; i < 60; ++i) {
+            const Real radius = i == 0 ? 1 : .05 + .1*rand.getValue();
+            MobilizedBody::Translation mobod(matter.updGround(), body);
+            contacts.addBody(setIndex, mobod, 
+                             ContactGeometry::Sphere(radius), Transform());
+        }
+        state = system.realizeTopology();
+        for (int i=0; i < state.getNQ(); ++i)
+            state.updQ()[i] = 2*rand.getValue() - 1;
+    }
+
+    // Return the contacting pairs, sorted.
+    Array_<std::pair<int,int> > findContacts() {
+        system.realize(state, Stage::Dynamics);
+        const Array_<Contact>& c = contacts.getContacts(state, setIndex);
+        Array_<std::pair<int,int> > found;
+        for (unsigned k=0; k < c.size(); ++k) {
+            const int s1 = c[k].getSurface1(), s2 = c[k].getSurface2();
+            found.push_back(std::make_pair(std::min(s1,s2), 
+                                           std::max(s1,s2)));
+        }
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    GeneralContactSubsystem contacts;
+    ContactSetIndex         setIndex;
+    State                   state;
+};
+
+// Both broad phase methods must lead to the same contacts as the bodies 
+// move.
+void testGeneralContactSubsystem() {
+    GeneralContactModel sap(ContactTrackerSubsystem::SweepAndPrune);
+    GeneralContactModel tree(ContactTrackerSubsystem::DynamicAABBTree);
+    SimTK_TEST(tree.contacts.getBroadPhaseMethod() 
+               == ContactTrackerSubsystem::DynamicAABBTree);
+
+    Random::Uniform rand(0, 1);
+    rand.setSeed(9);
+    for (int step=0; step < 20; ++step) {
+        const Array_<std::pair<int,int> > found = sap.findContacts();
+        SimTK_TEST(tree.findContacts() == found);
+        SimTK_TEST(!found.empty());
+        sap.state.autoUpdateDiscreteVariables();
+        tree.state.autoUpdateDiscreteVariables();
+        for (int i=0; i < sap.state.getNQ(); ++i) {
+            const Real dq = .1*(rand.getValue() - .5);
+            sap.state.updQ()[i] += dq;
+            tree.state.updQ()[i] += dq;
+        }
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestContactTrackerBroadPhase");
+        SimTK_SUBTEST(testSweepAndPrune);
+        SimTK_SUBTEST(testDynamicAABBTree);
+        SimTK_SUBTEST(testGeneralContactSubsystem);
+    SimTK_END_TEST();
+}
@@ -23,6 +23,8 @@
 
 #include "SimTKsimbody.h"
 
+#include <set>
+
 using namespace SimTK;
 using namespace std;
 
@@ -130,9 +132,110 @@ void testForces() {
     }
 }
 
+// Add the forces from the springs of one mesh, evaluating each spring 
+// directly from the bodies' station kinematics.
+void addSpringForces(const State& state, const GeneralContactSubsystem& contacts,
+                     ContactSetIndex setIndex, ContactSurfaceIndex meshIndex,
+                     ContactSurfaceIndex otherIndex, const set<int>& faces,
+                     Real stiffness, Real dissipation, Real us, Real ud, Real uv,
+                     Real vt, Real areaScale, Vector_<SpatialVec>& bodyForces,
+                     Real& pe) {
+    const ContactGeometry::TriangleMesh& mesh = 
+        ContactGeometry::TriangleMesh::getAs
+            (contacts.getBodyGeometry(setIndex, meshIndex));
+    const ContactGeometry& other = contacts.getBodyGeometry(setIndex, otherIndex);
+    const MobilizedBody& body1 = contacts.getBody(setIndex, meshIndex);
+    const MobilizedBody& body2 = contacts.getBody(setIndex, otherIndex);
+    const Transform t1g = body1.getBodyTransform(state)
+                          *contacts.getBodyTransform(setIndex, meshIndex);
+    const Transform t2g = body2.getBodyTransform(state)
+                          *contacts.getBodyTransform(setIndex, otherIndex);
+    for (set<int>::const_iterator iter = faces.begin(); iter != faces.end(); ++iter) {
+        const Vec3 spring = (mesh.getVertexPosition(mesh.getFaceVertex(*iter, 0))
+                            +mesh.getVertexPosition(mesh.getFaceVertex(*iter, 1))
+                            +mesh.getVertexPosition(mesh.getFaceVertex(*iter, 2)))/3;
+        bool inside;
+        UnitVec3 normal;
+        const Vec3 nearest = t2g*other.findNearestPoint(~t2g*(t1g*spring), inside, normal);
+        if (!inside)
+            continue;
+        const Vec3 displacement = nearest-t1g*spring;
+        const Real distance = displacement.norm();
+        const Vec3 dir = displacement/distance;
+        const Vec3 station1 = body1.findStationAtGroundPoint(state, nearest);
+        const Vec3 station2 = body2.findStationAtGroundPoint(state, nearest);
+        const Vec3 v = body2.findStationVelocityInGround(state, station2)
+                      -body1.findStationVelocityInGround(state, station1);
+        const Vec3 vtangent = v-dot(v, dir)*dir;
+        const Real area = areaScale*mesh.getFaceArea(*iter);
+        const Real f = stiffness*area*distance*(1+dissipation*dot(v, dir));
+        pe += stiffness*area*distance*distance/2;
+        if (f <= 0)
+            continue;
+        Vec3 force = f*dir;
+        const Real vslip = vtangent.norm();
+        const Real vrel = vslip/vt;
+        force += f*(std::min(vrel, Real(1))*(ud+2*(us-ud)/(1+vrel*vrel))+uv*vslip)
+                 *vtangent/vslip;
+        body1.applyForceToBodyPoint(state, station1, force, bodyForces);
+        body2.applyForceToBodyPoint(state, station2, -force, bodyForces);
+    }
+}
+
+// Two spinning meshes pressed together, both with springs, should feel the
+// sum of the individual spring forces.
+void testMeshMeshForces() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralContactSubsystem contacts(system);
+    GeneralForceSubsystem forces(system);
+    Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    ContactSetIndex setIndex = contacts.createContactSet();
+    MobilizedBody::Free ball1(matter.updGround(), Transform(), body, Transform());
+    MobilizedBody::Free ball2(matter.updGround(), Transform(), body, Transform());
+    contacts.addBody(setIndex, ball1, ContactGeometry::TriangleMesh
+        (PolygonalMesh::createSphereMesh(1, 3)), Transform(Vec3(0.1, 0, 0)));
+    contacts.addBody(setIndex, ball2, ContactGeometry::TriangleMesh
+        (PolygonalMesh::createSphereMesh(0.8, 3)), Transform(Rotation(0.3, YAxis)));
+    ElasticFoundationForce ef(forces, contacts, setIndex);
+    const Real vt = 0.02;
+    ef.setTransitionVelocity(vt);
+    ef.setBodyParameters(ContactSurfaceIndex(0), 1e6, 0.01, 0.5, 0.3, 0.01);
+    ef.setBodyParameters(ContactSurfaceIndex(1), 3e6, 0.02, 0.4, 0.2, 0.02);
+    State state = system.realizeTopology();
+    ball1.setQToFitTransform(state, Transform(Rotation(0.4, ZAxis), Vec3(-0.7, 0.1, 0)));
+    ball2.setQToFitTransform(state, Transform(Rotation(-0.2, XAxis), Vec3(0.8, -0.1, 0.05)));
+    ball1.setUToFitVelocity(state, SpatialVec(Vec3(0.5, 1, -2), Vec3(0.3, 0.1, 0)));
+    ball2.setUToFitVelocity(state, SpatialVec(Vec3(-1, 0.2, 0.7), Vec3(-0.2, 0, 0.1)));
+    system.realize(state, Stage::Dynamics);
+
+    const Array_<Contact>& contactList = contacts.getContacts(state, setIndex);
+    ASSERT(contactList.size() == 1);
+    const TriangleMeshContact& contact = 
+        static_cast<const TriangleMeshContact&>(contactList[0]);
+    ASSERT(!contact.getSurface1Faces().empty());
+    Vector_<SpatialVec> expectedForce(matter.getNumBodies());
+    expectedForce = SpatialVec(Vec3(0), Vec3(0));
+    Real pe = 0;
+    addSpringForces(state, contacts, setIndex, ContactSurfaceIndex(0), 
+                    ContactSurfaceIndex(1), contact.getSurface1Faces(), 
+                    1e6, 0.01, 0.5, 0.3, 0.01, vt, 0.5, expectedForce, pe);
+    addSpringForces(state, contacts, setIndex, ContactSurfaceIndex(1), 
+                    ContactSurfaceIndex(0), contact.getSurface2Faces(), 
+                    3e6, 0.02, 0.4, 0.2, 0.02, vt, 0.5, expectedForce, pe);
+    ASSERT(pe > 0);
+    for (MobilizedBodyIndex i(0); i < matter.getNumBodies(); ++i) {
+        const SpatialVec& actual = system.getRigidBodyForces(state, Stage::Dynamics)[i];
+        assertEqual(actual[0], expectedForce[i][0]);
+        assertEqual(actual[1], expectedForce[i][1]);
+    }
+    assertEqual(ef.calcPotentialEnergyContribution(state), pe);
+}
+
 int main() {
     try {
         testForces();
+        testMeshMeshForces();
     }
     catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
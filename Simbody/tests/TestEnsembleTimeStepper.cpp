@@ -0,0 +1,192 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Run an ensemble of constrained multibody systems under gravity, each
+// member with its own initial configuration and gravity magnitude, and check
+// each member against the same trajectory computed serially. Also check that
+// an EnsembleTimeStepper refuses Systems containing elements that keep
+// scratch data in themselves.
+
+#include "SimTKsimbody.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+const Real Accuracy = 1e-5;
+const Real ReportInterval = 0.1;
+
+// Each member's calls come from one thread at a time, so the members can
+// keep their own records without locking.
+class RecordingReporter : public EnsembleTimeStepper::Reporter {
+public:
+    explicit RecordingReporter(int numMembers) : lastY(numMembers) {}
+    void handleState(int member, const State& state) {
+        lastY[member] = state.getY();
+    }
+    Array_<Vector> lastY;
+};
+
+// A chain of three pendulum links, the second and third of which have their
+// pin angles coupled.
+class CoupledChain {
+public:
+    CoupledChain()
+    :   matter(system), forces(system),
+        gravity(forces, matter, -YAxis, 9.8)
+    {
+        Body::Rigid link(MassProperties(1, Vec3(0,-.5,0),
+                         UnitInertia::cylinderAlongY(.05, .5)));
+        MobilizedBody::Pin link1(matter.Ground(), Vec3(0),
+                                 link, Vec3(0,.5,0));
+        MobilizedBody::Pin link2(link1, Vec3(0,-.5,0), link, Vec3(0,.5,0));
+        MobilizedBody::Pin link3(link2, Vec3(0,-.5,0), link, Vec3(0,.5,0));
+
+        // q2 - q3/2 = 0
+        Array_<MobilizedBodyIndex> coordMobod;
+        Array_<MobilizerQIndex>    coordQIndex;
+        coordMobod.push_back(link2.getMobilizedBodyIndex());
+        coordMobod.push_back(link3.getMobilizedBodyIndex());
+        coordQIndex.push_back(MobilizerQIndex(0));
+        coordQIndex.push_back(MobilizerQIndex(0));
+        Constraint::CoordinateCoupler(matter,
+            new Function::Linear(Vector(Vec3(1, -.5, 0))),
+            coordMobod, coordQIndex);
+
+        system.realizeTopology();
+    }
+
+    State makeInitialState(int member) const {
+        State state = system.getDefaultState();
+        state.updQ()[0] = .2 + .1*member;
+        state.updQ()[1] = .1;
+        state.updQ()[2] = .2;
+        gravity.setMagnitude(state, 9 + .2*member);
+        system.project(state, 1e-12);
+        return state;
+    }
+
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    GeneralForceSubsystem   forces;
+    Force::Gravity          gravity;
+};
+
+Real getFinalTime(int member) {
+    return .5 + .23*(member % 4);
+}
+
+// Run one member the ordinary way, reporting at the same times.
+Vector runSerially(const System& system, const State& initState,
+                   Real tFinal) {
+    RungeKuttaMersonIntegrator integ(system);
+    integ.setAccuracy(Accuracy);
+    integ.setFinalTime(tFinal);
+    TimeStepper ts(system, integ);
+    ts.initialize(initState);
+    for (int k=1; ts.getTime() < tFinal; ++k)
+        ts.stepTo(std::min(k*ReportInterval, tFinal));
+    return ts.getState().getY();
+}
+
+void testCoupledChainEnsemble() {
+    const CoupledChain chain;
+
+    const int NumMembers = 10;
+    Array_<State> initStates;
+    Array_<Real>  finalTimes;
+    for (int i=0; i < NumMembers; ++i) {
+        initStates.push_back(chain.makeInitialState(i));
+        finalTimes.push_back(getFinalTime(i));
+    }
+
+    EnsembleTimeStepper::IntegratorFactory_<RungeKuttaMersonIntegrator>
+        factory(Accuracy);
+    EnsembleTimeStepper ensemble(chain.system, factory, 4);
+    ensemble.setReportInterval(ReportInterval);
+    RecordingReporter reporter(NumMembers);
+    ensemble.run(initStates, finalTimes, reporter);
+
+    SimTK_TEST(ensemble.getNumFailedMembers() == 0);
+    SimTK_TEST(chain.gravity.getNumEvaluations() > 0);
+    for (int i=0; i < NumMembers; ++i) {
+        SimTK_TEST(ensemble.getMemberTime(i) == finalTimes[i]);
+        // The integrators are deterministic, so we should get exactly the
+        // same answer no matter which thread ran the member.
+        const Vector y =
+            runSerially(chain.system, initStates[i], finalTimes[i]);
+        SimTK_TEST((reporter.lastY[i] - y).normInf() == 0);
+    }
+
+    // The members really were different.
+    SimTK_TEST((reporter.lastY[0] - reporter.lastY[4]).normInf() > 0);
+}
+
+// A SmoothHeightMap contact surface or a cable wrapping over a surface
+// obstacle would be corrupted by concurrent realization so must be refused;
+// a cable with only via points is fine.
+void testRefuseUnsafeSystems() {
+    EnsembleTimeStepper::IntegratorFactory_<RungeKuttaMersonIntegrator>
+        factory(Accuracy);
+
+    {   MultibodySystem         system;
+        SimbodyMatterSubsystem  matter(system);
+        ContactTrackerSubsystem tracker(system);
+        const BicubicSurface surface(Vec2(-1,-1), Vec2(.5,.5), Matrix(5,5,0.));
+        matter.Ground().updBody().addContactSurface(Transform(),
+            ContactSurface(ContactGeometry::SmoothHeightMap(surface),
+                           ContactMaterial(1e6, 0, 0, 0, 0)));
+        system.realizeTopology();
+        SimTK_TEST(!tracker.getSubsystemGuts().isThreadSafe());
+        SimTK_TEST_MUST_THROW(EnsembleTimeStepper(system, factory, 2));
+    }
+
+    {   MultibodySystem         system;
+        SimbodyMatterSubsystem  matter(system);
+        CableTrackerSubsystem   cables(system);
+        MobilizedBody::Pin body(matter.Ground(), Vec3(0),
+            Body::Rigid(MassProperties(1, Vec3(0), UnitInertia(1))),
+            Vec3(0,1,0));
+        CablePath path(cables, matter.Ground(), Vec3(-1,0,0),
+                               matter.Ground(), Vec3(1,0,0));
+        CableObstacle::ViaPoint via(path, body, Vec3(0,-1,0));
+        system.realizeTopology();
+        SimTK_TEST(cables.getSubsystemGuts().isThreadSafe());
+        EnsembleTimeStepper ensemble(system, factory, 2);
+
+        CableObstacle::Surface obstacle(path, body, Transform(),
+                                        ContactGeometry::Sphere(.1));
+        system.realizeTopology();
+        SimTK_TEST(!cables.getSubsystemGuts().isThreadSafe());
+        SimTK_TEST_MUST_THROW(EnsembleTimeStepper(system, factory, 2));
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestEnsembleTimeStepper");
+        SimTK_SUBTEST(testCoupledChainEnsemble);
+        SimTK_SUBTEST(testRefuseUnsafeSystems);
+    SimTK_END_TEST();
+}
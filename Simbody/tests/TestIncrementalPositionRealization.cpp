@@ -0,0 +1,227 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Position realization reuses the kinematics of bodies whose q's (and whose
+// ancestors' q's) haven't changed since the last realization. Check that the
+// results are exactly (bitwise) what a from-scratch realization produces.
+
+#include "SimTKsimbody.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+// A chain with a side branch, a quaternion-based ball joint in the middle
+// and a reversed mobilizer.
+static void buildTree(SimbodyMatterSubsystem& matter) {
+    const Body::Rigid body(MassProperties(1.5, Vec3(.1,.2,-.05),
+                                          Inertia(Vec3(.3,.2,.1))));
+    MobilizedBody::Pin      shoulder(matter.Ground(), Vec3(0,1,0),
+                                     body, Vec3(0,.5,0));
+    MobilizedBody::Ball     elbow(shoulder, Vec3(0,-.5,0), body, Vec3(0,.5,0));
+    MobilizedBody::Universal wrist(elbow, Vec3(0,-.5,0), body, Vec3(0,.2,0));
+    MobilizedBody::Slider   finger(wrist, Vec3(.1,-.2,0), body, Vec3(0));
+    MobilizedBody::Pin      thumb(wrist, Vec3(-.1,-.2,0), body, Vec3(0),
+                                  MobilizedBody::Reverse);
+    MobilizedBody::Free     side(shoulder, Vec3(1,0,0), body, Vec3(0));
+}
+
+static void setRandomQ(State& state, int seed) {
+    Random::Uniform rand(-1, 1);
+    rand.setSeed(seed);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+}
+
+// Realize a brand new State with the same q's, then compare kinematics.
+static void checkAgainstFreshState(const MultibodySystem& system,
+                                   const State& state) {
+    const SimbodyMatterSubsystem& matter = system.getMatterSubsystem();
+    State fresh = system.getDefaultState();
+    fresh.updQ() = state.getQ();
+    system.realize(fresh, Stage::Position);
+
+    for (MobilizedBodyIndex mbx(0); mbx < matter.getNumBodies(); ++mbx) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+        const Transform& X = mobod.getBodyTransform(state);
+        const Transform& Xfresh = mobod.getBodyTransform(fresh);
+        SimTK_TEST(X.p() == Xfresh.p() && X.R() == Xfresh.R());
+        SimTK_TEST(mobod.getBodyOriginLocation(state)
+                   == mobod.getBodyOriginLocation(fresh));
+    }
+    const Vector& qerr = state.getQErr();
+    const Vector& qerrFresh = fresh.getQErr();
+    SimTK_TEST(qerr.size() == qerrFresh.size());
+    for (int i=0; i < qerr.size(); ++i)
+        SimTK_TEST(qerr[i] == qerrFresh[i]);
+}
+
+void testChangeOneQ() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    buildTree(matter);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    setRandomQ(state, 1);
+    system.realize(state, Stage::Position);
+    checkAgainstFreshState(system, state);
+
+    // Change each q in turn; each affects a different subtree.
+    for (int i=0; i < state.getNQ(); ++i) {
+        state.updQ()[i] += 0.1;
+        system.realize(state, Stage::Position);
+        checkAgainstFreshState(system, state);
+    }
+
+    // Change nothing but invalidate anyway.
+    state.updQ();
+    system.realize(state, Stage::Position);
+    checkAgainstFreshState(system, state);
+
+    // Change everything.
+    setRandomQ(state, 2);
+    system.realize(state, Stage::Position);
+    checkAgainstFreshState(system, state);
+}
+
+// A copied State brings along its cache contents but not its qerr, so the
+// reused bodies must still produce correct quaternion errors.
+void testCopiedState() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    buildTree(matter);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    setRandomQ(state, 3);
+    system.realize(state, Stage::Position);
+
+    State copy(state);
+    system.realize(copy, Stage::Position);
+    checkAgainstFreshState(system, copy);
+
+    State copy2(state);
+    copy2.updQ()[0] -= 0.25; // the shoulder; everything moves but "side"
+    system.realize(copy2, Stage::Position);
+    checkAgainstFreshState(system, copy2);
+}
+
+// Switching to Euler angles changes the number of q's and reallocates the
+// cache, so nothing can be reused even where the q's happen to match.
+void testModelChange() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    buildTree(matter);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    setRandomQ(state, 4);
+    system.realize(state, Stage::Position);
+
+    matter.setUseEulerAngles(state, true);
+    system.realizeModel(state);
+    setRandomQ(state, 4);
+    system.realize(state, Stage::Position);
+
+    State fresh = system.getDefaultState();
+    matter.setUseEulerAngles(fresh, true);
+    system.realizeModel(fresh);
+    fresh.updQ() = state.getQ();
+    system.realize(fresh, Stage::Position);
+    for (MobilizedBodyIndex mbx(0); mbx < matter.getNumBodies(); ++mbx) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+        SimTK_TEST(mobod.getBodyOriginLocation(state)
+                   == mobod.getBodyOriginLocation(fresh));
+    }
+
+    // And back to quaternions.
+    matter.setUseEulerAngles(state, false);
+    system.realizeModel(state);
+    setRandomQ(state, 5);
+    system.realize(state, Stage::Position);
+    checkAgainstFreshState(system, state);
+}
+
+// A one-dof slider along x whose position also advances with time, as a 
+// user-written mobilizer is free to do.
+class TimeDependentSlider : public MobilizedBody::Custom::Implementation {
+public:
+    explicit TimeDependentSlider(SimbodyMatterSubsystem& matter) 
+    :   Implementation(matter, 1, 1, 0) {}
+    Implementation* clone() const {return new TimeDependentSlider(*this);}
+    Transform calcMobilizerTransformFromQ(const State& s, int nq, 
+                                          const Real* q) const {
+        return Transform(Vec3(q[0] + s.getTime(), 0, 0));
+    }
+    SpatialVec multiplyByHMatrix(const State&, int, const Real* u) const 
+    {   return SpatialVec(Vec3(0), Vec3(u[0],0,0)); }
+    void multiplyByHTranspose(const State&, const SpatialVec& F, int, 
+                              Real* f) const 
+    {   f[0] = F[1][0]; }
+    SpatialVec multiplyByHDotMatrix(const State&, int, const Real*) const 
+    {   return SpatialVec(Vec3(0), Vec3(0)); }
+    void multiplyByHDotTranspose(const State&, const SpatialVec&, int, 
+                                 Real* f) const 
+    {   f[0] = 0; }
+};
+
+// Nothing can be reused when a mobilizer depends on more than its q's; here
+// only time changes.
+void testTimeDependentMobilizer() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    const Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+    MobilizedBody::Pin      pin(matter.Ground(), Vec3(0), body, Vec3(0,.5,0));
+    MobilizedBody::Custom   slider(pin, new TimeDependentSlider(matter), 
+                                   Vec3(0), body, Vec3(0));
+    MobilizedBody::Pin      tip(slider, Vec3(0,-.5,0), body, Vec3(0,.5,0));
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    setRandomQ(state, 6);
+    system.realize(state, Stage::Position);
+
+    state.updTime() = 1;
+    system.realize(state, Stage::Position);
+
+    State fresh = system.getDefaultState();
+    fresh.updTime() = 1;
+    fresh.updQ() = state.getQ();
+    system.realize(fresh, Stage::Position);
+    for (MobilizedBodyIndex mbx(0); mbx < matter.getNumBodies(); ++mbx) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+        SimTK_TEST(mobod.getBodyOriginLocation(state)
+                   == mobod.getBodyOriginLocation(fresh));
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestIncrementalPositionRealization");
+        SimTK_SUBTEST(testChangeOneQ);
+        SimTK_SUBTEST(testCopiedState);
+        SimTK_SUBTEST(testModelChange);
+        SimTK_SUBTEST(testTimeDependentMobilizer);
+    SimTK_END_TEST();
+}
@@ -951,6 +951,110 @@ void testConstrainedSystem() {
 
 
 
+// The Matrix forms of multiplyByM(), multiplyByMInv() and 
+// multiplyByGTranspose() process several columns per sweep; they must agree
+// with the single-column operators, and the dense matrices assembled from
+// them must be consistent.
+void testMultipleRightHandSides() {
+    MultibodySystem mbs;
+    MyForceImpl* frcp;
+    makeSystem(true, mbs, frcp);
+    const SimbodyMatterSubsystem& matter = mbs.getMatterSubsystem();
+
+    State state = mbs.realizeTopology();
+    mbs.realize(state, Stage::Instance);
+    state.updQ() = Test::randVector(state.getNQ());
+    state.updU() = Test::randVector(state.getNU());
+    mbs.realize(state, Stage::Dynamics);
+
+    const int nu = state.getNU();
+    const int m  = state.getNMultipliers();
+    const Real Slop = nu*SignificantReal;
+
+    // Use more columns than fit in one block, so the last block is partial.
+    const int ncols = 2*nu + 3;
+    Matrix A = Test::randMatrix(nu, ncols);
+    Matrix MA, MInvA;
+    matter.multiplyByM(state, A, MA);
+    matter.multiplyByMInv(state, A, MInvA);
+    SimTK_TEST(MA.nrow() == nu && MA.ncol() == ncols);
+    SimTK_TEST(MInvA.nrow() == nu && MInvA.ncol() == ncols);
+    for (int j=0; j < ncols; ++j) {
+        Vector Ma, MInva;
+        matter.multiplyByM(state, A(j), Ma);
+        matter.multiplyByMInv(state, A(j), MInva);
+        SimTK_TEST_EQ_TOL(MA(j), Ma, Slop);
+        SimTK_TEST_EQ_TOL(MInvA(j), MInva, Slop);
+    }
+
+    // Noncontiguous input and output.
+    Matrix At = ~A, MAt(ncols, nu);
+    Matrix MAnc; MAnc.viewAssign(~MAt);
+    matter.multiplyByM(state, ~At, MAnc);
+    SimTK_TEST_EQ_TOL(~MAt, MA, Slop);
+
+    Matrix M, MInv;
+    matter.calcM(state, M); matter.calcMInv(state, MInv);
+    Matrix I(nu,nu); I.setToZero(); I.updDiag() = 1;
+    SimTK_TEST_EQ_TOL(M*MInv, I, 10*Slop);
+
+    Matrix Lambda = Test::randMatrix(m, 11);
+    Matrix GtLambda;
+    matter.multiplyByGTranspose(state, Lambda, GtLambda);
+    SimTK_TEST(GtLambda.nrow() == nu && GtLambda.ncol() == 11);
+    for (int j=0; j < 11; ++j) {
+        Vector f;
+        matter.multiplyByGTranspose(state, Lambda(j), f);
+        SimTK_TEST_EQ_TOL(GtLambda(j), f, Slop);
+    }
+
+    Matrix G, Gt, GMInvGt;
+    matter.calcG(state, G);
+    matter.calcGTranspose(state, Gt);
+    SimTK_TEST_EQ_TOL(Gt, ~G, Slop);
+    matter.calcProjectedMInv(state, GMInvGt);
+    SimTK_TEST_EQ_TOL(GMInvGt, G*MInv*~G, 10*Slop);
+
+    SimTK_TEST_MUST_THROW(matter.multiplyByM(state, Matrix(nu+1,2), MA));
+    SimTK_TEST_MUST_THROW(matter.multiplyByGTranspose(state, 
+                                                      Matrix(m+1,2), MA));
+}
+
+// The sparse mass matrix must agree with the dense one, and solving with its
+// LTL factorization must agree with multiplyByMInv().
+void testSparseMassMatrix() {
+    MultibodySystem mbs;
+    MyForceImpl* frcp;
+    makeSystem(false, mbs, frcp);
+    const SimbodyMatterSubsystem& matter = mbs.getMatterSubsystem();
+
+    State state = mbs.realizeTopology();
+    mbs.realize(state, Stage::Instance);
+    state.updQ() = Test::randVector(state.getNQ());
+    state.updU() = Test::randVector(state.getNU());
+    mbs.realize(state, Stage::Dynamics);
+
+    const int nu = state.getNU();
+    const Real Slop = nu*SignificantReal;
+
+    BranchInducedSparseMatrix sparseM;
+    matter.calcSparseM(state, sparseM);
+    SimTK_TEST(sparseM.size() == nu);
+    SimTK_TEST(sparseM.getNumStoredEntries() < nu*(nu+1)/2);
+
+    Matrix M, denseM;
+    matter.calcM(state, M);
+    sparseM.getAsMatrix(denseM);
+    SimTK_TEST_EQ_TOL(denseM, M, Slop);
+
+    const Vector f = Test::randVector(nu);
+    Vector MInvf, x;
+    matter.multiplyByMInv(state, f, MInvf);
+    sparseM.factorLTL();
+    sparseM.solve(f, x);
+    SimTK_TEST_EQ_TOL(x, MInvf, 10*Slop);
+}
+
 void testCompositeInertia() {
     MultibodySystem         mbs;
     SimbodyMatterSubsystem  pend(mbs);
@@ -1211,6 +1315,8 @@ int main() {
         SimTK_SUBTEST(testCompositeInertia);
         SimTK_SUBTEST(testUnconstrainedSystem);
         SimTK_SUBTEST(testConstrainedSystem);
+        SimTK_SUBTEST(testMultipleRightHandSides);
+        SimTK_SUBTEST(testSparseMassMatrix);
         SimTK_SUBTEST(testTaskJacobians);
     SimTK_END_TEST();
 }
@@ -0,0 +1,250 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Compare Force::NonbondedPairs against a brute force evaluation of all
+// pairs, check the forces against the energy gradient, and check that the
+// neighbor list is rebuilt only when something moves more than half the skin.
+
+#include "SimTKsimbody.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+const int   NumBodies = 60;
+const Real  Spacing   = 1;
+const Real  Cutoff    = 1.5;
+const Real  Skin      = .3;
+
+// All the bodies are on Translation mobilizers so the q's are just the body
+// origin locations in Ground. Every third body gets a second, offset station
+// so that there are torques too. Stations on bodies 1 and 2 don't interact,
+// and neither do the stations in clique 7.
+struct Model {
+    Model(Real skin, Force::NonbondedPairs::Potential potential)
+    :   matter(system), forces(system),
+        pairs(forces, Cutoff, skin, potential) {
+        Random::Uniform rand(0, 1);
+        rand.setSeed(11);
+        const Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+        for (int i=0; i < NumBodies; ++i) {
+            MobilizedBody::Translation mobod(matter.updGround(), body);
+            const int nStations = i % 3 == 0 ? 2 : 1;
+            for (int j=0; j < nStations; ++j) {
+                const Vec3 offset = j == 0 ? Vec3(0) : Vec3(.1, -.05, .08);
+                const int clique = (i % 10 == 5 && j == 0) ? 7 : -1;
+                const Real charge   = rand.getValue() - .5;
+                const Real radius   = .15 + .1*rand.getValue();
+                const Real strength = .5 + rand.getValue();
+                pairs.addStation(mobod, offset, charge, radius, strength,
+                                 clique);
+                stations.push_back(std::make_pair(mobod.getMobilizedBodyIndex(),
+                                                  offset));
+            }
+        }
+        pairs.excludeBodyPair(matter.getMobilizedBody(MobilizedBodyIndex(1)),
+                              matter.getMobilizedBody(MobilizedBodyIndex(2)));
+        pairs.setCoulombConstant(.5);
+
+        // Put the bodies on a jittered 4x4x4 lattice so that no stations
+        // are unreasonably close together.
+        state = system.realizeTopology();
+        for (int i=0; i < NumBodies; ++i) {
+            const Vec3 site(i%4, (i/4)%4, i/16);
+            for (int k=0; k < 3; ++k)
+                state.updQ()[3*i+k] = 
+                    Spacing*site[k] + .3*(rand.getValue() - .5);
+        }
+    }
+
+    // Evaluate every pair directly, returning the body forces and energy.
+    Real calcBruteForce(Vector_<SpatialVec>& bodyForces) const {
+        const Force::NonbondedPairs::Potential potential = pairs.getPotential();
+        const Real kc = pairs.getCoulombConstant();
+        Array_<Real> q, R, e;
+        Array_<int> clique;
+        Random::Uniform rand(0, 1);
+        rand.setSeed(11);
+        for (int i=0; i < NumBodies; ++i)
+            for (int j=0; j < (i % 3 == 0 ? 2 : 1); ++j) {
+                q.push_back(rand.getValue() - .5);
+                R.push_back(.15 + .1*rand.getValue());
+                e.push_back(.5 + rand.getValue());
+                clique.push_back((i % 10 == 5 && j == 0) ? 7 : -1);
+            }
+
+        bodyForces.resize(matter.getNumBodies());
+        bodyForces = SpatialVec(Vec3(0), Vec3(0));
+        Real pe = 0;
+        const int n = (int)stations.size();
+        for (int i=0; i < n; ++i)
+        for (int j=i+1; j < n; ++j) {
+            const MobilizedBodyIndex bi = stations[i].first;
+            const MobilizedBodyIndex bj = stations[j].first;
+            if (bi == bj || (clique[i] >= 0 && clique[i] == clique[j]))
+                continue;
+            if (std::min(bi,bj) == 1 && std::max(bi,bj) == 2)
+                continue;
+            const Vec3 pi = matter.getMobilizedBody(bi)
+                .findStationLocationInGround(state, stations[i].second);
+            const Vec3 pj = matter.getMobilizedBody(bj)
+                .findStationLocationInGround(state, stations[j].second);
+            const Vec3 r = pi - pj;
+            const Real d = r.norm();
+            if (d >= Cutoff)
+                continue;
+            const Real sigma = R[i] + R[j], eps = std::sqrt(e[i]*e[j]);
+            const Real qq = kc*q[i]*q[j];
+            Real energy = qq/d - qq/Cutoff, dEdr = -qq/square(d);
+            if (potential == Force::NonbondedPairs::LennardJones) {
+                const Real s6 = std::pow(sigma/d, 6);
+                const Real s6c = std::pow(sigma/Cutoff, 6);
+                energy += 4*eps*(s6*s6 - s6) - 4*eps*(s6c*s6c - s6c);
+                dEdr += 4*eps*(-12*s6*s6 + 6*s6)/d;
+            } else if (d < sigma) {
+                energy += eps*square(sigma-d)/2;
+                dEdr -= eps*(sigma-d);
+            }
+            pe += energy;
+            const Vec3 f = -dEdr*r/d;   // on station i
+            matter.getMobilizedBody(bi).applyForceToBodyPoint
+                (state, stations[i].second,  f, bodyForces);
+            matter.getMobilizedBody(bj).applyForceToBodyPoint
+                (state, stations[j].second, -f, bodyForces);
+        }
+        return pe;
+    }
+
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    GeneralForceSubsystem   forces;
+    Force::NonbondedPairs   pairs;
+    Array_<std::pair<MobilizedBodyIndex,Vec3> > stations;
+    State                   state;
+};
+
+void checkAgainstBruteForce(Model& model) {
+    model.system.realize(model.state, Stage::Dynamics);
+    Vector_<SpatialVec> expected;
+    const Real expectedPE = model.calcBruteForce(expected);
+    SimTK_TEST_EQ_TOL(model.system.getRigidBodyForces(model.state,
+                                                      Stage::Dynamics),
+                      expected, 1e-10);
+    SimTK_TEST_EQ_TOL(model.system.calcPotentialEnergy(model.state),
+                      expectedPE, 1e-10);
+}
+
+void testBruteForce() {
+    Model lj(Skin, Force::NonbondedPairs::LennardJones);
+    checkAgainstBruteForce(lj);
+    // The list should be much smaller than all pairs.
+    const int nStations = lj.pairs.getNumStations();
+    SimTK_TEST(lj.pairs.getNumNeighborPairs(lj.state) > 0);
+    SimTK_TEST(lj.pairs.getNumNeighborPairs(lj.state)
+               < nStations*(nStations-1)/4);
+
+    // Push two of the spheres into each other so they overlap.
+    Model soft(0, Force::NonbondedPairs::SoftSphere);
+    soft.state.updQ()[6] = soft.state.getQ()[9] - .2;
+    soft.state.updQ()[7] = soft.state.getQ()[10];
+    soft.state.updQ()[8] = soft.state.getQ()[11];
+    checkAgainstBruteForce(soft);
+}
+
+// With Translation mobilizers the translational body forces are the
+// mobility forces, which must be the negative gradient of the energy.
+void testEnergyGradient() {
+    Model model(Skin, Force::NonbondedPairs::LennardJones);
+    State& state = model.state;
+    model.system.realize(state, Stage::Dynamics);
+    const Vector_<SpatialVec> bodyForces =
+        model.system.getRigidBodyForces(state, Stage::Dynamics);
+    const Real h = 1e-6;
+    for (int i=0; i < state.getNQ(); i += 7) {
+        const Real q0 = state.getQ()[i];
+        state.updQ()[i] = q0 + h;
+        model.system.realize(state, Stage::Position);
+        const Real pePlus = model.system.calcPotentialEnergy(state);
+        state.updQ()[i] = q0 - h;
+        model.system.realize(state, Stage::Position);
+        const Real peMinus = model.system.calcPotentialEnergy(state);
+        state.updQ()[i] = q0;
+        const MobilizedBodyIndex mbx(i/3 + 1);
+        SimTK_TEST_EQ_TOL(-(pePlus-peMinus)/(2*h), bodyForces[mbx][1][i%3],
+                          1e-5*std::max(Real(1), std::abs(bodyForces[mbx][1][i%3])));
+    }
+}
+
+void testRebuildOnlyWhenNeeded() {
+    Model model(Skin, Force::NonbondedPairs::LennardJones);
+    State& state = model.state;
+    model.system.realize(state, Stage::Position);
+    SimTK_TEST(model.pairs.getNumNeighborListBuilds(state) == 1);
+    state.autoUpdateDiscreteVariables();
+    model.system.realize(state, Stage::Position);
+    SimTK_TEST(model.pairs.getNumNeighborListBuilds(state) == 1);
+
+    // Moving less than half the skin reuses the list, and the answers are
+    // still right.
+    state.updQ()[4] += .4*Skin;
+    checkAgainstBruteForce(model);
+    SimTK_TEST(model.pairs.getNumNeighborListBuilds(state) == 1);
+    state.autoUpdateDiscreteVariables();
+
+    // Moving farther requires a new list.
+    state.updQ()[4] += .2*Skin;
+    checkAgainstBruteForce(model);
+    SimTK_TEST(model.pairs.getNumNeighborListBuilds(state) == 2);
+    state.autoUpdateDiscreteVariables();
+    model.system.realize(state, Stage::Position);
+    SimTK_TEST(model.pairs.getNumNeighborListBuilds(state) == 2);
+}
+
+// Two stations in the same place have no force direction; they must not
+// produce NaNs.
+void testCoincidentStations() {
+    Model model(Skin, Force::NonbondedPairs::SoftSphere);
+    State& state = model.state;
+    for (int k=0; k < 3; ++k)
+        state.updQ()[6+k] = state.getQ()[9+k];
+    model.system.realize(state, Stage::Dynamics);
+    const Vector_<SpatialVec>& bodyForces =
+        model.system.getRigidBodyForces(state, Stage::Dynamics);
+    for (int i=0; i < bodyForces.size(); ++i)
+        for (int k=0; k < 3; ++k) {
+            SimTK_TEST(isFinite(bodyForces[i][0][k]));
+            SimTK_TEST(isFinite(bodyForces[i][1][k]));
+        }
+    SimTK_TEST(isFinite(model.system.calcPotentialEnergy(state)));
+}
+
+int main() {
+    SimTK_START_TEST("TestNonbondedPairs");
+        SimTK_SUBTEST(testBruteForce);
+        SimTK_SUBTEST(testEnergyGradient);
+        SimTK_SUBTEST(testRebuildOnlyWhenNeeded);
+        SimTK_SUBTEST(testCoincidentStations);
+    SimTK_END_TEST();
+}
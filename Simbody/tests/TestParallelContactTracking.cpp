@@ -0,0 +1,161 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check that tracking contacts across threads gives exactly the same active
+// contacts, ContactIds, and conditions as tracking them serially, and that
+// trackers which aren't thread safe stay on the calling thread.
+
+#include "SimTKsimbody.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+// A sphere-sphere tracker that doesn't claim to be thread safe, so it must
+// always be called on the thread doing the realization.
+class SerialOnlySphereSphere : public ContactTracker::SphereSphere {
+public:
+    bool trackContact(const Contact& priorStatus,
+                      const Transform& X_GS1, const ContactGeometry& surface1,
+                      const Transform& X_GS2, const ContactGeometry& surface2,
+                      Real cutoff, Contact& currentStatus) const
+    {   SimTK_TEST(!TaskScheduler::isWorkerThread());
+        ++numCalls;
+        return ContactTracker::SphereSphere::trackContact
+           (priorStatus, X_GS1, surface1, X_GS2, surface2, cutoff,
+            currentStatus); }
+    bool isThreadSafe() const {return false;}
+    mutable int numCalls;
+};
+
+// What we compare: the surfaces, condition, ContactId relative to the first
+// new one, and depth for circular point contacts.
+struct ContactSummary {
+    bool operator==(const ContactSummary& c) const
+    {   return surf1==c.surf1 && surf2==c.surf2 && condition==c.condition
+            && id==c.id && depth==c.depth; }
+    ContactSurfaceIndex surf1, surf2;
+    Contact::Condition  condition;
+    int                 id;
+    Real                depth;
+};
+
+// Spheres, ellipsoids and small meshes dropped in a heap onto a ground
+// plane; every step moves them a little and records the active contacts.
+Array_<Array_<ContactSummary> > runSimulation(bool useParallel,
+                                              int& numSerialCalls) {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    ContactTrackerSubsystem tracker(system);
+    SerialOnlySphereSphere* sphereSphere = new SerialOnlySphereSphere;
+    sphereSphere->numCalls = 0;
+    tracker.adoptContactTracker(sphereSphere);
+    if (useParallel) tracker.setUseParallelContactTracking(true, 4);
+    SimTK_TEST(tracker.getUseParallelContactTracking() == useParallel);
+
+    const ContactMaterial material(1e6, 0, 0, 0, 0);
+    matter.updGround().updBody().addContactSurface
+       (Transform(Rotation(-Pi/2, ZAxis)),
+        ContactSurface(ContactGeometry::HalfSpace(), material));
+
+    const PolygonalMesh cube = PolygonalMesh::createBrickMesh(Vec3(.15), 2);
+    Random::Uniform rand(0, 1);
+    rand.setSeed(23);
+    for (int i=0; i < 60; ++i) {
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+        const Real size = .1 + .1*rand.getValue();
+        switch (i % 3) {
+        case 0: body.addContactSurface(Transform(), ContactSurface
+                    (ContactGeometry::Sphere(size), material)); break;
+        case 1: body.addContactSurface(Transform(), ContactSurface
+                    (ContactGeometry::Ellipsoid(Vec3(size,.8*size,.6*size)),
+                     material)); break;
+        case 2: body.addContactSurface(Transform(), ContactSurface
+                    (ContactGeometry::TriangleMesh(cube), material)); break;
+        }
+        MobilizedBody::Free(matter.updGround(), body);
+    }
+
+    State state = system.realizeTopology();
+    for (int i=0; i < state.getNQ(); ++i)
+        state.updQ()[i] = rand.getValue() - .5;
+    for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx)
+        matter.getMobilizedBody(mbx).setQToFitTranslation
+           (state, Vec3(1.5*rand.getValue(), .4*rand.getValue(),
+                        1.5*rand.getValue()));
+
+    Array_<Array_<ContactSummary> > history;
+    int firstId = -1;
+    for (int step=0; step < 8; ++step) {
+        system.realize(state, Stage::Dynamics);
+        const ContactSnapshot& active = tracker.getActiveContacts(state);
+        history.push_back();
+        for (int i=0; i < active.getNumContacts(); ++i) {
+            const Contact& contact = active.getContact(i);
+            if (firstId < 0) firstId = contact.getContactId();
+            ContactSummary c;
+            c.surf1 = contact.getSurface1();
+            c.surf2 = contact.getSurface2();
+            c.condition = contact.getCondition();
+            c.id = contact.getContactId() - firstId;
+            c.depth = CircularPointContact::isInstance(contact)
+                      ? CircularPointContact::getAs(contact).getDepth() : 0;
+            history.back().push_back(c);
+        }
+        state.autoUpdateDiscreteVariables();
+        for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx)
+            matter.getMobilizedBody(mbx).setQToFitTranslation(state,
+                matter.getMobilizedBody(mbx).getBodyOriginLocation(state)
+                + Vec3(0, -.03, 0) + .02*Vec3(rand.getValue()-.5, 0,
+                                              rand.getValue()-.5));
+    }
+    numSerialCalls = sphereSphere->numCalls;
+    return history;
+}
+
+void testSerialAndParallelMatch() {
+    int numSerialCalls, numParallelCalls;
+    const Array_<Array_<ContactSummary> > serial =
+        runSimulation(false, numSerialCalls);
+    const Array_<Array_<ContactSummary> > parallel =
+        runSimulation(true, numParallelCalls);
+
+    SimTK_TEST(serial.size() == parallel.size());
+    int numContacts = 0;
+    for (unsigned step=0; step < serial.size(); ++step) {
+        SimTK_TEST(serial[step] == parallel[step]);
+        numContacts += serial[step].size();
+    }
+    SimTK_TEST(numContacts > 0);
+    // The sphere-sphere tracker that isn't thread safe was still used.
+    SimTK_TEST(numSerialCalls > 0);
+    SimTK_TEST(numParallelCalls == numSerialCalls);
+}
+
+int main() {
+    SimTK_START_TEST("TestParallelContactTracking");
+        SimTK_SUBTEST(testSerialAndParallelMatch);
+    SimTK_END_TEST();
+}
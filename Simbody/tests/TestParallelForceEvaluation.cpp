@@ -0,0 +1,154 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check that evaluating the force elements across threads gives the same
+// forces as evaluating them serially, that the parallel answers are
+// repeatable, and that force elements which aren't thread safe stay on the
+// calling thread.
+
+#include "SimTKsimbody.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+// A velocity dependent custom force that doesn't claim to be thread safe, so
+// it must always be called on the thread doing the realization.
+class SerialOnlyDrag : public Force::Custom::Implementation {
+public:
+    SerialOnlyDrag(const MobilizedBody& mobod) : mobod(mobod) {}
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+                   Vector_<Vec3>& particleForces, Vector& mobilityForces) const
+    {   SimTK_TEST(!TaskScheduler::isWorkerThread());
+        mobod.applyBodyForce(state, -.3*mobod.getBodyVelocity(state),
+                             bodyForces); }
+    Real calcPotentialEnergy(const State& state) const {return 0;}
+private:
+    const MobilizedBody mobod;
+};
+
+// A position-only custom force that is thread safe; these go through the
+// subsystem's cached force arrays.
+class SafeSpring : public Force::Custom::Implementation {
+public:
+    SafeSpring(const MobilizedBody& mobod, Real k) : mobod(mobod), k(k) {}
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+                   Vector_<Vec3>& particleForces, Vector& mobilityForces) const
+    {   mobod.applyBodyForce(state, SpatialVec(Vec3(0),
+            -k*mobod.getBodyOriginLocation(state)), bodyForces); }
+    Real calcPotentialEnergy(const State& state) const {return 0;}
+    bool dependsOnlyOnPositions() const {return true;}
+    bool isThreadSafe() const {return true;}
+private:
+    const MobilizedBody mobod;
+    const Real          k;
+};
+
+void testSerialAndParallelMatch() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    GeneralForceSubsystem   forces(system);
+    Force::UniformGravity   gravity(forces, matter, Vec3(0,-9.8,0));
+
+    const Body::Rigid body(MassProperties(1.5, Vec3(.1,.2,-.05),
+                                          Inertia(Vec3(.3,.2,.1))));
+    Array_<MobilizedBodyIndex> mobods;
+    for (int i=0; i < 30; ++i) {
+        MobilizedBody& parent = i < 5 ? matter.updGround()
+            : matter.updMobilizedBody(mobods[i-5]);
+        MobilizedBody::Ball ball(parent, Vec3(i%5,-1,0), body, Vec3(0,.5,0));
+        mobods.push_back(ball.getMobilizedBodyIndex());
+    }
+    for (int i=0; i+1 < (int)mobods.size(); ++i) {
+        const MobilizedBody& mobod1 = matter.getMobilizedBody(mobods[i]);
+        const MobilizedBody& mobod2 = matter.getMobilizedBody(mobods[i+1]);
+        Force::TwoPointLinearSpring(forces, mobod1, Vec3(.1,0,0),
+                                    mobod2, Vec3(0,.1,0), 10, .5);
+        Force::TwoPointLinearDamper(forces, mobod1, Vec3(0), 
+                                    mobod2, Vec3(0), 2);
+        Force::MobilityLinearSpring(forces, mobod1, MobilizerQIndex(1), 3, .1);
+        if (i % 4 == 0)
+            Force::Custom(forces, new SerialOnlyDrag(mobod1));
+        if (i % 3 == 0)
+            Force::Custom(forces, new SafeSpring(mobod1, 5));
+    }
+    Force::ConstantTorque disabled(forces, matter.getMobilizedBody(mobods[3]),
+                                   Vec3(1,2,3));
+    disabled.setDisabledByDefault(true);
+    Force::GlobalDamper(forces, matter, .1);
+
+    State state = system.realizeTopology();
+    Random::Uniform rand(-1, 1);
+    rand.setSeed(5);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+    for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+    system.realize(state, Stage::Dynamics);
+
+    SimTK_TEST(!forces.getUseParallelForceEvaluation());
+    const Vector_<SpatialVec> bodyForces =
+        system.getRigidBodyForces(state, Stage::Dynamics);
+    const Vector mobForces = system.getMobilityForces(state, Stage::Dynamics);
+
+    forces.setUseParallelForceEvaluation(true, 4);
+    SimTK_TEST(forces.getUseParallelForceEvaluation());
+    state.invalidateAll(Stage::Position);
+    system.realize(state, Stage::Dynamics);
+    const Vector_<SpatialVec> parBodyForces =
+        system.getRigidBodyForces(state, Stage::Dynamics);
+    const Vector parMobForces =
+        system.getMobilityForces(state, Stage::Dynamics);
+
+    // The sums are done in a different order so allow for roundoff.
+    SimTK_TEST_EQ(parBodyForces, bodyForces);
+    SimTK_TEST_EQ(parMobForces, mobForces);
+
+    // But doing it again must give exactly the same answers, with or without
+    // the position-only forces coming from the cache.
+    state.invalidateAll(Stage::Position);
+    system.realize(state, Stage::Dynamics);
+    for (int i=0; i < bodyForces.size(); ++i)
+        SimTK_TEST(system.getRigidBodyForces(state, Stage::Dynamics)[i]
+                   == parBodyForces[i]);
+    state.invalidateAll(Stage::Velocity);
+    system.realize(state, Stage::Dynamics);
+    for (int i=0; i < mobForces.size(); ++i)
+        SimTK_TEST(system.getMobilityForces(state, Stage::Dynamics)[i]
+                   == parMobForces[i]);
+
+    // Going back to serial should give the original answers exactly.
+    forces.setUseParallelForceEvaluation(false);
+    SimTK_TEST(!forces.getUseParallelForceEvaluation());
+    state.invalidateAll(Stage::Position);
+    system.realize(state, Stage::Dynamics);
+    for (int i=0; i < bodyForces.size(); ++i)
+        SimTK_TEST(system.getRigidBodyForces(state, Stage::Dynamics)[i]
+                   == bodyForces[i]);
+}
+
+int main() {
+    SimTK_START_TEST("TestParallelForceEvaluation");
+        SimTK_SUBTEST(testSerialAndParallelMatch);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,196 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check that realizing with the tree levels split across threads gives
+// exactly (bitwise) the same answers as the ordinary serial sweeps.
+
+#include "SimTKsimbody.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+// Build a short, wide multibody tree: many branches hanging from Ground, each
+// three bodies deep with a mix of mobilizer types.
+static void buildWideTree(SimbodyMatterSubsystem& matter, int nBranches) {
+    const Body::Rigid body(MassProperties(1.5, Vec3(.1,.2,-.05),
+                                          Inertia(Vec3(.3,.2,.1))));
+    for (int b=0; b < nBranches; ++b) {
+        const Vec3 base(b % 10, 0, b / 10);
+        MobilizedBody::Pin     arm  (matter.Ground(), Transform(base),
+                                     body, Vec3(0,1,0));
+        MobilizedBody::Ball    wrist(arm,  Vec3(0,-1,0), body, Vec3(0,.5,0));
+        MobilizedBody::Free    hand (wrist, Vec3(.1,-.5,0), body, Vec3(0));
+    }
+}
+
+static void setRandomState(const MultibodySystem& system, State& state) {
+    Random::Uniform rand(-1, 1);
+    rand.setSeed(17);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+    for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+    system.project(state, 1e-10); // normalizes the quaternions
+}
+
+void testSerialAndParallelMatch() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    GeneralForceSubsystem   forces(system);
+    Force::Gravity          gravity(forces, matter, -YAxis, 9.8);
+    buildWideTree(matter, 40);
+
+    State state = system.realizeTopology();
+    setRandomState(system, state);
+
+    SimTK_TEST(!matter.getUseParallelTreeSweeps());
+    system.realize(state, Stage::Acceleration);
+
+    const int nb = matter.getNumBodies();
+    Array_<Transform>  X_GB(nb);
+    Array_<SpatialVec> V_GB(nb), A_GB(nb);
+    Array_<SpatialInertia,MobilizedBodyIndex> R;
+    for (MobilizedBodyIndex mbx(0); mbx < nb; ++mbx) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+        X_GB[mbx] = mobod.getBodyTransform(state);
+        V_GB[mbx] = mobod.getBodyVelocity(state);
+        A_GB[mbx] = mobod.getBodyAcceleration(state);
+    }
+    matter.calcCompositeBodyInertias(state, R);
+    const Vector udot = state.getUDot();
+
+    // Split every level, even Ground's, to exercise the chunking.
+    matter.setUseParallelTreeSweeps(true, 3);
+    matter.setParallelTreeSweepThreshold(1);
+    SimTK_TEST(matter.getUseParallelTreeSweeps());
+    SimTK_TEST(matter.getParallelTreeSweepThreshold() == 1);
+
+    state.invalidateAll(Stage::Position);
+    system.realize(state, Stage::Acceleration);
+
+    Array_<SpatialInertia,MobilizedBodyIndex> Rpar;
+    matter.calcCompositeBodyInertias(state, Rpar);
+    for (MobilizedBodyIndex mbx(0); mbx < nb; ++mbx) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+        SimTK_TEST(mobod.getBodyTransform(state).p() == X_GB[mbx].p());
+        SimTK_TEST(mobod.getBodyTransform(state).R().asMat33()
+                   == X_GB[mbx].R().asMat33());
+        SimTK_TEST(mobod.getBodyVelocity(state) == V_GB[mbx]);
+        SimTK_TEST(mobod.getBodyAcceleration(state) == A_GB[mbx]);
+        if (mbx != GroundIndex) // Ground's infinite mass gives NaNs here
+            SimTK_TEST(Rpar[mbx].toSpatialMat() == R[mbx].toSpatialMat());
+    }
+    for (int i=0; i < state.getNU(); ++i)
+        SimTK_TEST(state.getUDot()[i] == udot[i]);
+
+    // Going back to serial should still give the same answers.
+    matter.setUseParallelTreeSweeps(false);
+    SimTK_TEST(!matter.getUseParallelTreeSweeps());
+    state.invalidateAll(Stage::Position);
+    system.realize(state, Stage::Acceleration);
+    for (int i=0; i < state.getNU(); ++i)
+        SimTK_TEST(state.getUDot()[i] == udot[i]);
+}
+
+// Realizing an ensemble of States together, serially or across threads, must
+// give the same answers as realizing each one on its own.
+void testRealizeBatch() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    GeneralForceSubsystem   forces(system);
+    Force::Gravity          gravity(forces, matter, -YAxis, 9.8);
+    buildWideTree(matter, 10);
+
+    State state = system.realizeTopology();
+    setRandomState(system, state);
+
+    // The articulated body inertias are realized for the whole batch in
+    // lockstep; check the first branch's bodies, one at each level of the
+    // tree, since each State moves that branch differently.
+    const MobilizedBodyIndex checkBodies[] = {MobilizedBodyIndex(1),
+        MobilizedBodyIndex(2), MobilizedBodyIndex(3)};
+
+    const int nStates = 7;
+    Array_<State>  ensemble(nStates, state);
+    Array_<State*> batch(nStates);
+    Array_<Vector> udot(nStates);
+    Array_<SpatialMat> abi(3*nStates);
+    for (int k=0; k < nStates; ++k) {
+        ensemble[k].updU() *= Real(k+1);
+        ensemble[k].updQ()[0] += Real(k)/10;
+        if (k % 2) ensemble[k].updTime() = k; // leave some at a lower stage
+        else system.realize(ensemble[k], Stage::Position);
+        if (k == 2) matter.realizeArticulatedBodyInertias(ensemble[k]);
+        batch[k] = &ensemble[k];
+
+        State single = ensemble[k];
+        system.realize(single, Stage::Acceleration);
+        udot[k] = single.getUDot();
+        for (int j=0; j < 3; ++j)
+            abi[3*k+j] = matter.getArticulatedBodyInertia
+                            (single, checkBodies[j]).toSpatialMat();
+    }
+
+    matter.realizeBatch(batch, Stage::Acceleration);
+    for (int k=0; k < nStates; ++k) {
+        SimTK_TEST(ensemble[k].getSystemStage() == Stage::Acceleration);
+        for (int i=0; i < state.getNU(); ++i)
+            SimTK_TEST(ensemble[k].getUDot()[i] == udot[k][i]);
+        for (int j=0; j < 3; ++j)
+            SimTK_TEST(matter.getArticulatedBodyInertia
+                (ensemble[k], checkBodies[j]).toSpatialMat() == abi[3*k+j]);
+    }
+    // The States really were different.
+    SimTK_TEST(abi[0] != abi[3]);
+
+    matter.setUseParallelTreeSweeps(true, 3);
+    for (int k=0; k < nStates; ++k)
+        ensemble[k].invalidateAll(Stage::Position);
+    matter.realizeBatch(batch, Stage::Report);
+    for (int k=0; k < nStates; ++k) {
+        SimTK_TEST(ensemble[k].getSystemStage() == Stage::Report);
+        for (int i=0; i < state.getNU(); ++i)
+            SimTK_TEST(ensemble[k].getUDot()[i] == udot[k][i]);
+    }
+
+    batch.push_back(0);
+    SimTK_TEST_MUST_THROW(matter.realizeBatch(batch, Stage::Position));
+}
+
+void testBadSettings() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    SimTK_TEST_MUST_THROW(matter.setParallelTreeSweepThreshold(0));
+    SimTK_TEST_MUST_THROW(matter.setUseParallelTreeSweeps(true, 0));
+    matter.setUseParallelTreeSweeps(false, 0); // thread count ignored
+    SimTK_TEST(!matter.getUseParallelTreeSweeps());
+}
+
+int main() {
+    SimTK_START_TEST("TestParallelTreeSweeps");
+        SimTK_SUBTEST(testSerialAndParallelMatch);
+        SimTK_SUBTEST(testRealizeBatch);
+        SimTK_SUBTEST(testBadSettings);
+    SimTK_END_TEST();
+}
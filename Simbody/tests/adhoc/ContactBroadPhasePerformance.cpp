@@ -0,0 +1,109 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: agent                                                             *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKsimbody.h"
+
+#include <cstdio>
+#include <string>
+
+using namespace SimTK;
+
+/**
+ * This program compares the cost of ContactTrackerSubsystem's two broad phase
+ * methods. Each scene is a cloud of small debris spheres on Translation
+ * mobilizers, optionally with a very large "terrain" sphere fixed to Ground
+ * in the middle of it. Each step moves every body a little and finds the
+ * broad phase pairs; the CPU time per step is printed for both methods.
+ */
+
+const int NumSteps = 200;
+
+void timeScene(const std::string& name, int numDebris, bool withTerrain,
+               ContactTrackerSubsystem::BroadPhaseMethod method) {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    ContactTrackerSubsystem tracker(system);
+    tracker.setBroadPhaseMethod(method);
+    const ContactMaterial   material(1e6, 0, 0, 0, 0);
+
+    // The debris fills a cube whose volume grows with the number of pieces,
+    // so the density (and number of pairs per piece) stays about the same.
+    const Real side = 2*std::pow(Real(numDebris), Real(1)/3);
+    if (withTerrain)
+        matter.updGround().updBody().addContactSurface(Transform(),
+            ContactSurface(ContactGeometry::Sphere(side/3), material));
+
+    Random::Uniform rand(0, 1);
+    rand.setSeed(17);
+    const Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+    for (int i=0; i < numDebris; ++i) {
+        Body::Rigid debris(body);
+        debris.addContactSurface(Transform(),
+            ContactSurface(ContactGeometry::Sphere(.2 + .3*rand.getValue()),
+                           material));
+        MobilizedBody::Translation(matter.updGround(), debris);
+    }
+
+    State state = system.realizeTopology();
+    for (int i=0; i < state.getNQ(); ++i)
+        state.updQ()[i] = side*(rand.getValue() - .5);
+
+    Array_<std::pair<ContactSurfaceIndex,ContactSurfaceIndex> > pairs;
+    system.realize(state, Stage::Position);
+    tracker.getBroadPhasePairs(state, pairs); // initial build isn't timed
+
+    double cpuTime = 0;
+    int numPairs = 0;
+    for (int step=0; step < NumSteps; ++step) {
+        state.autoUpdateDiscreteVariables();
+        for (int i=0; i < state.getNQ(); ++i)
+            state.updQ()[i] += .02*(rand.getValue() - .5);
+        system.realize(state, Stage::Position);
+        const double start = threadCpuTime();
+        tracker.getBroadPhasePairs(state, pairs);
+        cpuTime += threadCpuTime() - start;
+        numPairs += pairs.size();
+    }
+
+    std::printf("%24s %6d %-16s %10.2fus/step %8d pairs/step\n",
+        name.c_str(), numDebris,
+        method == ContactTrackerSubsystem::SweepAndPrune
+            ? "SweepAndPrune" : "DynamicAABBTree",
+        1e6*cpuTime/NumSteps, numPairs/NumSteps);
+}
+
+int main() {
+    try {
+        const int sizes[] = {500, 2000, 8000};
+        for (int s=0; s < 3; ++s)
+            for (int terrain=0; terrain < 2; ++terrain)
+                for (int m=0; m < 2; ++m)
+                    timeScene(terrain ? "debris + terrain" : "debris only",
+                              sizes[s], terrain != 0,
+                              ContactTrackerSubsystem::BroadPhaseMethod(m));
+    } catch (const std::exception& e) {
+        std::printf("EXCEPTION THROWN: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}